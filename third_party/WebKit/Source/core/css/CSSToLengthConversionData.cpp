@@ -115,6 +115,18 @@ float CSSToLengthConversionData::remFontSize() const
     return m_fontSizes.rem();
 }
 
+float CSSToLengthConversionData::exFontSize() const
+{
+    m_style->setHasFontMetricsUnits();
+    return m_fontSizes.ex();
+}
+
+float CSSToLengthConversionData::chFontSize() const
+{
+    m_style->setHasFontMetricsUnits();
+    return m_fontSizes.ch();
+}
+
 double CSSToLengthConversionData::zoomedComputedPixels(double value, CSSPrimitiveValue::UnitType type) const
 {
     // The logic in this function is duplicated in MediaValues::computeLength()
@@ -87,8 +87,9 @@ public:
 
     float emFontSize() const { return m_fontSizes.em(); }
     float remFontSize() const;
-    float exFontSize() const { return m_fontSizes.ex(); }
-    float chFontSize() const { return m_fontSizes.ch(); }
+    // Accessing these marks the style as having font metrics units
+    float exFontSize() const;
+    float chFontSize() const;
 
     // Accessing these marks the style as having viewport units
     double viewportWidthPercent() const;
@@ -0,0 +1,153 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "core/css/CompiledSelectorSet.h"
+
+#include "core/css/CSSSelector.h"
+#include "core/css/SelectorChecker.h"
+#include "core/dom/ContainerNode.h"
+#include "core/dom/Element.h"
+
+namespace blink {
+
+static const unsigned notCompiled = static_cast<unsigned>(-1);
+
+bool CompiledSelectorSet::canCompile(const CSSSelector& selector)
+{
+    for (const CSSSelector* component = &selector; component; component = component->tagHistory()) {
+        switch (component->match()) {
+        case CSSSelector::Tag:
+        case CSSSelector::Class:
+        case CSSSelector::Id:
+            break;
+        default:
+            return false;
+        }
+        if (component->isLastInTagHistory())
+            break;
+        switch (component->relation()) {
+        case CSSSelector::SubSelector:
+        case CSSSelector::Descendant:
+        case CSSSelector::Child:
+            break;
+        default:
+            return false;
+        }
+        if (component->relationIsAffectedByPseudoContent())
+            return false;
+    }
+    return true;
+}
+
+bool CompiledSelectorSet::canMatch(const Element& element, const ContainerNode* scope)
+{
+    // Without a scope, and for document scoped rules matched against elements
+    // of the document, SelectorChecker walks plain parent elements and never
+    // stops at a scoping shadow host.
+    if (!scope)
+        return true;
+    return scope->isDocumentNode() && scope->treeScope() == element.treeScope();
+}
+
+bool CompiledSelectorSet::compile(unsigned position, const CSSSelector& selector)
+{
+    ASSERT(position >= m_entryPoints.size());
+    if (!canCompile(selector))
+        return false;
+
+    while (m_entryPoints.size() < position)
+        m_entryPoints.append(notCompiled);
+    m_entryPoints.append(m_program.size());
+
+    for (const CSSSelector* component = &selector; component; component = component->tagHistory()) {
+        switch (component->match()) {
+        case CSSSelector::Tag:
+            if (component->tagQName() != anyQName())
+                m_program.append(Instruction { MatchTag, component });
+            break;
+        case CSSSelector::Class:
+            m_program.append(Instruction { MatchClass, component });
+            break;
+        case CSSSelector::Id:
+            m_program.append(Instruction { MatchId, component });
+            break;
+        default:
+            ASSERT_NOT_REACHED();
+        }
+        if (component->isLastInTagHistory())
+            break;
+        if (component->relation() == CSSSelector::Descendant)
+            m_program.append(Instruction { Descendant, nullptr });
+        else if (component->relation() == CSSSelector::Child)
+            m_program.append(Instruction { Child, nullptr });
+    }
+    m_program.append(Instruction { Matched, nullptr });
+    return true;
+}
+
+bool CompiledSelectorSet::match(unsigned position, Element& element) const
+{
+    ASSERT(m_entryPoints[position] != notCompiled);
+    const Instruction* instruction = m_program.data() + m_entryPoints[position];
+    Element* current = &element;
+
+    // Only the compound after the most recent descendant combinator ever has
+    // to be retried: the nearest ancestor matching it leaves the most room for
+    // the compounds further to the left, so earlier choices stay optimal.
+    const Instruction* backtrackInstruction = nullptr;
+    Element* backtrackElement = nullptr;
+
+    while (true) {
+        bool matched = false;
+        switch (instruction->opcode) {
+        case MatchTag:
+            matched = SelectorChecker::matchesTagName(*current, instruction->selector->tagQName());
+            break;
+        case MatchClass:
+            matched = current->hasClass() && current->classNames().contains(instruction->selector->value());
+            break;
+        case MatchId:
+            matched = current->hasID() && current->idForStyleResolution() == instruction->selector->value();
+            break;
+        case Descendant:
+            current = current->parentElement();
+            if (!current)
+                return false;
+            backtrackElement = current;
+            backtrackInstruction = ++instruction;
+            continue;
+        case Child:
+            // If the root was reached here, starting the current compound
+            // further up can't help either.
+            current = current->parentElement();
+            if (!current)
+                return false;
+            ++instruction;
+            continue;
+        case Matched:
+            return true;
+        }
+
+        if (matched) {
+            ++instruction;
+            continue;
+        }
+        if (!backtrackElement)
+            return false;
+        current = backtrackElement->parentElement();
+        if (!current)
+            return false;
+        backtrackElement = current;
+        instruction = backtrackInstruction;
+    }
+}
+
+void CompiledSelectorSet::shrinkToFit()
+{
+    m_entryPoints.shrinkToFit();
+    m_program.shrinkToFit();
+}
+
+} // namespace blink
@@ -0,0 +1,68 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CompiledSelectorSet_h
+#define CompiledSelectorSet_h
+
+#include "core/CoreExport.h"
+#include "wtf/Allocator.h"
+#include "wtf/Vector.h"
+
+namespace blink {
+
+class CSSSelector;
+class ContainerNode;
+class Element;
+
+// Selectors made only of type, class and id selectors joined by descendant
+// and child combinators are compiled into a flat program, which is run by a
+// non-recursive loop instead of SelectorChecker. These make up most of the
+// author rules on typical pages, e.g. ".a .b", "ul.nav > li" or "#id > x".
+//
+// The programs of all the compiled selectors of a RuleSet share one
+// instruction vector, and are looked up by the position of their RuleData.
+class CORE_EXPORT CompiledSelectorSet {
+    DISALLOW_NEW();
+    WTF_MAKE_NONCOPYABLE(CompiledSelectorSet);
+public:
+    CompiledSelectorSet() { }
+
+    static bool canCompile(const CSSSelector&);
+
+    // Whether a compiled selector matches the element the same way
+    // SelectorChecker would for rules matched under the given scope.
+    static bool canMatch(const Element&, const ContainerNode* scope);
+
+    // Returns false, and compiles nothing, if the selector is outside the
+    // supported subset. Positions must be added in increasing order.
+    bool compile(unsigned position, const CSSSelector&);
+    bool match(unsigned position, Element&) const;
+
+    bool isEmpty() const { return m_program.isEmpty(); }
+    void shrinkToFit();
+
+private:
+    enum Opcode {
+        MatchTag,
+        MatchClass,
+        MatchId,
+        // Move to the parent element. After a descendant combinator a failed
+        // match resumes at the same instruction one ancestor further up.
+        Descendant,
+        Child,
+        Matched,
+    };
+
+    struct Instruction {
+        Opcode opcode;
+        const CSSSelector* selector;
+    };
+
+    Vector<unsigned> m_entryPoints;
+    Vector<Instruction> m_program;
+};
+
+} // namespace blink
+
+#endif // CompiledSelectorSet_h
@@ -0,0 +1,95 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "core/css/CompiledSelectorSet.h"
+
+#include "core/css/CSSSelectorList.h"
+#include "core/css/SelectorChecker.h"
+#include "core/css/parser/CSSParser.h"
+#include "core/dom/Element.h"
+#include "core/dom/ElementTraversal.h"
+#include "core/html/HTMLDocument.h"
+#include "core/testing/DummyPageHolder.h"
+#include "core/testing/PerfTest.h"
+#include "wtf/text/StringBuilder.h"
+
+namespace blink {
+
+namespace {
+
+// Nested lists and cards, like the navigation and content blocks of a
+// framework based page.
+String buildDocumentMarkup(unsigned blockCount)
+{
+    StringBuilder builder;
+    builder.append("<body><div id='page' class='container'>");
+    for (unsigned i = 0; i < blockCount; ++i) {
+        builder.append("<div class='row'><div class='col-md-4 card'><ul class='nav navbar-nav'>");
+        builder.append("<li class='dropdown'><a class='dropdown-toggle'><span class='caret'></span></a></li>");
+        builder.append("<li class='active'><a><span class='badge'></span></a></li>");
+        builder.append("</ul><div class='card-body'><p class='text-muted'><span></span><a class='btn btn-default'></a></p></div></div></div>");
+    }
+    builder.append("</div></body>");
+    return builder.toString();
+}
+
+const char* const benchmarkSelectors =
+    ".navbar-nav > li > a, .nav .dropdown-toggle .caret, .card .card-body p, #page .row > .col-md-4,"
+    ".container .nav > .active > a, ul.nav li, .row .card .btn, .text-muted span, div > p > a.btn,"
+    ".navbar .nav > li > a, .row > .col-md-4 > ul > li span, .modal .btn, .card-body > p .badge";
+
+class CompiledSelectorSetPerfTest : public PerfTest {
+protected:
+    void measureMatchesPerSecond(Document& document, const CSSSelectorList& selectorList, const CompiledSelectorSet* compiledSelectors, const char* trace)
+    {
+        SelectorChecker checker(SelectorChecker::QueryingRules);
+        unsigned matchCount = 0;
+        for (int i = 0; i < 20; ++i) {
+            unsigned attemptCount = 0;
+            startTimer();
+            for (Element& element : ElementTraversal::descendantsOf(document)) {
+                unsigned position = 0;
+                for (const CSSSelector* selector = selectorList.first(); selector; selector = CSSSelectorList::next(*selector), ++position) {
+                    bool matched;
+                    if (compiledSelectors) {
+                        matched = compiledSelectors->match(position, element);
+                    } else {
+                        SelectorChecker::SelectorCheckingContext context(&element, SelectorChecker::VisitedMatchDisabled);
+                        context.selector = selector;
+                        matched = checker.match(context);
+                    }
+                    matchCount += matched;
+                    ++attemptCount;
+                }
+            }
+            stopTimer(attemptCount);
+        }
+        EXPECT_GT(matchCount, 0u);
+        reportRate("selector_matching", trace, "matches/s");
+    }
+};
+
+} // namespace
+
+TEST_F(CompiledSelectorSetPerfTest, DISABLED_MatchFrameworkSelectors)
+{
+    OwnPtr<DummyPageHolder> dummyPageHolder = DummyPageHolder::create(IntSize(800, 600));
+    Document& document = dummyPageHolder->document();
+    document.documentElement()->setInnerHTML(buildDocumentMarkup(500), ASSERT_NO_EXCEPTION);
+
+    CSSSelectorList selectorList;
+    CSSParser::parseSelector(CSSParserContext(document, nullptr), benchmarkSelectors, selectorList);
+    ASSERT_TRUE(selectorList.isValid());
+
+    CompiledSelectorSet compiledSelectors;
+    unsigned position = 0;
+    for (const CSSSelector* selector = selectorList.first(); selector; selector = CSSSelectorList::next(*selector), ++position)
+        ASSERT_TRUE(compiledSelectors.compile(position, *selector));
+
+    measureMatchesPerSecond(document, selectorList, nullptr, "selector_checker");
+    measureMatchesPerSecond(document, selectorList, &compiledSelectors, "compiled");
+}
+
+} // namespace blink
@@ -0,0 +1,103 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "core/css/CompiledSelectorSet.h"
+
+#include "core/css/CSSSelectorList.h"
+#include "core/css/SelectorChecker.h"
+#include "core/css/parser/CSSParser.h"
+#include "core/dom/Element.h"
+#include "core/dom/ElementTraversal.h"
+#include "core/html/HTMLDocument.h"
+#include "core/testing/DummyPageHolder.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace blink {
+
+class CompiledSelectorSetTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        m_dummyPageHolder = DummyPageHolder::create(IntSize(800, 600));
+        document().documentElement()->setInnerHTML(
+            "<body>"
+            "<div id='a' class='x'>"
+            "  <ul class='nav'>"
+            "    <li class='x y'><a id='b' class='y'></a></li>"
+            "    <li><div class='x'><div class='x'><span class='y'></span></div></div></li>"
+            "  </ul>"
+            "  <div class='x'><div><p class='z'><span id='c'></span></p></div></div>"
+            "</div>"
+            "<svg><foreignObject class='y'></foreignObject></svg>"
+            "</body>", ASSERT_NO_EXCEPTION);
+    }
+
+    Document& document() { return m_dummyPageHolder->document(); }
+
+    // Checks that every selector in the list compiles and matches exactly the
+    // elements SelectorChecker matches.
+    void expectSameMatches(const char* selectorText)
+    {
+        CSSSelectorList selectorList;
+        CSSParser::parseSelector(CSSParserContext(document(), nullptr), selectorText, selectorList);
+        ASSERT_TRUE(selectorList.isValid());
+
+        CompiledSelectorSet compiledSelectors;
+        unsigned position = 0;
+        for (const CSSSelector* selector = selectorList.first(); selector; selector = CSSSelectorList::next(*selector), ++position)
+            ASSERT_TRUE(compiledSelectors.compile(position, *selector)) << selectorText;
+
+        SelectorChecker checker(SelectorChecker::QueryingRules);
+        for (Element& element : ElementTraversal::descendantsOf(document())) {
+            position = 0;
+            for (const CSSSelector* selector = selectorList.first(); selector; selector = CSSSelectorList::next(*selector), ++position) {
+                SelectorChecker::SelectorCheckingContext context(&element, SelectorChecker::VisitedMatchDisabled);
+                context.selector = selector;
+                EXPECT_EQ(checker.match(context), compiledSelectors.match(position, element))
+                    << selectorText << " on " << element.tagName().utf8().data() << " " << element.getIdAttribute().utf8().data();
+            }
+        }
+    }
+
+    bool canCompile(const char* selectorText)
+    {
+        CSSSelectorList selectorList;
+        CSSParser::parseSelector(CSSParserContext(document(), nullptr), selectorText, selectorList);
+        return selectorList.isValid() && CompiledSelectorSet::canCompile(*selectorList.first());
+    }
+
+private:
+    OwnPtr<DummyPageHolder> m_dummyPageHolder;
+};
+
+TEST_F(CompiledSelectorSetTest, CompoundSelectors)
+{
+    expectSameMatches("*, div, .x, #a, div.x, li.x.y, a#b.y, #a.x, span.x, DIV, foreignobject, foreignObject.y");
+}
+
+TEST_F(CompiledSelectorSetTest, DescendantAndChildCombinators)
+{
+    expectSameMatches(".x .y, .nav > li, #a > ul > li > a, div .x span, div > .y, #a .x > .y, .x > div .z > span, html body div > div, li * span");
+}
+
+TEST_F(CompiledSelectorSetTest, Backtracking)
+{
+    // The nearest .x ancestor of the span in the second li is not a child of
+    // the li, but the one above it is.
+    expectSameMatches("li > .x .y, .x > div > p span, div > div span, ul > li .y, #a > .x span");
+}
+
+TEST_F(CompiledSelectorSetTest, UnsupportedSelectors)
+{
+    EXPECT_TRUE(canCompile("ul.nav > li a#b"));
+    EXPECT_FALSE(canCompile("a:hover"));
+    EXPECT_FALSE(canCompile("[href]"));
+    EXPECT_FALSE(canCompile("li + li"));
+    EXPECT_FALSE(canCompile("li ~ li"));
+    EXPECT_FALSE(canCompile("div::before"));
+    EXPECT_FALSE(canCompile(".x:not(.y) span"));
+}
+
+} // namespace blink
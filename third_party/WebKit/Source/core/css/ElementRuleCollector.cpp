@@ -42,6 +42,7 @@
 #include "core/css/resolver/StyleResolverStats.h"
 #include "core/dom/shadow/ShadowRoot.h"
 #include "core/style/StyleInheritedData.h"
+#include "platform/RuntimeEnabledFeatures.h"
 
 namespace blink {
 
@@ -134,14 +135,22 @@ void ElementRuleCollector::collectMatchingRulesForList(const RuleDataListType* r
     checkerContext.scrollbarPart = m_pseudoStyleRequest.scrollbarPart;
     checkerContext.isUARule = m_matchingUARules;
 
+    const CompiledSelectorSet& compiledSelectors = matchRequest.ruleSet->compiledSelectors();
+    bool useCompiledSelectors = RuntimeEnabledFeatures::compiledSelectorMatchingEnabled()
+        && CompiledSelectorSet::canMatch(*m_context.element(), matchRequest.scope);
+
     unsigned rejected = 0;
+    unsigned fastRejectChecked = 0;
     unsigned fastRejected = 0;
     unsigned matched = 0;
 
     for (const auto& ruleData : *rules) {
-        if (m_canUseFastReject && m_selectorFilter.fastRejectSelector<RuleData::maximumIdentifierCount>(ruleData.descendantSelectorIdentifierHashes())) {
-            fastRejected++;
-            continue;
+        if (m_canUseFastReject) {
+            fastRejectChecked++;
+            if (m_selectorFilter.fastRejectSelector<RuleData::maximumIdentifierCount>(ruleData.descendantSelectorIdentifierHashes())) {
+                fastRejected++;
+                continue;
+            }
         }
 
         // FIXME: Exposing the non-standard getMatchedCSSRules API to web is the only reason this is needed.
@@ -156,10 +165,17 @@ void ElementRuleCollector::collectMatchingRulesForList(const RuleDataListType* r
             continue;
 
         SelectorChecker::MatchResult result;
-        checkerContext.selector = &ruleData.selector();
-        if (!checker.match(checkerContext, result)) {
-            rejected++;
-            continue;
+        if (useCompiledSelectors && ruleData.hasCompiledSelector()) {
+            if (!compiledSelectors.match(ruleData.position(), *m_context.element())) {
+                rejected++;
+                continue;
+            }
+        } else {
+            checkerContext.selector = &ruleData.selector();
+            if (!checker.match(checkerContext, result)) {
+                rejected++;
+                continue;
+            }
         }
         if (m_pseudoStyleRequest.pseudoId != NOPSEUDO && m_pseudoStyleRequest.pseudoId != result.dynamicPseudo) {
             rejected++;
@@ -172,6 +188,7 @@ void ElementRuleCollector::collectMatchingRulesForList(const RuleDataListType* r
 
     if (StyleResolver* resolver = m_context.element()->document().styleResolver()) {
         INCREMENT_STYLE_STATS_COUNTER(*resolver, rulesRejected, rejected);
+        INCREMENT_STYLE_STATS_COUNTER(*resolver, rulesFastRejectChecked, fastRejectChecked);
         INCREMENT_STYLE_STATS_COUNTER(*resolver, rulesFastRejected, fastRejected);
         INCREMENT_STYLE_STATS_COUNTER(*resolver, rulesMatched, matched);
     }
@@ -115,6 +115,7 @@ RuleData::RuleData(StyleRule* rule, unsigned selectorIndex, unsigned position, A
     , m_linkMatchType(selector().computeLinkMatchType())
     , m_hasDocumentSecurityOrigin(addRuleFlags & RuleHasDocumentSecurityOrigin)
     , m_propertyWhitelistType(determinePropertyWhitelistType(addRuleFlags, selector()))
+    , m_hasCompiledSelector(false)
 {
     SelectorFilter::collectIdentifierHashes(selector(), m_descendantSelectorIdentifierHashes, maximumIdentifierCount);
 }
@@ -219,6 +220,12 @@ void RuleSet::addRule(StyleRule* rule, unsigned selectorIndex, AddRuleFlags addR
     RuleData ruleData(rule, selectorIndex, m_ruleCount++, addRuleFlags);
     m_features.collectFeaturesFromRuleData(ruleData);
 
+    // Compiled selectors are looked up by position, so stop compiling once
+    // positions no longer fit in RuleData.
+    if (RuntimeEnabledFeatures::compiledSelectorMatchingEnabled() && ruleData.position() == m_ruleCount - 1
+        && m_compiledSelectors.compile(ruleData.position(), ruleData.selector()))
+        ruleData.setHasCompiledSelector();
+
     if (!findBestRuleSetAndAdd(ruleData.selector(), ruleData)) {
         // If we didn't find a specialized map to stick it in, file under universal rules.
         m_universalRules.append(ruleData);
@@ -343,6 +350,7 @@ void RuleSet::compactRules()
     m_keyframesRules.shrinkToFit();
     m_deepCombinatorOrShadowPseudoRules.shrinkToFit();
     m_shadowDistributedRules.shrinkToFit();
+    m_compiledSelectors.shrinkToFit();
 }
 
 DEFINE_TRACE(MinimalRuleData)
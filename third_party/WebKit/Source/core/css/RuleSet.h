@@ -24,6 +24,7 @@
 
 #include "core/CoreExport.h"
 #include "core/css/CSSKeyframesRule.h"
+#include "core/css/CompiledSelectorSet.h"
 #include "core/css/MediaQueryEvaluator.h"
 #include "core/css/RuleFeature.h"
 #include "core/css/StyleRule.h"
@@ -87,6 +88,8 @@ public:
     unsigned linkMatchType() const { return m_linkMatchType; }
     bool hasDocumentSecurityOrigin() const { return m_hasDocumentSecurityOrigin; }
     PropertyWhitelistType propertyWhitelistType(bool isMatchingUARules = false) const { return isMatchingUARules ? PropertyWhitelistNone : static_cast<PropertyWhitelistType>(m_propertyWhitelistType); }
+    bool hasCompiledSelector() const { return m_hasCompiledSelector; }
+    void setHasCompiledSelector() { m_hasCompiledSelector = true; }
     // Try to balance between memory usage (there can be lots of RuleData objects) and good filtering performance.
     static const unsigned maximumIdentifierCount = 4;
     const unsigned* descendantSelectorIdentifierHashes() const { return m_descendantSelectorIdentifierHashes; }
@@ -105,6 +108,7 @@ private:
     unsigned m_linkMatchType : 2; //  CSSSelector::LinkMatchMask
     unsigned m_hasDocumentSecurityOrigin : 1;
     unsigned m_propertyWhitelistType : 2;
+    unsigned m_hasCompiledSelector : 1;
     // Use plain array instead of a Vector to minimize memory overhead.
     unsigned m_descendantSelectorIdentifierHashes[maximumIdentifierCount];
 };
@@ -130,6 +134,7 @@ public:
     void addRule(StyleRule*, unsigned selectorIndex, AddRuleFlags);
 
     const RuleFeatureSet& features() const { return m_features; }
+    const CompiledSelectorSet& compiledSelectors() const { return m_compiledSelectors; }
 
     const WillBeHeapTerminatedArray<RuleData>* idRules(const AtomicString& key) const { ASSERT(!m_pendingRules); return m_idRules.get(key); }
     const WillBeHeapTerminatedArray<RuleData>* classRules(const AtomicString& key) const { ASSERT(!m_pendingRules); return m_classRules.get(key); }
@@ -216,6 +221,7 @@ private:
     WillBeHeapVector<RuleData> m_universalRules;
     WillBeHeapVector<RuleData> m_shadowHostRules;
     RuleFeatureSet m_features;
+    CompiledSelectorSet m_compiledSelectors;
     WillBeHeapVector<RawPtrWillBeMember<StyleRulePage>> m_pageRules;
     WillBeHeapVector<RawPtrWillBeMember<StyleRuleViewport>> m_viewportRules;
     WillBeHeapVector<RawPtrWillBeMember<StyleRuleFontFace>> m_fontFaceRules;
@@ -83,7 +83,7 @@ static bool matchesListBoxPseudoClass(const Element& element)
     return isHTMLSelectElement(element) && !toHTMLSelectElement(element).usesMenuList();
 }
 
-static bool matchesTagName(const Element& element, const QualifiedName& tagQName)
+bool SelectorChecker::matchesTagName(const Element& element, const QualifiedName& tagQName)
 {
     if (tagQName == anyQName())
         return true;
@@ -103,6 +103,7 @@ public:
     bool match(const SelectorCheckingContext&) const;
 
     static bool matchesFocusPseudoClass(const Element&);
+    static bool matchesTagName(const Element&, const QualifiedName&);
 
 private:
     bool checkOne(const SelectorCheckingContext&, MatchResult&) const;
@@ -31,11 +31,20 @@
 
 #include "core/css/CSSSelector.h"
 #include "core/dom/Document.h"
+#include "wtf/text/StringHash.h"
 
 namespace blink {
 
 // Salt to separate otherwise identical string hashes so a class-selector like .article won't match <article> elements.
-enum { TagNameSalt = 13, IdAttributeSalt = 17, ClassAttributeSalt = 19 };
+enum { TagNameSalt = 13, IdAttributeSalt = 17, ClassAttributeSalt = 19, AttributeNameSalt = 23 };
+
+// Attribute names match case-insensitively on HTML elements in HTML documents,
+// so they are always filtered by a case-folded hash, which unlike lower()
+// doesn't make a new string for names with upper-case letters.
+static inline unsigned attributeNameHash(const AtomicString& localName)
+{
+    return CaseFoldingHash::hash(localName.impl()) * AttributeNameSalt;
+}
 
 static inline void collectElementIdentifierHashes(const Element& element, Vector<unsigned, 4>& identifierHashes)
 {
@@ -48,6 +57,10 @@ static inline void collectElementIdentifierHashes(const Element& element, Vector
         for (size_t i = 0; i < count; ++i)
             identifierHashes.append(classNames[i].impl()->existingHash() * ClassAttributeSalt);
     }
+    // Attribute selectors synchronize lazy attributes like style before
+    // matching, so the filter has to see them too.
+    for (const Attribute& attribute : element.attributes())
+        identifierHashes.append(attributeNameHash(attribute.localName()));
 }
 
 void SelectorFilter::pushParentStackFrame(Element& parent)
@@ -129,20 +142,36 @@ void SelectorFilter::popParent(Element& parent)
     popParentStackFrame();
 }
 
-static inline void collectDescendantSelectorIdentifierHashes(const CSSSelector& selector, unsigned*& hash)
+// When a selector has more ancestor identifiers than a rule can keep, the
+// ones least likely to be found on some ancestor are kept.
+enum IdentifierKind { IdIdentifier, ClassIdentifier, AttributeIdentifier, TagIdentifier, IdentifierKindCount };
+
+using IdentifierHashesByKind = Vector<unsigned, 4>[IdentifierKindCount];
+
+static inline void collectDescendantSelectorIdentifierHashes(const CSSSelector& selector, IdentifierHashesByKind& hashes)
 {
     switch (selector.match()) {
     case CSSSelector::Id:
         if (!selector.value().isEmpty())
-            (*hash++) = selector.value().impl()->existingHash() * IdAttributeSalt;
+            hashes[IdIdentifier].append(selector.value().impl()->existingHash() * IdAttributeSalt);
         break;
     case CSSSelector::Class:
         if (!selector.value().isEmpty())
-            (*hash++) = selector.value().impl()->existingHash() * ClassAttributeSalt;
+            hashes[ClassIdentifier].append(selector.value().impl()->existingHash() * ClassAttributeSalt);
         break;
     case CSSSelector::Tag:
         if (selector.tagQName().localName() != starAtom)
-            (*hash++) = selector.tagQName().localName().impl()->existingHash() * TagNameSalt;
+            hashes[TagIdentifier].append(selector.tagQName().localName().impl()->existingHash() * TagNameSalt);
+        break;
+    case CSSSelector::AttributeExact:
+    case CSSSelector::AttributeSet:
+    case CSSSelector::AttributeHyphen:
+    case CSSSelector::AttributeList:
+    case CSSSelector::AttributeContain:
+    case CSSSelector::AttributeBegin:
+    case CSSSelector::AttributeEnd:
+        if (selector.attribute().localName() != starAtom)
+            hashes[AttributeIdentifier].append(attributeNameHash(selector.attribute().localName()));
         break;
     default:
         break;
@@ -151,8 +180,7 @@ static inline void collectDescendantSelectorIdentifierHashes(const CSSSelector&
 
 void SelectorFilter::collectIdentifierHashes(const CSSSelector& selector, unsigned* identifierHashes, unsigned maximumIdentifierCount)
 {
-    unsigned* hash = identifierHashes;
-    unsigned* end = identifierHashes + maximumIdentifierCount;
+    IdentifierHashesByKind hashes;
     CSSSelector::Relation relation = selector.relation();
     bool relationIsAffectedByPseudoContent = selector.relationIsAffectedByPseudoContent();
 
@@ -163,7 +191,7 @@ void SelectorFilter::collectIdentifierHashes(const CSSSelector& selector, unsign
         switch (relation) {
         case CSSSelector::SubSelector:
             if (!skipOverSubselectors)
-                collectDescendantSelectorIdentifierHashes(*current, hash);
+                collectDescendantSelectorIdentifierHashes(*current, hashes);
             break;
         case CSSSelector::DirectAdjacent:
         case CSSSelector::IndirectAdjacent:
@@ -180,14 +208,22 @@ void SelectorFilter::collectIdentifierHashes(const CSSSelector& selector, unsign
         case CSSSelector::ShadowPseudo:
         case CSSSelector::ShadowDeep:
             skipOverSubselectors = false;
-            collectDescendantSelectorIdentifierHashes(*current, hash);
+            collectDescendantSelectorIdentifierHashes(*current, hashes);
             break;
         }
-        if (hash == end)
-            return;
         relation = current->relation();
         relationIsAffectedByPseudoContent = current->relationIsAffectedByPseudoContent();
     }
+
+    unsigned* hash = identifierHashes;
+    unsigned* end = identifierHashes + maximumIdentifierCount;
+    for (unsigned kind = 0; kind < IdentifierKindCount; ++kind) {
+        for (unsigned identifierHash : hashes[kind]) {
+            *hash++ = identifierHash;
+            if (hash == end)
+                return;
+        }
+    }
     *hash = 0;
 }
 
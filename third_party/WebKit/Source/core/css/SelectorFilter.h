@@ -70,8 +70,9 @@ private:
 
     WillBeHeapVector<ParentStackFrame> m_parentStack;
 
-    // With 100 unique strings in the filter, 2^12 slot table has false positive rate of ~0.2%.
-    static const unsigned bloomFilterKeyBits = 12;
+    // Ancestors add their tag name, id, classes and attribute names. With 200
+    // unique strings in the filter, 2^13 slot table has false positive rate of ~0.2%.
+    static const unsigned bloomFilterKeyBits = 13;
     OwnPtr<BloomFilter<bloomFilterKeyBits>> m_ancestorIdentifierFilter;
 };
 
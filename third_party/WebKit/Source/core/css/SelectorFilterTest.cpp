@@ -0,0 +1,80 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "core/css/SelectorFilter.h"
+
+#include "core/css/CSSSelectorList.h"
+#include "core/css/RuleSet.h"
+#include "core/css/parser/CSSParser.h"
+#include "core/dom/Document.h"
+#include "core/html/HTMLElement.h"
+#include "core/testing/DummyPageHolder.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace blink {
+
+class SelectorFilterTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        m_dummyPageHolder = DummyPageHolder::create(IntSize(800, 600));
+        document().body()->setInnerHTML(
+            "<div id='outer' class='a' data-state='open'>"
+            "  <p><span><a href='#'><b id='target'></b></a></span></p>"
+            "</div>", ASSERT_NO_EXCEPTION);
+    }
+
+    Document& document() { return m_dummyPageHolder->document(); }
+
+    // Whether the filter rejects the selector for children of the given element.
+    bool fastRejects(Element& parent, const char* selectorText)
+    {
+        CSSSelectorList selectorList;
+        CSSParser::parseSelector(CSSParserContext(document(), nullptr), selectorText, selectorList);
+        EXPECT_TRUE(selectorList.isValid());
+
+        unsigned identifierHashes[RuleData::maximumIdentifierCount];
+        SelectorFilter::collectIdentifierHashes(*selectorList.first(), identifierHashes, RuleData::maximumIdentifierCount);
+
+        SelectorFilter filter;
+        filter.pushParent(parent);
+        return filter.fastRejectSelector<RuleData::maximumIdentifierCount>(identifierHashes);
+    }
+
+private:
+    OwnPtr<DummyPageHolder> m_dummyPageHolder;
+};
+
+TEST_F(SelectorFilterTest, AncestorIdentifiers)
+{
+    Element& parent = *document().getElementById("target")->parentElement();
+    EXPECT_FALSE(fastRejects(parent, "#outer .a a > b"));
+    EXPECT_FALSE(fastRejects(parent, "body div p span b"));
+    EXPECT_TRUE(fastRejects(parent, ".b b"));
+    EXPECT_TRUE(fastRejects(parent, "#inner b"));
+    EXPECT_TRUE(fastRejects(parent, "ul > li b"));
+}
+
+TEST_F(SelectorFilterTest, AncestorAttributeNames)
+{
+    Element& parent = *document().getElementById("target")->parentElement();
+    EXPECT_FALSE(fastRejects(parent, "[data-state] b"));
+    EXPECT_FALSE(fastRejects(parent, "[data-state=closed] b"));
+    EXPECT_FALSE(fastRejects(parent, "[HREF] > b"));
+    EXPECT_FALSE(fastRejects(parent, "[id] [class] b"));
+    EXPECT_TRUE(fastRejects(parent, "[title] b"));
+    EXPECT_TRUE(fastRejects(parent, "div[data-open] b"));
+}
+
+TEST_F(SelectorFilterTest, KeepsMostSelectiveIdentifiers)
+{
+    // There are more ancestor identifiers than a rule keeps. The id, which is
+    // furthest from the subject, must be among the ones kept.
+    Element& parent = *document().getElementById("target")->parentElement();
+    EXPECT_FALSE(fastRejects(parent, "#outer div p span a > b"));
+    EXPECT_TRUE(fastRejects(parent, "#page div p span a > b"));
+}
+
+} // namespace blink
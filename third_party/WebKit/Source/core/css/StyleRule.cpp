@@ -34,6 +34,7 @@
 #include "core/css/StyleRuleImport.h"
 #include "core/css/StyleRuleKeyframe.h"
 #include "core/css/StyleRuleNamespace.h"
+#include "core/css/parser/CSSLazyParsingState.h"
 
 namespace blink {
 
@@ -251,6 +252,11 @@ unsigned StyleRule::averageSizeInBytes()
     return sizeof(StyleRule) + sizeof(CSSSelector) + StylePropertySet::averageSizeInBytes();
 }
 
+PassRefPtrWillBeRawPtr<StyleRule> StyleRule::createLazy(CSSSelectorList& selectorList, PassOwnPtrWillBeRawPtr<CSSLazyPropertyParser> lazyPropertyParser)
+{
+    return adoptRefWillBeNoop(new StyleRule(selectorList, lazyPropertyParser));
+}
+
 StyleRule::StyleRule(CSSSelectorList& selectorList, PassRefPtrWillBeRawPtr<StylePropertySet> properties)
     : StyleRuleBase(Style)
     , m_properties(properties)
@@ -258,9 +264,16 @@ StyleRule::StyleRule(CSSSelectorList& selectorList, PassRefPtrWillBeRawPtr<Style
     m_selectorList.adopt(selectorList);
 }
 
+StyleRule::StyleRule(CSSSelectorList& selectorList, PassOwnPtrWillBeRawPtr<CSSLazyPropertyParser> lazyPropertyParser)
+    : StyleRuleBase(Style)
+    , m_lazyPropertyParser(lazyPropertyParser)
+{
+    m_selectorList.adopt(selectorList);
+}
+
 StyleRule::StyleRule(const StyleRule& o)
     : StyleRuleBase(o)
-    , m_properties(o.m_properties->mutableCopy())
+    , m_properties(o.properties().mutableCopy())
     , m_selectorList(o.m_selectorList)
 {
 }
@@ -269,16 +282,31 @@ StyleRule::~StyleRule()
 {
 }
 
+const StylePropertySet& StyleRule::properties() const
+{
+    if (!m_properties) {
+        m_properties = m_lazyPropertyParser->parseProperties();
+        m_lazyPropertyParser.clear();
+    }
+    return *m_properties;
+}
+
 MutableStylePropertySet& StyleRule::mutableProperties()
 {
-    if (!m_properties->isMutable())
+    if (!properties().isMutable())
         m_properties = m_properties->mutableCopy();
     return *toMutableStylePropertySet(m_properties.get());
 }
 
+bool StyleRule::propertiesHaveFailedOrCanceledSubresources() const
+{
+    return m_properties && m_properties->hasFailedOrCanceledSubresources();
+}
+
 DEFINE_TRACE_AFTER_DISPATCH(StyleRule)
 {
     visitor->trace(m_properties);
+    visitor->trace(m_lazyPropertyParser);
     StyleRuleBase::traceAfterDispatch(visitor);
 }
 
@@ -31,6 +31,7 @@
 
 namespace blink {
 
+class CSSLazyPropertyParser;
 class CSSRule;
 class CSSStyleSheet;
 
@@ -109,13 +110,19 @@ public:
     {
         return adoptRefWillBeNoop(new StyleRule(selectorList, properties));
     }
+    // The declaration block is parsed when the properties are first used.
+    static PassRefPtrWillBeRawPtr<StyleRule> createLazy(CSSSelectorList&, PassOwnPtrWillBeRawPtr<CSSLazyPropertyParser>);
 
     ~StyleRule();
 
     const CSSSelectorList& selectorList() const { return m_selectorList; }
-    const StylePropertySet& properties() const { return *m_properties; }
+    const StylePropertySet& properties() const;
     MutableStylePropertySet& mutableProperties();
 
+    bool hasParsedProperties() const { return m_properties.get(); }
+    // Unparsed declarations haven't requested any subresources yet.
+    bool propertiesHaveFailedOrCanceledSubresources() const;
+
     void wrapperAdoptSelectorList(CSSSelectorList& selectors) { m_selectorList.adopt(selectors); }
 
     PassRefPtrWillBeRawPtr<StyleRule> copy() const { return adoptRefWillBeNoop(new StyleRule(*this)); }
@@ -126,9 +133,11 @@ public:
 
 private:
     StyleRule(CSSSelectorList&, PassRefPtrWillBeRawPtr<StylePropertySet>);
+    StyleRule(CSSSelectorList&, PassOwnPtrWillBeRawPtr<CSSLazyPropertyParser>);
     StyleRule(const StyleRule&);
 
-    RefPtrWillBeMember<StylePropertySet> m_properties; // Cannot be null.
+    mutable RefPtrWillBeMember<StylePropertySet> m_properties; // Null until the lazy parser has run.
+    mutable OwnPtrWillBeMember<CSSLazyPropertyParser> m_lazyPropertyParser;
     CSSSelectorList m_selectorList;
 };
 
@@ -63,7 +63,7 @@ private:
     public:
         ImportedStyleSheetClient(StyleRuleImport* ownerRule) : m_ownerRule(ownerRule) { }
         ~ImportedStyleSheetClient() override { }
-        void setCSSStyleSheet(const String& href, const KURL& baseURL, const String& charset, const CSSStyleSheetResource* sheet) override
+        void setCSSStyleSheet(const String& href, const KURL& baseURL, const String& charset, CSSStyleSheetResource* sheet) override
         {
             m_ownerRule->setCSSStyleSheet(href, baseURL, charset, sheet);
         }
@@ -78,7 +78,7 @@ private:
         RawPtrWillBeMember<StyleRuleImport> m_ownerRule;
     };
 
-    void setCSSStyleSheet(const String& href, const KURL& baseURL, const String& charset, const CSSStyleSheetResource*);
+    void setCSSStyleSheet(const String& href, const KURL& baseURL, const String& charset, CSSStyleSheetResource*);
     friend class ImportedStyleSheetClient;
 
     StyleRuleImport(const String& href, PassRefPtrWillBeRawPtr<MediaQuerySet>);
@@ -26,6 +26,7 @@
 #include "core/css/StyleRule.h"
 #include "core/css/StyleRuleImport.h"
 #include "core/css/StyleRuleNamespace.h"
+#include "core/css/parser/CSSLazyParsingState.h"
 #include "core/css/parser/CSSParser.h"
 #include "core/dom/Document.h"
 #include "core/dom/Node.h"
@@ -101,6 +102,8 @@ StyleSheetContents::StyleSheetContents(const StyleSheetContents& o)
 StyleSheetContents::~StyleSheetContents()
 {
 #if !ENABLE(OILPAN)
+    if (m_lazyParsingState)
+        m_lazyParsingState->clearOwningContents();
     clearRules();
 #endif
 }
@@ -144,6 +147,21 @@ bool StyleSheetContents::isCacheable() const
     return true;
 }
 
+bool StyleSheetContents::isCacheableInlineSheet() const
+{
+    // Inline sheets without imports load synchronously, so they can be shared
+    // while the owner element is still registered as a loading client.
+    if (!m_importRules.isEmpty())
+        return false;
+    if (m_hasMediaQueries)
+        return false;
+    if (m_isMutable)
+        return false;
+    if (!m_hasSyntacticallyValidCSSHeader)
+        return false;
+    return true;
+}
+
 void StyleSheetContents::parserAppendRule(PassRefPtrWillBeRawPtr<StyleRuleBase> rule)
 {
     if (rule->isImportRule()) {
@@ -325,7 +343,7 @@ const AtomicString& StyleSheetContents::determineNamespace(const AtomicString& p
     return m_namespaces.get(prefix);
 }
 
-void StyleSheetContents::parseAuthorStyleSheet(const CSSStyleSheetResource* cachedStyleSheet, const SecurityOrigin* securityOrigin)
+void StyleSheetContents::parseAuthorStyleSheet(CSSStyleSheetResource* cachedStyleSheet, const SecurityOrigin* securityOrigin)
 {
     TRACE_EVENT1("blink,devtools.timeline", "ParseAuthorStyleSheet", "data", InspectorParseAuthorStyleSheetEvent::data(cachedStyleSheet));
 
@@ -341,6 +359,12 @@ void StyleSheetContents::parseAuthorStyleSheet(const CSSStyleSheetResource* cach
     }
 
     CSSParserContext context(parserContext(), UseCounter::getFrom(this));
+    if (!sheetText.isNull()) {
+        if (OwnPtr<CSSTokenizer::Scope> tokens = cachedStyleSheet->takeTokenizedSheetText()) {
+            CSSParser::parseTokenizedSheet(context, this, tokens.release());
+            return;
+        }
+    }
     CSSParser::parseSheet(context, this, sheetText);
 }
 
@@ -478,7 +502,7 @@ static bool childRulesHaveFailedOrCanceledSubresources(const WillBeHeapVector<Re
         const StyleRuleBase* rule = rules[i].get();
         switch (rule->type()) {
         case StyleRuleBase::Style:
-            if (toStyleRule(rule)->properties().hasFailedOrCanceledSubresources())
+            if (toStyleRule(rule)->propertiesHaveFailedOrCanceledSubresources())
                 return true;
             break;
         case StyleRuleBase::FontFace:
@@ -578,17 +602,28 @@ void StyleSheetContents::removeSheetFromCache(Document* document)
     document->styleEngine().removeSheet(this);
 }
 
+void StyleSheetContents::setLazyParsingState(CSSLazyParsingState* state)
+{
+#if !ENABLE(OILPAN)
+    // Rules from an earlier parse may still use the old state, which must not
+    // point back at us once we're gone.
+    if (m_lazyParsingState && m_lazyParsingState != state)
+        m_lazyParsingState->clearOwningContents();
+#endif
+    m_lazyParsingState = state;
+}
+
 void StyleSheetContents::addedToMemoryCache()
 {
     ASSERT(!m_isInMemoryCache);
-    ASSERT(isCacheable());
+    ASSERT(isCacheable() || isCacheableInlineSheet());
     m_isInMemoryCache = true;
 }
 
 void StyleSheetContents::removedFromMemoryCache()
 {
     ASSERT(m_isInMemoryCache);
-    ASSERT(isCacheable());
+    ASSERT(isCacheable() || isCacheableInlineSheet());
     m_isInMemoryCache = false;
 }
 
@@ -679,6 +714,7 @@ DEFINE_TRACE(StyleSheetContents)
     visitor->trace(m_loadingClients);
     visitor->trace(m_completedClients);
     visitor->trace(m_ruleSet);
+    visitor->trace(m_lazyParsingState);
 #endif
 }
 
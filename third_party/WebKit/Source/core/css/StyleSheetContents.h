@@ -36,6 +36,7 @@
 
 namespace blink {
 
+class CSSLazyParsingState;
 class CSSStyleSheet;
 class CSSStyleSheetResource;
 class Document;
@@ -68,11 +69,12 @@ public:
     const AtomicString& defaultNamespace() { return m_defaultNamespace; }
     const AtomicString& determineNamespace(const AtomicString& prefix);
 
-    void parseAuthorStyleSheet(const CSSStyleSheetResource*, const SecurityOrigin*);
+    void parseAuthorStyleSheet(CSSStyleSheetResource*, const SecurityOrigin*);
     void parseString(const String&);
     void parseStringAtPosition(const String&, const TextPosition&);
 
     bool isCacheable() const;
+    bool isCacheableInlineSheet() const;
 
     bool isLoading() const;
 
@@ -158,6 +160,9 @@ public:
 
     String sourceMapURL() const { return m_sourceMapURL; }
 
+    // The tokens that the sheet's unparsed declaration blocks refer to.
+    void setLazyParsingState(CSSLazyParsingState*);
+
     DECLARE_TRACE();
 
 private:
@@ -195,6 +200,8 @@ private:
 
     OwnPtrWillBeMember<RuleSet> m_ruleSet;
     String m_sourceMapURL;
+
+    RawPtrWillBeWeakMember<CSSLazyParsingState> m_lazyParsingState;
 };
 
 } // namespace
@@ -78,10 +78,21 @@ bool InvalidationSet::invalidatesElement(Element& element) const
 
     if (element.hasClass() && m_classes) {
         const SpaceSplitString& classNames = element.classNames();
-        for (const auto& className : *m_classes) {
-            if (classNames.contains(className)) {
-                TRACE_STYLE_INVALIDATOR_INVALIDATION_SELECTORPART_IF_ENABLED(element, InvalidationSetMatchedClass, *this, className);
-                return true;
+        if (m_classes->size() > classNames.size()) {
+            // Sets for classes toggled on many elements can grow large. Look
+            // up the element's few classes in the set instead.
+            for (size_t i = 0; i < classNames.size(); ++i) {
+                if (m_classes->contains(classNames[i])) {
+                    TRACE_STYLE_INVALIDATOR_INVALIDATION_SELECTORPART_IF_ENABLED(element, InvalidationSetMatchedClass, *this, classNames[i]);
+                    return true;
+                }
+            }
+        } else {
+            for (const auto& className : *m_classes) {
+                if (classNames.contains(className)) {
+                    TRACE_STYLE_INVALIDATOR_INVALIDATION_SELECTORPART_IF_ENABLED(element, InvalidationSetMatchedClass, *this, className);
+                    return true;
+                }
             }
         }
     }
@@ -5,6 +5,9 @@
 #include "config.h"
 #include "core/css/invalidation/InvalidationSet.h"
 
+#include "core/dom/Document.h"
+#include "core/html/HTMLElement.h"
+#include "core/testing/DummyPageHolder.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace blink {
@@ -69,6 +72,31 @@ TEST(InvalidationSetTest, SubtreeInvalid_AddCustomPseudoBefore)
     ASSERT_TRUE(set->isEmpty());
 }
 
+// Matching looks up the element's classes in the set, or the set's classes in
+// the element's, whichever are fewer.
+TEST(InvalidationSetTest, InvalidatesElementByClass)
+{
+    OwnPtr<DummyPageHolder> dummyPageHolder = DummyPageHolder::create(IntSize(800, 600));
+    Document& document = dummyPageHolder->document();
+    document.body()->setInnerHTML("<div id='few' class='c'></div><div id='many' class='x y z c'></div><div id='none' class='x y'></div>", ASSERT_NO_EXCEPTION);
+
+    RefPtr<InvalidationSet> smallSet = DescendantInvalidationSet::create();
+    smallSet->addClass("c");
+
+    RefPtr<InvalidationSet> largeSet = DescendantInvalidationSet::create();
+    largeSet->addClass("a");
+    largeSet->addClass("b");
+    largeSet->addClass("c");
+    largeSet->addClass("d");
+    largeSet->addClass("e");
+
+    for (InvalidationSet* set : { smallSet.get(), largeSet.get() }) {
+        EXPECT_TRUE(set->invalidatesElement(*document.getElementById("few")));
+        EXPECT_TRUE(set->invalidatesElement(*document.getElementById("many")));
+        EXPECT_FALSE(set->invalidatesElement(*document.getElementById("none")));
+    }
+}
+
 #ifndef NDEBUG
 TEST(InvalidationSetTest, ShowDebug)
 {
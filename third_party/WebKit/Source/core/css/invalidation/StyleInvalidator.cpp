@@ -31,6 +31,13 @@ static const unsigned char* s_tracingEnabled = nullptr;
 
 void StyleInvalidator::invalidate(Document& document)
 {
+    TRACE_EVENT_BEGIN0("blink,blink_style", "StyleInvalidator::invalidate");
+    m_elementsVisited = 0;
+    m_elementsInvalidated = 0;
+
+    // All the invalidation sets scheduled since the last style update are
+    // applied in this single walk, which only descends into subtrees that
+    // have pending sets or are covered by the sets of an ancestor.
     RecursionData recursionData;
     SiblingData siblingData;
     if (Element* documentElement = document.documentElement())
@@ -38,6 +45,10 @@ void StyleInvalidator::invalidate(Document& document)
     document.clearChildNeedsStyleInvalidation();
     document.clearNeedsStyleInvalidation();
     m_pendingInvalidationMap.clear();
+
+    TRACE_EVENT_END2("blink,blink_style", "StyleInvalidator::invalidate",
+        "elementsVisited", m_elementsVisited,
+        "elementsInvalidated", m_elementsInvalidated);
 }
 
 void StyleInvalidator::scheduleInvalidationSetsForElement(const InvalidationLists& invalidationLists, Element& element)
@@ -67,10 +78,14 @@ void StyleInvalidator::scheduleInvalidationSetsForElement(const InvalidationList
 
     element.setNeedsStyleInvalidation();
 
+    // Toggling the same class or attribute repeatedly before the next
+    // style update schedules the same sets again. Keep one copy of each.
     PendingInvalidations& pendingInvalidations = ensurePendingInvalidations(element);
     if (element.nextSibling()) {
-        for (auto& invalidationSet : invalidationLists.siblings)
-            pendingInvalidations.siblings().append(invalidationSet);
+        for (auto& invalidationSet : invalidationLists.siblings) {
+            if (!pendingInvalidations.siblings().contains(invalidationSet))
+                pendingInvalidations.siblings().append(invalidationSet);
+        }
     }
 
     if (!requiresDescendantInvalidation)
@@ -78,7 +93,7 @@ void StyleInvalidator::scheduleInvalidationSetsForElement(const InvalidationList
 
     for (auto& invalidationSet : invalidationLists.descendants) {
         ASSERT(!invalidationSet->wholeSubtreeInvalid());
-        if (!invalidationSet->isEmpty())
+        if (!invalidationSet->isEmpty() && !pendingInvalidations.descendants().contains(invalidationSet))
             pendingInvalidations.descendants().append(invalidationSet);
     }
 }
@@ -100,6 +115,8 @@ PendingInvalidations& StyleInvalidator::ensurePendingInvalidations(Element& elem
 }
 
 StyleInvalidator::StyleInvalidator()
+    : m_elementsVisited(0)
+    , m_elementsInvalidated(0)
 {
     s_tracingEnabled = TRACE_EVENT_API_GET_CATEGORY_GROUP_ENABLED(TRACE_DISABLED_BY_DEFAULT("devtools.timeline.invalidationTracking"));
     InvalidationSet::cacheTracingFlag();
@@ -114,6 +131,10 @@ void StyleInvalidator::RecursionData::pushInvalidationSet(const DescendantInvali
     ASSERT(!m_wholeSubtreeInvalid);
     ASSERT(!invalidationSet.wholeSubtreeInvalid());
     ASSERT(!invalidationSet.isEmpty());
+    // The same set is often pending on an element and on its ancestors, e.g.
+    // for a class toggled on nested elements. It is matched once per element.
+    if (m_invalidationSets.contains(&invalidationSet))
+        return;
     if (invalidationSet.treeBoundaryCrossing())
         m_treeBoundaryCrossing = true;
     if (invalidationSet.insertionPointCrossing())
@@ -260,6 +281,7 @@ bool StyleInvalidator::invalidateChildren(Element& element, RecursionData& recur
 
 bool StyleInvalidator::invalidate(Element& element, RecursionData& recursionData, SiblingData& siblingData)
 {
+    ++m_elementsVisited;
     siblingData.advance();
     RecursionCheckpoint checkpoint(&recursionData);
 
@@ -271,6 +293,7 @@ bool StyleInvalidator::invalidate(Element& element, RecursionData& recursionData
 
     if (thisElementNeedsStyleRecalc) {
         ASSERT(!recursionData.wholeSubtreeInvalid());
+        ++m_elementsInvalidated;
         element.setNeedsStyleRecalc(LocalStyleChange, StyleChangeReasonForTracing::create(StyleChangeReason::StyleInvalidator));
     } else if (recursionData.hasInvalidationSets() && someChildrenNeedStyleRecalc) {
         // Clone the ComputedStyle in order to preserve correct style sharing, if possible. Otherwise recalc style.
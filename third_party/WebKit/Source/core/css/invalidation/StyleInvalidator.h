@@ -123,6 +123,10 @@ private:
     PendingInvalidations& ensurePendingInvalidations(Element&);
 
     PendingInvalidationMap m_pendingInvalidationMap;
+
+    // Traced per invalidate(Document&) call.
+    unsigned m_elementsVisited;
+    unsigned m_elementsInvalidated;
 };
 
 } // namespace blink
@@ -0,0 +1,50 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "core/css/parser/CSSLazyParsingState.h"
+
+#include "core/css/StylePropertySet.h"
+#include "core/css/StyleSheetContents.h"
+#include "core/css/parser/CSSParserImpl.h"
+#include "core/frame/UseCounter.h"
+
+namespace blink {
+
+CSSLazyParsingState::CSSLazyParsingState(const CSSParserContext& context, PassOwnPtr<CSSTokenizer::Scope> scope, StyleSheetContents* contents)
+    : m_scope(scope)
+    , m_context(context, nullptr)
+    , m_owningContents(contents)
+{
+}
+
+CSSLazyParsingState::~CSSLazyParsingState()
+{
+#if !ENABLE(OILPAN)
+    if (m_owningContents)
+        m_owningContents->setLazyParsingState(nullptr);
+#endif
+}
+
+CSSParserContext CSSLazyParsingState::context() const
+{
+    return CSSParserContext(m_context, UseCounter::getFrom(m_owningContents.get()));
+}
+
+DEFINE_TRACE(CSSLazyParsingState)
+{
+    visitor->trace(m_owningContents);
+}
+
+PassRefPtrWillBeRawPtr<StylePropertySet> CSSLazyPropertyParser::parseProperties()
+{
+    return CSSParserImpl::parseDeclarationListForLazyStyle(m_block, m_state->context());
+}
+
+DEFINE_TRACE(CSSLazyPropertyParser)
+{
+    visitor->trace(m_state);
+}
+
+} // namespace blink
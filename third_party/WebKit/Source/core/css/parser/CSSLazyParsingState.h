@@ -0,0 +1,81 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CSSLazyParsingState_h
+#define CSSLazyParsingState_h
+
+#include "core/css/parser/CSSParserMode.h"
+#include "core/css/parser/CSSParserTokenRange.h"
+#include "core/css/parser/CSSTokenizer.h"
+#include "platform/heap/Handle.h"
+#include "wtf/OwnPtr.h"
+#include "wtf/PassOwnPtr.h"
+#include "wtf/RefCounted.h"
+
+namespace blink {
+
+class StyleSheetContents;
+class StylePropertySet;
+
+// Keeps the tokens of a style sheet alive while some of its declaration
+// blocks are still unparsed. Shared by the CSSLazyPropertyParsers of the
+// sheet's style rules and released once all of them have parsed.
+class CSSLazyParsingState final : public RefCountedWillBeGarbageCollectedFinalized<CSSLazyParsingState> {
+public:
+    static PassRefPtrWillBeRawPtr<CSSLazyParsingState> create(const CSSParserContext& context, PassOwnPtr<CSSTokenizer::Scope> scope, StyleSheetContents* contents)
+    {
+        return adoptRefWillBeNoop(new CSSLazyParsingState(context, scope, contents));
+    }
+
+    ~CSSLazyParsingState();
+
+    CSSParserTokenRange tokenRange() { return m_scope->tokenRange(); }
+    unsigned tokenCount() { return m_scope->tokenCount(); }
+
+    // The use counter can't be kept from parse time, as the sheet may have
+    // moved to another document or lost its owner by the time a block is
+    // parsed.
+    CSSParserContext context() const;
+
+#if !ENABLE(OILPAN)
+    void clearOwningContents() { m_owningContents = nullptr; }
+#endif
+
+    DECLARE_TRACE();
+
+private:
+    CSSLazyParsingState(const CSSParserContext&, PassOwnPtr<CSSTokenizer::Scope>, StyleSheetContents*);
+
+    OwnPtr<CSSTokenizer::Scope> m_scope;
+    CSSParserContext m_context;
+    RawPtrWillBeWeakMember<StyleSheetContents> m_owningContents;
+};
+
+// The unparsed declaration block of a single style rule.
+class CSSLazyPropertyParser final : public NoBaseWillBeGarbageCollectedFinalized<CSSLazyPropertyParser> {
+    USING_FAST_MALLOC_WILL_BE_REMOVED(CSSLazyPropertyParser);
+public:
+    static PassOwnPtrWillBeRawPtr<CSSLazyPropertyParser> create(CSSParserTokenRange block, CSSLazyParsingState* state)
+    {
+        return adoptPtrWillBeNoop(new CSSLazyPropertyParser(block, state));
+    }
+
+    PassRefPtrWillBeRawPtr<StylePropertySet> parseProperties();
+
+    DECLARE_TRACE();
+
+private:
+    CSSLazyPropertyParser(CSSParserTokenRange block, CSSLazyParsingState* state)
+        : m_block(block)
+        , m_state(state)
+    {
+    }
+
+    CSSParserTokenRange m_block;
+    RefPtrWillBeMember<CSSLazyParsingState> m_state;
+};
+
+} // namespace blink
+
+#endif // CSSLazyParsingState_h
@@ -0,0 +1,75 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include "core/css/StyleRule.h"
+#include "core/css/StyleSheetContents.h"
+#include "core/css/parser/CSSParserMode.h"
+#include "platform/RuntimeEnabledFeatures.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace blink {
+
+class CSSLazyParsingTest : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        m_lazyParseCSSEnabled = RuntimeEnabledFeatures::lazyParseCSSEnabled();
+        RuntimeEnabledFeatures::setLazyParseCSSEnabled(true);
+    }
+
+    void TearDown() override
+    {
+        RuntimeEnabledFeatures::setLazyParseCSSEnabled(m_lazyParseCSSEnabled);
+    }
+
+    StyleRule* ruleAt(StyleSheetContents* sheet, size_t index)
+    {
+        return toStyleRule(sheet->childRules()[index].get());
+    }
+
+private:
+    bool m_lazyParseCSSEnabled;
+};
+
+TEST_F(CSSLazyParsingTest, Simple)
+{
+    CSSParserContext context(HTMLStandardMode, nullptr);
+    RefPtrWillBeRawPtr<StyleSheetContents> styleSheet = StyleSheetContents::create(context);
+    styleSheet->parseString("body { background-color: red; } p { color: blue; }");
+
+    StyleRule* rule = ruleAt(styleSheet.get(), 0);
+    EXPECT_FALSE(rule->hasParsedProperties());
+    EXPECT_EQ(1u, rule->properties().propertyCount());
+    EXPECT_TRUE(rule->hasParsedProperties());
+    EXPECT_FALSE(ruleAt(styleSheet.get(), 1)->hasParsedProperties());
+}
+
+TEST_F(CSSLazyParsingTest, RulesOutliveStyleSheet)
+{
+    CSSParserContext context(HTMLStandardMode, nullptr);
+    RefPtrWillBeRawPtr<StyleSheetContents> styleSheet = StyleSheetContents::create(context);
+    styleSheet->parseString("@media screen { div { color: blue; margin: 0 } }");
+
+    StyleRuleMedia* mediaRule = toStyleRuleMedia(styleSheet->childRules()[0].get());
+    RefPtrWillBeRawPtr<StyleRule> rule = toStyleRule(mediaRule->childRules()[0].get());
+    styleSheet.clear();
+
+    EXPECT_FALSE(rule->hasParsedProperties());
+    EXPECT_EQ(5u, rule->properties().propertyCount());
+}
+
+TEST_F(CSSLazyParsingTest, CopyParsesProperties)
+{
+    CSSParserContext context(HTMLStandardMode, nullptr);
+    RefPtrWillBeRawPtr<StyleSheetContents> styleSheet = StyleSheetContents::create(context);
+    styleSheet->parseString("a { color: green; }");
+
+    RefPtrWillBeRawPtr<StyleRule> copy = ruleAt(styleSheet.get(), 0)->copy();
+    EXPECT_TRUE(copy->hasParsedProperties());
+    EXPECT_TRUE(copy->properties().isMutable());
+}
+
+} // namespace blink
@@ -48,6 +48,11 @@ void CSSParser::parseSheet(const CSSParserContext& context, StyleSheetContents*
     return CSSParserImpl::parseStyleSheet(text, context, styleSheet);
 }
 
+void CSSParser::parseTokenizedSheet(const CSSParserContext& context, StyleSheetContents* styleSheet, PassOwnPtr<CSSTokenizer::Scope> scope)
+{
+    return CSSParserImpl::parseTokenizedStyleSheet(scope, context, styleSheet);
+}
+
 void CSSParser::parseSheetForInspector(const CSSParserContext& context, StyleSheetContents* styleSheet, const String& text, CSSParserObserver& observer)
 {
     return CSSParserImpl::parseStyleSheetForInspector(text, context, styleSheet, observer);
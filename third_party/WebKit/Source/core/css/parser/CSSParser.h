@@ -9,6 +9,7 @@
 #include "core/CoreExport.h"
 #include "core/css/CSSValue.h"
 #include "core/css/parser/CSSParserMode.h"
+#include "core/css/parser/CSSTokenizer.h"
 #include "platform/graphics/Color.h"
 
 namespace blink {
@@ -30,6 +31,8 @@ public:
     // As well as regular rules, allows @import and @namespace but not @charset
     static PassRefPtrWillBeRawPtr<StyleRuleBase> parseRule(const CSSParserContext&, StyleSheetContents*, const String&);
     static void parseSheet(const CSSParserContext&, StyleSheetContents*, const String&);
+    // For sheets whose text was already tokenized, e.g. on the parser thread.
+    static void parseTokenizedSheet(const CSSParserContext&, StyleSheetContents*, PassOwnPtr<CSSTokenizer::Scope>);
     static void parseSelector(const CSSParserContext&, const String&, CSSSelectorList&);
     static bool parseDeclarationList(const CSSParserContext&, MutableStylePropertySet*, const String&);
     // Returns whether anything was changed.
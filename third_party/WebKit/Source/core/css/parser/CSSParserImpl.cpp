@@ -14,6 +14,7 @@
 #include "core/css/StyleRuleNamespace.h"
 #include "core/css/StyleSheetContents.h"
 #include "core/css/parser/CSSAtRuleID.h"
+#include "core/css/parser/CSSLazyParsingState.h"
 #include "core/css/parser/CSSParserObserver.h"
 #include "core/css/parser/CSSParserObserverWrapper.h"
 #include "core/css/parser/CSSParserSelector.h"
@@ -26,6 +27,7 @@
 #include "core/dom/Document.h"
 #include "core/dom/Element.h"
 #include "core/frame/UseCounter.h"
+#include "platform/RuntimeEnabledFeatures.h"
 #include "platform/TraceEvent.h"
 #include "wtf/BitArray.h"
 
@@ -34,6 +36,7 @@ namespace blink {
 CSSParserImpl::CSSParserImpl(const CSSParserContext& context, StyleSheetContents* styleSheet)
 : m_context(context)
 , m_styleSheet(styleSheet)
+, m_lazyState(nullptr)
 , m_observerWrapper(nullptr)
 {
 }
@@ -155,23 +158,47 @@ void CSSParserImpl::parseStyleSheet(const String& string, const CSSParserContext
         "mode", context.mode());
 
     TRACE_EVENT_BEGIN0("blink,blink_style", "CSSParserImpl::parseStyleSheet.tokenize");
-    CSSTokenizer::Scope scope(string);
+    OwnPtr<CSSTokenizer::Scope> scope = adoptPtr(new CSSTokenizer::Scope(string));
+    unsigned tokenCount = scope->tokenCount();
     TRACE_EVENT_END0("blink,blink_style", "CSSParserImpl::parseStyleSheet.tokenize");
 
+    parseTokenizedStyleSheet(scope.release(), context, styleSheet);
+
+    TRACE_EVENT_END2(
+        "blink,blink_style", "CSSParserImpl::parseStyleSheet",
+        "tokenCount", tokenCount,
+        "length", string.length());
+}
+
+void CSSParserImpl::parseTokenizedStyleSheet(PassOwnPtr<CSSTokenizer::Scope> passScope, const CSSParserContext& context, StyleSheetContents* styleSheet)
+{
     TRACE_EVENT_BEGIN0("blink,blink_style", "CSSParserImpl::parseStyleSheet.parse");
+    OwnPtr<CSSTokenizer::Scope> scope = passScope;
+    CSSParserTokenRange range = scope->tokenRange();
+
     CSSParserImpl parser(context, styleSheet);
-    bool firstRuleValid = parser.consumeRuleList(scope.tokenRange(), TopLevelRuleList, [&styleSheet](PassRefPtrWillBeRawPtr<StyleRuleBase> rule) {
+    // With lazy parsing the tokens outlive this call, as style rules keep
+    // ranges into them until their declaration blocks are first used.
+    RefPtrWillBeRawPtr<CSSLazyParsingState> lazyState = nullptr;
+    if (RuntimeEnabledFeatures::lazyParseCSSEnabled()) {
+        lazyState = CSSLazyParsingState::create(context, scope.release(), styleSheet);
+        styleSheet->setLazyParsingState(lazyState.get());
+        parser.m_lazyState = lazyState.get();
+    }
+    bool firstRuleValid = parser.consumeRuleList(range, TopLevelRuleList, [&styleSheet](PassRefPtrWillBeRawPtr<StyleRuleBase> rule) {
         if (rule->isCharsetRule())
             return;
         styleSheet->parserAppendRule(rule);
     });
     styleSheet->setHasSyntacticallyValidCSSHeader(firstRuleValid);
     TRACE_EVENT_END0("blink,blink_style", "CSSParserImpl::parseStyleSheet.parse");
+}
 
-    TRACE_EVENT_END2(
-        "blink,blink_style", "CSSParserImpl::parseStyleSheet",
-        "tokenCount", scope.tokenCount(),
-        "length", string.length());
+PassRefPtrWillBeRawPtr<ImmutableStylePropertySet> CSSParserImpl::parseDeclarationListForLazyStyle(CSSParserTokenRange block, const CSSParserContext& context)
+{
+    CSSParserImpl parser(context);
+    parser.consumeDeclarationList(block, StyleRule::Style);
+    return createStylePropertySet(parser.m_parsedProperties, context.mode());
 }
 
 PassOwnPtr<Vector<double>> CSSParserImpl::parseKeyframeKeyList(const String& keyList)
@@ -627,6 +654,9 @@ PassRefPtrWillBeRawPtr<StyleRule> CSSParserImpl::consumeStyleRule(CSSParserToken
     if (m_observerWrapper)
         observeSelectors(*m_observerWrapper, prelude);
 
+    if (m_lazyState && !m_observerWrapper)
+        return StyleRule::createLazy(selectorList, CSSLazyPropertyParser::create(block, m_lazyState));
+
     consumeDeclarationList(block, StyleRule::Style);
 
     return StyleRule::create(selectorList, createStylePropertySet(m_parsedProperties, m_context.mode()));
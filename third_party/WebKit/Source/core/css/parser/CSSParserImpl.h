@@ -10,12 +10,14 @@
 #include "core/css/CSSPropertySourceData.h"
 #include "core/css/parser/CSSParserMode.h"
 #include "core/css/parser/CSSParserTokenRange.h"
+#include "core/css/parser/CSSTokenizer.h"
 #include "platform/heap/Handle.h"
 #include "wtf/Vector.h"
 #include "wtf/text/WTFString.h"
 
 namespace blink {
 
+class CSSLazyParsingState;
 class CSSParserObserver;
 class CSSParserObserverWrapper;
 class StyleRule;
@@ -60,6 +62,8 @@ public:
     static bool parseDeclarationList(MutableStylePropertySet*, const String&, const CSSParserContext&);
     static PassRefPtrWillBeRawPtr<StyleRuleBase> parseRule(const String&, const CSSParserContext&, StyleSheetContents*, AllowedRulesType);
     static void parseStyleSheet(const String&, const CSSParserContext&, StyleSheetContents*);
+    static void parseTokenizedStyleSheet(PassOwnPtr<CSSTokenizer::Scope>, const CSSParserContext&, StyleSheetContents*);
+    static PassRefPtrWillBeRawPtr<ImmutableStylePropertySet> parseDeclarationListForLazyStyle(CSSParserTokenRange block, const CSSParserContext&);
 
     static PassOwnPtr<Vector<double>> parseKeyframeKeyList(const String&);
 
@@ -110,6 +114,9 @@ private:
 
     RawPtrWillBeMember<StyleSheetContents> m_styleSheet;
 
+    // Set when style rules should keep their declaration blocks unparsed
+    RawPtrWillBeMember<CSSLazyParsingState> m_lazyState;
+
     // For the inspector
     CSSParserObserverWrapper* m_observerWrapper;
 };
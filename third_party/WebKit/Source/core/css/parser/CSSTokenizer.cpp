@@ -501,20 +501,18 @@ CSSParserToken CSSTokenizer::consumeIdentLikeToken()
 CSSParserToken CSSTokenizer::consumeStringTokenUntil(UChar endingCodePoint)
 {
     // Strings without escapes get handled without allocations
-    for (unsigned size = 0; ; size++) {
-        UChar cc = m_input.peekWithoutReplacement(size);
-        if (cc == endingCodePoint) {
-            unsigned startOffset = m_input.offset();
-            m_input.advance(size + 1);
-            return CSSParserToken(StringToken, m_input.rangeAsCSSParserString(startOffset, size));
-        }
-        if (isNewLine(cc)) {
-            m_input.advance(size);
-            return CSSParserToken(BadStringToken);
-        }
-        if (cc == '\0' || cc == '\\')
-            break;
+    unsigned size = m_input.findStringTerminator(endingCodePoint, 0);
+    UChar cc = m_input.peekWithoutReplacement(size);
+    if (cc == endingCodePoint) {
+        unsigned startOffset = m_input.offset();
+        m_input.advance(size + 1);
+        return CSSParserToken(StringToken, m_input.rangeAsCSSParserString(startOffset, size));
+    }
+    if (isNewLine(cc)) {
+        m_input.advance(size);
+        return CSSParserToken(BadStringToken);
     }
+    ASSERT(cc == '\0' || cc == '\\');
 
     StringBuilder output;
     while (true) {
@@ -581,15 +579,11 @@ CSSParserToken CSSTokenizer::consumeUrlToken()
     consumeUntilNonWhitespace();
 
     // URL tokens without escapes get handled without allocations
-    for (unsigned size = 0; ; size++) {
-        UChar cc = m_input.peekWithoutReplacement(size);
-        if (cc == ')') {
-            unsigned startOffset = m_input.offset();
-            m_input.advance(size + 1);
-            return CSSParserToken(UrlToken, m_input.rangeAsCSSParserString(startOffset, size));
-        }
-        if (cc <= ' ' || cc == '\\' || cc == '"' || cc == '\'' || cc == '(' || cc == '\x7f')
-            break;
+    unsigned size = m_input.findUrlTerminator(0);
+    if (m_input.peekWithoutReplacement(size) == ')') {
+        unsigned startOffset = m_input.offset();
+        m_input.advance(size + 1);
+        return CSSParserToken(UrlToken, m_input.rangeAsCSSParserString(startOffset, size));
     }
 
     StringBuilder result;
@@ -638,8 +632,7 @@ void CSSTokenizer::consumeBadUrlRemnants()
 void CSSTokenizer::consumeUntilNonWhitespace()
 {
     // Using HTML space here rather than CSS space since we don't do preprocessing
-    while (isHTMLSpace<UChar>(m_input.nextInputChar()))
-        consume();
+    consume(m_input.skipWhitespace(0));
 }
 
 void CSSTokenizer::consumeSingleWhitespaceIfNext()
@@ -654,16 +647,11 @@ void CSSTokenizer::consumeSingleWhitespaceIfNext()
 
 void CSSTokenizer::consumeUntilCommentEndFound()
 {
-    UChar c = consume();
     while (true) {
-        if (c == kEndOfFileMarker)
+        consume(m_input.findCharacter('*', 0));
+        if (consume() == kEndOfFileMarker)
             return;
-        if (c != '*') {
-            c = consume();
-            continue;
-        }
-        c = consume();
-        if (c == '/')
+        if (consumeIfNext('/'))
             return;
     }
 }
@@ -681,15 +669,12 @@ bool CSSTokenizer::consumeIfNext(UChar character)
 CSSParserString CSSTokenizer::consumeName()
 {
     // Names without escapes get handled without allocations
-    for (unsigned size = 0; ; ++size) {
-        UChar cc = m_input.peekWithoutReplacement(size);
-        if (cc == '\0' || cc == '\\')
-            break;
-        if (!isNameChar(cc)) {
-            unsigned startOffset = m_input.offset();
-            m_input.advance(size);
-            return m_input.rangeAsCSSParserString(startOffset, size);
-        }
+    unsigned size = m_input.skipNameCharacters(0);
+    UChar cc = m_input.peekWithoutReplacement(size);
+    if (cc != '\0' && cc != '\\') {
+        unsigned startOffset = m_input.offset();
+        m_input.advance(size);
+        return m_input.rangeAsCSSParserString(startOffset, size);
     }
 
     StringBuilder result;
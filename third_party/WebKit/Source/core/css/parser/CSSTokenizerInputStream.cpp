@@ -6,10 +6,101 @@
 #include "core/css/parser/CSSTokenizerInputStream.h"
 
 #include "core/css/parser/CSSParserString.h"
+#include "core/html/parser/HTMLParserIdioms.h"
 #include "core/html/parser/InputStreamPreprocessor.h"
+#include "platform/text/CharacterScan.h"
+#include "wtf/ASCIICType.h"
 
 namespace blink {
 
+namespace {
+
+using namespace CharacterScan;
+
+// Each matcher answers whether a scan stops at a character, both for a single
+// character and for a vector of them.
+struct NotWhitespace {
+    bool operator()(UChar c) const { return !isHTMLSpace(c); }
+#if CHARACTER_SCAN_VECTORIZED
+    CharacterVector operator()(CharacterVector characters) const
+    {
+        CharacterVector spaces = either(either(equalTo(characters, ' '), equalTo(characters, '\n')), equalTo(characters, '\t'));
+        spaces = either(spaces, either(equalTo(characters, '\r'), equalTo(characters, '\f')));
+        return invert(spaces);
+    }
+#endif
+};
+
+// Stops at anything that is not a name code point, which includes the NULs
+// and escapes the tokenizer's fast paths bail out on.
+struct NotNameCharacter {
+    bool operator()(UChar c) const { return !isASCIIAlphanumeric(c) && c != '_' && c != '-' && isASCII(c); }
+#if CHARACTER_SCAN_VECTORIZED
+    CharacterVector operator()(CharacterVector characters) const
+    {
+        CharacterVector letters = either(inRange(characters, 'a', 'z'), inRange(characters, 'A', 'Z'));
+        CharacterVector punctuation = either(equalTo(characters, '_'), equalTo(characters, '-'));
+        CharacterVector nameCharacters = either(either(letters, inRange(characters, '0', '9')), either(punctuation, inRange(characters, 0x80, 0xFF)));
+        return invert(nameCharacters);
+    }
+#endif
+};
+
+struct Character {
+    explicit Character(UChar c)
+        : m_character(c)
+    {
+        ASSERT(isASCII(c));
+    }
+    bool operator()(UChar c) const { return c == m_character; }
+#if CHARACTER_SCAN_VECTORIZED
+    CharacterVector operator()(CharacterVector characters) const { return equalTo(characters, static_cast<LChar>(m_character)); }
+#endif
+    UChar m_character;
+};
+
+// Stops at the closing quote, newlines, NULs and escapes.
+struct StringTerminator {
+    explicit StringTerminator(UChar quote)
+        : m_quote(quote)
+    {
+        ASSERT(isASCII(quote));
+    }
+    bool operator()(UChar c) const
+    {
+        return c == m_quote || c == '\n' || c == '\r' || c == '\f' || c == '\0' || c == '\\';
+    }
+#if CHARACTER_SCAN_VECTORIZED
+    CharacterVector operator()(CharacterVector characters) const
+    {
+        CharacterVector newlines = either(equalTo(characters, '\n'), either(equalTo(characters, '\r'), equalTo(characters, '\f')));
+        CharacterVector specials = either(equalTo(characters, static_cast<LChar>(m_quote)), either(equalTo(characters, '\0'), equalTo(characters, '\\')));
+        return either(newlines, specials);
+    }
+#endif
+    UChar m_quote;
+};
+
+// Stops at the closing parenthesis and at everything that can't appear
+// unescaped in a url token.
+struct UrlTerminator {
+    bool operator()(UChar c) const
+    {
+        return c == ')' || c <= ' ' || c == '\\' || c == '"' || c == '\'' || c == '(' || c == '\x7f';
+    }
+#if CHARACTER_SCAN_VECTORIZED
+    CharacterVector operator()(CharacterVector characters) const
+    {
+        CharacterVector parentheses = either(equalTo(characters, ')'), equalTo(characters, '('));
+        CharacterVector quotes = either(equalTo(characters, '"'), equalTo(characters, '\''));
+        CharacterVector others = either(inRange(characters, 0, ' '), either(equalTo(characters, '\\'), equalTo(characters, '\x7f')));
+        return either(parentheses, either(quotes, others));
+    }
+#endif
+};
+
+} // namespace
+
 CSSTokenizerInputStream::CSSTokenizerInputStream(String input)
     : m_offset(0)
     , m_stringLength(input.length())
@@ -25,6 +116,45 @@ UChar CSSTokenizerInputStream::peek(unsigned lookaheadOffset)
     return result ? result : 0xFFFD;
 }
 
+template<typename Matcher>
+unsigned CSSTokenizerInputStream::scan(unsigned offset, const Matcher& stopsAt) const
+{
+    size_t start = m_offset + offset;
+    if (start >= m_stringLength)
+        return offset;
+    size_t end;
+    if (m_string->is8Bit())
+        end = scanCharacters(m_string->characters8(), start, m_stringLength, stopsAt);
+    else
+        end = scanCharacters(m_string->characters16(), start, m_stringLength, stopsAt);
+    return end - m_offset;
+}
+
+unsigned CSSTokenizerInputStream::skipWhitespace(unsigned offset) const
+{
+    return scan(offset, NotWhitespace());
+}
+
+unsigned CSSTokenizerInputStream::skipNameCharacters(unsigned offset) const
+{
+    return scan(offset, NotNameCharacter());
+}
+
+unsigned CSSTokenizerInputStream::findCharacter(UChar c, unsigned offset) const
+{
+    return scan(offset, Character(c));
+}
+
+unsigned CSSTokenizerInputStream::findStringTerminator(UChar quote, unsigned offset) const
+{
+    return scan(offset, StringTerminator(quote));
+}
+
+unsigned CSSTokenizerInputStream::findUrlTerminator(unsigned offset) const
+{
+    return scan(offset, UrlTerminator());
+}
+
 void CSSTokenizerInputStream::pushBack(UChar cc)
 {
     --m_offset;
@@ -45,10 +45,22 @@ public:
         return offset;
     }
 
+    // Vectorized scans for the tokenizer's hot loops. Each returns the
+    // lookahead offset of the first character at or after |offset| that ends
+    // the run, or the offset of the end of the input.
+    unsigned skipWhitespace(unsigned offset) const;
+    unsigned skipNameCharacters(unsigned offset) const;
+    unsigned findCharacter(UChar, unsigned offset) const;
+    unsigned findStringTerminator(UChar quote, unsigned offset) const;
+    unsigned findUrlTerminator(unsigned offset) const;
+
     unsigned offset() const { return std::min(m_offset, m_stringLength); }
     CSSParserString rangeAsCSSParserString(unsigned start, unsigned length) const;
 
 private:
+    template<typename Matcher>
+    unsigned scan(unsigned offset, const Matcher&) const;
+
     size_t m_offset;
     const size_t m_stringLength;
     const RefPtr<StringImpl> m_string;
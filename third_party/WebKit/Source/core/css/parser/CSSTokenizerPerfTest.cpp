@@ -0,0 +1,70 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "core/css/parser/CSSTokenizer.h"
+
+#include "core/testing/PerfTest.h"
+#include "wtf/text/StringBuilder.h"
+
+namespace blink {
+
+namespace {
+
+// Builds a stylesheet shaped like the large framework sheets that dominate
+// first load: long selector lists, vendor prefixed declarations, urls,
+// strings and license comments, with little whitespace between tokens.
+String buildFrameworkStyleSheet(unsigned ruleCount, bool nonLatin1)
+{
+    StringBuilder builder;
+    builder.append("/*! Framework v3.3.5 | MIT License | a comment long enough to span several blocks */\n");
+    for (unsigned i = 0; i < ruleCount; ++i) {
+        builder.append(".navbar-collapse-");
+        builder.appendNumber(i);
+        builder.append(" > .dropdown-menu-right.open, .btn-group-vertical > .btn:not(:first-child):not(:last-child) {\n");
+        builder.append("  -webkit-box-shadow: inset 0 1px 0 rgba(255, 255, 255, .15), 0 1px 5px rgba(0, 0, 0, .075);\n");
+        builder.append("  background-image: url(../fonts/glyphicons-halflings-regular.woff2?v=");
+        builder.appendNumber(i);
+        builder.append(");\n");
+        builder.append("  font-family: \"Helvetica Neue\", Helvetica, Arial, sans-serif;\n");
+        builder.append("  content: \"");
+        if (nonLatin1)
+            builder.append(static_cast<UChar>(0x2192));
+        builder.append("\\e080 separator\";\n");
+        builder.append("  transition: border-color ease-in-out .15s, box-shadow ease-in-out .15s;\n");
+        builder.append("}\n");
+        builder.append("/* Collapsible navbar rules for the responsive layout */\n");
+    }
+    return builder.toString();
+}
+
+class CSSTokenizerPerfTest : public PerfTest {
+protected:
+    void measureTokensPerSecond(const String& sheet, const char* trace)
+    {
+        for (int i = 0; i < 10; ++i) {
+            startTimer();
+            CSSTokenizer::Scope scope(sheet);
+            stopTimer(scope.tokenCount());
+        }
+        reportRate("css_tokenizer", trace, "tokens/s");
+    }
+};
+
+} // namespace
+
+TEST_F(CSSTokenizerPerfTest, DISABLED_TokenizeFrameworkStyleSheets)
+{
+    const unsigned ruleCount = 10000;
+
+    String latin1Sheet = buildFrameworkStyleSheet(ruleCount, false);
+    String utf16Sheet = buildFrameworkStyleSheet(ruleCount, true);
+    ASSERT_TRUE(latin1Sheet.is8Bit());
+    ASSERT_FALSE(utf16Sheet.is8Bit());
+
+    measureTokensPerSecond(latin1Sheet, "8_bit");
+    measureTokensPerSecond(utf16Sheet, "16_bit");
+}
+
+} // namespace blink
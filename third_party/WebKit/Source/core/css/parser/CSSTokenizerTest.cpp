@@ -446,6 +446,22 @@ TEST(CSSTokenizerTest, CommentToken)
     TEST_TOKENS(";/******", semicolon());
 }
 
+TEST(CSSTokenizerTest, LongTokens)
+{
+    // Tokens longer than the vectorized scans' 16 character blocks, in both
+    // 8-bit and 16-bit strings.
+    String longName("a-very-long-identifier_with_0123456789_digits");
+    String nonLatin1Name = longName + fromUChar32(0x3042) + longName;
+    TEST_TOKENS(longName + "  \t\n\r\f                 " + longName, ident(longName), whitespace(), ident(longName));
+    TEST_TOKENS(nonLatin1Name + ",", ident(nonLatin1Name), comma());
+    TEST_TOKENS(longName + "\\66 oo", ident(longName + "foo"));
+    TEST_TOKENS("'" + nonLatin1Name + "'", string(nonLatin1Name));
+    TEST_TOKENS("\"" + longName + "\n" + longName, badString(), whitespace(), ident(longName));
+    TEST_TOKENS("url(" + nonLatin1Name + ")", url(nonLatin1Name));
+    TEST_TOKENS("url(https://example.com/" + longName + "(bad))", badUrl(), rightParenthesis());
+    TEST_TOKENS("/* comment spanning several blocks ** / *" + nonLatin1Name + "*/;", semicolon());
+}
+
 typedef struct {
     const char* input;
     const unsigned maxLevel;
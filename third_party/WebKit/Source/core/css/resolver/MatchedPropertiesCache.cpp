@@ -114,6 +114,7 @@ void MatchedPropertiesCache::clear()
         cacheEntry.value->clear();
     }
     m_cache.clear();
+    m_declarationTexts.clear();
 }
 
 void MatchedPropertiesCache::clearViewportDependent()
@@ -145,6 +146,13 @@ void MatchedPropertiesCache::sweep(Timer<MatchedPropertiesCache>*)
         }
     }
     m_cache.removeAll(toRemove);
+
+    Vector<const StylePropertySet*, 16> declarationTextsToRemove;
+    for (const auto& textEntry : m_declarationTexts) {
+        if (textEntry.key->hasOneRef())
+            declarationTextsToRemove.append(textEntry.key.get());
+    }
+    m_declarationTexts.removeAll(declarationTextsToRemove);
     m_additionsSinceLastSweep = 0;
 }
 #endif
@@ -165,10 +173,24 @@ bool MatchedPropertiesCache::isCacheable(const ComputedStyle& style, const Compu
     return true;
 }
 
+String MatchedPropertiesCache::declarationText(const StylePropertySet& properties)
+{
+    if (properties.isMutable())
+        return String();
+    DeclarationTextMap::AddResult addResult = m_declarationTexts.add(&properties, String());
+    if (addResult.isNewEntry) {
+        String text = properties.asText();
+        if (text.find("url(") == kNotFound)
+            addResult.storedValue->value = text;
+    }
+    return addResult.storedValue->value;
+}
+
 DEFINE_TRACE(MatchedPropertiesCache)
 {
 #if ENABLE(OILPAN)
     visitor->trace(m_cache);
+    visitor->trace(m_declarationTexts);
 #endif
 }
 
@@ -107,6 +107,12 @@ public:
 
     static bool isCacheable(const ComputedStyle&, const ComputedStyle& parentStyle);
 
+    // The serialized declarations of a property set, which key the
+    // SharedMatchedPropertiesCache. Null for mutable sets, whose text may
+    // change under the same pointer, and for sets with URLs, which are
+    // serialized relative to the base URL of their style sheet.
+    String declarationText(const StylePropertySet&);
+
     DECLARE_TRACE();
 
 private:
@@ -123,6 +129,9 @@ private:
     Timer<MatchedPropertiesCache> m_sweepTimer;
 #endif
     Cache m_cache;
+
+    using DeclarationTextMap = WillBeHeapHashMap<RefPtrWillBeWeakMember<const StylePropertySet>, String>;
+    DeclarationTextMap m_declarationTexts;
 };
 
 }
@@ -0,0 +1,132 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "core/css/resolver/SharedMatchedPropertiesCache.h"
+
+#include "core/style/ComputedStyle.h"
+#include "wtf/MainThread.h"
+#include "wtf/StdLibExtras.h"
+#include "wtf/StringHasher.h"
+
+namespace blink {
+
+SharedMatchedPropertiesCache::Key::Key()
+    : m_parentFontSize(0)
+    , m_parentEffectiveZoom(0)
+    , m_insideLink(NotInsideLink)
+    , m_hash(0)
+{
+}
+
+void SharedMatchedPropertiesCache::Key::addDeclarations(const String& declarationText, unsigned linkMatchType, unsigned whitelistType, CSSParserMode parserMode)
+{
+    ASSERT(!declarationText.isNull());
+    m_declarations.append(declarationText);
+    m_types.append(linkMatchType | whitelistType << 2 | parserMode << 4);
+}
+
+void SharedMatchedPropertiesCache::Key::setParentData(float parentFontSize, float parentEffectiveZoom, EInsideLink insideLink)
+{
+    m_parentFontSize = parentFontSize;
+    m_parentEffectiveZoom = parentEffectiveZoom;
+    m_insideLink = insideLink;
+}
+
+void SharedMatchedPropertiesCache::Key::finish()
+{
+    Vector<unsigned, 32> components;
+    for (size_t i = 0; i < m_declarations.size(); ++i) {
+        components.append(m_declarations[i].impl()->hash());
+        components.append(m_types[i]);
+    }
+    components.append(bitwise_cast<unsigned>(m_parentFontSize));
+    components.append(bitwise_cast<unsigned>(m_parentEffectiveZoom));
+    components.append(m_insideLink);
+    m_hash = StringHasher::hashMemory(components.data(), components.size() * sizeof(unsigned));
+}
+
+size_t SharedMatchedPropertiesCache::Key::estimatedSize() const
+{
+    size_t size = m_declarations.capacity() * sizeof(String) + m_types.capacity() * sizeof(unsigned);
+    for (const String& declarations : m_declarations)
+        size += declarations.length() * (declarations.is8Bit() ? sizeof(LChar) : sizeof(UChar));
+    return size;
+}
+
+bool SharedMatchedPropertiesCache::Key::operator==(const Key& other) const
+{
+    ASSERT(m_hash && other.m_hash);
+    return m_hash == other.m_hash
+        && m_parentFontSize == other.m_parentFontSize
+        && m_parentEffectiveZoom == other.m_parentEffectiveZoom
+        && m_insideLink == other.m_insideLink
+        && m_types == other.m_types
+        && m_declarations == other.m_declarations;
+}
+
+SharedMatchedPropertiesCache& SharedMatchedPropertiesCache::instance()
+{
+    ASSERT(isMainThread());
+    DEFINE_STATIC_LOCAL(SharedMatchedPropertiesCache, cache, ());
+    return cache;
+}
+
+SharedMatchedPropertiesCache::SharedMatchedPropertiesCache(size_t memoryBudget)
+    : m_memoryBudget(memoryBudget)
+    , m_memoryUsage(0)
+{
+}
+
+const ComputedStyle* SharedMatchedPropertiesCache::find(const Key& key)
+{
+    ASSERT(key.hash());
+    auto it = m_cache.find(key.hash());
+    if (it == m_cache.end() || !(it->value->key == key))
+        return nullptr;
+    m_recentlyUsed.appendOrMoveToLast(key.hash());
+    return it->value->computedStyle.get();
+}
+
+void SharedMatchedPropertiesCache::add(const Key& key, const ComputedStyle& style)
+{
+    ASSERT(key.hash());
+    remove(key.hash());
+
+    OwnPtr<Entry> entry = adoptPtr(new Entry);
+    entry->key = key;
+    // As in MatchedPropertiesCache, the cached style is only a holder for
+    // the substructures, which it shares with the original.
+    entry->computedStyle = ComputedStyle::clone(style);
+    entry->estimatedSize = sizeof(Entry) + sizeof(ComputedStyle) + key.estimatedSize();
+
+    m_memoryUsage += entry->estimatedSize;
+    m_cache.add(key.hash(), entry.release());
+    m_recentlyUsed.appendOrMoveToLast(key.hash());
+    evictToBudget();
+}
+
+void SharedMatchedPropertiesCache::remove(unsigned hash)
+{
+    OwnPtr<Entry> entry = m_cache.take(hash);
+    if (!entry)
+        return;
+    m_memoryUsage -= entry->estimatedSize;
+    m_recentlyUsed.remove(hash);
+}
+
+void SharedMatchedPropertiesCache::evictToBudget()
+{
+    while (m_memoryUsage > m_memoryBudget && !m_recentlyUsed.isEmpty())
+        remove(m_recentlyUsed.first());
+}
+
+void SharedMatchedPropertiesCache::clear()
+{
+    m_cache.clear();
+    m_recentlyUsed.clear();
+    m_memoryUsage = 0;
+}
+
+} // namespace blink
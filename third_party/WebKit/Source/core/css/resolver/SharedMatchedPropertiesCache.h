@@ -0,0 +1,102 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SharedMatchedPropertiesCache_h
+#define SharedMatchedPropertiesCache_h
+
+#include "core/CoreExport.h"
+#include "core/css/parser/CSSParserMode.h"
+#include "core/style/ComputedStyleConstants.h"
+#include "wtf/Allocator.h"
+#include "wtf/HashMap.h"
+#include "wtf/ListHashSet.h"
+#include "wtf/Noncopyable.h"
+#include "wtf/OwnPtr.h"
+#include "wtf/RefPtr.h"
+#include "wtf/Vector.h"
+#include "wtf/text/WTFString.h"
+
+namespace blink {
+
+class ComputedStyle;
+
+// A process-wide tier behind the per-StyleResolver MatchedPropertiesCache.
+// Entries are keyed on the serialized text of the matched declarations
+// instead of the StylePropertySet pointers, so frames and tabs showing the
+// same pages, which parse their own copies of the same style sheets, can
+// reuse each other's non-inherited style data.
+//
+// Only non-inherited data is ever copied out of this cache: inherited data
+// holds the document's fonts. Styles referring to document resources, such
+// as images, or depending on the document's fonts, through ex or ch units,
+// are never added, and the cache is cleared when a document loads fonts.
+// The least recently used entries are evicted once the estimated size of
+// the cache exceeds its memory budget.
+class CORE_EXPORT SharedMatchedPropertiesCache {
+    USING_FAST_MALLOC(SharedMatchedPropertiesCache);
+    WTF_MAKE_NONCOPYABLE(SharedMatchedPropertiesCache);
+public:
+    static const size_t defaultMemoryBudget = 2 * 1024 * 1024;
+
+    class CORE_EXPORT Key {
+        DISALLOW_NEW();
+    public:
+        Key();
+
+        // The declarations are only shared between property sets parsed in
+        // the same mode. Their text must not depend on the base URL of the
+        // style sheet, which is not part of the key.
+        void addDeclarations(const String& declarationText, unsigned linkMatchType, unsigned whitelistType, CSSParserMode);
+        // The parent data which the non-inherited properties of the matched
+        // declarations most commonly depend on, through font relative units.
+        void setParentData(float parentFontSize, float parentEffectiveZoom, EInsideLink);
+        void finish();
+
+        unsigned hash() const { return m_hash; }
+        size_t estimatedSize() const;
+
+        bool operator==(const Key&) const;
+
+    private:
+        Vector<String, 8> m_declarations;
+        Vector<unsigned, 8> m_types;
+        float m_parentFontSize;
+        float m_parentEffectiveZoom;
+        unsigned m_insideLink;
+        unsigned m_hash;
+    };
+
+    static SharedMatchedPropertiesCache& instance();
+
+    explicit SharedMatchedPropertiesCache(size_t memoryBudget = defaultMemoryBudget);
+
+    const ComputedStyle* find(const Key&);
+    void add(const Key&, const ComputedStyle&);
+    void clear();
+
+    size_t size() const { return m_cache.size(); }
+    size_t memoryUsage() const { return m_memoryUsage; }
+
+private:
+    struct Entry {
+        USING_FAST_MALLOC(Entry);
+    public:
+        Key key;
+        RefPtr<ComputedStyle> computedStyle;
+        size_t estimatedSize;
+    };
+
+    void remove(unsigned hash);
+    void evictToBudget();
+
+    HashMap<unsigned, OwnPtr<Entry>> m_cache;
+    // Hashes of the entries, least recently used first.
+    ListHashSet<unsigned> m_recentlyUsed;
+    size_t m_memoryBudget;
+    size_t m_memoryUsage;
+};
+
+} // namespace blink
+
+#endif // SharedMatchedPropertiesCache_h
@@ -0,0 +1,68 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "core/css/resolver/SharedMatchedPropertiesCache.h"
+
+#include "core/style/ComputedStyle.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "wtf/text/StringBuilder.h"
+
+namespace blink {
+
+namespace {
+
+SharedMatchedPropertiesCache::Key createKey(const char* declarations, float parentFontSize = 16, CSSParserMode parserMode = HTMLStandardMode)
+{
+    // Build the text at run time so equal keys never share string buffers,
+    // like the declarations of style sheets parsed by different documents.
+    StringBuilder builder;
+    builder.append(declarations);
+
+    SharedMatchedPropertiesCache::Key key;
+    key.addDeclarations(builder.toString(), 0, 0, parserMode);
+    key.setParentData(parentFontSize, 1, NotInsideLink);
+    key.finish();
+    return key;
+}
+
+} // namespace
+
+TEST(SharedMatchedPropertiesCacheTest, MatchesDeclarationText)
+{
+    SharedMatchedPropertiesCache cache;
+    RefPtr<ComputedStyle> style = ComputedStyle::create();
+    cache.add(createKey("display: block; margin: 0px;"), *style);
+
+    EXPECT_TRUE(cache.find(createKey("display: block; margin: 0px;")));
+    EXPECT_FALSE(cache.find(createKey("display: block; margin: 1px;")));
+    EXPECT_FALSE(cache.find(createKey("display: block; margin: 0px;", 20)));
+    EXPECT_FALSE(cache.find(createKey("display: block; margin: 0px;", 16, HTMLQuirksMode)));
+}
+
+TEST(SharedMatchedPropertiesCacheTest, EvictsLeastRecentlyUsed)
+{
+    SharedMatchedPropertiesCache unbounded;
+    RefPtr<ComputedStyle> style = ComputedStyle::create();
+    unbounded.add(createKey("width: 1px;"), *style);
+    size_t entrySize = unbounded.memoryUsage();
+
+    SharedMatchedPropertiesCache cache(entrySize * 2);
+    cache.add(createKey("width: 1px;"), *style);
+    cache.add(createKey("width: 2px;"), *style);
+    EXPECT_TRUE(cache.find(createKey("width: 1px;")));
+
+    cache.add(createKey("width: 3px;"), *style);
+    EXPECT_EQ(2u, cache.size());
+    EXPECT_LE(cache.memoryUsage(), entrySize * 2);
+    EXPECT_TRUE(cache.find(createKey("width: 1px;")));
+    EXPECT_FALSE(cache.find(createKey("width: 2px;")));
+    EXPECT_TRUE(cache.find(createKey("width: 3px;")));
+
+    cache.clear();
+    EXPECT_EQ(0u, cache.size());
+    EXPECT_EQ(0u, cache.memoryUsage());
+}
+
+} // namespace blink
@@ -48,7 +48,9 @@
 #include "core/html/HTMLOptionElement.h"
 #include "core/style/ComputedStyle.h"
 #include "core/svg/SVGElement.h"
+#include "platform/RuntimeEnabledFeatures.h"
 #include "platform/TraceEvent.h"
+#include "wtf/HashFunctions.h"
 #include "wtf/HashSet.h"
 #include "wtf/text/AtomicString.h"
 
@@ -101,11 +103,11 @@ bool SharedStyleFinder::canShareStyleWithControl(Element& candidate) const
     return true;
 }
 
-bool SharedStyleFinder::classNamesAffectedByRules(const SpaceSplitString& classNames) const
+bool SharedStyleFinder::classNamesAffectedByRules(const SpaceSplitString& classNames, const RuleFeatureSet& features)
 {
     unsigned count = classNames.size();
     for (unsigned i = 0; i < count; ++i) {
-        if (m_features.hasSelectorForClass(classNames[i]))
+        if (features.hasSelectorForClass(classNames[i]))
             return true;
     }
     return false;
@@ -117,6 +119,29 @@ static inline const AtomicString& typeAttributeValue(const Element& element)
     return element.isSVGElement() ? element.getAttribute(typeAttr) : element.fastGetAttribute(typeAttr);
 }
 
+unsigned SharedStyleFinder::styleSharingKey(const Element& element, const RuleFeatureSet& features)
+{
+    return styleSharingKey(element, element.hasClass() && classNamesAffectedByRules(element.classNames(), features));
+}
+
+unsigned SharedStyleFinder::styleSharingKey(const Element& element, bool affectedByClassRules)
+{
+    // Built from the cheapest of the conditions checked by
+    // canShareStyleWithElement(). Classes only have to match when rules
+    // depend on them.
+    const Element* parent = element.parentOrShadowHostElement();
+    unsigned key = PtrHash<const ComputedStyle*>::hash(parent ? parent->computedStyle() : nullptr);
+    key = WTF::pairIntHash(key, element.tagQName().localName().impl()->existingHash());
+    if (affectedByClassRules) {
+        const AtomicString& classes = element.isSVGElement() ? element.getAttribute(classAttr) : element.fastGetAttribute(classAttr);
+        key = WTF::pairIntHash(key, classes.impl()->existingHash());
+    }
+    const AtomicString& type = typeAttributeValue(element);
+    if (!type.isNull())
+        key = WTF::pairIntHash(key, type.impl()->existingHash());
+    return key;
+}
+
 bool SharedStyleFinder::sharingCandidateHasIdenticalStyleAffectingAttributes(Element& candidate) const
 {
     if (element().sharesSameElementData(candidate))
@@ -305,6 +330,17 @@ inline Element* SharedStyleFinder::findElementForStyleSharing() const
         }
         return &candidate;
     }
+
+    if (RuntimeEnabledFeatures::styleSharingIndexEnabled()) {
+        // Identical elements in wide lists and tables are often further
+        // apart than the lists reach.
+        Element* candidate = m_styleResolver->findStyleSharingCandidate(styleSharingKey(element(), m_elementAffectedByClassRules));
+        if (candidate && canShareStyleWithElement(*candidate)) {
+            INCREMENT_STYLE_STATS_COUNTER(*m_styleResolver, sharedStyleFoundInIndex, 1);
+            return candidate;
+        }
+    }
+
     m_styleResolver->addToStyleSharingList(element());
     return nullptr;
 }
@@ -52,13 +52,20 @@ public:
 
     ComputedStyle* findSharedStyle();
 
+    // Elements which can share style have the same key, which indexes
+    // candidates beyond the few kept in the style sharing lists.
+    static unsigned styleSharingKey(const Element&, const RuleFeatureSet&);
+
 private:
+    static unsigned styleSharingKey(const Element&, bool affectedByClassRules);
+
     Element* findElementForStyleSharing() const;
 
     // Only used when we're collecting stats on styles.
     bool documentContainsValidCandidate() const;
 
-    bool classNamesAffectedByRules(const SpaceSplitString&) const;
+    static bool classNamesAffectedByRules(const SpaceSplitString&, const RuleFeatureSet&);
+    bool classNamesAffectedByRules(const SpaceSplitString& classNames) const { return classNamesAffectedByRules(classNames, m_features); }
 
     bool canShareStyleWithElement(Element& candidate) const;
     bool canShareStyleWithControl(Element& candidate) const;
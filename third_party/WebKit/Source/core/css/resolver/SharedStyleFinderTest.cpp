@@ -0,0 +1,92 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "core/css/resolver/SharedStyleFinder.h"
+
+#include "core/dom/Document.h"
+#include "core/dom/NodeComputedStyle.h"
+#include "core/html/HTMLElement.h"
+#include "core/testing/DummyPageHolder.h"
+#include "platform/RuntimeEnabledFeatures.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "wtf/text/StringBuilder.h"
+
+namespace blink {
+
+class SharedStyleFinderTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        m_styleSharingIndexEnabled = RuntimeEnabledFeatures::styleSharingIndexEnabled();
+        m_dummyPageHolder = DummyPageHolder::create(IntSize(800, 600));
+    }
+
+    void TearDown() override
+    {
+        RuntimeEnabledFeatures::setStyleSharingIndexEnabled(m_styleSharingIndexEnabled);
+    }
+
+    Document& document() { return m_dummyPageHolder->document(); }
+
+    // Two rows with more distinctly styled cells than the style sharing
+    // lists hold, so a cell's twin in the previous row has left the lists.
+    void setTableContent()
+    {
+        const unsigned columns = 30;
+        StringBuilder markup;
+        markup.append("<style>");
+        for (unsigned i = 0; i < columns; ++i) {
+            markup.append(".c");
+            markup.appendNumber(i);
+            markup.append(" { padding: ");
+            markup.appendNumber(i);
+            markup.append("px }");
+        }
+        markup.append("</style><table>");
+        for (unsigned row = 0; row < 2; ++row) {
+            markup.append("<tr>");
+            for (unsigned i = 0; i < columns; ++i) {
+                markup.append("<td id='r");
+                markup.appendNumber(row);
+                markup.append("c");
+                markup.appendNumber(i);
+                markup.append("' class='c");
+                markup.appendNumber(i);
+                markup.append("'></td>");
+            }
+            markup.append("</tr>");
+        }
+        markup.append("</table>");
+        document().body()->setInnerHTML(markup.toString(), ASSERT_NO_EXCEPTION);
+        document().updateLayoutTreeIfNeeded();
+    }
+
+    const ComputedStyle* styleOf(const char* id)
+    {
+        return document().getElementById(id)->computedStyle();
+    }
+
+private:
+    OwnPtr<DummyPageHolder> m_dummyPageHolder;
+    bool m_styleSharingIndexEnabled;
+};
+
+TEST_F(SharedStyleFinderTest, SharesWithDistantCandidate)
+{
+    RuntimeEnabledFeatures::setStyleSharingIndexEnabled(true);
+    setTableContent();
+    EXPECT_EQ(styleOf("r0c0"), styleOf("r1c0"));
+    EXPECT_EQ(styleOf("r0c29"), styleOf("r1c29"));
+    EXPECT_NE(styleOf("r1c0"), styleOf("r1c1"));
+}
+
+TEST_F(SharedStyleFinderTest, DistantCandidateOutOfListReach)
+{
+    RuntimeEnabledFeatures::setStyleSharingIndexEnabled(false);
+    setTableContent();
+    EXPECT_NE(styleOf("r0c0"), styleOf("r1c0"));
+}
+
+} // namespace blink
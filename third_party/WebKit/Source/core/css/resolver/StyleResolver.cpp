@@ -327,6 +327,14 @@ void StyleResolver::addToStyleSharingList(Element& element)
     if (list.size() >= styleSharingListSize)
         list.removeLast();
     list.prepend(&element);
+
+    if (RuntimeEnabledFeatures::styleSharingIndexEnabled()) {
+        // The index only lives for one style recalc. Starting over when it
+        // is full keeps it bounded and keeps the most recent candidates.
+        if (m_styleSharingIndex.size() >= styleSharingIndexMaxSize)
+            m_styleSharingIndex.clear();
+        m_styleSharingIndex.set(SharedStyleFinder::styleSharingKey(element, m_features), &element);
+    }
 }
 
 StyleSharingList& StyleResolver::styleSharingList()
@@ -345,6 +353,7 @@ StyleSharingList& StyleResolver::styleSharingList()
 void StyleResolver::clearStyleSharingList()
 {
     m_styleSharingLists.resize(0);
+    m_styleSharingIndex.clear();
 }
 
 void StyleResolver::pushParentElement(Element& parent)
@@ -686,6 +695,9 @@ PassRefPtr<ComputedStyle> StyleResolver::styleForElement(Element* element, const
     if (state.style()->hasRemUnits())
         document().styleEngine().setUsesRemUnit(true);
 
+    if (RuntimeEnabledFeatures::internedStyleGroupsEnabled())
+        state.style()->internGroups();
+
     // Now return the style.
     return state.takeStyle();
 }
@@ -1333,6 +1345,19 @@ static unsigned computeMatchedPropertiesHash(const MatchedProperties* properties
     return StringHasher::hashMemory(properties, sizeof(MatchedProperties) * size);
 }
 
+bool StyleResolver::computeSharedMatchedPropertiesKey(const StyleResolverState& state, const MatchResult& matchResult, SharedMatchedPropertiesCache::Key& key)
+{
+    for (const auto& matchedProperties : matchResult.matchedProperties()) {
+        String declarationText = m_matchedPropertiesCache.declarationText(*matchedProperties.properties);
+        if (declarationText.isNull())
+            return false;
+        key.addDeclarations(declarationText, matchedProperties.m_types.linkMatchType, matchedProperties.m_types.whitelistType, matchedProperties.properties->cssParserMode());
+    }
+    key.setParentData(state.parentStyle()->fontDescription().computedSize(), state.parentStyle()->effectiveZoom(), state.style()->insideLink());
+    key.finish();
+    return true;
+}
+
 void StyleResolver::invalidateMatchedPropertiesCache()
 {
     m_matchedPropertiesCache.clear();
@@ -1354,8 +1379,25 @@ void StyleResolver::applyMatchedProperties(StyleResolverState& state, const Matc
     unsigned cacheHash = RuntimeEnabledFeatures::styleMatchedPropertiesCacheEnabled() && matchResult.isCacheable() ? computeMatchedPropertiesHash(matchResult.matchedProperties().data(), matchResult.matchedProperties().size()) : 0;
     bool applyInheritedOnly = false;
     const CachedMatchedProperties* cachedMatchedProperties = cacheHash ? m_matchedPropertiesCache.find(cacheHash, state, matchResult.matchedProperties()) : nullptr;
-
-    if (cachedMatchedProperties && MatchedPropertiesCache::isCacheable(*state.style(), *state.parentStyle())) {
+    const ComputedStyle* cachedStyle = cachedMatchedProperties ? cachedMatchedProperties->computedStyle.get() : nullptr;
+
+    SharedMatchedPropertiesCache::Key sharedCacheKey;
+    bool useSharedCache = cacheHash && !cachedMatchedProperties && RuntimeEnabledFeatures::sharedMatchedPropertiesCacheEnabled()
+        && computeSharedMatchedPropertiesKey(state, matchResult, sharedCacheKey);
+
+    if (useSharedCache && MatchedPropertiesCache::isCacheable(*state.style(), *state.parentStyle())) {
+        cachedStyle = SharedMatchedPropertiesCache::instance().find(sharedCacheKey);
+        if (cachedStyle) {
+            INCREMENT_STYLE_STATS_COUNTER(*this, sharedMatchedPropertyCacheHit, 1);
+            // Another document computed a style from the same declarations.
+            // Its inherited data refers to that document's fonts, so only the
+            // non-inherited properties are copied.
+            state.style()->copyNonInheritedFromCached(*cachedStyle);
+            applyInheritedOnly = true;
+        } else {
+            INCREMENT_STYLE_STATS_COUNTER(*this, sharedMatchedPropertyCacheMiss, 1);
+        }
+    } else if (cachedMatchedProperties && MatchedPropertiesCache::isCacheable(*state.style(), *state.parentStyle())) {
         INCREMENT_STYLE_STATS_COUNTER(*this, matchedPropertyCacheHit, 1);
         // We can build up the style by copying non-inherited properties from an earlier style object built using the same exact
         // style declarations. We then only need to apply the inherited properties, if any, as their values can depend on the
@@ -1408,7 +1450,7 @@ void StyleResolver::applyMatchedProperties(StyleResolverState& state, const Matc
         state.setEffectiveZoom(ComputedStyle::initialZoom());
     }
 
-    if (cachedMatchedProperties && cachedMatchedProperties->computedStyle->effectiveZoom() != state.style()->effectiveZoom()) {
+    if (cachedStyle && cachedStyle->effectiveZoom() != state.style()->effectiveZoom()) {
         state.fontBuilder().didChangeEffectiveZoom();
         applyInheritedOnly = false;
     }
@@ -1417,7 +1459,7 @@ void StyleResolver::applyMatchedProperties(StyleResolverState& state, const Matc
     updateFont(state);
 
     // Many properties depend on the font. If it changes we just apply all properties.
-    if (cachedMatchedProperties && cachedMatchedProperties->computedStyle->fontDescription() != state.style()->fontDescription())
+    if (cachedStyle && cachedStyle->fontDescription() != state.style()->fontDescription())
         applyInheritedOnly = false;
 
     // Now do the normal priority UA properties.
@@ -1441,12 +1483,22 @@ void StyleResolver::applyMatchedProperties(StyleResolverState& state, const Matc
         state.style()->setHasAuthorBorder(hasAuthorBorder(state));
     }
 
+    // Images and SVG documents are loaded through, and owned by, this
+    // document, so styles using them are not shared with other documents.
+    bool usesDocumentResources = !state.elementStyleResources().pendingImageProperties().isEmpty()
+        || !state.elementStyleResources().pendingSVGDocuments().isEmpty();
+
     loadPendingResources(state);
 
     if (!cachedMatchedProperties && cacheHash && MatchedPropertiesCache::isCacheable(*state.style(), *state.parentStyle())) {
         ASSERT(RuntimeEnabledFeatures::styleMatchedPropertiesCacheEnabled());
         INCREMENT_STYLE_STATS_COUNTER(*this, matchedPropertyCacheAdded, 1);
         m_matchedPropertiesCache.add(*state.style(), *state.parentStyle(), cacheHash, matchResult.matchedProperties());
+
+        if (useSharedCache && !cachedStyle && !usesDocumentResources && !state.style()->hasViewportUnits() && !state.style()->hasRemUnits() && !state.style()->hasFontMetricsUnits()) {
+            INCREMENT_STYLE_STATS_COUNTER(*this, sharedMatchedPropertyCacheAdded, 1);
+            SharedMatchedPropertiesCache::instance().add(sharedCacheKey, *state.style());
+        }
     }
 
     ASSERT(!state.fontBuilder().fontDirty());
@@ -1560,6 +1612,7 @@ DEFINE_TRACE(StyleResolver)
     visitor->trace(m_treeBoundaryCrossingScopes);
     visitor->trace(m_styleResourceLoader);
     visitor->trace(m_styleSharingLists);
+    visitor->trace(m_styleSharingIndex);
     visitor->trace(m_pendingStyleSheets);
     visitor->trace(m_document);
 #endif
@@ -32,6 +32,7 @@
 #include "core/css/SelectorFilter.h"
 #include "core/css/resolver/CSSPropertyPriority.h"
 #include "core/css/resolver/MatchedPropertiesCache.h"
+#include "core/css/resolver/SharedMatchedPropertiesCache.h"
 #include "core/css/resolver/StyleBuilder.h"
 #include "core/css/resolver/StyleResolverStats.h"
 #include "core/css/resolver/StyleResourceLoader.h"
@@ -74,7 +75,10 @@ enum RuleMatchingBehavior {
 
 const unsigned styleSharingListSize = 15;
 const unsigned styleSharingMaxDepth = 32;
+const unsigned styleSharingIndexMaxSize = 1024;
 using StyleSharingList = WillBeHeapDeque<RawPtrWillBeMember<Element>, styleSharingListSize>;
+// The most recent candidate for each SharedStyleFinder::styleSharingKey().
+using StyleSharingIndex = WillBeHeapHashMap<unsigned, RawPtrWillBeMember<Element>, DefaultHash<unsigned>::Hash, WTF::UnsignedWithZeroKeyHashTraits<unsigned>>;
 using ActiveInterpolationsMap = HashMap<PropertyHandle, Vector<RefPtr<Interpolation>, 1>>;
 
 // This class selects a ComputedStyle for a given element based on a collection of stylesheets.
@@ -166,6 +170,7 @@ public:
     }
 
     StyleSharingList& styleSharingList();
+    Element* findStyleSharingCandidate(unsigned styleSharingKey) const { return m_styleSharingIndex.get(styleSharingKey); }
 
     bool hasRulesForId(const AtomicString&) const;
 
@@ -212,6 +217,7 @@ private:
     void resetRuleFeatures();
 
     void applyMatchedProperties(StyleResolverState&, const MatchResult&);
+    bool computeSharedMatchedPropertiesKey(const StyleResolverState&, const MatchResult&, SharedMatchedPropertiesCache::Key&);
     bool applyAnimatedProperties(StyleResolverState&, const Element* animatingElement);
     void applyCallbackSelectors(StyleResolverState&);
 
@@ -262,6 +268,7 @@ private:
 
     unsigned m_styleSharingDepth;
     WillBeHeapVector<OwnPtrWillBeMember<StyleSharingList>, styleSharingMaxDepth> m_styleSharingLists;
+    StyleSharingIndex m_styleSharingIndex;
 
     OwnPtr<StyleResolverStats> m_styleResolverStats;
 
@@ -38,6 +38,7 @@ void StyleResolverStats::reset()
     sharedStyleLookups = 0;
     sharedStyleCandidates = 0;
     sharedStyleFound = 0;
+    sharedStyleFoundInIndex = 0;
     sharedStyleMissed = 0;
     sharedStyleRejectedByUncommonAttributeRules = 0;
     sharedStyleRejectedBySiblingRules = 0;
@@ -46,6 +47,10 @@ void StyleResolverStats::reset()
     matchedPropertyCacheHit = 0;
     matchedPropertyCacheInheritedHit = 0;
     matchedPropertyCacheAdded = 0;
+    sharedMatchedPropertyCacheHit = 0;
+    sharedMatchedPropertyCacheMiss = 0;
+    sharedMatchedPropertyCacheAdded = 0;
+    rulesFastRejectChecked = 0;
     rulesFastRejected = 0;
     rulesRejected = 0;
     rulesMatched = 0;
@@ -70,6 +75,7 @@ PassRefPtr<TracedValue> StyleResolverStats::toTracedValue() const
     tracedValue->setInteger("sharedStyleLookups", sharedStyleLookups);
     tracedValue->setInteger("sharedStyleCandidates", sharedStyleCandidates);
     tracedValue->setInteger("sharedStyleFound", sharedStyleFound);
+    tracedValue->setInteger("sharedStyleFoundInIndex", sharedStyleFoundInIndex);
     if (allCountersEnabled())
         tracedValue->setInteger("sharedStyleMissed", sharedStyleMissed);
     tracedValue->setInteger("sharedStyleRejectedByUncommonAttributeRules", sharedStyleRejectedByUncommonAttributeRules);
@@ -79,7 +85,11 @@ PassRefPtr<TracedValue> StyleResolverStats::toTracedValue() const
     tracedValue->setInteger("matchedPropertyCacheHit", matchedPropertyCacheHit);
     tracedValue->setInteger("matchedPropertyCacheInheritedHit", matchedPropertyCacheInheritedHit);
     tracedValue->setInteger("matchedPropertyCacheAdded", matchedPropertyCacheAdded);
+    tracedValue->setInteger("sharedMatchedPropertyCacheHit", sharedMatchedPropertyCacheHit);
+    tracedValue->setInteger("sharedMatchedPropertyCacheMiss", sharedMatchedPropertyCacheMiss);
+    tracedValue->setInteger("sharedMatchedPropertyCacheAdded", sharedMatchedPropertyCacheAdded);
     tracedValue->setInteger("rulesRejected", rulesRejected);
+    tracedValue->setInteger("rulesFastRejectChecked", rulesFastRejectChecked);
     tracedValue->setInteger("rulesFastRejected", rulesFastRejected);
     tracedValue->setInteger("rulesMatched", rulesMatched);
     tracedValue->setInteger("stylesChanged", stylesChanged);
@@ -52,6 +52,9 @@ public:
     unsigned sharedStyleLookups;
     unsigned sharedStyleCandidates;
     unsigned sharedStyleFound;
+    // Of sharedStyleFound, those found in the style sharing index rather
+    // than the style sharing lists.
+    unsigned sharedStyleFoundInIndex;
     unsigned sharedStyleMissed;
     unsigned sharedStyleRejectedByUncommonAttributeRules;
     unsigned sharedStyleRejectedBySiblingRules;
@@ -60,6 +63,14 @@ public:
     unsigned matchedPropertyCacheHit;
     unsigned matchedPropertyCacheInheritedHit;
     unsigned matchedPropertyCacheAdded;
+    // Lookups in the process-wide SharedMatchedPropertiesCache, which are
+    // made after misses in the per-document cache.
+    unsigned sharedMatchedPropertyCacheHit;
+    unsigned sharedMatchedPropertyCacheMiss;
+    unsigned sharedMatchedPropertyCacheAdded;
+    // Rules tested against the ancestor filter, of which rulesFastRejected
+    // were rejected by it.
+    unsigned rulesFastRejectChecked;
     unsigned rulesFastRejected;
     unsigned rulesRejected;
     unsigned rulesMatched;
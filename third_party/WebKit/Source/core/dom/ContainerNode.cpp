@@ -809,6 +809,55 @@ void ContainerNode::parserAppendChild(PassRefPtrWillBeRawPtr<Node> newChild)
     notifyNodeInserted(*newChild, ChildrenChangeSourceParser);
 }
 
+void ContainerNode::parserAppendChildren(const NodeVector& children)
+{
+    ASSERT(!isDocumentNode());
+    ASSERT(!isHTMLTemplateElement(this));
+
+    if (children.isEmpty())
+        return;
+
+    RefPtrWillBeRawPtr<Node> protect(this);
+
+    bool hasElementChild = false;
+    {
+        EventDispatchForbiddenScope assertNoEventDispatch;
+        ScriptForbiddenScope forbidScript;
+        ChildListMutationScope mutation(*this);
+
+        for (const auto& child : children) {
+            ASSERT(!child->parentNode());
+            ASSERT(!child->isDocumentFragment());
+            ASSERT(child->document() == document());
+            treeScope().adoptIfNeeded(*child);
+            appendChildCommon(*child);
+            child->updateAncestorConnectedSubframeCountForInsertion();
+            mutation.childAdded(*child);
+            hasElementChild |= child->isElementNode();
+        }
+    }
+
+    NodeVector postInsertionNotificationTargets;
+    for (const auto& child : children) {
+        InspectorInstrumentation::didInsertDOMNode(child.get());
+        notifyNodeInsertedInternal(*child, postInsertionNotificationTargets);
+    }
+
+    // Changes made by the parser don't look at the siblings of the change.
+    ChildrenChange change = {
+        hasElementChild ? ElementInserted : NonElementInserted,
+        children.first()->previousSibling(),
+        nullptr,
+        ChildrenChangeSourceParser
+    };
+    childrenChanged(change);
+
+    for (const auto& targetNode : postInsertionNotificationTargets) {
+        if (targetNode->inDocument())
+            targetNode->didNotifySubtreeInsertionsToDocument();
+    }
+}
+
 void ContainerNode::notifyNodeInserted(Node& root, ChildrenChangeSource source)
 {
     ASSERT(!EventDispatchForbiddenScope::isEventDispatchForbidden());
@@ -105,6 +105,9 @@ public:
     void parserRemoveChild(Node&);
     void parserInsertBefore(PassRefPtrWillBeRawPtr<Node> newChild, Node& refChild);
     void parserTakeAllChildrenFrom(ContainerNode&);
+    // Appends nodes which aren't in a tree yet, notifying this node of the
+    // insertions with a single childrenChanged().
+    void parserAppendChildren(const NodeVector&);
 
     void removeChildren(SubtreeModificationAction = DispatchSubtreeModifiedEvent);
 
@@ -0,0 +1,69 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "core/dom/ContainerNode.h"
+
+#include "bindings/core/v8/ExceptionStatePlaceholder.h"
+#include "core/dom/Document.h"
+#include "core/dom/Element.h"
+#include "core/dom/Text.h"
+#include "core/html/HTMLElement.h"
+#include "core/testing/DummyPageHolder.h"
+#include "core/testing/PerfTest.h"
+
+namespace blink {
+
+namespace {
+
+// The children of a long list, like the rows of a table or the items of a
+// feed: an element and the whitespace after it for every item.
+NodeVector createListItems(Document& document, unsigned itemCount)
+{
+    NodeVector items;
+    for (unsigned i = 0; i < itemCount; ++i) {
+        items.append(document.createElement("li", ASSERT_NO_EXCEPTION));
+        items.append(document.createTextNode("\n"));
+    }
+    return items;
+}
+
+class ContainerNodePerfTest : public PerfTest {
+protected:
+    void measureNodesPerSecond(Document& document, bool appendRuns, const char* trace)
+    {
+        for (int i = 0; i < 10; ++i) {
+            RefPtrWillBeRawPtr<Element> list = document.createElement("ul", ASSERT_NO_EXCEPTION);
+            document.body()->appendChild(list, ASSERT_NO_EXCEPTION);
+            NodeVector items = createListItems(document, 5000);
+
+            startTimer();
+            if (appendRuns) {
+                list->parserAppendChildren(items);
+            } else {
+                for (const auto& item : items)
+                    list->parserAppendChild(item.get());
+            }
+            stopTimer(items.size());
+
+            EXPECT_EQ(items.size(), list->countChildren());
+            list->remove(ASSERT_NO_EXCEPTION);
+        }
+        reportRate("parser_append_children", trace, "nodes/s");
+    }
+};
+
+} // namespace
+
+TEST_F(ContainerNodePerfTest, DISABLED_ParserAppendSiblings)
+{
+    OwnPtr<DummyPageHolder> dummyPageHolder = DummyPageHolder::create(IntSize(800, 600));
+    Document& document = dummyPageHolder->document();
+    document.documentElement()->setInnerHTML("<body></body>", ASSERT_NO_EXCEPTION);
+
+    measureNodesPerSecond(document, false, "one_by_one");
+    measureNodesPerSecond(document, true, "runs");
+}
+
+} // namespace blink
@@ -189,6 +189,7 @@
 #include "core/page/Page.h"
 #include "core/page/PointerLockController.h"
 #include "core/page/scrolling/ScrollingCoordinator.h"
+#include "core/style/StyleGroupInterner.h"
 #include "core/svg/SVGDocumentExtensions.h"
 #include "core/svg/SVGTitleElement.h"
 #include "core/svg/SVGUseElement.h"
@@ -1867,6 +1868,15 @@ void Document::updateStyle(StyleRecalcChange change)
     ASSERT(styleResolver() == &resolver);
     m_lifecycle.advanceTo(DocumentLifecycle::StyleClean);
     if (shouldRecordStats) {
+        if (resolver.stats()->allCountersEnabled()) {
+            StyleGroupSharingReport report;
+            for (Element& element : ElementTraversal::startsAt(documentElement())) {
+                if (const ComputedStyle* style = element.computedStyle())
+                    report.addStyle(*style);
+            }
+            TRACE_EVENT_INSTANT1(TRACE_DISABLED_BY_DEFAULT("blink.style"), "Document::styleGroupSharing", TRACE_EVENT_SCOPE_THREAD,
+                "groups", report.toTracedValue());
+        }
         TRACE_EVENT_END2("blink,blink_style", "Document::updateStyle",
             "resolverAccessCount", styleEngine().resolverAccessCount() - initialResolverAccessCount,
             "counters", resolver.stats()->toTracedValue());
@@ -5,6 +5,7 @@
 #include "config.h"
 #include "core/dom/Node.h"
 
+#include "bindings/core/v8/ExceptionStatePlaceholder.h"
 #include "core/editing/EditingTestBase.h"
 
 namespace blink {
@@ -39,4 +40,26 @@ TEST_F(NodeTest, canStartSelectionWithShadowDOM)
     EXPECT_FALSE(one->firstChild()->canStartSelection());
 }
 
+TEST_F(NodeTest, parserAppendChildren)
+{
+    setBodyContent("<div id=list><span id=first></span></div>");
+    Element* list = document().getElementById("list");
+    Node* first = list->firstChild();
+
+    NodeVector children;
+    children.append(document().createElement("span", ASSERT_NO_EXCEPTION));
+    children.append(document().createTextNode("text"));
+    children.append(document().createElement("span", ASSERT_NO_EXCEPTION));
+    list->parserAppendChildren(children);
+
+    EXPECT_EQ(4u, list->countChildren());
+    EXPECT_EQ(children[0].get(), first->nextSibling());
+    EXPECT_EQ(children[1].get(), children[0]->nextSibling());
+    EXPECT_EQ(children[2].get(), list->lastChild());
+    for (const auto& child : children) {
+        EXPECT_EQ(list, child->parentNode());
+        EXPECT_TRUE(child->inDocument());
+    }
+}
+
 } // namespace blink
@@ -90,7 +90,7 @@ private:
     bool checkStyleSheet(String& href, String& charset);
     void process(const String& href, const String& charset);
 
-    void setCSSStyleSheet(const String& href, const KURL& baseURL, const String& charset, const CSSStyleSheetResource*) override;
+    void setCSSStyleSheet(const String& href, const KURL& baseURL, const String& charset, CSSStyleSheetResource*) override;
     void setXSLStyleSheet(const String& href, const KURL& baseURL, const String& sheet) override;
 
     bool sheetLoaded() override;
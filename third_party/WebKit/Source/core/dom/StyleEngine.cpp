@@ -35,6 +35,7 @@
 #include "core/css/StyleSheetContents.h"
 #include "core/css/invalidation/InvalidationSet.h"
 #include "core/css/resolver/ScopedStyleResolver.h"
+#include "core/css/resolver/SharedMatchedPropertiesCache.h"
 #include "core/dom/DocumentStyleSheetCollector.h"
 #include "core/dom/Element.h"
 #include "core/dom/ProcessingInstruction.h"
@@ -49,6 +50,7 @@
 #include "core/svg/SVGStyleElement.h"
 #include "platform/TraceEvent.h"
 #include "platform/fonts/FontCache.h"
+#include "platform/weborigin/SecurityOrigin.h"
 
 namespace blink {
 
@@ -537,6 +539,81 @@ static bool isCacheableForStyleElement(const StyleSheetContents& contents)
     return true;
 }
 
+// Parsed <style> sheets shared by all documents in the process, so that
+// the same text in another frame or after a navigation is neither parsed nor
+// indexed into a RuleSet again. Entries are marked as being in the memory
+// cache, which makes CSSStyleSheet copy them before any mutation. The least
+// recently used entry is evicted when the cache is full.
+typedef WillBePersistentHeapHashMap<AtomicString, RefPtrWillBeMember<StyleSheetContents>> SharedInlineStyleSheetCache;
+
+static const unsigned maxSharedInlineStyleSheets = 64;
+
+static SharedInlineStyleSheetCache& sharedInlineStyleSheetCache()
+{
+    ASSERT(isMainThread());
+    DEFINE_STATIC_LOCAL(SharedInlineStyleSheetCache, cache, ());
+    return cache;
+}
+
+// The texts of the shared sheets, least recently used first.
+static ListHashSet<AtomicString>& sharedInlineStyleSheetUses()
+{
+    ASSERT(isMainThread());
+    DEFINE_STATIC_LOCAL(ListHashSet<AtomicString>, uses, ());
+    return uses;
+}
+
+static void removeSharedInlineStyleSheet(const AtomicString& text)
+{
+    RefPtrWillBeRawPtr<StyleSheetContents> contents = sharedInlineStyleSheetCache().take(text);
+    if (contents)
+        contents->removedFromMemoryCache();
+    sharedInlineStyleSheetUses().remove(text);
+}
+
+static bool canShareInlineStyleSheets(const Document& document)
+{
+    // The RuleSet of a sheet records whether it has the document's security
+    // origin, so only share between documents that agree on it.
+    return document.securityOrigin()->canRequest(document.baseURL());
+}
+
+static StyleSheetContents* findSharedInlineStyleSheet(const Document& document, const AtomicString& text)
+{
+    if (!canShareInlineStyleSheets(document))
+        return nullptr;
+    SharedInlineStyleSheetCache::iterator it = sharedInlineStyleSheetCache().find(text);
+    if (it == sharedInlineStyleSheetCache().end())
+        return nullptr;
+    // Contexts must be identical so we know we would get the same exact result if we parsed again.
+    if (it->value->parserContext() != CSSParserContext(document, 0, KURL(), document.characterSet()))
+        return nullptr;
+    sharedInlineStyleSheetUses().appendOrMoveToLast(text);
+    return it->value.get();
+}
+
+static bool addSharedInlineStyleSheet(const Document& document, const AtomicString& text, StyleSheetContents* contents)
+{
+    if (!canShareInlineStyleSheets(document) || !contents->isCacheableInlineSheet())
+        return false;
+
+    removeSharedInlineStyleSheet(text);
+    if (sharedInlineStyleSheetCache().size() >= maxSharedInlineStyleSheets)
+        removeSharedInlineStyleSheet(sharedInlineStyleSheetUses().first());
+    contents->addedToMemoryCache();
+    sharedInlineStyleSheetCache().add(text, contents);
+    sharedInlineStyleSheetUses().add(text);
+    return true;
+}
+
+void StyleEngine::clearSharedInlineStyleSheetCache()
+{
+    for (auto& entry : sharedInlineStyleSheetCache())
+        entry.value->removedFromMemoryCache();
+    sharedInlineStyleSheetCache().clear();
+    sharedInlineStyleSheetUses().clear();
+}
+
 PassRefPtrWillBeRawPtr<CSSStyleSheet> StyleEngine::createSheet(Element* e, const String& text, TextPosition startPosition)
 {
     RefPtrWillBeRawPtr<CSSStyleSheet> styleSheet = nullptr;
@@ -547,10 +624,18 @@ PassRefPtrWillBeRawPtr<CSSStyleSheet> StyleEngine::createSheet(Element* e, const
 
     WillBeHeapHashMap<AtomicString, RawPtrWillBeMember<StyleSheetContents>>::AddResult result = m_textToSheetCache.add(textContent, nullptr);
     if (result.isNewEntry || !result.storedValue->value) {
-        styleSheet = StyleEngine::parseSheet(e, text, startPosition);
-        if (result.isNewEntry && isCacheableForStyleElement(*styleSheet->contents())) {
-            result.storedValue->value = styleSheet->contents();
-            m_sheetToTextCache.add(styleSheet->contents(), textContent);
+        // Shared sheets have owners in other documents, so they are never
+        // entered in this document's cache; the null entry sends later
+        // lookups of the same text back here.
+        if (StyleSheetContents* contents = findSharedInlineStyleSheet(e->document(), textContent)) {
+            styleSheet = CSSStyleSheet::createInline(contents, e, startPosition);
+        } else {
+            styleSheet = StyleEngine::parseSheet(e, text, startPosition);
+            if (!addSharedInlineStyleSheet(e->document(), textContent, styleSheet->contents())
+                && result.isNewEntry && isCacheableForStyleElement(*styleSheet->contents())) {
+                result.storedValue->value = styleSheet->contents();
+                m_sheetToTextCache.add(styleSheet->contents(), textContent);
+            }
         }
     } else {
         StyleSheetContents* contents = result.storedValue->value;
@@ -606,6 +691,9 @@ void StyleEngine::fontsNeedUpdate(CSSFontSelector*)
 
     if (m_resolver)
         m_resolver->invalidateMatchedPropertiesCache();
+    // Shared entries may have been computed before the fonts loaded in the
+    // document that added them.
+    SharedMatchedPropertiesCache::instance().clear();
     document().setNeedsStyleRecalc(SubtreeStyleChange, StyleChangeReasonForTracing::create(StyleChangeReason::Fonts));
 }
 
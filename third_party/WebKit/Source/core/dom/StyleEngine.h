@@ -166,6 +166,8 @@ public:
     void markDocumentDirty();
 
     PassRefPtrWillBeRawPtr<CSSStyleSheet> createSheet(Element*, const String& text, TextPosition startPosition);
+    // Drops the parsed <style> sheets shared between documents.
+    static void clearSharedInlineStyleSheetCache();
     void removeSheet(StyleSheetContents*);
 
     void collectScopedStyleFeaturesTo(RuleFeatureSet&) const;
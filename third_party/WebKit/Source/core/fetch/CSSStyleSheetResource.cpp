@@ -32,12 +32,82 @@
 #include "core/fetch/ResourceClientWalker.h"
 #include "core/fetch/ResourceFetcher.h"
 #include "core/fetch/StyleSheetResourceClient.h"
+#include "core/html/parser/HTMLParserThread.h"
+#include "platform/RuntimeEnabledFeatures.h"
 #include "platform/SharedBuffer.h"
+#include "platform/ThreadSafeFunctional.h"
+#include "platform/TraceEvent.h"
 #include "platform/network/HTTPParsers.h"
+#include "public/platform/Platform.h"
+#include "public/platform/WebTaskRunner.h"
+#include "public/platform/WebThread.h"
+#include "public/platform/WebTraceLocation.h"
 #include "wtf/CurrentTime.h"
+#include "wtf/MainThread.h"
+#include "wtf/ThreadSafeRefCounted.h"
 
 namespace blink {
 
+// Below this length tokenizing on the main thread is cheaper than the round
+// trip to the parser thread.
+static const unsigned minimumLengthForBackgroundTokenization = 16 * 1024;
+
+// Tokenizes the text of a style sheet on the HTML parser thread. Only the
+// tokens cross threads; building the rules needs AtomicStrings and the
+// CSSValuePool, so it stays on the main thread.
+class CSSStyleSheetResource::BackgroundTokenizer final : public ThreadSafeRefCounted<BackgroundTokenizer> {
+public:
+    static PassRefPtr<BackgroundTokenizer> create(CSSStyleSheetResource* resource, const String& sheetText)
+    {
+        return adoptRef(new BackgroundTokenizer(resource, sheetText));
+    }
+
+    void start()
+    {
+        ASSERT(isMainThread());
+        HTMLParserThread::shared()->postTask(threadSafeBind(&BackgroundTokenizer::tokenize, PassRefPtr<BackgroundTokenizer>(this)));
+    }
+
+    void detach()
+    {
+        ASSERT(isMainThread());
+        m_resource = nullptr;
+    }
+
+private:
+    BackgroundTokenizer(CSSStyleSheetResource* resource, const String& sheetText)
+        : m_resource(resource)
+        , m_sheetText(sheetText.isolatedCopy())
+    {
+    }
+
+    void tokenize()
+    {
+        ASSERT(!isMainThread());
+        TRACE_EVENT0("blink,blink_style", "CSSStyleSheetResource::BackgroundTokenizer::tokenize");
+        {
+            // The scope must hold the only reference to the text by the time
+            // it is handed to the main thread.
+            String sheetText;
+            sheetText.swap(m_sheetText);
+            m_scope = adoptPtr(new CSSTokenizer::Scope(sheetText));
+        }
+        Platform::current()->mainThread()->taskRunner()->postTask(BLINK_FROM_HERE, threadSafeBind(&BackgroundTokenizer::didTokenize, PassRefPtr<BackgroundTokenizer>(this)));
+    }
+
+    void didTokenize()
+    {
+        ASSERT(isMainThread());
+        if (m_resource)
+            m_resource->didTokenizeSheetText(m_scope.release());
+    }
+
+    // Only touched on the main thread.
+    CSSStyleSheetResource* m_resource;
+    String m_sheetText;
+    OwnPtr<CSSTokenizer::Scope> m_scope;
+};
+
 ResourcePtr<CSSStyleSheetResource> CSSStyleSheetResource::fetch(FetchRequest& request, ResourceFetcher* fetcher)
 {
     ASSERT(request.resourceRequest().frameType() == WebURLRequest::FrameTypeNone);
@@ -45,6 +115,11 @@ ResourcePtr<CSSStyleSheetResource> CSSStyleSheetResource::fetch(FetchRequest& re
     return toCSSStyleSheetResource(fetcher->requestResource(request, CSSStyleSheetResourceFactory()));
 }
 
+ResourcePtr<CSSStyleSheetResource> CSSStyleSheetResource::createForTest(const ResourceRequest& request, const String& charset)
+{
+    return new CSSStyleSheetResource(request, charset);
+}
+
 CSSStyleSheetResource::CSSStyleSheetResource(const ResourceRequest& resourceRequest, const String& charset)
     : StyleSheetResource(resourceRequest, CSSStyleSheet, "text/css", charset)
 {
@@ -59,10 +134,12 @@ CSSStyleSheetResource::~CSSStyleSheetResource()
 {
     // Make sure dispose() was cllaed before destruction.
     ASSERT(!m_parsedStyleSheetCache);
+    ASSERT(!m_backgroundTokenizer);
 }
 
 void CSSStyleSheetResource::dispose()
 {
+    cancelBackgroundTokenization();
     if (m_parsedStyleSheetCache)
         m_parsedStyleSheetCache->removedFromMemoryCache();
     m_parsedStyleSheetCache.clear();
@@ -82,10 +159,27 @@ void CSSStyleSheetResource::didAddClient(ResourceClient* c)
     // see the comment of HTMLLinkElement::setCSSStyleSheet.
     Resource::didAddClient(c);
 
-    if (!isLoading())
+    // While the sheet is being tokenized, the client is notified along with
+    // the others once the tokens arrive.
+    if (m_backgroundTokenizer)
+        m_clientsAwaitingTokens.add(c);
+    else if (!isLoading())
         static_cast<StyleSheetResourceClient*>(c)->setCSSStyleSheet(m_resourceRequest.url(), m_response.url(), encoding(), this);
 }
 
+void CSSStyleSheetResource::didRemoveClient(ResourceClient* c)
+{
+    if (!hasClient(c))
+        m_clientsAwaitingTokens.removeAll(c);
+}
+
+void CSSStyleSheetResource::error(Resource::Status status)
+{
+    // The clients are notified of the error right away.
+    cancelBackgroundTokenization();
+    StyleSheetResource::error(status);
+}
+
 const String CSSStyleSheetResource::sheetText(MIMETypeCheck mimeTypeCheck) const
 {
     ASSERT(!isPurgeable());
@@ -107,15 +201,65 @@ const AtomicString CSSStyleSheetResource::mimeType() const
 
 void CSSStyleSheetResource::checkNotify()
 {
-    // Decode the data to find out the encoding and keep the sheet text around during checkNotify()
-    if (m_data)
-        m_decodedSheetText = decodedText();
+    if (!m_backgroundTokenizer) {
+        // Decode the data to find out the encoding and keep the sheet text around during checkNotify()
+        if (m_data)
+            m_decodedSheetText = decodedText();
+
+        if (shouldTokenizeInBackground()) {
+            m_backgroundTokenizer = BackgroundTokenizer::create(this, m_decodedSheetText);
+            m_backgroundTokenizer->start();
+        }
+    }
+
+    if (m_backgroundTokenizer) {
+        // The clients are notified when the tokens arrive. Resource::finish()
+        // marks them finished in the meantime, so remember them here.
+        for (const auto& client : m_clients)
+            m_clientsAwaitingTokens.add(client.key);
+        return;
+    }
+
+    notifyClients();
+}
+
+bool CSSStyleSheetResource::shouldTokenizeInBackground() const
+{
+    if (!RuntimeEnabledFeatures::threadedCSSTokenizerEnabled() || !HTMLParserThread::shared())
+        return false;
+    return hasClients() && !errorOccurred() && m_decodedSheetText.length() >= minimumLengthForBackgroundTokenization;
+}
+
+void CSSStyleSheetResource::didTokenizeSheetText(PassOwnPtr<CSSTokenizer::Scope> scope)
+{
+    ASSERT(m_backgroundTokenizer);
+    m_backgroundTokenizer.clear();
+    m_tokenizedSheetText = scope;
+    notifyClients();
+}
 
-    ResourceClientWalker<StyleSheetResourceClient> w(m_clients);
+void CSSStyleSheetResource::cancelBackgroundTokenization()
+{
+    if (!m_backgroundTokenizer)
+        return;
+    m_backgroundTokenizer->detach();
+    m_backgroundTokenizer.clear();
+    // The clients still awaiting the tokens are notified by the next
+    // checkNotify(), with whatever data the resource has by then.
+    m_decodedSheetText = String();
+}
+
+void CSSStyleSheetResource::notifyClients()
+{
+    for (const auto& client : m_clients)
+        m_clientsAwaitingTokens.add(client.key);
+    ResourceClientWalker<StyleSheetResourceClient> w(m_clientsAwaitingTokens);
     while (StyleSheetResourceClient* c = w.next())
         c->setCSSStyleSheet(m_resourceRequest.url(), m_response.url(), encoding(), this);
+    m_clientsAwaitingTokens.clear();
     // Clear the decoded text as it is unlikely to be needed immediately again and is cheap to regenerate.
     m_decodedSheetText = String();
+    m_tokenizedSheetText.clear();
 }
 
 bool CSSStyleSheetResource::isSafeToUnlock() const
@@ -134,6 +278,13 @@ void CSSStyleSheetResource::destroyDecodedDataIfPossible()
     setDecodedSize(0);
 }
 
+void CSSStyleSheetResource::destroyDecodedDataForFailedRevalidation()
+{
+    // The tokens in flight are for the data being replaced.
+    cancelBackgroundTokenization();
+    destroyDecodedDataIfPossible();
+}
+
 bool CSSStyleSheetResource::canUseSheet(MIMETypeCheck mimeTypeCheck) const
 {
     if (errorOccurred())
@@ -26,9 +26,13 @@
 #ifndef CSSStyleSheetResource_h
 #define CSSStyleSheetResource_h
 
+#include "core/css/parser/CSSTokenizer.h"
 #include "core/fetch/ResourcePtr.h"
 #include "core/fetch/StyleSheetResource.h"
 #include "platform/heap/Handle.h"
+#include "wtf/HashCountedSet.h"
+#include "wtf/OwnPtr.h"
+#include "wtf/RefPtr.h"
 
 namespace blink {
 
@@ -43,6 +47,7 @@ public:
     enum class MIMETypeCheck { Strict, Lax };
 
     static ResourcePtr<CSSStyleSheetResource> fetch(FetchRequest&, ResourceFetcher*);
+    static ResourcePtr<CSSStyleSheetResource> createForTest(const ResourceRequest&, const String& charset);
 
     ~CSSStyleSheetResource() override;
     DECLARE_VIRTUAL_TRACE();
@@ -52,16 +57,25 @@ public:
     const AtomicString mimeType() const;
 
     void didAddClient(ResourceClient*) override;
+    void didRemoveClient(ResourceClient*) override;
+    void error(Resource::Status) override;
 
     PassRefPtrWillBeRawPtr<StyleSheetContents> restoreParsedStyleSheet(const CSSParserContext&);
     void saveParsedStyleSheet(PassRefPtrWillBeRawPtr<StyleSheetContents>);
 
+    // The tokens of the sheet text, if it was tokenized on the parser thread.
+    // Only available while the clients are being notified, and only to the
+    // first client that asks for them.
+    PassOwnPtr<CSSTokenizer::Scope> takeTokenizedSheetText() { return m_tokenizedSheetText.release(); }
+
 protected:
     bool isSafeToUnlock() const override;
     void destroyDecodedDataIfPossible() override;
-    void destroyDecodedDataForFailedRevalidation() override { destroyDecodedDataIfPossible(); }
+    void destroyDecodedDataForFailedRevalidation() override;
 
 private:
+    class BackgroundTokenizer;
+
     class CSSStyleSheetResourceFactory : public ResourceFactory {
     public:
         CSSStyleSheetResourceFactory()
@@ -78,7 +92,16 @@ private:
     void dispose() override;
     void checkNotify() override;
 
+    bool shouldTokenizeInBackground() const;
+    void didTokenizeSheetText(PassOwnPtr<CSSTokenizer::Scope>);
+    void cancelBackgroundTokenization();
+    void notifyClients();
+
     String m_decodedSheetText;
+    RefPtr<BackgroundTokenizer> m_backgroundTokenizer;
+    OwnPtr<CSSTokenizer::Scope> m_tokenizedSheetText;
+    // Clients held back until the background tokenizer finishes.
+    HashCountedSet<ResourceClient*> m_clientsAwaitingTokens;
 
     RefPtrWillBeMember<StyleSheetContents> m_parsedStyleSheetCache;
 };
@@ -0,0 +1,266 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "core/fetch/CSSStyleSheetResource.h"
+
+#include "core/css/StyleSheetContents.h"
+#include "core/css/parser/CSSParser.h"
+#include "core/css/parser/CSSParserMode.h"
+#include "core/fetch/ResourcePtr.h"
+#include "core/fetch/StyleSheetResourceClient.h"
+#include "core/html/parser/HTMLParserThread.h"
+#include "platform/RuntimeEnabledFeatures.h"
+#include "platform/ThreadSafeFunctional.h"
+#include "platform/network/ResourceRequest.h"
+#include "platform/network/ResourceResponse.h"
+#include "platform/testing/URLTestHelpers.h"
+#include "platform/testing/UnitTestHelpers.h"
+#include "public/platform/Platform.h"
+#include "public/platform/WebWaitableEvent.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "wtf/text/StringBuilder.h"
+
+namespace blink {
+
+namespace {
+
+// Parses the sheet when notified, from the tokens if it gets them.
+class TestClient final : public StyleSheetResourceClient {
+public:
+    TestClient()
+        : m_notifications(0)
+        , m_errorOccurred(false)
+        , m_receivedTokens(false)
+        , m_ruleCount(0)
+    {
+    }
+
+    void setCSSStyleSheet(const String&, const KURL&, const String&, CSSStyleSheetResource* resource) override
+    {
+        ++m_notifications;
+        m_errorOccurred = resource->errorOccurred();
+        OwnPtr<CSSTokenizer::Scope> tokens = resource->takeTokenizedSheetText();
+        m_receivedTokens = !!tokens;
+        if (m_errorOccurred)
+            return;
+        CSSParserContext context(HTMLStandardMode, nullptr);
+        RefPtrWillBeRawPtr<StyleSheetContents> contents = StyleSheetContents::create(context);
+        if (tokens)
+            CSSParser::parseTokenizedSheet(context, contents.get(), tokens.release());
+        else
+            CSSParser::parseSheet(context, contents.get(), resource->sheetText());
+        m_ruleCount = contents->ruleCount();
+    }
+    String debugName() const override { return "TestClient"; }
+
+    int notifications() const { return m_notifications; }
+    bool errorOccurred() const { return m_errorOccurred; }
+    bool receivedTokens() const { return m_receivedTokens; }
+    unsigned ruleCount() const { return m_ruleCount; }
+
+private:
+    int m_notifications;
+    bool m_errorOccurred;
+    bool m_receivedTokens;
+    unsigned m_ruleCount;
+};
+
+class CSSStyleSheetResourceTest : public ::testing::Test {
+protected:
+    CSSStyleSheetResourceTest()
+        : m_threadedCSSTokenizerEnabled(RuntimeEnabledFeatures::threadedCSSTokenizerEnabled())
+    {
+        RuntimeEnabledFeatures::setThreadedCSSTokenizerEnabled(true);
+    }
+
+    ~CSSStyleSheetResourceTest() override
+    {
+        RuntimeEnabledFeatures::setThreadedCSSTokenizerEnabled(m_threadedCSSTokenizerEnabled);
+    }
+
+    static ResourcePtr<CSSStyleSheetResource> createResource()
+    {
+        KURL url = URLTestHelpers::toKURL("https://example.com/style.css");
+        ResourcePtr<CSSStyleSheetResource> resource = CSSStyleSheetResource::createForTest(ResourceRequest(url), "UTF-8");
+        resource->setLoading(true);
+        ResourceResponse response;
+        response.setURL(url);
+        response.setHTTPStatusCode(200);
+        resource->responseReceived(response, nullptr);
+        return resource;
+    }
+
+    static void finishLoading(CSSStyleSheetResource* resource, const String& sheetText)
+    {
+        CString data = sheetText.utf8();
+        resource->appendData(data.data(), data.length());
+        resource->finish();
+    }
+
+    // Long enough to be tokenized on the parser thread.
+    static String largeSheet(const char* selector)
+    {
+        StringBuilder builder;
+        for (unsigned i = 0; i < 1000; ++i) {
+            builder.append(selector);
+            builder.appendNumber(i);
+            builder.append(" { color: red; margin: 1px 2px; }\n");
+        }
+        return builder.toString();
+    }
+
+    // Waits until the parser thread has run the tasks posted so far, then
+    // runs the replies they posted to the main thread.
+    static void waitForParserThread()
+    {
+        OwnPtr<WebWaitableEvent> event = adoptPtr(Platform::current()->createWaitableEvent());
+        HTMLParserThread::shared()->postTask(threadSafeBind(&WebWaitableEvent::signal, AllowCrossThreadAccess(event.get())));
+        event->wait();
+        testing::runPendingTasks();
+    }
+
+private:
+    bool m_threadedCSSTokenizerEnabled;
+};
+
+TEST_F(CSSStyleSheetResourceTest, SmallSheetIsTokenizedOnMainThread)
+{
+    ResourcePtr<CSSStyleSheetResource> resource = createResource();
+    TestClient client;
+    resource->addClient(&client);
+    finishLoading(resource.get(), ".a { color: red; } .b { color: blue; }");
+    EXPECT_EQ(1, client.notifications());
+    EXPECT_FALSE(client.receivedTokens());
+    EXPECT_EQ(2u, client.ruleCount());
+    resource->removeClient(&client);
+}
+
+TEST_F(CSSStyleSheetResourceTest, ClientsWaitForTokens)
+{
+    ResourcePtr<CSSStyleSheetResource> resource = createResource();
+    TestClient client;
+    resource->addClient(&client);
+    finishLoading(resource.get(), largeSheet(".a"));
+    EXPECT_EQ(0, client.notifications());
+
+    // A client added while the tokens are in flight waits for them too.
+    TestClient lateClient;
+    resource->addClient(&lateClient);
+    EXPECT_EQ(0, lateClient.notifications());
+
+    waitForParserThread();
+    EXPECT_EQ(1, client.notifications());
+    EXPECT_EQ(1, lateClient.notifications());
+    // Only one client gets the tokens; the rules match a main thread parse.
+    EXPECT_NE(client.receivedTokens(), lateClient.receivedTokens());
+    EXPECT_EQ(1000u, client.ruleCount());
+    EXPECT_EQ(1000u, lateClient.ruleCount());
+    EXPECT_FALSE(resource->takeTokenizedSheetText().get());
+
+    // Clients added afterwards are notified right away and parse the text.
+    TestClient nextClient;
+    resource->addClient(&nextClient);
+    EXPECT_EQ(1, nextClient.notifications());
+    EXPECT_FALSE(nextClient.receivedTokens());
+    EXPECT_EQ(1000u, nextClient.ruleCount());
+
+    resource->removeClient(&client);
+    resource->removeClient(&lateClient);
+    resource->removeClient(&nextClient);
+}
+
+TEST_F(CSSStyleSheetResourceTest, ClientRemovedWhileTokenizing)
+{
+    ResourcePtr<CSSStyleSheetResource> resource = createResource();
+    TestClient client;
+    TestClient removedClient;
+    resource->addClient(&client);
+    resource->addClient(&removedClient);
+    finishLoading(resource.get(), largeSheet(".a"));
+    resource->removeClient(&removedClient);
+
+    waitForParserThread();
+    EXPECT_EQ(1, client.notifications());
+    EXPECT_EQ(0, removedClient.notifications());
+    resource->removeClient(&client);
+}
+
+TEST_F(CSSStyleSheetResourceTest, DestroyedWhileTokenizing)
+{
+    TestClient client;
+    {
+        ResourcePtr<CSSStyleSheetResource> resource = createResource();
+        resource->addClient(&client);
+        finishLoading(resource.get(), largeSheet(".a"));
+        resource->removeClient(&client);
+    }
+    // The reply must not reach the destroyed resource.
+    waitForParserThread();
+    EXPECT_EQ(0, client.notifications());
+}
+
+TEST_F(CSSStyleSheetResourceTest, DataReplacedWhileTokenizing)
+{
+    ResourcePtr<CSSStyleSheetResource> resource = createResource();
+    TestClient client;
+    resource->addClient(&client);
+    finishLoading(resource.get(), largeSheet(".a"));
+
+    // A failed revalidation replaces the data the tokens were made from.
+    resource->setRevalidatingRequest(resource->resourceRequest());
+    resource->setLoading(true);
+    ResourceResponse response;
+    response.setURL(resource->url());
+    response.setHTTPStatusCode(200);
+    resource->responseReceived(response, nullptr);
+    String newSheet = largeSheet(".b") + largeSheet(".c");
+    finishLoading(resource.get(), newSheet);
+    EXPECT_EQ(0, client.notifications());
+
+    // Only the tokens of the new data are delivered.
+    waitForParserThread();
+    EXPECT_EQ(1, client.notifications());
+    EXPECT_TRUE(client.receivedTokens());
+    EXPECT_EQ(2000u, client.ruleCount());
+    resource->removeClient(&client);
+}
+
+TEST_F(CSSStyleSheetResourceTest, ErrorWhileTokenizing)
+{
+    ResourcePtr<CSSStyleSheetResource> resource = createResource();
+    TestClient client;
+    resource->addClient(&client);
+    finishLoading(resource.get(), largeSheet(".a"));
+    resource->error(Resource::LoadError);
+    EXPECT_EQ(1, client.notifications());
+    EXPECT_TRUE(client.errorOccurred());
+
+    // The tokens arrive after the clients were notified, and are dropped.
+    waitForParserThread();
+    EXPECT_EQ(1, client.notifications());
+    EXPECT_FALSE(client.receivedTokens());
+    resource->removeClient(&client);
+}
+
+TEST_F(CSSStyleSheetResourceTest, NoParserThread)
+{
+    HTMLParserThread::shutdown();
+    ASSERT_FALSE(HTMLParserThread::shared());
+
+    ResourcePtr<CSSStyleSheetResource> resource = createResource();
+    TestClient client;
+    resource->addClient(&client);
+    finishLoading(resource.get(), largeSheet(".a"));
+    EXPECT_EQ(1, client.notifications());
+    EXPECT_FALSE(client.receivedTokens());
+    EXPECT_EQ(1000u, client.ruleCount());
+    resource->removeClient(&client);
+
+    HTMLParserThread::init();
+}
+
+} // namespace
+
+} // namespace blink
@@ -38,7 +38,7 @@ public:
     ~StyleSheetResourceClient() override {}
     static ResourceClientType expectedType() { return StyleSheetType; }
     ResourceClientType resourceClientType() const final { return expectedType(); }
-    virtual void setCSSStyleSheet(const String& /* href */, const KURL& /* baseURL */, const String& /* charset */, const CSSStyleSheetResource*) {}
+    virtual void setCSSStyleSheet(const String& /* href */, const KURL& /* baseURL */, const String& /* charset */, CSSStyleSheetResource*) {}
     virtual void setXSLStyleSheet(const String& /* href */, const KURL& /* baseURL */, const String& /* sheet */) {}
 };
 
@@ -486,7 +486,7 @@ Document& LinkStyle::document()
     return m_owner->document();
 }
 
-void LinkStyle::setCSSStyleSheet(const String& href, const KURL& baseURL, const String& charset, const CSSStyleSheetResource* cachedStyleSheet)
+void LinkStyle::setCSSStyleSheet(const String& href, const KURL& baseURL, const String& charset, CSSStyleSheetResource* cachedStyleSheet)
 {
     if (!m_owner->inDocument()) {
         ASSERT(!m_sheet);
@@ -515,7 +515,7 @@ void LinkStyle::setCSSStyleSheet(const String& href, const KURL& baseURL, const
 
     CSSParserContext parserContext(m_owner->document(), 0, baseURL, charset);
 
-    if (RefPtrWillBeRawPtr<StyleSheetContents> restoredSheet = const_cast<CSSStyleSheetResource*>(cachedStyleSheet)->restoreParsedStyleSheet(parserContext)) {
+    if (RefPtrWillBeRawPtr<StyleSheetContents> restoredSheet = cachedStyleSheet->restoreParsedStyleSheet(parserContext)) {
         ASSERT(restoredSheet->isCacheable());
         ASSERT(!restoredSheet->isLoading());
 
@@ -548,7 +548,7 @@ void LinkStyle::setCSSStyleSheet(const String& href, const KURL& baseURL, const
     styleSheet->checkLoaded();
 
     if (styleSheet->isCacheable())
-        const_cast<CSSStyleSheetResource*>(cachedStyleSheet)->saveParsedStyleSheet(styleSheet);
+        cachedStyleSheet->saveParsedStyleSheet(styleSheet);
 }
 
 bool LinkStyle::sheetLoaded()
@@ -86,7 +86,7 @@ public:
 
 private:
     // From StyleSheetResourceClient
-    void setCSSStyleSheet(const String& href, const KURL& baseURL, const String& charset, const CSSStyleSheetResource*) override;
+    void setCSSStyleSheet(const String& href, const KURL& baseURL, const String& charset, CSSStyleSheetResource*) override;
     String debugName() const override { return "LinkStyle"; }
 
     enum DisabledState {
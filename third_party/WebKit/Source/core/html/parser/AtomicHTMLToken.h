@@ -165,7 +165,8 @@ public:
         case HTMLToken::StartTag:
             m_attributes.reserveInitialCapacity(token.attributes().size());
             for (const CompactHTMLToken::Attribute& attribute : token.attributes()) {
-                QualifiedName name(nullAtom, AtomicString(attribute.name), nullAtom);
+                // Known names were resolved on the parser thread.
+                QualifiedName name = attribute.knownName ? *attribute.knownName : QualifiedName(nullAtom, AtomicString(attribute.name), nullAtom);
                 // FIXME: This is N^2 for the number of attributes.
                 if (!findAttributeInVector(m_attributes, name))
                     m_attributes.append(Attribute(name, AtomicString(attribute.value)));
@@ -5,10 +5,36 @@
 #include "config.h"
 #include "core/html/parser/AtomicHTMLToken.h"
 
+#include "core/HTMLNames.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace blink {
 
+namespace {
+
+// Builds <tagName attributeName=1> the way the tokenizer does.
+void buildStartTag(HTMLToken& token, const char* tagName, const char* attributeName)
+{
+    int offset = 1;
+    token.beginStartTag(*tagName);
+    while (*++tagName) {
+        token.appendToName(*tagName);
+        ++offset;
+    }
+    token.addNewAttribute();
+    token.beginAttributeName(++offset);
+    for (; *attributeName; ++attributeName) {
+        token.appendToAttributeName(*attributeName);
+        ++offset;
+    }
+    token.endAttributeName(offset);
+    token.beginAttributeValue(++offset);
+    token.appendToAttributeValue('1');
+    token.endAttributeValue(++offset);
+}
+
+} // namespace
+
 TEST(AtomicHTMLTokenTest, EmptyAttributeValueFromHTMLToken)
 {
     HTMLToken token;
@@ -77,4 +103,38 @@ TEST(AtomicHTMLTokenTest, EmptyAttributeValueFromCompactHTMLToken)
     EXPECT_FALSE(attributeD);
 }
 
+TEST(AtomicHTMLTokenTest, KnownNamesFromCompactHTMLToken)
+{
+    HTMLToken token;
+    buildStartTag(token, "div", "class");
+    CompactHTMLToken ctoken(&token, TextPosition());
+    ASSERT_EQ(1u, ctoken.attributes().size());
+    ASSERT_TRUE(ctoken.attributes()[0].knownName);
+    EXPECT_EQ(HTMLNames::classAttr, *ctoken.attributes()[0].knownName);
+
+    AtomicHTMLToken atoken(ctoken);
+    EXPECT_EQ(HTMLNames::divTag.localName().impl(), atoken.name().impl());
+    ASSERT_EQ(1u, atoken.attributes().size());
+    EXPECT_EQ(HTMLNames::classAttr, atoken.attributes()[0].name());
+    EXPECT_EQ(HTMLNames::classAttr.localName().impl(), atoken.attributes()[0].localName().impl());
+    EXPECT_EQ("1", atoken.attributes()[0].value());
+}
+
+TEST(AtomicHTMLTokenTest, UnknownNamesFromCompactHTMLToken)
+{
+    HTMLToken token;
+    buildStartTag(token, "x-widget", "data-state");
+    CompactHTMLToken ctoken(&token, TextPosition());
+    ASSERT_EQ(1u, ctoken.attributes().size());
+    EXPECT_FALSE(ctoken.attributes()[0].knownName);
+
+    AtomicHTMLToken atoken(ctoken);
+    EXPECT_EQ("x-widget", atoken.name());
+    EXPECT_FALSE(atoken.name().impl()->isStatic());
+    ASSERT_EQ(1u, atoken.attributes().size());
+    EXPECT_EQ(QualifiedName(nullAtom, "data-state", nullAtom), atoken.attributes()[0].name());
+    EXPECT_FALSE(atoken.attributes()[0].localName().impl()->isStatic());
+    EXPECT_EQ("1", atoken.attributes()[0].value());
+}
+
 } // namespace blink
@@ -90,6 +90,7 @@ void BackgroundHTMLParser::start(PassRefPtr<WeakReference<BackgroundHTMLParser>>
 BackgroundHTMLParser::Configuration::Configuration()
     : outstandingTokenLimit(defaultOutstandingTokenLimit)
     , pendingTokenLimit(defaultPendingTokenLimit)
+    , speculativeTreeBuilding(false)
 {
 }
 
@@ -98,6 +99,7 @@ BackgroundHTMLParser::BackgroundHTMLParser(PassRefPtr<WeakReference<BackgroundHT
     , m_token(adoptPtr(new HTMLToken))
     , m_tokenizer(HTMLTokenizer::create(config->options))
     , m_treeBuilderSimulator(config->options)
+    , m_speculativeTreeBuilder(config->speculativeTreeBuilding ? adoptPtr(new HTMLSpeculativeTreeBuilder) : nullptr)
     , m_options(config->options)
     , m_outstandingTokenLimit(config->outstandingTokenLimit)
     , m_parser(config->parser)
@@ -175,6 +177,8 @@ void BackgroundHTMLParser::resumeFrom(PassOwnPtr<Checkpoint> checkpoint)
     m_token = checkpoint->token.release();
     m_tokenizer = checkpoint->tokenizer.release();
     m_treeBuilderSimulator.setState(checkpoint->treeBuilderState);
+    if (m_speculativeTreeBuilder)
+        m_speculativeTreeBuilder->abandonOpenSubtree();
     m_input.rewindTo(checkpoint->inputCheckpoint, checkpoint->unparsedInput);
     m_preloadScanner->rewindTo(checkpoint->preloadScannerCheckpoint);
     m_startingScript = false;
@@ -257,6 +261,11 @@ void BackgroundHTMLParser::pumpTokenizer()
                 m_startingScript = true;
             }
 
+            if (m_speculativeTreeBuilder) {
+                bool inHTMLContent = simulatedToken == HTMLTreeBuilderSimulator::OtherToken && !m_treeBuilderSimulator.inForeignContent();
+                m_speculativeTreeBuilder->process(token, m_pendingTokens->size(), inHTMLContent);
+            }
+
             m_pendingTokens->append(token);
         }
 
@@ -285,6 +294,8 @@ void BackgroundHTMLParser::sendTokensToMainThread()
     OwnPtr<HTMLDocumentParser::ParsedChunk> chunk = adoptPtr(new HTMLDocumentParser::ParsedChunk);
     chunk->preloads.swap(m_pendingPreloads);
     chunk->xssInfos.swap(m_pendingXSSInfos);
+    if (m_speculativeTreeBuilder)
+        m_speculativeTreeBuilder->takeSubtrees(chunk->speculativeSubtrees);
     chunk->tokenizerState = m_tokenizer->state();
     chunk->treeBuilderState = m_treeBuilderSimulator.state();
     chunk->inputCheckpoint = m_input.createCheckpoint(m_pendingTokens->size());
@@ -32,6 +32,7 @@
 #include "core/html/parser/HTMLParserOptions.h"
 #include "core/html/parser/HTMLPreloadScanner.h"
 #include "core/html/parser/HTMLSourceTracker.h"
+#include "core/html/parser/HTMLSpeculativeTreeBuilder.h"
 #include "core/html/parser/HTMLTreeBuilderSimulator.h"
 #include "core/html/parser/ParsedChunkQueue.h"
 #include "core/html/parser/TextResourceDecoder.h"
@@ -63,6 +64,7 @@ public:
         // pendingTokenLimit
         size_t outstandingTokenLimit;
         size_t pendingTokenLimit;
+        bool speculativeTreeBuilding;
     };
 
     static void start(PassRefPtr<WeakReference<BackgroundHTMLParser>>, PassOwnPtr<Configuration>, PassOwnPtr<WebTaskRunner>);
@@ -107,6 +109,7 @@ private:
     OwnPtr<HTMLToken> m_token;
     OwnPtr<HTMLTokenizer> m_tokenizer;
     HTMLTreeBuilderSimulator m_treeBuilderSimulator;
+    OwnPtr<HTMLSpeculativeTreeBuilder> m_speculativeTreeBuilder;
     HTMLParserOptions m_options;
     const size_t m_outstandingTokenLimit;
     WeakPtr<HTMLDocumentParser> m_parser;
@@ -26,8 +26,11 @@
 #include "config.h"
 #include "core/html/parser/CompactHTMLToken.h"
 
+#include "core/HTMLNames.h"
 #include "core/dom/QualifiedName.h"
 #include "core/html/parser/HTMLParserIdioms.h"
+#include "wtf/HashMap.h"
+#include "wtf/Threading.h"
 
 namespace blink {
 
@@ -40,6 +43,27 @@ struct SameSizeAsCompactHTMLToken  {
 
 static_assert(sizeof(CompactHTMLToken) == sizeof(SameSizeAsCompactHTMLToken), "CompactHTMLToken should stay small");
 
+// Known attribute names are static strings, which are the local names of the
+// HTMLNames attributes, so they can be matched by pointer on any thread.
+typedef HashMap<StringImpl*, const QualifiedName*, PtrHash<StringImpl*>> KnownAttributeNameMap;
+
+static KnownAttributeNameMap* createKnownAttributeNameMap()
+{
+    KnownAttributeNameMap* map = new KnownAttributeNameMap;
+    OwnPtr<const QualifiedName*[]> attrs = HTMLNames::getHTMLAttrs();
+    for (size_t i = 0; i < HTMLNames::HTMLAttrsCount; ++i)
+        map->add(attrs[i]->localName().impl(), attrs[i]);
+    return map;
+}
+
+static const QualifiedName* knownAttributeName(const String& name)
+{
+    if (!name.impl() || !name.impl()->isStatic())
+        return nullptr;
+    AtomicallyInitializedStaticReference(const KnownAttributeNameMap, map, createKnownAttributeNameMap());
+    return map.get(name.impl());
+}
+
 CompactHTMLToken::CompactHTMLToken(const HTMLToken* token, const TextPosition& textPosition)
     : m_type(token->type())
     , m_isAll8BitData(false)
@@ -63,8 +87,11 @@ CompactHTMLToken::CompactHTMLToken(const HTMLToken* token, const TextPosition& t
         break;
     case HTMLToken::StartTag:
         m_attributes.reserveInitialCapacity(token->attributes().size());
-        for (const HTMLToken::Attribute& attribute : token->attributes())
-            m_attributes.append(Attribute(attemptStaticStringCreation(attribute.name, Likely8Bit), StringImpl::create8BitIfPossible(attribute.value)));
+        for (const HTMLToken::Attribute& attribute : token->attributes()) {
+            String name = attemptStaticStringCreation(attribute.name, Likely8Bit);
+            const QualifiedName* knownName = knownAttributeName(name);
+            m_attributes.append(Attribute(name, StringImpl::create8BitIfPossible(attribute.value), knownName));
+        }
         // Fall through!
     case HTMLToken::EndTag:
         m_selfClosing = token->selfClosing();
@@ -41,14 +41,19 @@ class CORE_EXPORT CompactHTMLToken {
 public:
     struct Attribute {
         DISALLOW_NEW_EXCEPT_PLACEMENT_NEW();
-        Attribute(const String& name, const String& value)
+        Attribute(const String& name, const String& value, const QualifiedName* knownName = nullptr)
             : name(name)
             , value(value)
+            , knownName(knownName)
         {
         }
 
         String name;
         String value;
+        // The HTMLNames attribute with this name, resolved on the parser
+        // thread so that the main thread can use it without looking up the
+        // name. Null for other names.
+        const QualifiedName* knownName;
     };
 
     CompactHTMLToken(const HTMLToken*, const TextPosition&);
@@ -43,6 +43,7 @@
 #include "core/html/HTMLScriptElement.h"
 #include "core/html/HTMLTemplateElement.h"
 #include "core/html/parser/AtomicHTMLToken.h"
+#include "core/html/parser/CompactHTMLToken.h"
 #include "core/html/parser/HTMLParserIdioms.h"
 #include "core/html/parser/HTMLStackItem.h"
 #include "core/html/parser/HTMLToken.h"
@@ -692,6 +693,65 @@ void HTMLConstructionSite::insertTextNode(const String& string, WhitespaceMode w
     m_pendingText.append(dummyTask.parent, dummyTask.nextChild, string, whitespaceMode);
 }
 
+void HTMLConstructionSite::insertSpeculativeSubtree(const CompactHTMLToken* begin, const CompactHTMLToken* end)
+{
+    ASSERT(begin->type() == HTMLToken::StartTag);
+    ASSERT(!shouldFosterParent());
+
+    // The subtree is built bottom-up: the children of an element are appended
+    // to it in one go when its end tag closes it.
+    RefPtrWillBeRawPtr<HTMLElement> root;
+    WillBeHeapVector<RefPtrWillBeMember<HTMLElement>, 16> openElements;
+    NodeVector children;
+    Vector<size_t, 16> firstChildIndices;
+    StringBuilder text;
+    for (const CompactHTMLToken* token = begin; token != end; ++token) {
+        if (token->type() == HTMLToken::Character) {
+            text.append(token->data());
+            continue;
+        }
+        if (!text.isEmpty()) {
+            children.append(Text::create(openElements.last()->document(), atomizeIfAllWhitespace(text.toString(), WhitespaceUnknown)));
+            text.clear();
+        }
+        if (token->type() == HTMLToken::EndTag) {
+            size_t firstChildIndex = firstChildIndices.last();
+            NodeVector elementChildren;
+            elementChildren.append(children.data() + firstChildIndex, children.size() - firstChildIndex);
+            children.shrink(firstChildIndex);
+            openElements.last()->parserAppendChildren(elementChildren);
+            openElements.last()->finishParsingChildren();
+            openElements.removeLast();
+            firstChildIndices.removeLast();
+            continue;
+        }
+        ASSERT(token->type() == HTMLToken::StartTag);
+        AtomicHTMLToken atomicToken(*token);
+        RefPtrWillBeRawPtr<HTMLElement> element = createHTMLElement(&atomicToken);
+        element->beginParsingChildren();
+        if (openElements.isEmpty())
+            root = element;
+        else
+            children.append(element);
+        openElements.append(element.release());
+        firstChildIndices.append(children.size());
+    }
+    ASSERT(openElements.isEmpty());
+    ASSERT(children.isEmpty());
+    ASSERT(text.isEmpty());
+
+    // The subtree's elements have begun and finished parsing already.
+    HTMLConstructionSiteTask task(HTMLConstructionSiteTask::InsertAlreadyParsedChild);
+    task.parent = currentNode();
+    task.child = root.release();
+    queueTask(task);
+}
+
+bool HTMLConstructionSite::canAttachSubtreeOfDepth(unsigned depth) const
+{
+    return m_openElements.stackDepth() + depth - 1 <= maximumHTMLParserDOMTreeDepth;
+}
+
 void HTMLConstructionSite::reparent(HTMLElementStack::ElementRecord* newParent, HTMLElementStack::ElementRecord* child)
 {
     HTMLConstructionSiteTask task(HTMLConstructionSiteTask::Reparent);
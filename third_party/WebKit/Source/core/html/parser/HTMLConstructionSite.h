@@ -101,6 +101,7 @@ enum FlushMode {
 };
 
 class AtomicHTMLToken;
+class CompactHTMLToken;
 class Document;
 class Element;
 class HTMLFormElement;
@@ -155,6 +156,13 @@ public:
     void insertScriptElement(AtomicHTMLToken*);
     void insertTextNode(const String&, WhitespaceMode = WhitespaceUnknown);
     void insertForeignElement(AtomicHTMLToken*, const AtomicString& namespaceURI);
+    // Builds the elements and text of a subtree found by
+    // HTMLSpeculativeTreeBuilder detached, and queues its insertion below the
+    // current node.
+    void insertSpeculativeSubtree(const CompactHTMLToken* begin, const CompactHTMLToken* end);
+    // Whether elements nested |depth| deep below the current node would all
+    // be attached to their parent, rather than flattened at the maximum depth.
+    bool canAttachSubtreeOfDepth(unsigned depth) const;
 
     void insertHTMLHtmlStartTagBeforeHTML(AtomicHTMLToken*);
     void insertHTMLHtmlStartTagInBody(AtomicHTMLToken*);
@@ -494,6 +494,7 @@ size_t HTMLDocumentParser::processParsedChunkFromBackgroundParser(PassOwnPtr<Par
     if (isDetached())
         return elementTokenCount;
 
+    SpeculativeSubtreeStream::const_iterator nextSubtree = chunk->speculativeSubtrees.begin();
     for (Vector<CompactHTMLToken>::const_iterator it = tokens->begin(); it != tokens->end(); ++it) {
         ASSERT(!isWaitingForScripts());
 
@@ -513,7 +514,19 @@ size_t HTMLDocumentParser::processParsedChunkFromBackgroundParser(PassOwnPtr<Par
 
         m_textPosition = it->textPosition();
 
-        constructTreeFromCompactHTMLToken(*it);
+        if (nextSubtree != chunk->speculativeSubtrees.end() && it == tokens->begin() + nextSubtree->firstToken) {
+            const SpeculativeSubtree& subtree = *nextSubtree++;
+            if (constructTreeFromSpeculativeSubtree(it, subtree)) {
+                if (!chunk->startingScript)
+                    elementTokenCount += 2 * subtree.elementCount - 1;
+                it += subtree.tokenCount - 1;
+                m_textPosition = it->textPosition();
+            } else {
+                constructTreeFromCompactHTMLToken(*it);
+            }
+        } else {
+            constructTreeFromCompactHTMLToken(*it);
+        }
 
         if (isStopped())
             break;
@@ -735,6 +748,14 @@ void HTMLDocumentParser::constructTreeFromCompactHTMLToken(const CompactHTMLToke
     m_treeBuilder->constructTree(&token);
 }
 
+bool HTMLDocumentParser::constructTreeFromSpeculativeSubtree(const CompactHTMLToken* tokens, const SpeculativeSubtree& subtree)
+{
+    // Observers would see the subtree inserted as a whole.
+    if (document()->hasMutationObserversOfType(MutationObserver::ChildList))
+        return false;
+    return m_treeBuilder->insertSpeculativeSubtree(tokens, subtree);
+}
+
 bool HTMLDocumentParser::hasInsertionPoint()
 {
     // FIXME: The wasCreatedByScript() branch here might not be fully correct.
@@ -820,6 +841,7 @@ void HTMLDocumentParser::startBackgroundParser()
         if (document()->settings()->backgroundHtmlParserPendingTokenLimit())
             config->pendingTokenLimit = document()->settings()->backgroundHtmlParserPendingTokenLimit();
     }
+    config->speculativeTreeBuilding = RuntimeEnabledFeatures::speculativeTreeBuildingEnabled();
 
     ASSERT(config->xssAuditor->isSafeToSendToAnotherThread());
     ASSERT(config->preloadScanner->isSafeToSendToAnotherThread());
@@ -37,6 +37,7 @@
 #include "core/html/parser/HTMLPreloadScanner.h"
 #include "core/html/parser/HTMLScriptRunnerHost.h"
 #include "core/html/parser/HTMLSourceTracker.h"
+#include "core/html/parser/HTMLSpeculativeTreeBuilder.h"
 #include "core/html/parser/HTMLToken.h"
 #include "core/html/parser/HTMLTokenizer.h"
 #include "core/html/parser/HTMLTreeBuilderSimulator.h"
@@ -97,6 +98,7 @@ public:
         OwnPtr<CompactHTMLTokenStream> tokens;
         PreloadRequestStream preloads;
         XSSInfoStream xssInfos;
+        SpeculativeSubtreeStream speculativeSubtrees;
         HTMLTokenizer::State tokenizerState;
         HTMLTreeBuilderSimulator::State treeBuilderState;
         HTMLInputCheckpoint inputCheckpoint;
@@ -160,6 +162,7 @@ private:
     void pumpTokenizerIfPossible();
     void constructTreeFromHTMLToken();
     void constructTreeFromCompactHTMLToken(const CompactHTMLToken&);
+    bool constructTreeFromSpeculativeSubtree(const CompactHTMLToken*, const SpeculativeSubtree&);
 
     void runScriptsForPausedTreeBuilder();
     void resumeParsingAfterScriptExecution();
@@ -0,0 +1,131 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "core/html/parser/HTMLSpeculativeTreeBuilder.h"
+
+#include "core/HTMLNames.h"
+#include "core/dom/Text.h"
+#include "core/html/parser/CompactHTMLToken.h"
+#include "core/html/parser/HTMLParserIdioms.h"
+
+namespace blink {
+
+using namespace HTMLNames;
+
+static bool hasOnlySpeculatableAttributes(const CompactHTMLToken& token)
+{
+    for (const CompactHTMLToken::Attribute& attribute : token.attributes()) {
+        // Event handlers are compiled with the text position of their token,
+        // and "is" makes the element a custom element.
+        if (attribute.name.startsWith("on") || threadSafeMatch(attribute.name, isAttr))
+            return false;
+    }
+    return true;
+}
+
+HTMLSpeculativeTreeBuilder::HTMLSpeculativeTreeBuilder()
+    : m_textLength(0)
+{
+}
+
+HTMLSpeculativeTreeBuilder::ElementType HTMLSpeculativeTreeBuilder::elementTypeFor(const CompactHTMLToken& token)
+{
+    ASSERT(token.type() == HTMLToken::StartTag || token.type() == HTMLToken::EndTag);
+    const String& tagName = token.data();
+    if (threadSafeMatch(tagName, divTag))
+        return DivElement;
+    if (threadSafeMatch(tagName, pTag))
+        return ParagraphElement;
+    if (threadSafeMatch(tagName, spanTag))
+        return SpanElement;
+    return OtherElement;
+}
+
+void HTMLSpeculativeTreeBuilder::process(const CompactHTMLToken& token, size_t tokenIndex, bool inHTMLContent)
+{
+    if (!m_openElements.isEmpty()) {
+        if (inHTMLContent && processInOpenSubtree(token))
+            return;
+        abandonOpenSubtree();
+    }
+
+    // <div/> opens a <div>, but keep to the common case.
+    if (!inHTMLContent || token.type() != HTMLToken::StartTag || token.selfClosing())
+        return;
+    ElementType type = elementTypeFor(token);
+    if (type == OtherElement || !hasOnlySpeculatableAttributes(token))
+        return;
+
+    m_openSubtree.firstToken = tokenIndex;
+    m_openSubtree.tokenCount = 1;
+    m_openSubtree.elementCount = 1;
+    m_openSubtree.depth = 1;
+    m_openSubtree.closesParagraph = type != SpanElement;
+    m_openElements.append(type);
+    m_textLength = 0;
+}
+
+bool HTMLSpeculativeTreeBuilder::processInOpenSubtree(const CompactHTMLToken& token)
+{
+    switch (token.type()) {
+    case HTMLToken::Character:
+        // "In body" drops null characters from text.
+        if (token.data().find(static_cast<UChar>(0)) != kNotFound)
+            return false;
+        // Adjacent character tokens make a single Text node, which the main
+        // thread would split at its length limit.
+        m_textLength += token.data().length();
+        if (m_textLength >= Text::defaultLengthLimit)
+            return false;
+        break;
+    case HTMLToken::StartTag: {
+        if (token.selfClosing())
+            return false;
+        ElementType type = elementTypeFor(token);
+        if (type == OtherElement || !hasOnlySpeculatableAttributes(token))
+            return false;
+        if (type != SpanElement) {
+            // Instead of nesting, it would close the open <p>.
+            if (m_openElements.contains(ParagraphElement))
+                return false;
+            m_openSubtree.closesParagraph = true;
+        }
+        m_openElements.append(type);
+        ++m_openSubtree.elementCount;
+        m_openSubtree.depth = std::max<unsigned>(m_openSubtree.depth, m_openElements.size());
+        m_textLength = 0;
+        break;
+    }
+    case HTMLToken::EndTag:
+        // Only an end tag for the current element closes exactly one element.
+        if (elementTypeFor(token) != m_openElements.last())
+            return false;
+        m_openElements.removeLast();
+        m_textLength = 0;
+        break;
+    default:
+        return false;
+    }
+
+    ++m_openSubtree.tokenCount;
+    if (m_openElements.isEmpty())
+        m_subtrees.append(m_openSubtree);
+    return true;
+}
+
+void HTMLSpeculativeTreeBuilder::takeSubtrees(SpeculativeSubtreeStream& subtrees)
+{
+    abandonOpenSubtree();
+    subtrees.swap(m_subtrees);
+    m_subtrees.clear();
+}
+
+void HTMLSpeculativeTreeBuilder::abandonOpenSubtree()
+{
+    m_openElements.clear();
+    m_textLength = 0;
+}
+
+} // namespace blink
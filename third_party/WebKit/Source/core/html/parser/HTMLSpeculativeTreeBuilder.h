@@ -0,0 +1,77 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef HTMLSpeculativeTreeBuilder_h
+#define HTMLSpeculativeTreeBuilder_h
+
+#include "core/CoreExport.h"
+#include "wtf/Allocator.h"
+#include "wtf/Noncopyable.h"
+#include "wtf/Vector.h"
+
+namespace blink {
+
+class CompactHTMLToken;
+
+// A run of tokens in a chunk which builds a subtree of its own below the
+// current node: balanced elements and the text inside them.
+struct SpeculativeSubtree {
+    DISALLOW_NEW_EXCEPT_PLACEMENT_NEW();
+    size_t firstToken;
+    size_t tokenCount;
+    unsigned elementCount;
+    unsigned depth;
+    // Whether the subtree has a <div> or <p>, which closes an open <p>.
+    bool closesParagraph;
+};
+
+typedef Vector<SpeculativeSubtree> SpeculativeSubtreeStream;
+
+// Runs the part of tree construction which doesn't depend on the state of the
+// main thread's tree builder on the parser thread. It finds the runs of tokens
+// in a chunk which, in the "in body" insertion mode, would build a subtree of
+// <div>, <p> and <span> elements and text below the current node without
+// consulting any state outside of the run. The main thread then builds each
+// such subtree detached and inserts it with a single task, instead of running
+// its tokens through HTMLTreeBuilder one at a time.
+//
+// Whatever the insertion depends on outside of the run, such as the insertion
+// mode or an open <p>, is checked on the main thread before a subtree is used.
+class CORE_EXPORT HTMLSpeculativeTreeBuilder {
+    USING_FAST_MALLOC(HTMLSpeculativeTreeBuilder);
+    WTF_MAKE_NONCOPYABLE(HTMLSpeculativeTreeBuilder);
+public:
+    HTMLSpeculativeTreeBuilder();
+
+    // |tokenIndex| is the index of the token in its chunk. |inHTMLContent|
+    // tells whether HTMLTreeBuilderSimulator found the token outside of
+    // scripts and foreign content.
+    void process(const CompactHTMLToken&, size_t tokenIndex, bool inHTMLContent);
+
+    // Moves the subtrees found in the current chunk to |subtrees|. A subtree
+    // which is still open at the end of the chunk is abandoned.
+    void takeSubtrees(SpeculativeSubtreeStream& subtrees);
+    void abandonOpenSubtree();
+
+private:
+    enum ElementType {
+        OtherElement,
+        DivElement,
+        ParagraphElement,
+        SpanElement
+    };
+
+    static ElementType elementTypeFor(const CompactHTMLToken&);
+
+    bool processInOpenSubtree(const CompactHTMLToken&);
+
+    SpeculativeSubtree m_openSubtree;
+    Vector<ElementType, 16> m_openElements;
+    size_t m_textLength;
+    SpeculativeSubtreeStream m_subtrees;
+};
+
+} // namespace blink
+
+#endif // HTMLSpeculativeTreeBuilder_h
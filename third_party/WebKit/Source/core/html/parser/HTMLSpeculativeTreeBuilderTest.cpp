@@ -0,0 +1,92 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "core/html/parser/HTMLSpeculativeTreeBuilder.h"
+
+#include "core/html/parser/CompactHTMLToken.h"
+#include "core/html/parser/HTMLParserOptions.h"
+#include "core/html/parser/HTMLToken.h"
+#include "core/html/parser/HTMLTokenizer.h"
+#include "core/html/parser/HTMLTreeBuilderSimulator.h"
+#include "platform/text/SegmentedString.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace blink {
+
+namespace {
+
+// Tokenizes |html| as one chunk and returns the subtrees found in it.
+SpeculativeSubtreeStream findSubtrees(const String& html)
+{
+    HTMLParserOptions options;
+    OwnPtr<HTMLTokenizer> tokenizer = HTMLTokenizer::create(options);
+    HTMLTreeBuilderSimulator simulator(options);
+    HTMLSpeculativeTreeBuilder builder;
+
+    SegmentedString input(html);
+    HTMLToken token;
+    size_t tokenIndex = 0;
+    while (tokenizer->nextToken(input, token)) {
+        CompactHTMLToken compactToken(&token, TextPosition());
+        HTMLTreeBuilderSimulator::SimulatedToken simulatedToken = simulator.simulate(compactToken, tokenizer.get());
+        builder.process(compactToken, tokenIndex++, simulatedToken == HTMLTreeBuilderSimulator::OtherToken && !simulator.inForeignContent());
+        token.clear();
+    }
+
+    SpeculativeSubtreeStream subtrees;
+    builder.takeSubtrees(subtrees);
+    return subtrees;
+}
+
+} // namespace
+
+TEST(HTMLSpeculativeTreeBuilderTest, FindsBalancedSubtrees)
+{
+    SpeculativeSubtreeStream subtrees = findSubtrees("<div class=a><p>Hello <span>world</span></p></div><b>x</b><span>t</span>");
+    ASSERT_EQ(2u, subtrees.size());
+
+    EXPECT_EQ(0u, subtrees[0].firstToken);
+    EXPECT_EQ(8u, subtrees[0].tokenCount);
+    EXPECT_EQ(3u, subtrees[0].elementCount);
+    EXPECT_EQ(3u, subtrees[0].depth);
+    EXPECT_TRUE(subtrees[0].closesParagraph);
+
+    EXPECT_EQ(11u, subtrees[1].firstToken);
+    EXPECT_EQ(3u, subtrees[1].tokenCount);
+    EXPECT_EQ(1u, subtrees[1].elementCount);
+    EXPECT_EQ(1u, subtrees[1].depth);
+    EXPECT_FALSE(subtrees[1].closesParagraph);
+}
+
+TEST(HTMLSpeculativeTreeBuilderTest, RejectsEventHandlers)
+{
+    EXPECT_TRUE(findSubtrees("<div onclick=f()>x</div>").isEmpty());
+    EXPECT_TRUE(findSubtrees("<div><span onmouseover=f()>x</span></div>").isEmpty());
+    EXPECT_TRUE(findSubtrees("<div is=x-foo>x</div>").isEmpty());
+}
+
+TEST(HTMLSpeculativeTreeBuilderTest, RejectsBlocksInParagraphs)
+{
+    // The <div> closes the <p>, so only the <div> on its own is a subtree.
+    SpeculativeSubtreeStream subtrees = findSubtrees("<p><div>x</div></p>");
+    ASSERT_EQ(1u, subtrees.size());
+    EXPECT_EQ(1u, subtrees[0].firstToken);
+    EXPECT_EQ(3u, subtrees[0].tokenCount);
+}
+
+TEST(HTMLSpeculativeTreeBuilderTest, RejectsUnbalancedTags)
+{
+    EXPECT_TRUE(findSubtrees("<div><span>x</div>").isEmpty());
+    EXPECT_TRUE(findSubtrees("<div>x").isEmpty());
+    EXPECT_TRUE(findSubtrees("<div/>").isEmpty());
+}
+
+TEST(HTMLSpeculativeTreeBuilderTest, RejectsOtherElements)
+{
+    EXPECT_TRUE(findSubtrees("<div><b>x</b></div>").isEmpty());
+    EXPECT_TRUE(findSubtrees("<div><!-- x --></div>").isEmpty());
+}
+
+} // namespace blink
@@ -344,6 +344,14 @@ public:
         m_currentAttribute->value.append(character);
     }
 
+    template<typename CharacterType>
+    void appendToAttributeValue(const CharacterType* characters, size_t length)
+    {
+        ASSERT(m_type == StartTag || m_type == EndTag);
+        ASSERT(m_currentAttribute->valueRange.start);
+        m_currentAttribute->value.append(characters, length);
+    }
+
     void appendToAttributeValue(size_t i, const String& value)
     {
         ASSERT(!value.isEmpty());
@@ -408,6 +416,20 @@ public:
         m_data.appendVector(characters);
     }
 
+    void appendToCharacter(const LChar* characters, size_t length)
+    {
+        ASSERT(m_type == Character);
+        m_data.append(characters, length);
+    }
+
+    void appendToCharacter(const UChar* characters, size_t length)
+    {
+        ASSERT(m_type == Character);
+        m_data.append(characters, length);
+        for (size_t i = 0; i < length; ++i)
+            m_orAllData |= characters[i];
+    }
+
     /* Comment Tokens */
 
     const DataVector& comment() const
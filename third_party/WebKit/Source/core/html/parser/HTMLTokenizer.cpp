@@ -35,6 +35,7 @@
 #include "core/html/parser/HTMLTreeBuilder.h"
 #include "core/xml/parser/MarkupTokenizerInlines.h"
 #include "platform/NotImplemented.h"
+#include "platform/text/CharacterScan.h"
 #include "wtf/ASCIICType.h"
 #include "wtf/text/Unicode.h"
 
@@ -81,6 +82,59 @@ static inline bool isEndTagBufferingState(HTMLTokenizer::State state)
     }
 }
 
+namespace {
+
+using namespace CharacterScan;
+
+// Stops at the characters the data state handles itself, and at those the
+// input stream preprocessor rewrites.
+struct DataStateRunEnd {
+    bool operator()(UChar c) const { return c == '<' || c == '&' || c == '\r' || c == '\0'; }
+#if CHARACTER_SCAN_VECTORIZED
+    CharacterVector operator()(CharacterVector characters) const
+    {
+        CharacterVector markup = either(equalTo(characters, '<'), equalTo(characters, '&'));
+        return either(markup, either(equalTo(characters, '\r'), equalTo(characters, '\0')));
+    }
+#endif
+};
+
+struct AttributeValueRunEnd {
+    explicit AttributeValueRunEnd(UChar quote)
+        : m_quote(quote)
+    {
+        ASSERT(quote == '"' || quote == '\'');
+    }
+    bool operator()(UChar c) const { return c == m_quote || c == '&' || c == '\r' || c == '\0'; }
+#if CHARACTER_SCAN_VECTORIZED
+    CharacterVector operator()(CharacterVector characters) const
+    {
+        CharacterVector markup = either(equalTo(characters, static_cast<LChar>(m_quote)), equalTo(characters, '&'));
+        return either(markup, either(equalTo(characters, '\r'), equalTo(characters, '\0')));
+    }
+#endif
+    UChar m_quote;
+};
+
+// Returns the length of the run following the current character of
+// |source|, which is |cc|, within the current substring.
+template<typename Matcher>
+inline unsigned runLength(SegmentedString& source, UChar cc, const Matcher& stopsAt)
+{
+    // When the preprocessor has rewritten the current character, the source
+    // may still have to skip a newline after it.
+    if (source.currentChar() != cc)
+        return 0;
+    unsigned length = source.currentSubstringLength();
+    if (length <= 1)
+        return 0;
+    if (source.currentSubstringIs8Bit())
+        return scanCharacters(source.currentSubstringCharacters8(), 1, length, stopsAt) - 1;
+    return scanCharacters(source.currentSubstringCharacters16(), 1, length, stopsAt) - 1;
+}
+
+} // namespace
+
 #define HTML_BEGIN_STATE(stateName) BEGIN_STATE(HTMLTokenizer, stateName)
 #define HTML_RECONSUME_IN(stateName) RECONSUME_IN(HTMLTokenizer, stateName)
 #define HTML_ADVANCE_TO(stateName) ADVANCE_TO(HTMLTokenizer, stateName)
@@ -123,6 +177,30 @@ inline bool HTMLTokenizer::processEntity(SegmentedString& source)
     return true;
 }
 
+inline void HTMLTokenizer::bufferCharacterRun(SegmentedString& source, UChar cc)
+{
+    unsigned length = runLength(source, cc, DataStateRunEnd());
+    if (!length)
+        return;
+    if (source.currentSubstringIs8Bit())
+        m_token->appendToCharacter(source.currentSubstringCharacters8() + 1, length);
+    else
+        m_token->appendToCharacter(source.currentSubstringCharacters16() + 1, length);
+    source.advanceWithinCurrentSubstring(length);
+}
+
+inline void HTMLTokenizer::appendToAttributeValueRun(SegmentedString& source, UChar cc, UChar quote)
+{
+    unsigned length = runLength(source, cc, AttributeValueRunEnd(quote));
+    if (!length)
+        return;
+    if (source.currentSubstringIs8Bit())
+        m_token->appendToAttributeValue(source.currentSubstringCharacters8() + 1, length);
+    else
+        m_token->appendToAttributeValue(source.currentSubstringCharacters16() + 1, length);
+    source.advanceWithinCurrentSubstring(length);
+}
+
 bool HTMLTokenizer::flushBufferedEndTag(SegmentedString& source)
 {
     ASSERT(m_token->type() == HTMLToken::Character || m_token->type() == HTMLToken::Uninitialized);
@@ -195,6 +273,7 @@ bool HTMLTokenizer::nextToken(SegmentedString& source, HTMLToken& token)
             return emitEndOfFile(source);
         else {
             bufferCharacter(cc);
+            bufferCharacterRun(source, cc);
             HTML_ADVANCE_TO(DataState);
         }
     }
@@ -902,6 +981,7 @@ bool HTMLTokenizer::nextToken(SegmentedString& source, HTMLToken& token)
             HTML_RECONSUME_IN(DataState);
         } else {
             m_token->appendToAttributeValue(cc);
+            appendToAttributeValueRun(source, cc, '"');
             HTML_ADVANCE_TO(AttributeValueDoubleQuotedState);
         }
     }
@@ -920,6 +1000,7 @@ bool HTMLTokenizer::nextToken(SegmentedString& source, HTMLToken& token)
             HTML_RECONSUME_IN(DataState);
         } else {
             m_token->appendToAttributeValue(cc);
+            appendToAttributeValueRun(source, cc, '\'');
             HTML_ADVANCE_TO(AttributeValueSingleQuotedState);
         }
     }
@@ -186,6 +186,15 @@ private:
         m_token->appendToCharacter(character);
     }
 
+    // Consume the run of characters following the current one, which has
+    // just been handled, that the data state or a quoted attribute value
+    // state would append to the token one at a time. Runs end at the first
+    // character the state or the input stream preprocessor handle specially,
+    // and at the end of the current substring. The source is left on the
+    // last character of the run, for the state to advance past as usual.
+    inline void bufferCharacterRun(SegmentedString&, UChar cc);
+    inline void appendToAttributeValueRun(SegmentedString&, UChar cc, UChar quote);
+
     inline bool emitAndResumeIn(SegmentedString& source, State state)
     {
         saveEndTagNameIfNeeded();
@@ -0,0 +1,93 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "core/html/parser/HTMLTokenizer.h"
+
+#include "core/html/parser/HTMLParserOptions.h"
+#include "core/html/parser/HTMLToken.h"
+#include "core/testing/PerfTest.h"
+#include "platform/text/SegmentedString.h"
+#include "wtf/text/StringBuilder.h"
+
+namespace blink {
+
+namespace {
+
+// Builds a document shaped like a long news article: navigation lists with
+// long urls and class names, paragraphs of prose with the odd entity, and
+// figures with quoted attributes. Most of the input is text and attribute
+// values, as it is on such pages.
+String buildArticle(unsigned sectionCount, bool nonLatin1)
+{
+    StringBuilder builder;
+    builder.append("<html lang=\"en\"><head><title>Article</title>\n");
+    builder.append("<meta name=\"viewport\" content=\"width=device-width, initial-scale=1\">\n");
+    builder.append("</head><body class=\"article-page layout-wide theme-light\">\n");
+    for (unsigned i = 0; i < sectionCount; ++i) {
+        builder.append("<nav class=\"section-nav js-section-nav\"><ul>\n");
+        for (unsigned j = 0; j < 4; ++j) {
+            builder.append("  <li class=\"section-nav__item\"><a href=\"https://www.example.com/news/world/2015/11/");
+            builder.appendNumber(i);
+            builder.append("/story-about-something-important?utm_source=homepage&amp;utm_medium=link\" data-link-name='nav : ");
+            builder.appendNumber(j);
+            builder.append("'>Section ");
+            builder.appendNumber(j);
+            builder.append("</a></li>\n");
+        }
+        builder.append("</ul></nav>\n<article><h2>Heading for section ");
+        builder.appendNumber(i);
+        builder.append("</h2>\n");
+        for (unsigned j = 0; j < 3; ++j) {
+            builder.append("<p>The committee said on Tuesday that the proposal, which had been debated for several months,\n");
+            builder.append("would go ahead in a revised form. &ldquo;We have listened carefully to the concerns raised by\n");
+            builder.append("residents,&rdquo; a spokeswoman said, adding that the changes would be reviewed next year");
+            if (nonLatin1)
+                builder.append(static_cast<UChar>(0x2014));
+            builder.append(" and that further consultation was planned for the spring.</p>\n");
+        }
+        builder.append("<figure class=\"media media--wide\"><img src=\"https://images.example.com/img/media/");
+        builder.appendNumber(i);
+        builder.append("/master/3000.jpg?width=620&amp;quality=85&amp;auto=format\" alt=\"A view of the city centre at dusk, taken from the river\" width=\"620\" height=\"372\">\n");
+        builder.append("<figcaption>The city centre, where the changes are due to take effect. Photograph: Agency</figcaption></figure>\n");
+        builder.append("</article>\n");
+    }
+    builder.append("</body></html>\n");
+    return builder.toString();
+}
+
+class HTMLTokenizerPerfTest : public PerfTest {
+protected:
+    void measureMegabytesPerSecond(const String& html, const char* trace)
+    {
+        for (int i = 0; i < 10; ++i) {
+            startTimer();
+            OwnPtr<HTMLTokenizer> tokenizer = HTMLTokenizer::create(HTMLParserOptions());
+            SegmentedString input(html);
+            input.close();
+            HTMLToken token;
+            while (tokenizer->nextToken(input, token))
+                token.clear();
+            stopTimer(static_cast<double>(html.length()) / (1024 * 1024));
+        }
+        reportRate("html_tokenizer", trace, "MB/s");
+    }
+};
+
+} // namespace
+
+TEST_F(HTMLTokenizerPerfTest, DISABLED_TokenizeArticles)
+{
+    const unsigned sectionCount = 2000;
+
+    String latin1Article = buildArticle(sectionCount, false);
+    String utf16Article = buildArticle(sectionCount, true);
+    ASSERT_TRUE(latin1Article.is8Bit());
+    ASSERT_FALSE(utf16Article.is8Bit());
+
+    measureMegabytesPerSecond(latin1Article, "8_bit");
+    measureMegabytesPerSecond(utf16Article, "16_bit");
+}
+
+} // namespace blink
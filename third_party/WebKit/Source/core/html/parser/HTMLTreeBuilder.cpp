@@ -39,8 +39,10 @@
 #include "core/html/HTMLDocument.h"
 #include "core/html/HTMLFormElement.h"
 #include "core/html/parser/AtomicHTMLToken.h"
+#include "core/html/parser/CompactHTMLToken.h"
 #include "core/html/parser/HTMLDocumentParser.h"
 #include "core/html/parser/HTMLParserIdioms.h"
+#include "core/html/parser/HTMLSpeculativeTreeBuilder.h"
 #include "core/html/parser/HTMLStackItem.h"
 #include "core/html/parser/HTMLToken.h"
 #include "core/html/parser/HTMLTokenizer.h"
@@ -393,6 +395,41 @@ void HTMLTreeBuilder::constructTree(AtomicHTMLToken* token)
     // We might be detached now.
 }
 
+bool HTMLTreeBuilder::insertSpeculativeSubtree(const CompactHTMLToken* tokens, const SpeculativeSubtree& subtree)
+{
+    ASSERT(tokens->type() == HTMLToken::StartTag);
+    ASSERT(!m_parser->tokenizer());
+
+    // Within the subtree, the tokens only depend on each other. Outside of it,
+    // the start tags would be processed "in body", insert below the current
+    // node without reconstructing any active formatting elements, and only
+    // close an open <p> if there's one in button scope.
+    if (m_insertionMode != InBodyMode || m_tree.isEmpty())
+        return false;
+    if (!m_tree.currentStackItem()->isInHTMLNamespace() || m_tree.shouldFosterParent())
+        return false;
+    unsigned firstUnopenElementIndex;
+    if (m_tree.indexOfFirstUnopenFormattingElement(firstUnopenElementIndex))
+        return false;
+    if (subtree.closesParagraph && m_tree.openElements()->inButtonScope(pTag))
+        return false;
+    if (!m_tree.canAttachSubtreeOfDepth(subtree.depth))
+        return false;
+
+    // The first token is a start tag, which flushes pending text anyway. When
+    // the checks above fail, processToken() flushes it instead.
+    m_tree.flush(FlushAlways);
+    m_shouldSkipLeadingNewline = false;
+    const CompactHTMLToken* end = tokens + subtree.tokenCount;
+    for (const CompactHTMLToken* token = tokens; m_framesetOk && token != end; ++token) {
+        if (token->type() == HTMLToken::Character && !isAllWhitespaceOrReplacementCharacters(token->data()))
+            m_framesetOk = false;
+    }
+    m_tree.insertSpeculativeSubtree(tokens, end);
+    m_tree.executeQueuedTasks();
+    return true;
+}
+
 void HTMLTreeBuilder::processToken(AtomicHTMLToken* token)
 {
     if (token->type() == HTMLToken::Character) {
@@ -42,10 +42,12 @@
 namespace blink {
 
 class AtomicHTMLToken;
+class CompactHTMLToken;
 class DocumentFragment;
 class Element;
 class HTMLDocument;
 class HTMLDocumentParser;
+struct SpeculativeSubtree;
 
 class HTMLTreeBuilder final : public NoBaseWillBeGarbageCollectedFinalized<HTMLTreeBuilder> {
     WTF_MAKE_NONCOPYABLE(HTMLTreeBuilder); USING_FAST_MALLOC_WILL_BE_REMOVED(HTMLTreeBuilder);
@@ -71,6 +73,12 @@ public:
 
     void constructTree(AtomicHTMLToken*);
 
+    // Builds a subtree found on the parser thread by HTMLSpeculativeTreeBuilder
+    // from its tokens, starting at |tokens|, if its tokens would build the same
+    // nodes when processed one at a time. Returns false, without processing any
+    // token, otherwise.
+    bool insertSpeculativeSubtree(const CompactHTMLToken* tokens, const SpeculativeSubtree&);
+
     bool hasParserBlockingScript() const { return !!m_scriptToProcess; }
     // Must be called to take the parser-blocking script before calling the parser again.
     PassRefPtrWillBeRawPtr<Element> takeScriptToProcess(TextPosition& scriptStartPosition);
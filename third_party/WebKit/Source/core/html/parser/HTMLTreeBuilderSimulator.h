@@ -62,11 +62,11 @@ public:
 
     SimulatedToken simulate(const CompactHTMLToken&, HTMLTokenizer*);
 
+    bool inForeignContent() const { return m_namespaceStack.last() != HTML; }
+
 private:
     explicit HTMLTreeBuilderSimulator(HTMLTreeBuilder*);
 
-    bool inForeignContent() const { return m_namespaceStack.last() != HTML; }
-
     HTMLParserOptions m_options;
     State m_namespaceStack;
 };
@@ -47,7 +47,7 @@ public:
 private:
     RawPtrWillBeMember<InspectorResourceContentLoader> m_loader;
 
-    void setCSSStyleSheet(const String&, const KURL&, const String&, const CSSStyleSheetResource*) override;
+    void setCSSStyleSheet(const String&, const KURL&, const String&, CSSStyleSheetResource*) override;
     void notifyFinished(Resource*) override;
     String debugName() const override { return "InspectorResourceContentLoader::ResourceClient"; }
     void resourceFinished(Resource*);
@@ -70,9 +70,9 @@ void InspectorResourceContentLoader::ResourceClient::resourceFinished(Resource*
 #endif
 }
 
-void InspectorResourceContentLoader::ResourceClient::setCSSStyleSheet(const String&, const KURL& url, const String&, const CSSStyleSheetResource* resource)
+void InspectorResourceContentLoader::ResourceClient::setCSSStyleSheet(const String&, const KURL& url, const String&, CSSStyleSheetResource* resource)
 {
-    resourceFinished(const_cast<CSSStyleSheetResource*>(resource));
+    resourceFinished(resource);
 }
 
 void InspectorResourceContentLoader::ResourceClient::notifyFinished(Resource* resource)
@@ -20,8 +20,10 @@
 #include "config.h"
 #include "core/page/Page.h"
 
+#include "core/css/resolver/SharedMatchedPropertiesCache.h"
 #include "core/css/resolver/ViewportStyleResolver.h"
 #include "core/dom/ClientRectList.h"
+#include "core/dom/StyleEngine.h"
 #include "core/dom/VisitedLinkState.h"
 #include "core/editing/DragCaretController.h"
 #include "core/editing/commands/UndoStack.h"
@@ -93,6 +95,8 @@ void Page::onMemoryPressure()
 {
     for (auto& page : ordinaryPages())
         page->memoryPurgeController().purgeMemory();
+    SharedMatchedPropertiesCache::instance().clear();
+    StyleEngine::clearSharedInlineStyleSheetCache();
 }
 
 float deviceScaleFactor(LocalFrame* frame)
@@ -34,6 +34,7 @@
 #include "core/style/PathStyleMotionPath.h"
 #include "core/style/QuotesData.h"
 #include "core/style/ShadowList.h"
+#include "core/style/StyleGroupInterner.h"
 #include "core/style/StyleImage.h"
 #include "core/style/StyleInheritedData.h"
 #include "platform/LengthFunctions.h"
@@ -255,6 +256,7 @@ void ComputedStyle::copyNonInheritedFromCached(const ComputedStyle& other)
     noninherited_flags.pageBreakAfter = other.noninherited_flags.pageBreakAfter;
     noninherited_flags.pageBreakInside = other.noninherited_flags.pageBreakInside;
     noninherited_flags.hasRemUnits = other.noninherited_flags.hasRemUnits;
+    noninherited_flags.hasFontMetricsUnits = other.noninherited_flags.hasFontMetricsUnits;
 
     // Correctly set during selector matching:
     // noninherited_flags.styleType
@@ -294,6 +296,16 @@ void ComputedStyle::copyNonInheritedFromCached(const ComputedStyle& other)
     ASSERT(zoom() == initialZoom());
 }
 
+void ComputedStyle::internGroups()
+{
+    StyleGroupInterner<StyleBoxData>::instance().intern(m_box);
+    StyleGroupInterner<StyleVisualData>::instance().intern(visual);
+    // Border images are loaded through, and hold on to, the document of
+    // the style, so they must not be handed to other documents.
+    if (!borderImageSource())
+        StyleGroupInterner<StyleSurroundData>::instance().intern(surround);
+}
+
 bool ComputedStyle::operator==(const ComputedStyle& o) const
 {
     // compare everything except the pseudoStyle pointer
@@ -133,6 +133,7 @@ class CORE_EXPORT ComputedStyle: public RefCounted<ComputedStyle> {
     friend class StyleBuilderFunctions; // Sets color styles
     friend class CachedUAStyle; // Saves Border/Background information for later comparison.
     friend class ColorPropertyFunctions; // Reads initial style values and accesses visited and unvisited colors.
+    friend class StyleGroupSharingReport; // Counts distinct data groups.
     friend class LengthPropertyFunctions; // Reads initial style values.
     friend class NumberPropertyFunctions; // Reads initial style values.
     friend class PaintPropertyFunctions; // Reads initial style values.
@@ -285,8 +286,11 @@ protected:
         unsigned isLink : 1;
 
         mutable unsigned hasRemUnits : 1;
+        // This is set if we used ex or ch units, which depend on the metrics
+        // of the primary font, when resolving a length.
+        mutable unsigned hasFontMetricsUnits : 1;
         // If you add more style bits here, you will also need to update ComputedStyle::copyNonInheritedFromCached()
-        // 62 bits
+        // 63 bits
     } noninherited_flags;
 
 // !END SYNC!
@@ -338,6 +342,7 @@ protected:
         noninherited_flags.affectedByDrag = false;
         noninherited_flags.isLink = false;
         noninherited_flags.hasRemUnits = false;
+        noninherited_flags.hasFontMetricsUnits = false;
     }
 
 private:
@@ -377,6 +382,8 @@ public:
 
     void inheritFrom(const ComputedStyle& inheritParent, IsAtShadowBoundary = NotAtShadowBoundary);
     void copyNonInheritedFromCached(const ComputedStyle&);
+    // Replaces data groups with equal ones interned by other styles.
+    void internGroups();
 
     PseudoId styleType() const { return static_cast<PseudoId>(noninherited_flags.styleType); }
     void setStyleType(PseudoId styleType) { noninherited_flags.styleType = styleType; }
@@ -393,6 +400,9 @@ public:
     void setHasRemUnits() const { noninherited_flags.hasRemUnits = true; }
     bool hasRemUnits() const { return noninherited_flags.hasRemUnits; }
 
+    void setHasFontMetricsUnits() const { noninherited_flags.hasFontMetricsUnits = true; }
+    bool hasFontMetricsUnits() const { return noninherited_flags.hasFontMetricsUnits; }
+
     bool affectedByFocus() const { return noninherited_flags.affectedByFocus; }
     bool affectedByHover() const { return noninherited_flags.affectedByHover; }
     bool affectedByActive() const { return noninherited_flags.affectedByActive; }
@@ -65,6 +65,13 @@ public:
         return m_data != o.m_data && *m_data != *o.m_data;
     }
 
+    // Points to an equal copy of the data instead, so they are stored once.
+    void replaceWithEqual(T* data)
+    {
+        ASSERT(*data == *m_data);
+        m_data = data;
+    }
+
     void operator=(std::nullptr_t) { m_data = nullptr; }
 private:
     // TODO(Oilpan): remove this once the GC plugin change in r359074 has
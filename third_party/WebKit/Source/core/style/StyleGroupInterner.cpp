@@ -0,0 +1,133 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "core/style/StyleGroupInterner.h"
+
+#include "core/style/ComputedStyle.h"
+#include "platform/LengthBox.h"
+#include "platform/TracedValue.h"
+#include "wtf/MainThread.h"
+#include "wtf/StdLibExtras.h"
+#include "wtf/StringHasher.h"
+#include "wtf/Vector.h"
+
+namespace blink {
+
+namespace {
+
+class GroupHasher {
+    STACK_ALLOCATED();
+public:
+    void add(unsigned value) { m_components.append(value); }
+
+    // Only the parts of a Length its operator== always compares.
+    void add(const Length& length)
+    {
+        add(length.type() | length.quirk() << 8);
+        if (!length.isCalculated() && !length.isMaxSizeNone())
+            add(bitwise_cast<unsigned>(length.value()));
+    }
+
+    void add(const LengthBox& box)
+    {
+        add(box.left());
+        add(box.right());
+        add(box.top());
+        add(box.bottom());
+    }
+
+    unsigned hash() const { return StringHasher::hashMemory(m_components.data(), m_components.size() * sizeof(unsigned)); }
+
+private:
+    Vector<unsigned, 32> m_components;
+};
+
+} // namespace
+
+template <>
+unsigned StyleGroupInterner<StyleBoxData>::hash(const StyleBoxData& box)
+{
+    GroupHasher hasher;
+    hasher.add(box.width());
+    hasher.add(box.height());
+    hasher.add(box.minWidth());
+    hasher.add(box.maxWidth());
+    hasher.add(box.minHeight());
+    hasher.add(box.maxHeight());
+    hasher.add(box.verticalAlign());
+    hasher.add(box.zIndex());
+    hasher.add(box.hasAutoZIndex() | box.boxSizing() << 1 | box.boxDecorationBreak() << 2);
+    return hasher.hash();
+}
+
+template <>
+unsigned StyleGroupInterner<StyleVisualData>::hash(const StyleVisualData& visual)
+{
+    GroupHasher hasher;
+    hasher.add(visual.clip);
+    hasher.add(visual.hasAutoClip | visual.textDecoration << 1);
+    hasher.add(bitwise_cast<unsigned>(visual.m_zoom));
+    return hasher.hash();
+}
+
+template <>
+unsigned StyleGroupInterner<StyleSurroundData>::hash(const StyleSurroundData& surround)
+{
+    // Borders are left to operator==; most elements have none.
+    GroupHasher hasher;
+    hasher.add(surround.offset);
+    hasher.add(surround.margin);
+    hasher.add(surround.padding);
+    return hasher.hash();
+}
+
+template <typename T>
+StyleGroupInterner<T>& StyleGroupInterner<T>::instance()
+{
+    ASSERT(isMainThread());
+    DEFINE_STATIC_LOCAL(StyleGroupInterner, interner, ());
+    return interner;
+}
+
+template class CORE_TEMPLATE_EXPORT StyleGroupInterner<StyleBoxData>;
+template class CORE_TEMPLATE_EXPORT StyleGroupInterner<StyleVisualData>;
+template class CORE_TEMPLATE_EXPORT StyleGroupInterner<StyleSurroundData>;
+
+void StyleGroupSharingReport::addStyle(const ComputedStyle& style)
+{
+    ++m_styleCount;
+    m_box.add(style.m_box.get());
+    m_visual.add(style.visual.get());
+    m_background.add(style.m_background.get());
+    m_surround.add(style.surround.get());
+    m_rareNonInherited.add(style.rareNonInheritedData.get());
+    m_rareInherited.add(style.rareInheritedData.get());
+    m_inherited.add(style.inherited.get());
+    m_svg.add(style.m_svgStyle.get());
+}
+
+unsigned StyleGroupSharingReport::uniqueGroupCount() const
+{
+    return m_box.size() + m_visual.size() + m_background.size() + m_surround.size()
+        + m_rareNonInherited.size() + m_rareInherited.size() + m_inherited.size() + m_svg.size();
+}
+
+PassRefPtr<TracedValue> StyleGroupSharingReport::toTracedValue() const
+{
+    // Each style points to one group of each kind.
+    RefPtr<TracedValue> tracedValue = TracedValue::create();
+    tracedValue->setInteger("styles", m_styleCount);
+    tracedValue->setInteger("box", m_box.size());
+    tracedValue->setInteger("visual", m_visual.size());
+    tracedValue->setInteger("background", m_background.size());
+    tracedValue->setInteger("surround", m_surround.size());
+    tracedValue->setInteger("rareNonInherited", m_rareNonInherited.size());
+    tracedValue->setInteger("rareInherited", m_rareInherited.size());
+    tracedValue->setInteger("inherited", m_inherited.size());
+    tracedValue->setInteger("svg", m_svg.size());
+    return tracedValue.release();
+}
+
+} // namespace blink
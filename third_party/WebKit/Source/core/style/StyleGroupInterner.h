@@ -0,0 +1,121 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef StyleGroupInterner_h
+#define StyleGroupInterner_h
+
+#include "core/CoreExport.h"
+#include "core/style/DataRef.h"
+#include "wtf/Allocator.h"
+#include "wtf/HashMap.h"
+#include "wtf/HashSet.h"
+#include "wtf/Noncopyable.h"
+#include "wtf/PassRefPtr.h"
+#include "wtf/RefPtr.h"
+
+namespace blink {
+
+class ComputedStyle;
+class StyleBoxData;
+class StyleSurroundData;
+class StyleVisualData;
+class TracedValue;
+
+// Hash-conses the data groups of ComputedStyles. Groups are copy-on-write,
+// so a group equal to one already interned can be replaced by it, and the
+// elements of a page which end up with equal groups after style resolution
+// store them once.
+//
+// Only groups with a cheap hash over their values are interned, and only
+// if they hold no document resources, which rules out surround groups with
+// a border image. The table holds a reference to each interned group;
+// groups no style uses anymore are swept after every sweepInterval
+// additions.
+template <typename T>
+class StyleGroupInterner {
+    USING_FAST_MALLOC(StyleGroupInterner);
+    WTF_MAKE_NONCOPYABLE(StyleGroupInterner);
+public:
+    static StyleGroupInterner& instance();
+
+    StyleGroupInterner() : m_additionsSinceLastSweep(0) { }
+
+    void intern(DataRef<T>& group)
+    {
+        unsigned hash = this->hash(*group);
+        typename GroupMap::AddResult addResult = m_groups.add(hash, nullptr);
+        if (addResult.isNewEntry) {
+            addResult.storedValue->value = const_cast<T*>(group.get());
+            if (++m_additionsSinceLastSweep >= sweepInterval)
+                sweep();
+            return;
+        }
+        // Groups colliding with a different interned group stay as they are.
+        T* interned = addResult.storedValue->value.get();
+        if (interned != group.get() && *interned == *group)
+            group.replaceWithEqual(interned);
+    }
+
+    size_t size() const { return m_groups.size(); }
+    void clear() { m_groups.clear(); }
+
+private:
+    static const unsigned sweepInterval = 1000;
+
+    // Never zero, like the hashes of StringHasher it is built on.
+    static unsigned hash(const T&);
+
+    void sweep()
+    {
+        Vector<unsigned, 16> toRemove;
+        for (const auto& entry : m_groups) {
+            if (entry.value->hasOneRef())
+                toRemove.append(entry.key);
+        }
+        m_groups.removeAll(toRemove);
+        m_additionsSinceLastSweep = 0;
+    }
+
+    using GroupMap = HashMap<unsigned, RefPtr<T>>;
+    GroupMap m_groups;
+    unsigned m_additionsSinceLastSweep;
+};
+
+template <> unsigned StyleGroupInterner<StyleBoxData>::hash(const StyleBoxData&);
+template <> unsigned StyleGroupInterner<StyleVisualData>::hash(const StyleVisualData&);
+template <> unsigned StyleGroupInterner<StyleSurroundData>::hash(const StyleSurroundData&);
+
+extern template class CORE_EXTERN_TEMPLATE_EXPORT StyleGroupInterner<StyleBoxData>;
+extern template class CORE_EXTERN_TEMPLATE_EXPORT StyleGroupInterner<StyleVisualData>;
+extern template class CORE_EXTERN_TEMPLATE_EXPORT StyleGroupInterner<StyleSurroundData>;
+
+// Counts the data groups of a set of ComputedStyles against the number of
+// distinct group objects among them.
+class CORE_EXPORT StyleGroupSharingReport {
+    STACK_ALLOCATED();
+public:
+    StyleGroupSharingReport() : m_styleCount(0) { }
+
+    void addStyle(const ComputedStyle&);
+
+    unsigned styleCount() const { return m_styleCount; }
+    unsigned uniqueGroupCount() const;
+
+    PassRefPtr<TracedValue> toTracedValue() const;
+
+private:
+    unsigned m_styleCount;
+    HashSet<const void*> m_box;
+    HashSet<const void*> m_visual;
+    HashSet<const void*> m_background;
+    HashSet<const void*> m_surround;
+    HashSet<const void*> m_rareNonInherited;
+    HashSet<const void*> m_rareInherited;
+    HashSet<const void*> m_inherited;
+    HashSet<const void*> m_svg;
+};
+
+} // namespace blink
+
+#endif // StyleGroupInterner_h
@@ -0,0 +1,68 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "core/style/StyleGroupInterner.h"
+
+#include "core/css/CSSGradientValue.h"
+#include "core/style/ComputedStyle.h"
+#include "core/style/StyleGeneratedImage.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace blink {
+
+TEST(StyleGroupInternerTest, EqualGroupsAreStoredOnce)
+{
+    RefPtr<ComputedStyle> style1 = ComputedStyle::create();
+    RefPtr<ComputedStyle> style2 = ComputedStyle::create();
+    RefPtr<ComputedStyle> style3 = ComputedStyle::create();
+    style1->setWidth(Length(123, Fixed));
+    style2->setWidth(Length(123, Fixed));
+    style3->setWidth(Length(50, Percent));
+
+    StyleGroupSharingReport before;
+    before.addStyle(*style1);
+    before.addStyle(*style2);
+    before.addStyle(*style3);
+
+    style1->internGroups();
+    style2->internGroups();
+    style3->internGroups();
+
+    StyleGroupSharingReport after;
+    after.addStyle(*style1);
+    after.addStyle(*style2);
+    after.addStyle(*style3);
+    EXPECT_EQ(3u, after.styleCount());
+    EXPECT_EQ(before.uniqueGroupCount() - 1, after.uniqueGroupCount());
+
+    // Interned groups are still copied on write.
+    style1->setWidth(Length(7, Fixed));
+    EXPECT_EQ(Length(7, Fixed), style1->width());
+    EXPECT_EQ(Length(123, Fixed), style2->width());
+    EXPECT_EQ(Length(50, Percent), style3->width());
+}
+
+TEST(StyleGroupInternerTest, SurroundGroupsWithBorderImagesAreNotInterned)
+{
+    RefPtrWillBeRawPtr<CSSLinearGradientValue> gradient = CSSLinearGradientValue::create(Repeating);
+    RefPtr<ComputedStyle> style1 = ComputedStyle::create();
+    RefPtr<ComputedStyle> style2 = ComputedStyle::create();
+    style1->setBorderImageSource(StyleGeneratedImage::create(*gradient));
+    style2->setBorderImageSource(style1->borderImageSource());
+
+    StyleGroupSharingReport before;
+    before.addStyle(*style1);
+    before.addStyle(*style2);
+
+    style1->internGroups();
+    style2->internGroups();
+
+    StyleGroupSharingReport after;
+    after.addStyle(*style1);
+    after.addStyle(*style2);
+    EXPECT_EQ(before.uniqueGroupCount(), after.uniqueGroupCount());
+}
+
+} // namespace blink
@@ -0,0 +1,44 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "core/testing/PerfTest.h"
+
+#include "testing/perf/perf_test.h"
+#include "wtf/Assertions.h"
+#include "wtf/CurrentTime.h"
+
+namespace blink {
+
+PerfTest::PerfTest()
+    : m_startTime(0)
+    , m_elapsedTime(0)
+    , m_work(0)
+{
+}
+
+void PerfTest::startTimer()
+{
+    ASSERT(!m_startTime);
+    m_startTime = WTF::monotonicallyIncreasingTime();
+}
+
+void PerfTest::stopTimer(double work)
+{
+    ASSERT(m_startTime);
+    m_elapsedTime += WTF::monotonicallyIncreasingTime() - m_startTime;
+    m_startTime = 0;
+    m_work += work;
+}
+
+void PerfTest::reportRate(const char* measurement, const char* trace, const char* units)
+{
+    ASSERT(!m_startTime);
+    ASSERT_GT(m_elapsedTime, 0);
+    perf_test::PrintResult(measurement, "", trace, m_work / m_elapsedTime, units, true);
+    m_elapsedTime = 0;
+    m_work = 0;
+}
+
+} // namespace blink
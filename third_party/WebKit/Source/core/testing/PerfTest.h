@@ -0,0 +1,35 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PerfTest_h
+#define PerfTest_h
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace blink {
+
+// Fixture for the perf tests, which measure how much work some code gets
+// through per second and print it for the perf dashboards. They are named
+// DISABLED_ so that they only run with --gtest_also_run_disabled_tests.
+class PerfTest : public ::testing::Test {
+protected:
+    PerfTest();
+
+    // Only the time between startTimer() and stopTimer() is measured, so that
+    // setting up the input of each iteration isn't.
+    void startTimer();
+    void stopTimer(double work);
+
+    // Prints the work per second measured since the last report.
+    void reportRate(const char* measurement, const char* trace, const char* units);
+
+private:
+    double m_startTime;
+    double m_elapsedTime;
+    double m_work;
+};
+
+} // namespace blink
+
+#endif // PerfTest_h
@@ -73,6 +73,25 @@
         }],
       ],
     },
+    {
+      'target_name': 'blink_heap_perftests',
+      'type': 'executable',
+      'dependencies': [
+        '../config.gyp:unittest_config',
+        '../wtf/wtf.gyp:wtf',
+        '<(DEPTH)/base/base.gyp:test_support_base',
+        '<(DEPTH)/content/content_shell_and_tests.gyp:test_support_content',
+        '<(DEPTH)/testing/perf/perf_test.gyp:perf_test',
+        'blink_platform.gyp:blink_platform',
+      ],
+      'defines': [
+        'INSIDE_BLINK',
+      ],
+      'sources': [
+        'heap/RunAllTests.cpp',
+        '<@(platform_heap_perftest_files)',
+      ],
+    },
     {
       'target_name': 'blink_platform_unittests',
       'type': 'executable',
@@ -88,11 +88,8 @@ bool DecodingImageGenerator::onGetYUV8Planes(SkISize sizes[3], void* planes[3],
     if (requestingYUVSizes)
         return m_frameGenerator->getYUVComponentSizes(sizes);
 
-    if (colorSpace)
-        *colorSpace = kJPEG_SkYUVColorSpace;
-
     PlatformInstrumentation::willDecodeLazyPixelRef(m_generationId);
-    bool decoded = m_frameGenerator->decodeToYUV(sizes, planes, rowBytes);
+    bool decoded = m_frameGenerator->decodeToYUV(sizes, planes, rowBytes, colorSpace);
     PlatformInstrumentation::didDecodeLazyPixelRef();
 
     return decoded;
@@ -219,8 +219,8 @@ void DeferredImageDecoder::activateLazyDecoding()
 
     m_size = m_actualDecoder->size();
     m_filenameExtension = m_actualDecoder->filenameExtension();
-    // JPEG images support YUV decoding: other decoders do not, WEBP could in future.
-    m_canYUVDecode = RuntimeEnabledFeatures::decodeToYUVEnabled() && (m_filenameExtension == "jpg");
+    // JPEG and lossy WEBP images support YUV decoding: other decoders do not.
+    m_canYUVDecode = RuntimeEnabledFeatures::decodeToYUVEnabled() && (m_filenameExtension == "jpg" || m_filenameExtension == "webp");
     m_hasColorProfile = m_actualDecoder->hasColorProfile();
 
     const bool isSingleFrame = m_actualDecoder->repetitionCount() == cAnimationNone || (m_allDataReceived && m_actualDecoder->frameCount() == 1u);
@@ -213,7 +213,7 @@ bool ImageFrameGenerator::decodeAndScale(const SkImageInfo& info, size_t index,
     return result;
 }
 
-bool ImageFrameGenerator::decodeToYUV(SkISize componentSizes[3], void* planes[3], size_t rowBytes[3])
+bool ImageFrameGenerator::decodeToYUV(SkISize componentSizes[3], void* planes[3], size_t rowBytes[3], SkYUVColorSpace* colorSpace)
 {
     // This method is called to populate a discardable memory owned by Skia.
 
@@ -249,6 +249,9 @@ bool ImageFrameGenerator::decodeToYUV(SkISize componentSizes[3], void* planes[3]
     bool sizeUpdated = updateYUVComponentSizes(decoder.get(), componentSizes, ImageDecoder::ActualSize);
     RELEASE_ASSERT(sizeUpdated);
 
+    if (colorSpace)
+        *colorSpace = decoder->yuvColorSpace();
+
     bool yuvDecoded = decoder->decodeToYUV();
     if (yuvDecoded)
         setHasAlpha(0, false); // YUV is always opaque
@@ -72,8 +72,9 @@ public:
     // a stride of |rowBytes|. Returns true if decoding was successful.
     bool decodeAndScale(const SkImageInfo&, size_t index, void* pixels, size_t rowBytes);
 
-    // Decodes YUV components directly into the provided memory planes.
-    bool decodeToYUV(SkISize componentSizes[3], void* planes[3], size_t rowBytes[3]);
+    // Decodes YUV components directly into the provided memory planes, and
+    // sets |colorSpace| to the color space of the decoded planes.
+    bool decodeToYUV(SkISize componentSizes[3], void* planes[3], size_t rowBytes[3], SkYUVColorSpace* colorSpace);
 
     void setData(PassRefPtr<SharedBuffer>, bool allDataReceived);
 
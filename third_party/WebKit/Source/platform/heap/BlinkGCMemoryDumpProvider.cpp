@@ -6,6 +6,7 @@
 #include "platform/heap/BlinkGCMemoryDumpProvider.h"
 
 #include "platform/heap/Handle.h"
+#include "platform/heap/HeapCompact.h"
 #include "public/platform/Platform.h"
 #include "public/platform/WebMemoryAllocatorDump.h"
 #include "public/platform/WebProcessMemoryDump.h"
@@ -27,6 +28,15 @@ void dumpMemoryTotals(blink::WebProcessMemoryDump* memoryDump)
     // Heap::markedObjectSize() can be underestimated if we're still in the
     // process of lazy sweeping.
     objectsDump->addScalar("size", "bytes", Heap::allocatedObjectSize() + Heap::markedObjectSize());
+
+    // Fragmentation of the collection backing heaps before and after the
+    // last heap compaction, if any.
+    if (Heap::isHeapCompactionEnabled()) {
+        WebMemoryAllocatorDump* compactionDump = memoryDump->createMemoryAllocatorDump("blink_gc/compaction");
+        compactionDump->addScalar("fragmented_size_before", "bytes", HeapCompact::fragmentedSizeBeforeCompaction());
+        compactionDump->addScalar("fragmented_size_after", "bytes", HeapCompact::fragmentedSizeAfterCompaction());
+        compactionDump->addScalar("freed_size", "bytes", HeapCompact::compactionFreedSize());
+    }
 }
 
 } // namespace
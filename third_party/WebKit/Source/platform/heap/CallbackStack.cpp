@@ -24,6 +24,16 @@ void CallbackStack::Block::invokeEphemeronCallbacks(Visitor* visitor)
     }
 }
 
+void CallbackStack::Block::moveOldestEntriesTo(Block* to, size_t count)
+{
+    ASSERT(to->isEmptyBlock());
+    ASSERT(count <= size());
+    memcpy(to->m_buffer, m_buffer, count * sizeof(Item));
+    memmove(m_buffer, m_buffer + count, (size() - count) * sizeof(Item));
+    to->m_current = to->m_buffer + count;
+    m_current -= count;
+}
+
 #if ENABLE(ASSERT)
 bool CallbackStack::Block::hasCallbackForObject(const void* object)
 {
@@ -98,6 +108,47 @@ CallbackStack::Item* CallbackStack::popSlow()
     }
 }
 
+bool CallbackStack::takeBlockFrom(CallbackStack* other)
+{
+    ASSERT(other != this);
+    Block* block = other->m_first->next();
+    if (block) {
+        // Take the most recently filled full block, leaving the block that
+        // |other| is currently pushing onto in place.
+        other->m_first->setNext(block->next());
+        if (other->m_last == block)
+            other->m_last = other->m_first;
+    } else {
+        size_t size = other->m_first->size();
+        if (!size)
+            return false;
+        // Leave the newer half of the entries with |other|.
+        size_t count = (size + 1) / 2;
+        if (isEmpty()) {
+            other->m_first->moveOldestEntriesTo(m_first, count);
+            return true;
+        }
+        block = new Block(nullptr);
+        other->m_first->moveOldestEntriesTo(block, count);
+    }
+
+    if (isEmpty()) {
+        delete m_first;
+        block->setNext(nullptr);
+        m_last = block;
+    } else {
+        block->setNext(m_first);
+    }
+    m_first = block;
+    return true;
+}
+
+bool CallbackStack::hasAtLeast(size_t entries) const
+{
+    ASSERT(entries <= blockSize);
+    return !hasJustOneBlock() || m_first->size() >= entries;
+}
+
 void CallbackStack::invokeEphemeronCallbacks(Visitor* visitor)
 {
     // The first block is the only one where new ephemerons are added, so we
@@ -44,6 +44,16 @@ public:
 
     bool isEmpty() const;
 
+    // Support for parallel marking, where marker threads exchange work
+    // through a shared stack. takeBlockFrom() moves a full block of entries
+    // from |other| onto this stack, or the older half of its entries if
+    // |other| consists of a single block. Returns false if |other| is empty.
+    // The caller must ensure that neither stack is used concurrently.
+    bool takeBlockFrom(CallbackStack* other);
+    // Returns true if the stack holds at least |entries| entries, where
+    // |entries| is at most the number of entries in a block.
+    bool hasAtLeast(size_t entries) const;
+
     void invokeEphemeronCallbacks(Visitor*);
 
 #if ENABLE(ASSERT)
@@ -97,6 +107,10 @@ private:
             return --m_current;
         }
 
+        // Moves the |count| oldest entries of this block to the empty block
+        // |to|, preserving their order.
+        void moveOldestEntriesTo(Block* to, size_t count);
+
         void invokeEphemeronCallbacks(Visitor*);
 #if ENABLE(ASSERT)
         bool hasCallbackForObject(const void*);
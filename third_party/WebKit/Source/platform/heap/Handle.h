@@ -703,17 +703,20 @@ public:
     Member(T* raw) : m_raw(raw)
     {
         checkPointer();
+        writeBarrier();
     }
 
     explicit Member(T& raw) : m_raw(&raw)
     {
         checkPointer();
+        writeBarrier();
     }
 
     template<typename U>
     Member(const RawPtr<U>& other) : m_raw(other.get())
     {
         checkPointer();
+        writeBarrier();
     }
 
     Member(WTF::HashTableDeletedValueType) : m_raw(reinterpret_cast<T*>(-1))
@@ -726,17 +729,20 @@ public:
     Member(const Persistent<U>& other) : m_raw(other)
     {
         checkPointer();
+        writeBarrier();
     }
 
     Member(const Member& other) : m_raw(other)
     {
         checkPointer();
+        writeBarrier();
     }
 
     template<typename U>
     Member(const Member<U>& other) : m_raw(other)
     {
         checkPointer();
+        writeBarrier();
     }
 
     T* release()
@@ -760,6 +766,7 @@ public:
     {
         m_raw = other;
         checkPointer();
+        writeBarrier();
         return *this;
     }
 
@@ -768,6 +775,7 @@ public:
     {
         m_raw = other;
         checkPointer();
+        writeBarrier();
         return *this;
     }
 
@@ -776,6 +784,7 @@ public:
     {
         m_raw = other;
         checkPointer();
+        writeBarrier();
         return *this;
     }
 
@@ -784,6 +793,7 @@ public:
     {
         m_raw = other;
         checkPointer();
+        writeBarrier();
         return *this;
     }
 
@@ -797,6 +807,8 @@ public:
     {
         std::swap(m_raw, other.m_raw);
         checkPointer();
+        writeBarrier();
+        other.writeBarrier();
     }
 
     T* get() const { return m_raw; }
@@ -832,6 +844,14 @@ protected:
 #endif
     }
 
+    // While incremental marking is in progress, objects stored into Members
+    // are marked, so that no object that has been traced already points to
+    // an unmarked one. See Heap::writeBarrier().
+    void writeBarrier() const
+    {
+        Heap::writeBarrier(m_raw);
+    }
+
     T* m_raw;
 
     template<bool x, WTF::WeakHandlingFlag y, WTF::ShouldWeakPointersBeMarkedStrongly z, typename U, typename V> friend struct CollectionBackingTraceTrait;
@@ -1372,6 +1392,8 @@ template <typename T, size_t inlineCapacity> struct VectorTraits<blink::HeapVect
     static const bool canInitializeWithMemset = VectorTraits<T>::canInitializeWithMemset;
     static const bool canClearUnusedSlotsWithMemset = VectorTraits<T>::canClearUnusedSlotsWithMemset;
     static const bool canMoveWithMemcpy = VectorTraits<T>::canMoveWithMemcpy;
+    // Elements in the inline buffer are pointed to by the vector.
+    static const bool hasInteriorPointers = true;
 };
 
 template <typename T, size_t inlineCapacity> struct VectorTraits<blink::HeapDeque<T, inlineCapacity>> : VectorTraitsBase<blink::HeapDeque<T, inlineCapacity>> {
@@ -1379,6 +1401,15 @@ template <typename T, size_t inlineCapacity> struct VectorTraits<blink::HeapDequ
     static const bool canInitializeWithMemset = VectorTraits<T>::canInitializeWithMemset;
     static const bool canClearUnusedSlotsWithMemset = VectorTraits<T>::canClearUnusedSlotsWithMemset;
     static const bool canMoveWithMemcpy = VectorTraits<T>::canMoveWithMemcpy;
+    static const bool hasInteriorPointers = true;
+};
+
+template <typename T, size_t inlineCapacity> struct HashTraits<blink::HeapVector<T, inlineCapacity>> : GenericHashTraits<blink::HeapVector<T, inlineCapacity>> {
+    static const bool hasInteriorPointers = inlineCapacity;
+};
+
+template <typename T, size_t inlineCapacity> struct HashTraits<blink::HeapDeque<T, inlineCapacity>> : GenericHashTraits<blink::HeapDeque<T, inlineCapacity>> {
+    static const bool hasInteriorPointers = inlineCapacity;
 };
 
 template<typename T> struct HashTraits<blink::Member<T>> : SimpleClassHashTraits<blink::Member<T>> {
@@ -35,19 +35,27 @@
 #include "platform/TraceEvent.h"
 #include "platform/heap/BlinkGCMemoryDumpProvider.h"
 #include "platform/heap/CallbackStack.h"
+#include "platform/heap/HeapCompact.h"
 #include "platform/heap/MarkingVisitor.h"
 #include "platform/heap/PageMemory.h"
 #include "platform/heap/PagePool.h"
 #include "platform/heap/SafePoint.h"
+#include "platform/heap/StackFrameDepth.h"
 #include "platform/heap/ThreadState.h"
+#include "platform/Task.h"
+#include "platform/ThreadSafeFunctional.h"
 #include "public/platform/Platform.h"
 #include "public/platform/WebMemoryAllocatorDump.h"
 #include "public/platform/WebProcessMemoryDump.h"
+#include "public/platform/WebThread.h"
+#include "public/platform/WebTraceLocation.h"
 #include "wtf/Assertions.h"
 #include "wtf/DataLog.h"
 #include "wtf/LeakAnnotations.h"
 #include "wtf/MainThread.h"
 #include "wtf/Partitions.h"
+#include "wtf/SpinLock.h"
+#include "wtf/ThreadingPrimitives.h"
 
 namespace blink {
 
@@ -145,6 +153,190 @@ private:
     bool m_resumeThreads;
 };
 
+static SpinLock s_sharedCallbackStackLock;
+
+// Pushes onto the callback stacks shared by all markers (post-marking,
+// weak and ephemeron callbacks) have to be serialized while marker threads
+// are running. The lock is only taken during parallel marking.
+class SharedCallbackStackLocker final {
+    WTF_MAKE_NONCOPYABLE(SharedCallbackStackLocker);
+public:
+    SharedCallbackStackLocker()
+        : m_locked(Heap::isMarkingInParallel())
+    {
+        if (m_locked)
+            s_sharedCallbackStackLock.lock();
+    }
+
+    ~SharedCallbackStackLocker()
+    {
+        if (m_locked)
+            s_sharedCallbackStackLock.unlock();
+    }
+
+private:
+    bool m_locked;
+};
+
+// Drives one round of parallel marking. The GCing thread and each of the
+// marker threads drain a private marking stack. Markers with surplus work
+// hand out blocks of it through the shared (global) marking stack while
+// other markers are idle; the shared stack is only accessed under m_mutex
+// during the round. The round is over when every participant is idle and
+// the shared stack is empty, as no one can produce more work at that point.
+class ParallelMarker final {
+    WTF_MAKE_NONCOPYABLE(ParallelMarker);
+public:
+    ParallelMarker(CallbackStack* sharedStack, size_t markerThreadCount)
+        : m_sharedStack(sharedStack)
+        , m_participants(static_cast<int>(markerThreadCount) + 1)
+        , m_idleParticipants(0)
+        , m_runningMarkerThreads(static_cast<int>(markerThreadCount))
+    {
+    }
+
+    void mark()
+    {
+        CallbackStack markingStack;
+        MarkingVisitor<Visitor::GlobalMarking> visitor(&markingStack);
+        while (takeWork(&markingStack)) {
+            while (CallbackStack::Item* item = markingStack.pop()) {
+                item->call(&visitor);
+                if (acquireLoad(&m_idleParticipants) && markingStack.hasAtLeast(minimumEntriesToShare))
+                    shareWork(&markingStack);
+            }
+        }
+        ASSERT(markingStack.isEmpty());
+    }
+
+    void markOnMarkerThread()
+    {
+        TRACE_EVENT0("blink_gc", "ParallelMarker::markOnMarkerThread");
+        mark();
+
+        MutexLocker locker(m_mutex);
+        if (!--m_runningMarkerThreads)
+            m_markerThreadsDone.signal();
+    }
+
+    void waitForMarkerThreads()
+    {
+        MutexLocker locker(m_mutex);
+        while (m_runningMarkerThreads)
+            m_markerThreadsDone.wait(m_mutex);
+    }
+
+private:
+    // Sharing a handful of entries costs more in synchronization than
+    // it saves by tracing them elsewhere.
+    static const size_t minimumEntriesToShare = 64;
+
+    // Blocks until work is available, returning false once marking is done.
+    bool takeWork(CallbackStack* markingStack)
+    {
+        MutexLocker locker(m_mutex);
+        releaseStore(&m_idleParticipants, m_idleParticipants + 1);
+        for (;;) {
+            if (markingStack->takeBlockFrom(m_sharedStack)) {
+                releaseStore(&m_idleParticipants, m_idleParticipants - 1);
+                if (!m_sharedStack->isEmpty())
+                    m_workAvailable.signal();
+                return true;
+            }
+            if (m_idleParticipants == m_participants) {
+                m_workAvailable.broadcast();
+                return false;
+            }
+            m_workAvailable.wait(m_mutex);
+        }
+    }
+
+    void shareWork(CallbackStack* markingStack)
+    {
+        MutexLocker locker(m_mutex);
+        m_sharedStack->takeBlockFrom(markingStack);
+        m_workAvailable.signal();
+    }
+
+    CallbackStack* m_sharedStack;
+    const int m_participants;
+    int m_idleParticipants;
+    int m_runningMarkerThreads;
+    Mutex m_mutex;
+    ThreadCondition m_workAvailable;
+    ThreadCondition m_markerThreadsDone;
+};
+
+// Marks the objects directly reachable from persistent handles when
+// incremental marking starts. The marking stack is processed by later
+// marking steps, so nothing may be traced eagerly by this visitor.
+// Persistent collections live off the heap and may be gone by the time
+// marking is finalized, so no callbacks are registered for them; their
+// weak processing is left to the GC finalizing marking, which rescans
+// the persistent handles.
+class IncrementalMarkingRootVisitor final : public Visitor, public MarkingVisitorImpl<IncrementalMarkingRootVisitor> {
+public:
+    using Impl = MarkingVisitorImpl<IncrementalMarkingRootVisitor>;
+    friend class MarkingVisitorImpl<IncrementalMarkingRootVisitor>;
+
+    IncrementalMarkingRootVisitor()
+        : Visitor(Visitor::GlobalMarking)
+    {
+        StackFrameDepth::disableRecursion();
+    }
+
+    ~IncrementalMarkingRootVisitor()
+    {
+        // Clear the queued bits of the ephemeron tables.
+        for (const auto& table : m_weakTables)
+            table.second(this, const_cast<void*>(table.first));
+        StackFrameDepth::disableStackLimit();
+    }
+
+    void markHeader(HeapObjectHeader* header, TraceCallback callback) override
+    {
+        Impl::markHeader(header, header->payload(), callback);
+    }
+
+    void mark(const void* objectPointer, TraceCallback callback) override
+    {
+        Impl::mark(objectPointer, callback);
+    }
+
+    void registerDelayedMarkNoTracing(const void*) override { }
+
+    void registerWeakMembers(const void*, const void*, WeakCallback) override { }
+
+    void registerWeakTable(const void* closure, EphemeronCallback, EphemeronCallback iterationDoneCallback) override
+    {
+        m_weakTables.append(std::make_pair(closure, iterationDoneCallback));
+    }
+
+#if ENABLE(ASSERT)
+    bool weakTableRegistered(const void* closure) override
+    {
+        for (const auto& table : m_weakTables) {
+            if (table.first == closure)
+                return true;
+        }
+        return false;
+    }
+#endif
+
+    bool ensureMarked(const void* objectPointer) override
+    {
+        return Impl::ensureMarked(objectPointer);
+    }
+
+protected:
+    void registerWeakCellWithCallback(void**, WeakCallback) override { }
+
+    inline bool shouldMarkObject(const void*) { return true; }
+
+private:
+    Vector<std::pair<const void*, EphemeronCallback>> m_weakTables;
+};
+
 void Heap::flushHeapDoesNotContainCache()
 {
     s_heapDoesNotContainCache->flush();
@@ -157,6 +349,7 @@ void Heap::init()
     s_postMarkingCallbackStack = new CallbackStack();
     s_globalWeakCallbackStack = new CallbackStack();
     s_ephemeronStack = new CallbackStack();
+    s_writeBarrierStack = new CallbackStack();
     s_heapDoesNotContainCache = new HeapDoesNotContainCache();
     s_freePagePool = new FreePagePool();
     s_orphanedPagePool = new OrphanedPagePool();
@@ -194,6 +387,9 @@ void Heap::doShutdown()
     if (!s_markingStack)
         return;
 
+    disableParallelMarking();
+    disableConcurrentSweeping();
+
     ASSERT(!ThreadState::attachedThreads().size());
     delete s_heapDoesNotContainCache;
     s_heapDoesNotContainCache = nullptr;
@@ -209,6 +405,8 @@ void Heap::doShutdown()
     s_markingStack = nullptr;
     delete s_ephemeronStack;
     s_ephemeronStack = nullptr;
+    delete s_writeBarrierStack;
+    s_writeBarrierStack = nullptr;
     delete s_regionTree;
     s_regionTree = nullptr;
     GCInfoTable::shutdown();
@@ -254,13 +452,16 @@ Address Heap::checkAndMarkPointer(Visitor* visitor, Address address)
     return nullptr;
 }
 
-void Heap::pushTraceCallback(void* object, TraceCallback callback)
+void Heap::pushTraceCallback(CallbackStack* markingStack, void* object, TraceCallback callback)
 {
-    ASSERT(ThreadState::current()->isInGC());
+    ASSERT(isMarkingOnCurrentThread());
+    // The global marking stack is shared by all markers during parallel
+    // marking and must not be pushed onto directly.
+    ASSERT(markingStack || !s_isMarkingInParallel);
 
     // Trace should never reach an orphaned page.
     ASSERT(!Heap::orphanedPagePool()->contains(object));
-    CallbackStack::Item* slot = s_markingStack->allocateEntry();
+    CallbackStack::Item* slot = (markingStack ? markingStack : s_markingStack)->allocateEntry();
     *slot = CallbackStack::Item(object, callback);
 }
 
@@ -275,10 +476,11 @@ bool Heap::popAndInvokeTraceCallback(Visitor* visitor)
 
 void Heap::pushPostMarkingCallback(void* object, TraceCallback callback)
 {
-    ASSERT(ThreadState::current()->isInGC());
+    ASSERT(isMarkingOnCurrentThread());
 
     // Trace should never reach an orphaned page.
     ASSERT(!Heap::orphanedPagePool()->contains(object));
+    SharedCallbackStackLocker locker;
     CallbackStack::Item* slot = s_postMarkingCallbackStack->allocateEntry();
     *slot = CallbackStack::Item(object, callback);
 }
@@ -294,21 +496,23 @@ bool Heap::popAndInvokePostMarkingCallback(Visitor* visitor)
 
 void Heap::pushGlobalWeakCallback(void** cell, WeakCallback callback)
 {
-    ASSERT(ThreadState::current()->isInGC());
+    ASSERT(isMarkingOnCurrentThread());
 
     // Trace should never reach an orphaned page.
     ASSERT(!Heap::orphanedPagePool()->contains(cell));
+    SharedCallbackStackLocker locker;
     CallbackStack::Item* slot = s_globalWeakCallbackStack->allocateEntry();
     *slot = CallbackStack::Item(cell, callback);
 }
 
 void Heap::pushThreadLocalWeakCallback(void* closure, void* object, WeakCallback callback)
 {
-    ASSERT(ThreadState::current()->isInGC());
+    ASSERT(isMarkingOnCurrentThread());
 
     // Trace should never reach an orphaned page.
     ASSERT(!Heap::orphanedPagePool()->contains(object));
     ThreadState* state = pageFromObject(object)->heap()->threadState();
+    SharedCallbackStackLocker locker;
     state->pushThreadLocalWeakCallback(closure, callback);
 }
 
@@ -323,12 +527,15 @@ bool Heap::popAndInvokeGlobalWeakCallback(Visitor* visitor)
 
 void Heap::registerWeakTable(void* table, EphemeronCallback iterationCallback, EphemeronCallback iterationDoneCallback)
 {
-    ASSERT(ThreadState::current()->isInGC());
+    ASSERT(isMarkingOnCurrentThread());
 
     // Trace should never reach an orphaned page.
     ASSERT(!Heap::orphanedPagePool()->contains(table));
-    CallbackStack::Item* slot = s_ephemeronStack->allocateEntry();
-    *slot = CallbackStack::Item(table, iterationCallback);
+    {
+        SharedCallbackStackLocker locker;
+        CallbackStack::Item* slot = s_ephemeronStack->allocateEntry();
+        *slot = CallbackStack::Item(table, iterationCallback);
+    }
 
     // Register a post-marking callback to tell the tables that
     // ephemeron iteration is complete.
@@ -383,6 +590,12 @@ void Heap::collectGarbage(BlinkGC::StackState stackState, BlinkGC::GCType gcType
     ThreadState* state = ThreadState::current();
     // Nested collectGarbage() invocations aren't supported.
     RELEASE_ASSERT(!state->isGCForbidden());
+
+    // A snapshot doesn't account for the marks of an unfinished incremental
+    // marking, so finish that first.
+    if (gcType == BlinkGC::TakeSnapshot && s_isIncrementalMarkingInProgress)
+        collectGarbage(stackState, BlinkGC::GCWithSweep, reason);
+
     state->completeSweep();
 
     GCScope gcScope(state, stackState, gcType);
@@ -413,6 +626,14 @@ void Heap::collectGarbage(BlinkGC::StackState stackState, BlinkGC::GCType gcType
 
     preGC();
 
+    // Collection backings are only compacted after atomic marking, as the
+    // marking steps of incremental marking don't record their slots.
+    bool compactBackings = s_isHeapCompactionEnabled && gcType != BlinkGC::TakeSnapshot && !s_isIncrementalMarkingInProgress;
+    if (compactBackings)
+        HeapCompact::resetFragmentationCounters();
+    for (ThreadState* attachedState : ThreadState::attachedThreads())
+        attachedState->heapCompact()->initialize(compactBackings);
+
     StackFrameDepthScope stackDepthScope;
 
     size_t totalObjectSize = Heap::allocatedObjectSize() + Heap::markedObjectSize();
@@ -426,7 +647,16 @@ void Heap::collectGarbage(BlinkGC::StackState stackState, BlinkGC::GCType gcType
     // given stackState since other threads might have a different stack state.
     ThreadState::visitStackRoots(gcScope.visitor());
 
-    // 3. Transitive closure to trace objects including ephemerons.
+    // 3. If this GC finalizes incremental marking, trace what the mutator
+    // has stored into the heap since the last marking step. Objects marked
+    // by the marking steps are not traced again.
+    bool finalizesIncrementalMarking = s_isIncrementalMarkingInProgress;
+    if (finalizesIncrementalMarking) {
+        processWriteBarrierStack(gcScope.visitor());
+        s_isIncrementalMarkingInProgress = false;
+    }
+
+    // 4. Transitive closure to trace objects including ephemerons.
     processMarkingStack(gcScope.visitor());
 
     postMarkingProcessing(gcScope.visitor());
@@ -438,7 +668,10 @@ void Heap::collectGarbage(BlinkGC::StackState stackState, BlinkGC::GCType gcType
     orphanedPagePool()->decommitOrphanedPages();
 
     double markingTimeInMilliseconds = WTF::currentTimeMS() - startTime;
-    s_estimatedMarkingTimePerByte = totalObjectSize ? (markingTimeInMilliseconds / 1000 / totalObjectSize) : 0;
+    // The final pause of incremental marking says little about the time
+    // an atomic GC would take.
+    if (!finalizesIncrementalMarking)
+        s_estimatedMarkingTimePerByte = totalObjectSize ? (markingTimeInMilliseconds / 1000 / totalObjectSize) : 0;
 
 #if PRINT_HEAP_STATS
     dataLogF("Heap::collectGarbage (gcReason=%s, lazySweeping=%d, time=%.1lfms)\n", gcReasonString(reason), gcType == BlinkGC::GCWithoutSweep, markingTimeInMilliseconds);
@@ -463,6 +696,9 @@ void Heap::collectGarbage(BlinkGC::StackState stackState, BlinkGC::GCType gcType
 
 void Heap::collectGarbageForTerminatingThread(ThreadState* state)
 {
+    // ThreadState::cleanup() finishes incremental marking before getting
+    // here, as the marking stack would otherwise be shared with it.
+    ASSERT(!s_isIncrementalMarkingInProgress);
     {
         // A thread-specific termination GC must not allow other global GCs to go
         // ahead while it is running, hence the termination GC does not enter a
@@ -473,6 +709,7 @@ void Heap::collectGarbageForTerminatingThread(ThreadState* state)
         ThreadState::NoAllocationScope noAllocationScope(state);
 
         state->preGC();
+        state->heapCompact()->initialize(false);
 
         // 1. Trace the thread local persistent roots. For thread local GCs we
         // don't trace the stack (ie. no conservative scanning) since this is
@@ -500,9 +737,17 @@ void Heap::collectGarbageForTerminatingThread(ThreadState* state)
 
 void Heap::processMarkingStack(Visitor* visitor)
 {
+    bool markInParallel = s_markerThreads && visitor->markingMode() == Visitor::GlobalMarking;
+
     // Ephemeron fixed point loop.
     do {
-        {
+        if (markInParallel) {
+            // Iteratively mark all objects that are reachable from the objects
+            // currently pushed onto the marking stack, using the marker
+            // threads in addition to the current thread.
+            TRACE_EVENT1("blink_gc", "Heap::processMarkingStackInParallel", "markerThreads", static_cast<int>(s_markerThreads->size()));
+            processMarkingStackInParallel();
+        } else {
             // Iteratively mark all objects that are reachable from the objects
             // currently pushed onto the marking stack.
             TRACE_EVENT0("blink_gc", "Heap::processMarkingStackSingleThreaded");
@@ -520,6 +765,264 @@ void Heap::processMarkingStack(Visitor* visitor)
     } while (!s_markingStack->isEmpty());
 }
 
+void Heap::processMarkingStackInParallel()
+{
+    ASSERT(!s_isMarkingInParallel);
+    if (s_markingStack->isEmpty())
+        return;
+
+    ParallelMarker marker(s_markingStack, s_markerThreads->size());
+
+    // The stack limit used to bound eager tracing is only valid on the
+    // GCing thread.
+    StackFrameDepth::disableRecursion();
+    s_isMarkingInParallel = true;
+    for (const auto& thread : *s_markerThreads)
+        thread->taskRunner()->postTask(BLINK_FROM_HERE, new Task(threadSafeBind(&ParallelMarker::markOnMarkerThread, AllowCrossThreadAccess(&marker))));
+
+    marker.mark();
+    marker.waitForMarkerThreads();
+
+    s_isMarkingInParallel = false;
+    StackFrameDepth::enableStackLimit();
+    ASSERT(s_markingStack->isEmpty());
+}
+
+void Heap::enableParallelMarking(size_t markerThreadCount)
+{
+    ASSERT(isMainThread());
+    ASSERT(!ThreadState::current()->isInGC());
+    disableParallelMarking();
+    if (!markerThreadCount)
+        return;
+
+    OwnPtr<Vector<OwnPtr<WebThread>>> markerThreads = adoptPtr(new Vector<OwnPtr<WebThread>>);
+    for (size_t i = 0; i < markerThreadCount; ++i) {
+        OwnPtr<WebThread> thread = adoptPtr(Platform::current()->createThread("BlinkGCMarker"));
+        // Without a platform thread implementation (e.g. in some unit test
+        // configurations) marking stays on the GCing thread.
+        if (!thread)
+            return;
+        markerThreads->append(thread.release());
+    }
+    s_markerThreads = markerThreads.leakPtr();
+}
+
+void Heap::disableParallelMarking()
+{
+    ASSERT(!s_isMarkingInParallel);
+    delete s_markerThreads;
+    s_markerThreads = nullptr;
+}
+
+void Heap::enableConcurrentSweeping()
+{
+    ASSERT(isMainThread());
+    if (s_sweeperThread)
+        return;
+    // Without a platform thread implementation all pages are swept by
+    // their owning threads.
+    s_sweeperThread = Platform::current()->createThread("BlinkGCSweeper");
+}
+
+void Heap::disableConcurrentSweeping()
+{
+    ASSERT(isMainThread());
+    // Pages that the sweeper thread has not got to yet stay queued on their
+    // heaps and are swept by the owning threads.
+    delete s_sweeperThread;
+    s_sweeperThread = nullptr;
+}
+
+void Heap::enableIncrementalMarking()
+{
+    ASSERT(isMainThread());
+    s_isIncrementalMarkingEnabled = true;
+}
+
+void Heap::disableIncrementalMarking()
+{
+    ASSERT(isMainThread());
+    // Marking that is already in progress is finalized as usual.
+    s_isIncrementalMarkingEnabled = false;
+}
+
+bool Heap::startIncrementalMarking()
+{
+    ThreadState* state = ThreadState::current();
+    ASSERT(state->isMainThread());
+    ASSERT(!s_isIncrementalMarkingInProgress);
+    if (!s_isIncrementalMarkingEnabled || state->isGCForbidden())
+        return false;
+    // Marking must not hide a GC that has been scheduled for other reasons.
+    if (state->gcState() != ThreadState::NoGCScheduled && state->gcState() != ThreadState::IdleGCScheduled)
+        return false;
+
+    GCScope gcScope(state, BlinkGC::NoHeapPointersOnStack, BlinkGC::GCWithoutSweep);
+    SafePointScope safePointScope(BlinkGC::NoHeapPointersOnStack, state);
+    if (!gcScope.parkAllThreads(BlinkGC::NoHeapPointersOnStack, BlinkGC::GCWithoutSweep))
+        return false;
+    ResumeThreadScope resumeThreads(BlinkGC::GCWithoutSweep);
+
+    // Other threads' mutations are not recorded by the write barriers.
+    if (ThreadState::attachedThreads().size() != 1)
+        return false;
+
+    ScriptForbiddenIfMainThreadScope scriptForbidden;
+    ThreadState::NoAllocationScope noAllocationScope(state);
+    TRACE_EVENT0("blink_gc", "Heap::startIncrementalMarking");
+    double startTime = WTF::currentTimeMS();
+
+    state->setGCState(ThreadState::GCRunning);
+    state->makeConsistentForIncrementalMarking();
+    {
+        IncrementalMarkingRootVisitor visitor;
+        ThreadState::visitPersistentRoots(&visitor);
+    }
+    ASSERT(s_writeBarrierStack->isEmpty());
+    s_isIncrementalMarkingInProgress = true;
+    state->setGCState(ThreadState::IncrementalMarking);
+
+    Platform::current()->histogramCustomCounts("BlinkGC.StartIncrementalMarking", WTF::currentTimeMS() - startTime, 0, 10 * 1000, 50);
+    return true;
+}
+
+bool Heap::incrementalMarkingStep(double deadlineSeconds)
+{
+    ThreadState* state = ThreadState::current();
+    ASSERT(state->isMainThread());
+    ASSERT(state->gcState() == ThreadState::IncrementalMarking);
+    ASSERT(s_isIncrementalMarkingInProgress);
+    RELEASE_ASSERT(!state->isGCForbidden());
+
+    // Steps can be taken from within allocations, so the stack may contain
+    // heap pointers. They don't need to be scanned until marking is
+    // finalized, but a GC of another thread must not miss them.
+    GCScope gcScope(state, BlinkGC::HeapPointersOnStack, BlinkGC::GCWithoutSweep);
+    SafePointScope safePointScope(BlinkGC::HeapPointersOnStack, state);
+    if (!gcScope.parkAllThreads(BlinkGC::HeapPointersOnStack, BlinkGC::GCWithoutSweep))
+        return false;
+    ResumeThreadScope resumeThreads(BlinkGC::GCWithoutSweep);
+    ScriptForbiddenIfMainThreadScope scriptForbidden;
+    ThreadState::NoAllocationScope noAllocationScope(state);
+
+    // The duration of the step is that of the trace event.
+    double budgetInMilliseconds = (deadlineSeconds - Platform::current()->monotonicallyIncreasingTimeSeconds()) * 1000;
+    TRACE_EVENT1("blink_gc", "Heap::incrementalMarkingStep", "budgetInMilliseconds", budgetInMilliseconds);
+    double startTime = WTF::currentTimeMS();
+
+    state->setGCState(ThreadState::GCRunning);
+    state->makeConsistentForIncrementalMarking();
+
+    bool markingDone = false;
+    {
+        StackFrameDepthScope stackDepthScope;
+        processWriteBarrierStack(gcScope.visitor());
+
+        // Reading the clock is comparatively expensive, so the deadline is
+        // only checked after each batch of trace callbacks.
+        const size_t traceCallbacksPerDeadlineCheck = 128;
+        do {
+            for (size_t i = 0; i < traceCallbacksPerDeadlineCheck; ++i) {
+                if (!popAndInvokeTraceCallback(gcScope.visitor())) {
+                    markingDone = true;
+                    break;
+                }
+            }
+        } while (!markingDone && Platform::current()->monotonicallyIncreasingTimeSeconds() < deadlineSeconds);
+    }
+
+    state->setGCState(ThreadState::IncrementalMarking);
+
+    double stepTimeInMilliseconds = WTF::currentTimeMS() - startTime;
+    Platform::current()->histogramCustomCounts("BlinkGC.IncrementalMarkingStep", stepTimeInMilliseconds, 0, 10 * 1000, 50);
+    return markingDone;
+}
+
+void Heap::pushWriteBarrierEntry(const void* object, TraceCallback callback)
+{
+    // Marking only runs while the main thread is the only attached thread.
+    // Threads attached later can't reach objects of the main thread's heap
+    // through Members, so their stores need not be recorded.
+    if (!isMainThread())
+        return;
+    CallbackStack::Item* slot = s_writeBarrierStack->allocateEntry();
+    *slot = CallbackStack::Item(const_cast<void*>(object), callback);
+}
+
+void Heap::markWriteBarrierObject(Visitor* visitor, void* object)
+{
+    // Member values may point into the middle of a mixin's object, so find
+    // the object the same way conservative stack scanning does.
+    checkAndMarkPointer(visitor, reinterpret_cast<Address>(object));
+}
+
+void Heap::retraceWriteBarrierObject(Visitor* visitor, void* address)
+{
+    // Collections that aren't on the heap are traced again when the
+    // persistent handles and the stack are rescanned.
+    BasePage* page = lookup(reinterpret_cast<Address>(address));
+    if (!page)
+        return;
+    HeapObjectHeader* header;
+    if (page->isLargeObjectPage())
+        header = static_cast<LargeObjectPage*>(page)->heapObjectHeader();
+    else
+        header = static_cast<NormalPage*>(page)->findHeaderFromAddress(reinterpret_cast<Address>(address));
+    if (!header || header->isFree())
+        return;
+
+    if (!header->isMarked()) {
+        // An unmarked object that embeds an inline buffer is traced with
+        // everything in it once it is found to be reachable. A new backing
+        // has to be marked now, as its owner may have been traced already.
+        if (address != header->payload())
+            return;
+        header->mark();
+    }
+    pushTraceCallback(nullptr, header->payload(), gcInfo(header->gcInfoIndex())->m_trace);
+}
+
+void Heap::processWriteBarrierStack(Visitor* visitor)
+{
+    TRACE_EVENT0("blink_gc", "Heap::processWriteBarrierStack");
+    while (CallbackStack::Item* item = s_writeBarrierStack->pop())
+        item->call(visitor);
+}
+
+void Heap::registerBackingStoreReferenceSlow(void** slot)
+{
+    ASSERT(*slot);
+    // Large objects are never moved.
+    BasePage* page = pageFromObject(*slot);
+    if (page->isLargeObjectPage())
+        return;
+    HeapCompact* compact = page->heap()->threadState()->heapCompact();
+    if (!compact->isCompacting())
+        return;
+    // Slots outside of the heap, like those of persistent collections, may
+    // be freed by pre-finalizers and weak callbacks before the heap is
+    // compacted, so they are not recorded and their backings stay put.
+    // Heap::lookup() can't be used by the marker threads.
+    Address slotAddress = reinterpret_cast<Address>(slot);
+    PageMemoryRegion* region = s_regionTree ? s_regionTree->lookup(slotAddress) : nullptr;
+    if (!region || !region->pageFromAddress(slotAddress)) {
+        compact->pinPage(page);
+        return;
+    }
+    compact->registerSlot(slot);
+}
+
+#if ENABLE(ASSERT)
+bool Heap::isMarkingOnCurrentThread()
+{
+    // Marker threads are not attached and have no ThreadState.
+    if (ThreadState* state = ThreadState::current())
+        return state->isInGC();
+    return s_isMarkingInParallel;
+}
+#endif
+
 void Heap::postMarkingProcessing(Visitor* visitor)
 {
     TRACE_EVENT0("blink_gc", "Heap::postMarkingProcessing");
@@ -751,6 +1254,13 @@ CallbackStack* Heap::s_markingStack;
 CallbackStack* Heap::s_postMarkingCallbackStack;
 CallbackStack* Heap::s_globalWeakCallbackStack;
 CallbackStack* Heap::s_ephemeronStack;
+Vector<OwnPtr<WebThread>>* Heap::s_markerThreads = nullptr;
+bool Heap::s_isMarkingInParallel = false;
+WebThread* Heap::s_sweeperThread = nullptr;
+CallbackStack* Heap::s_writeBarrierStack;
+bool Heap::s_isIncrementalMarkingEnabled = false;
+bool Heap::s_isIncrementalMarkingInProgress = false;
+bool Heap::s_isHeapCompactionEnabled = false;
 HeapDoesNotContainCache* Heap::s_heapDoesNotContainCache;
 bool Heap::s_shutdownCalled = false;
 FreePagePool* Heap::s_freePagePool;
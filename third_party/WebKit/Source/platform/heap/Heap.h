@@ -40,9 +40,13 @@
 #include "wtf/Assertions.h"
 #include "wtf/Atomics.h"
 #include "wtf/Forward.h"
+#include "wtf/OwnPtr.h"
+#include "wtf/Vector.h"
 
 namespace blink {
 
+class WebThread;
+
 template<typename T> class Member;
 template<typename T> class WeakMember;
 template<typename T> class UntracedMember;
@@ -128,6 +132,10 @@ public:
     {
         static_assert(IsGarbageCollectedType<T>::value, "only objects deriving from GarbageCollected can be used.");
         BasePage* page = pageFromObject(objectPointer);
+        // The page may be handed to the sweeper thread. Let that sweep
+        // settle before looking at the page's sweeping state.
+        if (page->heap()->isSweepingConcurrently())
+            page->heap()->waitForConcurrentSweep();
         if (page->hasBeenSwept())
             return false;
         ASSERT(page->heap()->threadState()->isSweepingInProgress());
@@ -135,8 +143,9 @@ public:
         return !Heap::isHeapObjectAlive(const_cast<T*>(objectPointer));
     }
 
-    // Push a trace callback on the marking stack.
-    static void pushTraceCallback(void* containerObject, TraceCallback);
+    // Push a trace callback on the given marking stack, or on the global
+    // marking stack if |markingStack| is null.
+    static void pushTraceCallback(CallbackStack* markingStack, void* containerObject, TraceCallback);
 
     // Push a trace callback on the post-marking callback stack.  These
     // callbacks are called after normal marking (including ephemeron
@@ -201,6 +210,84 @@ public:
     static void collectAllGarbage();
 
     static void processMarkingStack(Visitor*);
+
+    // Parallel marking. When enabled, the transitive closure of a global
+    // GC is computed by the GCing thread together with |markerThreadCount|
+    // dedicated marker threads. Snapshot and thread termination GCs are
+    // always marked on the GCing thread.
+    static void enableParallelMarking(size_t markerThreadCount);
+    static void disableParallelMarking();
+    static bool isParallelMarkingEnabled() { return !!s_markerThreads; }
+    static bool isMarkingInParallel() { return s_isMarkingInParallel; }
+#if ENABLE(ASSERT)
+    // Returns true if the current thread is the GCing thread, or a marker
+    // thread taking part in parallel marking.
+    static bool isMarkingOnCurrentThread();
+#endif
+
+    // Concurrent sweeping. When enabled, pages of the normal page heaps whose
+    // dead objects need no finalization are swept on a dedicated sweeper
+    // thread, leaving only the pages with finalizable objects to the lazy
+    // sweeping of the owning thread.
+    static void enableConcurrentSweeping();
+    static void disableConcurrentSweeping();
+    static bool isConcurrentSweepingEnabled() { return !!s_sweeperThread; }
+    static WebThread* sweeperThread() { return s_sweeperThread; }
+
+    // Incremental marking. When enabled, idle GCs of the main thread mark
+    // the heap in bounded steps interleaved with the execution of the
+    // mutator (see ThreadState::performIdleIncrementalMarking()), and the
+    // GC that finalizes marking only has to rescan the roots and to trace
+    // what the mutator changed in the meantime. Incremental marking is
+    // only started while the main thread is the only attached thread, and
+    // only the main thread's mutations are recorded by the write barriers.
+    static void enableIncrementalMarking();
+    static void disableIncrementalMarking();
+    static bool isIncrementalMarkingEnabled() { return s_isIncrementalMarkingEnabled; }
+    static bool isIncrementalMarkingInProgress() { return s_isIncrementalMarkingInProgress; }
+    // Marks the objects reachable from persistent handles. Returns false if
+    // incremental marking can't be started, in which case nothing has
+    // been marked.
+    static bool startIncrementalMarking();
+    // Marks until there is no marking work left or |deadlineSeconds| (in
+    // monotonically increasing time) has been reached. Returns true if
+    // there is no marking work left, in which case marking should be
+    // finalized by a GC.
+    static bool incrementalMarkingStep(double deadlineSeconds);
+
+    // Write barrier for storing |object| into a Member while incremental
+    // marking is in progress. The object is marked and traced by the next
+    // marking step unless it has been marked already.
+    static void writeBarrier(const void* object)
+    {
+        if (UNLIKELY(s_isIncrementalMarkingInProgress) && object)
+            pushWriteBarrierEntry(object, &markWriteBarrierObject);
+    }
+    // Write barrier for collections that move elements into a heap object
+    // without going through Member, i.e. when a new backing is installed
+    // or elements are moved into an inline buffer. The object containing
+    // |address| is traced by the next marking step if it is a new backing
+    // or has been marked already.
+    static void backingWriteBarrier(const void* address)
+    {
+        if (UNLIKELY(s_isIncrementalMarkingInProgress) && address)
+            pushWriteBarrierEntry(address, &retraceWriteBarrierObject);
+    }
+
+    // Heap compaction. When enabled, the GCs that mark the heap atomically
+    // compact the collection backing heaps of the threads before sweeping
+    // them (see HeapCompact).
+    static void enableHeapCompaction() { s_isHeapCompactionEnabled = true; }
+    static void disableHeapCompaction() { s_isHeapCompactionEnabled = false; }
+    static bool isHeapCompactionEnabled() { return s_isHeapCompactionEnabled; }
+    // Records |slot| as the reference to the collection backing it points
+    // to, so that compaction can move the backing and update the slot.
+    static void registerBackingStoreReference(void** slot)
+    {
+        if (UNLIKELY(s_isHeapCompactionEnabled))
+            registerBackingStoreReferenceSlow(slot);
+    }
+
     static void postMarkingProcessing(Visitor*);
     static void globalWeakProcessing(Visitor*);
     static void setForcePreciseGCForTesting();
@@ -289,10 +376,26 @@ private:
     static int heapIndexForObjectSize(size_t);
     static bool isNormalHeapIndex(int);
 
+    static void processMarkingStackInParallel();
+
+    static void pushWriteBarrierEntry(const void*, TraceCallback);
+    static void markWriteBarrierObject(Visitor*, void*);
+    static void retraceWriteBarrierObject(Visitor*, void*);
+    static void processWriteBarrierStack(Visitor*);
+
+    static void registerBackingStoreReferenceSlow(void** slot);
+
     static CallbackStack* s_markingStack;
     static CallbackStack* s_postMarkingCallbackStack;
     static CallbackStack* s_globalWeakCallbackStack;
     static CallbackStack* s_ephemeronStack;
+    static Vector<OwnPtr<WebThread>>* s_markerThreads;
+    static bool s_isMarkingInParallel;
+    static WebThread* s_sweeperThread;
+    static CallbackStack* s_writeBarrierStack;
+    static bool s_isIncrementalMarkingEnabled;
+    static bool s_isIncrementalMarkingInProgress;
+    static bool s_isHeapCompactionEnabled;
     static HeapDoesNotContainCache* s_heapDoesNotContainCache;
     static bool s_shutdownCalled;
     static FreePagePool* s_freePagePool;
@@ -17,6 +17,10 @@ void HeapAllocator::backingFree(void* address)
         return;
     ASSERT(!state->isInGC());
 
+    // The backing may have been marked and be on the marking stack.
+    if (Heap::isIncrementalMarkingInProgress())
+        return;
+
     // Don't promptly free large objects because their page is never reused.
     // Don't free backings allocated on other threads.
     BasePage* page = pageFromObject(address);
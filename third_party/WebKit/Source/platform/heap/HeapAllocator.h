@@ -119,6 +119,16 @@ public:
         TraceCollectionIfEnabled<WTF::NeedsTracingTrait<Traits>::value, Traits::weakHandlingFlag, WTF::WeakPointersActWeak, T, Traits>::trace(visitor, t);
     }
 
+    // Records |slot| as the reference to the backing it points to, so that
+    // heap compaction can move the backing. Only the backings that are
+    // marked by a global GC can be moved.
+    template<typename VisitorDispatcher>
+    static void registerBackingStoreReference(VisitorDispatcher visitor, void** slot)
+    {
+        if (visitor->markingMode() == Visitor::GlobalMarking)
+            Heap::registerBackingStoreReference(slot);
+    }
+
     template<typename VisitorDispatcher>
     static void registerDelayedMarkNoTracing(VisitorDispatcher visitor, const void* object)
     {
@@ -171,6 +181,19 @@ public:
         ThreadState::current()->leaveGCForbiddenScope();
     }
 
+    static bool isIncrementalMarkingInProgress()
+    {
+        return Heap::isIncrementalMarkingInProgress();
+    }
+
+    // Called when a collection has installed a new backing, or has moved
+    // elements into the inline buffer at |address|. See
+    // Heap::backingWriteBarrier().
+    static void backingWriteBarrier(const void* address)
+    {
+        Heap::backingWriteBarrier(address);
+    }
+
 private:
     static void backingFree(void*);
     static bool backingExpand(void*, size_t);
@@ -229,7 +252,11 @@ public:
         // Consider using a LinkedHashSet instead if this compile-time assert fails:
         static_assert(!WTF::IsWeak<ValueArg>::value, "weak pointers in a ListHashSet will result in null entries in the set");
 
-        return malloc<void*, Node>(sizeof(Node), nullptr /* Oilpan does not use the heap profiler at the moment. */);
+        void* node = malloc<void*, Node>(sizeof(Node), nullptr /* Oilpan does not use the heap profiler at the moment. */);
+        // Nodes are stored in the table and linked to each other through
+        // raw pointers, so they are marked like new backings.
+        backingWriteBarrier(node);
+        return node;
     }
 
     template<typename VisitorDispatcher>
@@ -0,0 +1,156 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "platform/heap/HeapCompact.h"
+
+#include "platform/ScriptForbiddenScope.h"
+#include "platform/TraceEvent.h"
+#include "platform/heap/Heap.h"
+#include "platform/heap/HeapPage.h"
+#include "platform/heap/ThreadState.h"
+#include "public/platform/Platform.h"
+#include "wtf/Atomics.h"
+#include "wtf/CurrentTime.h"
+#include "wtf/SpinLock.h"
+
+namespace blink {
+
+// Serializes the recording of slots by the parallel marker threads.
+static SpinLock s_slotsLock;
+
+size_t HeapCompact::s_fragmentedSizeBeforeCompaction = 0;
+size_t HeapCompact::s_fragmentedSizeAfterCompaction = 0;
+size_t HeapCompact::s_compactionFreedSize = 0;
+
+HeapCompact::HeapCompact()
+    : m_isCompacting(false)
+{
+}
+
+void HeapCompact::initialize(bool compact)
+{
+    clear();
+    m_isCompacting = compact;
+}
+
+void HeapCompact::registerSlot(void** slot)
+{
+    ASSERT(m_isCompacting);
+    SpinLock::Guard guard(s_slotsLock);
+    m_slots.add(slot, reinterpret_cast<Address>(*slot));
+}
+
+void HeapCompact::pinPage(BasePage* page)
+{
+    ASSERT(m_isCompacting);
+    SpinLock::Guard guard(s_slotsLock);
+    m_pinnedPages.add(page);
+}
+
+void HeapCompact::compact(ThreadState* state)
+{
+    ASSERT(m_isCompacting);
+    ASSERT(state->isSweepingInProgress());
+    TRACE_EVENT0("blink_gc", "HeapCompact::compact");
+    // The finalizers of dead backings are run while compacting.
+    ThreadState::SweepForbiddenScope sweepForbidden(state);
+    ScriptForbiddenIfMainThreadScope scriptForbidden;
+    double startTime = WTF::currentTimeMS();
+
+    // A backing can only be moved if a slot still refers to it.
+    removeStaleSlots();
+    for (const auto& slot : m_slots)
+        m_referencedBackings.add(slot.value);
+
+    // All the heaps are planned before any object is moved, as slots may
+    // be found in the backings of any of them.
+    size_t fragmentedSize = 0;
+    for (int i = BlinkGC::Vector1HeapIndex; i <= BlinkGC::HashTableHeapIndex; i++)
+        fragmentedSize += static_cast<NormalPageHeap*>(state->heap(i))->planCompaction(this);
+    updateSlots();
+    size_t freedSize = 0;
+    for (int i = BlinkGC::Vector1HeapIndex; i <= BlinkGC::HashTableHeapIndex; i++)
+        freedSize += static_cast<NormalPageHeap*>(state->heap(i))->compact(this);
+
+    atomicAdd(&s_fragmentedSizeBeforeCompaction, static_cast<long>(fragmentedSize));
+    atomicAdd(&s_fragmentedSizeAfterCompaction, static_cast<long>(fragmentedSize - freedSize));
+    atomicAdd(&s_compactionFreedSize, static_cast<long>(freedSize));
+
+    Platform::current()->histogramCustomCounts("BlinkGC.CompactionFreedSize", freedSize / 1024, 0, 1024 * 1024, 50);
+    Platform::current()->histogramCustomCounts("BlinkGC.TimeForHeapCompaction", WTF::currentTimeMS() - startTime, 0, 10 * 1000, 50);
+    clear();
+}
+
+// Whether |slot| is in an object that survived marking. All recorded slots
+// are in the heap, but pre-finalizers may have freed the backing of a live
+// collection that held them.
+static bool isInLiveObject(void** slot)
+{
+    BasePage* page = pageFromObject(slot);
+    HeapObjectHeader* header = page->isLargeObjectPage()
+        ? static_cast<LargeObjectPage*>(page)->heapObjectHeader()
+        : static_cast<NormalPage*>(page)->findHeaderFromAddress(reinterpret_cast<Address>(slot));
+    return header && header->isMarked();
+}
+
+void HeapCompact::removeStaleSlots()
+{
+    // Weak processing and pre-finalizers may have cleared or replaced the
+    // backings of collections since they were marked, or freed the memory
+    // holding the slots, and a slot in a weak table may have been traced for
+    // a backing that didn't survive marking. Such slots are forgotten and
+    // the backings they referred to, if still alive, pin their pages.
+    Vector<void**> staleSlots;
+    for (const auto& slot : m_slots) {
+        if (!isInLiveObject(slot.key) || reinterpret_cast<Address>(*slot.key) != slot.value || !HeapObjectHeader::fromPayload(slot.value)->isMarked())
+            staleSlots.append(slot.key);
+    }
+    for (void** slot : staleSlots)
+        m_slots.remove(slot);
+}
+
+void HeapCompact::updateSlots()
+{
+    // The slots are updated in place before anything moves. Slots that are
+    // in a moved backing are moved along with it. Every slot is updated
+    // once, from the backing it was recorded with.
+    for (const auto& slot : m_slots) {
+        if (Address newAddress = forwardingAddress(slot.value))
+            *slot.key = newAddress;
+    }
+}
+
+void HeapCompact::clear()
+{
+    m_isCompacting = false;
+    m_slots.clear();
+    m_referencedBackings.clear();
+    m_pinnedPages.clear();
+    m_forwardingAddresses.clear();
+}
+
+void HeapCompact::resetFragmentationCounters()
+{
+    releaseStore(&s_fragmentedSizeBeforeCompaction, 0);
+    releaseStore(&s_fragmentedSizeAfterCompaction, 0);
+    releaseStore(&s_compactionFreedSize, 0);
+}
+
+size_t HeapCompact::fragmentedSizeBeforeCompaction()
+{
+    return acquireLoad(&s_fragmentedSizeBeforeCompaction);
+}
+
+size_t HeapCompact::fragmentedSizeAfterCompaction()
+{
+    return acquireLoad(&s_fragmentedSizeAfterCompaction);
+}
+
+size_t HeapCompact::compactionFreedSize()
+{
+    return acquireLoad(&s_compactionFreedSize);
+}
+
+} // namespace blink
@@ -0,0 +1,106 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef HeapCompact_h
+#define HeapCompact_h
+
+#include "platform/PlatformExport.h"
+#include "platform/heap/BlinkGC.h"
+#include "wtf/HashMap.h"
+#include "wtf/HashSet.h"
+#include "wtf/Noncopyable.h"
+#include "wtf/PassOwnPtr.h"
+#include "wtf/Vector.h"
+
+namespace blink {
+
+class BasePage;
+class ThreadState;
+
+// HeapCompact compacts the heaps of a thread that hold collection backings
+// (the vector, inline vector and hash table heaps), which fragment more than
+// the other heaps as collections grow, shrink and are promptly freed.
+//
+// While marking, the collections record the slot that refers to their
+// backing (Vector::m_buffer, HashTable::m_table). Right before the thread
+// sweeps, the live backings on pages that are not pinned are slid towards
+// the start of the heap, the recorded slots are updated and the pages that
+// have been evacuated are released to the free page pool. A page is pinned,
+// and swept as usual, if a conservatively scanned stack points into it or if
+// it has a live backing that no recorded slot refers to.
+//
+// Backings are assumed to be referenced by the slot of their collection
+// only. Collections whose backings are pointed into by the elements, like
+// LinkedHashSet or vectors of vectors with inline capacity, don't record
+// their slot so that their backings stay put; element types with such
+// interior pointers set the hasInteriorPointers trait. Slots outside of the
+// heap, such as those of persistent collections, aren't recorded either,
+// and pin the pages of their backings.
+class PLATFORM_EXPORT HeapCompact final {
+    WTF_MAKE_NONCOPYABLE(HeapCompact);
+public:
+    static PassOwnPtr<HeapCompact> create()
+    {
+        return adoptPtr(new HeapCompact);
+    }
+
+    static bool isCompactableHeap(int heapIndex)
+    {
+        return BlinkGC::Vector1HeapIndex <= heapIndex && heapIndex <= BlinkGC::HashTableHeapIndex;
+    }
+
+    // Called at the start of a GC. If |compact| is false, nothing is recorded
+    // for the thread by this GC and its heaps are swept as usual.
+    void initialize(bool compact);
+    bool isCompacting() const { return m_isCompacting; }
+
+    // Records that |slot| refers to the backing it currently points to.
+    // A slot may be traced more than once, by weak tables for instance, but
+    // is recorded only once. May be called by the parallel marker threads.
+    void registerSlot(void** slot);
+    // Keeps the objects on |page| where they are.
+    void pinPage(BasePage*);
+
+    // Compacts the heaps of |state| using the slots recorded by the GC that
+    // has just finished marking, and forgets about them.
+    void compact(ThreadState*);
+
+    // Used by NormalPageHeap while compacting.
+    bool isPinned(BasePage* page) const { return m_pinnedPages.contains(page); }
+    bool isReferencedBacking(Address payload) const { return m_referencedBackings.contains(payload); }
+    void setForwardingAddress(Address from, Address to) { m_forwardingAddresses.add(from, to); }
+    Address forwardingAddress(Address from) const { return m_forwardingAddresses.get(from); }
+
+    // Free space in the pages of the compacted heaps right before and right
+    // after the compaction done by the last GC, summed up over all threads.
+    // These are reported to the memory-infra dumps.
+    static void resetFragmentationCounters();
+    static size_t fragmentedSizeBeforeCompaction();
+    static size_t fragmentedSizeAfterCompaction();
+    // The payload size of the pages released by the compaction done by the
+    // last GC.
+    static size_t compactionFreedSize();
+
+private:
+    HeapCompact();
+
+    void removeStaleSlots();
+    void updateSlots();
+    void clear();
+
+    bool m_isCompacting;
+    // The recorded slots and the backings they referred to when recorded.
+    HashMap<void**, Address> m_slots;
+    HashSet<Address> m_referencedBackings;
+    HashSet<BasePage*> m_pinnedPages;
+    HashMap<Address, Address> m_forwardingAddresses;
+
+    static size_t s_fragmentedSizeBeforeCompaction;
+    static size_t s_fragmentedSizeAfterCompaction;
+    static size_t s_compactionFreedSize;
+};
+
+} // namespace blink
+
+#endif // HeapCompact_h
@@ -33,10 +33,12 @@
 
 #include "platform/ScriptForbiddenScope.h"
 #include "platform/Task.h"
+#include "platform/ThreadSafeFunctional.h"
 #include "platform/TraceEvent.h"
 #include "platform/heap/BlinkGCMemoryDumpProvider.h"
 #include "platform/heap/CallbackStack.h"
 #include "platform/heap/Heap.h"
+#include "platform/heap/HeapCompact.h"
 #include "platform/heap/MarkingVisitor.h"
 #include "platform/heap/PageMemory.h"
 #include "platform/heap/PagePool.h"
@@ -45,6 +47,8 @@
 #include "public/platform/Platform.h"
 #include "public/platform/WebMemoryAllocatorDump.h"
 #include "public/platform/WebProcessMemoryDump.h"
+#include "public/platform/WebThread.h"
+#include "public/platform/WebTraceLocation.h"
 #include "wtf/Assertions.h"
 #include "wtf/ContainerAnnotations.h"
 #include "wtf/LeakAnnotations.h"
@@ -52,6 +56,9 @@
 #include "wtf/PageAllocator.h"
 #include "wtf/Partitions.h"
 #include "wtf/PassOwnPtr.h"
+#include "wtf/Threading.h"
+#include "wtf/ThreadingPrimitives.h"
+#include "wtf/Vector.h"
 
 #ifdef ANNOTATE_CONTIGUOUS_CONTAINER
 // FIXME: have ContainerAnnotations.h define an ENABLE_-style name instead.
@@ -88,6 +95,28 @@
 
 namespace blink {
 
+// The concurrent sweeping state of all heaps is guarded by a single mutex;
+// there is one sweeper thread and it takes one page at a time.
+static Mutex& concurrentSweepMutex()
+{
+    AtomicallyInitializedStaticReference(Mutex, mutex, new Mutex);
+    return mutex;
+}
+
+static ThreadCondition& concurrentSweepCondition()
+{
+    AtomicallyInitializedStaticReference(ThreadCondition, condition, new ThreadCondition);
+    return condition;
+}
+
+// Heaps that have pages queued for, or swept by, the sweeper thread.
+// Guarded by concurrentSweepMutex().
+static Vector<NormalPageHeap*>& concurrentlySweptHeaps()
+{
+    DEFINE_STATIC_LOCAL(Vector<NormalPageHeap*>, heaps, ());
+    return heaps;
+}
+
 #if ENABLE(ASSERT)
 NO_SANITIZE_ADDRESS
 void HeapObjectHeader::zapMagic()
@@ -125,6 +154,7 @@ void BaseHeap::cleanupPages()
     clearFreeLists();
 
     ASSERT(!m_firstUnsweptPage);
+    ASSERT(!isSweepingConcurrently());
     // Add the BaseHeap's pages to the orphanedPagePool.
     for (BasePage* page = m_firstPage; page; page = page->next()) {
         Heap::decreaseAllocatedSpace(page->size());
@@ -175,6 +205,12 @@ BasePage* BaseHeap::findPageFromAddress(Address address)
 
 void BaseHeap::makeConsistentForGC()
 {
+    // Take back the pages handed to the sweeper thread, so that the pages
+    // this heap knows about are all it has.
+    waitForConcurrentSweep();
+    collectConcurrentlySweptPages();
+    ASSERT(!isSweepingConcurrently());
+
     clearFreeLists();
     ASSERT(isConsistentForGC());
     for (BasePage* page = m_firstPage; page; page = page->next()) {
@@ -204,6 +240,19 @@ void BaseHeap::makeConsistentForGC()
     ASSERT(!m_firstUnsweptPage);
 }
 
+void BaseHeap::makeConsistentForIncrementalMarking()
+{
+    // Incremental marking starts right after sweeping has been completed
+    // and no sweeping happens until it is finalized.
+    ASSERT(!isSweepingConcurrently());
+    ASSERT(!m_firstUnsweptPage);
+
+    // Objects may have been allocated since the object start bitmaps were
+    // computed.
+    for (BasePage* page = m_firstPage; page; page = page->next())
+        page->invalidateObjectStartBitmap();
+}
+
 void BaseHeap::makeConsistentForMutator()
 {
     clearFreeLists();
@@ -285,7 +334,7 @@ void BaseHeap::poisonHeap(BlinkGC::ObjectsToPoison objectsToPoison, BlinkGC::Poi
 Address BaseHeap::lazySweep(size_t allocationSize, size_t gcInfoIndex)
 {
     // If there are no pages to be swept, return immediately.
-    if (!m_firstUnsweptPage)
+    if (!m_firstUnsweptPage && !isSweepingConcurrently())
         return nullptr;
 
     RELEASE_ASSERT(threadState()->isSweepingInProgress());
@@ -336,6 +385,7 @@ bool BaseHeap::lazySweepWithDeadline(double deadlineSeconds)
     ASSERT(threadState()->sweepForbidden());
     ASSERT(!threadState()->isMainThread() || ScriptForbiddenScope::isScriptForbidden());
 
+    collectConcurrentlySweptPages();
     int pageCount = 1;
     while (m_firstUnsweptPage) {
         sweepUnsweptPage();
@@ -343,13 +393,16 @@ bool BaseHeap::lazySweepWithDeadline(double deadlineSeconds)
             if (deadlineSeconds <= Platform::current()->monotonicallyIncreasingTimeSeconds()) {
                 // Deadline has come.
                 Heap::reportMemoryUsageForTracing();
-                return !m_firstUnsweptPage;
+                return !m_firstUnsweptPage && !isSweepingConcurrently();
             }
         }
         pageCount++;
     }
+    // Pages that the sweeper thread has not finished yet are picked up by
+    // the next idle task.
+    collectConcurrentlySweptPages();
     Heap::reportMemoryUsageForTracing();
-    return true;
+    return !m_firstUnsweptPage && !isSweepingConcurrently();
 }
 
 void BaseHeap::completeSweep()
@@ -358,6 +411,9 @@ void BaseHeap::completeSweep()
     ASSERT(threadState()->sweepForbidden());
     ASSERT(!threadState()->isMainThread() || ScriptForbiddenScope::isScriptForbidden());
 
+    waitForConcurrentSweep();
+    collectConcurrentlySweptPages();
+    ASSERT(!isSweepingConcurrently());
     while (m_firstUnsweptPage) {
         sweepUnsweptPage();
     }
@@ -369,17 +425,46 @@ NormalPageHeap::NormalPageHeap(ThreadState* state, int index)
     , m_currentAllocationPoint(nullptr)
     , m_remainingAllocationSize(0)
     , m_lastRemainingAllocationSize(0)
+    , m_maxSizeClassAllocationSize(0)
     , m_promptlyFreedSize(0)
-{
+    , m_isSweepingConcurrently(false)
+    , m_firstConcurrentSweepPage(nullptr)
+    , m_firstConcurrentlySweptPage(nullptr)
+    , m_firstDeferredConcurrentSweepPage(nullptr)
+    , m_concurrentSweepPagesInProgress(0)
+    , m_concurrentPromptlyFreedSize(0)
+    , m_firstCompactedPage(nullptr)
+{
+    for (size_t i = 0; i < sizeClassCount; ++i) {
+        m_sizeClassAllocationPoints[i] = nullptr;
+        m_sizeClassRemainingAllocationSizes[i] = 0;
+    }
     clearFreeLists();
+    setSizeClassAllocationEnabled(index < BlinkGC::Vector1HeapIndex || index > BlinkGC::HashTableHeapIndex);
 }
 
 void NormalPageHeap::clearFreeLists()
 {
+    clearSizeClassAllocationAreas();
     setAllocationPoint(nullptr, 0);
     m_freeList.clear();
 }
 
+void NormalPageHeap::makeConsistentForIncrementalMarking()
+{
+    // Return the allocation areas to the free list, so that the objects of
+    // their pages can be iterated.
+    clearSizeClassAllocationAreas();
+    setAllocationPoint(nullptr, 0);
+    BaseHeap::makeConsistentForIncrementalMarking();
+}
+
+void NormalPageHeap::setSizeClassAllocationEnabled(bool enabled)
+{
+    clearSizeClassAllocationAreas();
+    m_maxSizeClassAllocationSize = enabled ? maxSizeClassAllocationSize : 0;
+}
+
 #if ENABLE(ASSERT)
 bool NormalPageHeap::isConsistentForGC()
 {
@@ -391,6 +476,14 @@ bool NormalPageHeap::isConsistentForGC()
                 return false;
         }
     }
+    for (size_t i = 0; i < sizeClassCount; ++i) {
+        for (FreeListEntry* freeListEntry = m_freeList.m_sizeClassFreeLists[i]; freeListEntry; freeListEntry = freeListEntry->next()) {
+            if (pagesToBeSweptContains(freeListEntry->address()))
+                return false;
+        }
+        if (m_sizeClassRemainingAllocationSizes[i] && pagesToBeSweptContains(m_sizeClassAllocationPoints[i]))
+            return false;
+    }
     if (hasCurrentAllocationArea()) {
         if (pagesToBeSweptContains(currentAllocationPoint()))
             return false;
@@ -501,6 +594,7 @@ bool NormalPageHeap::coalesce()
 
     ASSERT(!hasCurrentAllocationArea());
     TRACE_EVENT0("blink_gc", "BaseHeap::coalesce");
+    clearSizeClassAllocationAreas();
 
     // Rebuild free lists.
     m_freeList.clear();
@@ -633,7 +727,22 @@ Address NormalPageHeap::lazySweepPages(size_t allocationSize, size_t gcInfoIndex
 {
     ASSERT(!hasCurrentAllocationArea());
     Address result = nullptr;
-    while (m_firstUnsweptPage) {
+    while (true) {
+        if (isSweepingConcurrently()) {
+            collectConcurrentlySweptPages();
+            result = allocateFromFreeList(allocationSize, gcInfoIndex);
+            if (result)
+                break;
+        }
+        if (!m_firstUnsweptPage) {
+            // Only pages queued for the sweeper thread are left. Sweep them
+            // here rather than growing the heap while they are pending.
+            if (!isSweepingConcurrently())
+                break;
+            if (!sweepConcurrentPage(this))
+                waitForConcurrentSweep();
+            continue;
+        }
         BasePage* page = m_firstUnsweptPage;
         if (page->isEmpty()) {
             page->unlink(&m_firstUnsweptPage);
@@ -656,6 +765,298 @@ Address NormalPageHeap::lazySweepPages(size_t allocationSize, size_t gcInfoIndex
     return result;
 }
 
+void NormalPageHeap::scheduleConcurrentSweep()
+{
+    ASSERT(threadState()->isSweepingInProgress());
+    ASSERT(!m_isSweepingConcurrently);
+    if (!m_firstUnsweptPage || !Heap::sweeperThread())
+        return;
+
+    // Empty pages are released right away; the sweeper thread cannot hand
+    // pages back to the page pool.
+    BasePage* queuedPages = nullptr;
+    while (BasePage* page = m_firstUnsweptPage) {
+        page->unlink(&m_firstUnsweptPage);
+        if (page->isEmpty())
+            page->removeFromHeap();
+        else
+            page->link(&queuedPages);
+    }
+    if (!queuedPages)
+        return;
+
+    {
+        MutexLocker locker(concurrentSweepMutex());
+        ASSERT(!m_firstConcurrentSweepPage);
+        m_firstConcurrentSweepPage = queuedPages;
+        concurrentlySweptHeaps().append(this);
+    }
+    m_isSweepingConcurrently = true;
+    Heap::sweeperThread()->taskRunner()->postTask(BLINK_FROM_HERE, new Task(threadSafeBind(&NormalPageHeap::sweepOnSweeperThread)));
+}
+
+bool NormalPageHeap::sweepConcurrentPage(NormalPageHeap* heap)
+{
+    NormalPage* page;
+    {
+        MutexLocker locker(concurrentSweepMutex());
+        if (!heap) {
+            for (NormalPageHeap* candidate : concurrentlySweptHeaps()) {
+                if (candidate->m_firstConcurrentSweepPage) {
+                    heap = candidate;
+                    break;
+                }
+            }
+            if (!heap)
+                return false;
+        }
+        if (!heap->m_firstConcurrentSweepPage)
+            return false;
+        page = static_cast<NormalPage*>(heap->m_firstConcurrentSweepPage);
+        page->unlink(&heap->m_firstConcurrentSweepPage);
+        heap->m_concurrentSweepPagesInProgress++;
+    }
+
+    // Finalizers have to run on the thread owning the heap, so pages with
+    // finalizable dead objects are handed back unswept.
+    bool deferred = page->hasFinalizableDeadObjects();
+    FreeList freeList;
+    size_t promptlyFreedSize = 0;
+    if (!deferred)
+        promptlyFreedSize = page->sweepIntoFreeList(&freeList);
+
+    MutexLocker locker(concurrentSweepMutex());
+    if (deferred) {
+        page->link(&heap->m_firstDeferredConcurrentSweepPage);
+    } else {
+        page->markAsSwept();
+        page->link(&heap->m_firstConcurrentlySweptPage);
+        heap->m_concurrentFreeList.takeEntriesFrom(&freeList);
+        heap->m_concurrentPromptlyFreedSize += promptlyFreedSize;
+    }
+    ASSERT(heap->m_concurrentSweepPagesInProgress);
+    heap->m_concurrentSweepPagesInProgress--;
+    concurrentSweepCondition().broadcast();
+    return true;
+}
+
+void NormalPageHeap::sweepOnSweeperThread()
+{
+    TRACE_EVENT0("blink_gc", "NormalPageHeap::sweepOnSweeperThread");
+    while (sweepConcurrentPage(nullptr)) { }
+}
+
+void NormalPageHeap::waitForConcurrentSweep()
+{
+    if (!m_isSweepingConcurrently)
+        return;
+
+    TRACE_EVENT0("blink_gc", "NormalPageHeap::waitForConcurrentSweep");
+    while (sweepConcurrentPage(this)) { }
+    MutexLocker locker(concurrentSweepMutex());
+    while (m_concurrentSweepPagesInProgress)
+        concurrentSweepCondition().wait(concurrentSweepMutex());
+}
+
+void NormalPageHeap::collectConcurrentlySweptPages()
+{
+    if (!m_isSweepingConcurrently)
+        return;
+
+    MutexLocker locker(concurrentSweepMutex());
+    while (BasePage* page = m_firstConcurrentlySweptPage) {
+        page->unlink(&m_firstConcurrentlySweptPage);
+        page->link(&m_firstPage);
+    }
+    while (BasePage* page = m_firstDeferredConcurrentSweepPage) {
+        page->unlink(&m_firstDeferredConcurrentSweepPage);
+        page->link(&m_firstUnsweptPage);
+    }
+    m_freeList.takeEntriesFrom(&m_concurrentFreeList);
+    decreasePromptlyFreedSize(m_concurrentPromptlyFreedSize);
+    m_concurrentPromptlyFreedSize = 0;
+
+    if (!m_firstConcurrentSweepPage && !m_concurrentSweepPagesInProgress) {
+        size_t index = concurrentlySweptHeaps().find(this);
+        ASSERT(index != kNotFound);
+        concurrentlySweptHeaps().remove(index);
+        m_isSweepingConcurrently = false;
+    }
+}
+
+size_t NormalPageHeap::planCompaction(HeapCompact* compact)
+{
+    ASSERT(threadState()->isSweepingInProgress());
+    ASSERT(!isSweepingConcurrently());
+    ASSERT(!m_firstCompactedPage);
+
+    // Take the unswept pages whose live objects are all referenced by a
+    // recorded slot. Taking the pages reverses their order, which is fine
+    // as long as the same order is used to assign the new addresses and to
+    // move the objects: an object is then never moved past its address.
+    size_t fragmentedSize = 0;
+    size_t compactedPageCount = 0;
+    BasePage* unsweptPages = m_firstUnsweptPage;
+    m_firstUnsweptPage = nullptr;
+    while (BasePage* page = unsweptPages) {
+        page->unlink(&unsweptPages);
+        NormalPage* normalPage = static_cast<NormalPage*>(page);
+        bool canEvacuate = !compact->isPinned(page);
+#if ENABLE_ASAN_CONTAINER_ANNOTATIONS
+        // The container annotations of vector backings can't be moved.
+        if (ThreadState::isVectorHeapIndex(heapIndex()))
+            canEvacuate = false;
+#endif
+        size_t markedObjectSize = 0;
+        for (Address headerAddress = normalPage->payload(); headerAddress < normalPage->payloadEnd();) {
+            HeapObjectHeader* header = reinterpret_cast<HeapObjectHeader*>(headerAddress);
+            ASSERT(header->size() < blinkPagePayloadSize());
+            if (!header->isFree() && header->isMarked()) {
+                ASSERT(header->checkHeader());
+                markedObjectSize += header->size();
+                if (!compact->isReferencedBacking(header->payload()))
+                    canEvacuate = false;
+            }
+            headerAddress += header->size();
+        }
+        fragmentedSize += normalPage->payloadSize() - markedObjectSize;
+        if (canEvacuate) {
+            page->link(&m_firstCompactedPage);
+            compactedPageCount++;
+        } else {
+            page->link(&m_firstUnsweptPage);
+        }
+    }
+
+    // Moving the objects only pays off if it releases pages.
+    if (assignForwardingAddresses(nullptr) < compactedPageCount) {
+        assignForwardingAddresses(compact);
+    } else {
+        while (BasePage* page = m_firstCompactedPage) {
+            page->unlink(&m_firstCompactedPage);
+            page->link(&m_firstUnsweptPage);
+        }
+    }
+    return fragmentedSize;
+}
+
+size_t NormalPageHeap::assignForwardingAddresses(HeapCompact* compact)
+{
+    if (!m_firstCompactedPage)
+        return 0;
+    NormalPage* destinationPage = static_cast<NormalPage*>(m_firstCompactedPage);
+    Address destination = destinationPage->payload();
+    size_t filledPageCount = 0;
+    for (BasePage* page = m_firstCompactedPage; page; page = page->next()) {
+        NormalPage* normalPage = static_cast<NormalPage*>(page);
+        for (Address headerAddress = normalPage->payload(); headerAddress < normalPage->payloadEnd();) {
+            HeapObjectHeader* header = reinterpret_cast<HeapObjectHeader*>(headerAddress);
+            size_t size = header->size();
+            if (!header->isFree() && header->isMarked()) {
+                if (destination + size > destinationPage->payloadEnd()) {
+                    destinationPage = static_cast<NormalPage*>(destinationPage->next());
+                    destination = destinationPage->payload();
+                    filledPageCount++;
+                }
+                // An object is never moved to a later page or address.
+                ASSERT(destinationPage != normalPage || destination <= headerAddress);
+                if (compact)
+                    compact->setForwardingAddress(header->payload(), destination + sizeof(HeapObjectHeader));
+                destination += size;
+            }
+            headerAddress += size;
+        }
+    }
+    if (destination != destinationPage->payload())
+        filledPageCount++;
+    return filledPageCount;
+}
+
+size_t NormalPageHeap::compact(HeapCompact* compact)
+{
+    if (!m_firstCompactedPage)
+        return 0;
+    TRACE_EVENT0("blink_gc", "NormalPageHeap::compact");
+
+#if defined(ADDRESS_SANITIZER)
+    // Objects are moved over free list entries and dead objects.
+    for (BasePage* page = m_firstCompactedPage; page; page = page->next())
+        ASAN_UNPOISON_MEMORY_REGION(static_cast<NormalPage*>(page)->payload(), static_cast<NormalPage*>(page)->payloadSize());
+#endif
+
+    // The pages that objects are moved into are filled in the order of the
+    // compacted pages, so the page being filled is always the first one.
+    NormalPage* destinationPage = static_cast<NormalPage*>(m_firstCompactedPage);
+    Address destination = destinationPage->payload();
+    size_t markedObjectSize = 0;
+    size_t promptlyFreedSize = 0;
+    for (BasePage* page = m_firstCompactedPage; page; page = page->next()) {
+        NormalPage* normalPage = static_cast<NormalPage*>(page);
+        for (Address headerAddress = normalPage->payload(); headerAddress < normalPage->payloadEnd();) {
+            HeapObjectHeader* header = reinterpret_cast<HeapObjectHeader*>(headerAddress);
+            size_t size = header->size();
+            if (header->isFree()) {
+                if (header->isPromptlyFreed())
+                    promptlyFreedSize += size;
+                headerAddress += size;
+                continue;
+            }
+            ASSERT(header->checkHeader());
+            if (!header->isMarked()) {
+                header->finalize(header->payload(), size - sizeof(HeapObjectHeader));
+                headerAddress += size;
+                continue;
+            }
+            Address newHeaderAddress = compact->forwardingAddress(header->payload()) - sizeof(HeapObjectHeader);
+            if (!destinationPage->containedInObjectPayload(newHeaderAddress)) {
+                ASSERT(destinationPage != normalPage);
+                destinationPage->unlink(&m_firstCompactedPage);
+                finishCompactedPage(destinationPage, destination);
+                destinationPage = static_cast<NormalPage*>(m_firstCompactedPage);
+                destination = destinationPage->payload();
+            }
+            ASSERT(newHeaderAddress == destination);
+            if (newHeaderAddress != headerAddress)
+                memmove(newHeaderAddress, headerAddress, size);
+            reinterpret_cast<HeapObjectHeader*>(newHeaderAddress)->unmark();
+            destination += size;
+            markedObjectSize += size;
+            headerAddress += size;
+        }
+    }
+    if (destination != destinationPage->payload()) {
+        destinationPage->unlink(&m_firstCompactedPage);
+        finishCompactedPage(destinationPage, destination);
+    }
+
+    // The pages left are empty.
+    size_t freedSize = 0;
+    while (BasePage* page = m_firstCompactedPage) {
+        NormalPage* normalPage = static_cast<NormalPage*>(page);
+        page->unlink(&m_firstCompactedPage);
+        SET_MEMORY_INACCESSIBLE(normalPage->payload(), normalPage->payloadSize());
+        freedSize += normalPage->payloadSize();
+        page->removeFromHeap();
+    }
+
+    if (markedObjectSize)
+        Heap::increaseMarkedObjectSize(markedObjectSize);
+    decreasePromptlyFreedSize(promptlyFreedSize);
+    return freedSize;
+}
+
+void NormalPageHeap::finishCompactedPage(NormalPage* page, Address end)
+{
+    if (end != page->payloadEnd()) {
+        // Maintain the invariant that memory on the free list is zero filled.
+        SET_MEMORY_INACCESSIBLE(end, page->payloadEnd() - end);
+        addToFreeList(end, page->payloadEnd() - end);
+    }
+    page->invalidateObjectStartBitmap();
+    page->link(&m_firstPage);
+    page->markAsSwept();
+}
+
 void NormalPageHeap::setRemainingAllocationSize(size_t newRemainingAllocationSize)
 {
     m_remainingAllocationSize = newRemainingAllocationSize;
@@ -679,6 +1080,52 @@ void NormalPageHeap::updateRemainingAllocationSize()
     ASSERT(m_lastRemainingAllocationSize == remainingAllocationSize());
 }
 
+void NormalPageHeap::setSizeClassAllocationArea(size_t sizeClass, Address point, size_t size)
+{
+    size_t remainingSize = m_sizeClassRemainingAllocationSizes[sizeClass];
+    if (remainingSize) {
+        addToFreeList(m_sizeClassAllocationPoints[sizeClass], remainingSize);
+        Heap::decreaseAllocatedObjectSize(remainingSize);
+    }
+    m_sizeClassAllocationPoints[sizeClass] = point;
+    m_sizeClassRemainingAllocationSizes[sizeClass] = size;
+}
+
+void NormalPageHeap::clearSizeClassAllocationAreas()
+{
+    for (size_t i = 0; i < sizeClassCount; ++i)
+        setSizeClassAllocationArea(i, nullptr, 0);
+}
+
+Address NormalPageHeap::outOfLineAllocateSizeClassObject(size_t allocationSize, size_t gcInfoIndex)
+{
+    size_t sizeClass = FreeList::sizeClassIndexForSize(allocationSize);
+    ASSERT(allocationSize <= m_maxSizeClassAllocationSize);
+    ASSERT(allocationSize > m_sizeClassRemainingAllocationSizes[sizeClass]);
+    setSizeClassAllocationArea(sizeClass, nullptr, 0);
+
+    // 1. Reuse a free list entry of this size class, or of a larger one.
+    if (FreeListEntry* entry = m_freeList.takeSizeClassEntry(allocationSize)) {
+        Heap::increaseAllocatedObjectSize(entry->size());
+        setSizeClassAllocationArea(sizeClass, entry->address(), entry->size());
+        return allocateObject(allocationSize, gcInfoIndex);
+    }
+
+    // 2. Carve a new allocation area out of the current allocation area.
+    if (allocationSize <= remainingAllocationSize()) {
+        size_t areaSize = std::min(allocationSize * sizeClassAllocationAreaObjectCount, remainingAllocationSize());
+        Address area = currentAllocationPoint();
+        m_currentAllocationPoint += areaSize;
+        setRemainingAllocationSize(remainingAllocationSize() - areaSize);
+        setSizeClassAllocationArea(sizeClass, area, areaSize);
+        return allocateObject(allocationSize, gcInfoIndex);
+    }
+
+    // 3. Allocate the object from a new current allocation area, which the
+    // next allocation area of this size class will be carved out of.
+    return outOfLineAllocate(allocationSize, gcInfoIndex);
+}
+
 void NormalPageHeap::setAllocationPoint(Address point, size_t size)
 {
 #if ENABLE(ASSERT)
@@ -774,10 +1221,19 @@ Address NormalPageHeap::allocateFromFreeList(size_t allocationSize, size_t gcInf
             ASSERT(hasCurrentAllocationArea());
             ASSERT(remainingAllocationSize() >= allocationSize);
             m_freeList.m_biggestFreeListIndex = index;
-            return allocateObject(allocationSize, gcInfoIndex);
+            return allocateAtAllocationPoint(allocationSize, gcInfoIndex);
         }
     }
     m_freeList.m_biggestFreeListIndex = index;
+
+    // Small allocations can also be served by the entries that are too small
+    // to be put in the buckets.
+    if (allocationSize <= maxSizeClassAllocationSize) {
+        if (FreeListEntry* entry = m_freeList.takeSizeClassEntry(allocationSize)) {
+            setAllocationPoint(entry->address(), entry->size());
+            return allocateAtAllocationPoint(allocationSize, gcInfoIndex);
+        }
+    }
     return nullptr;
 }
 
@@ -906,6 +1362,7 @@ Address LargeObjectHeap::lazySweepPages(size_t allocationSize, size_t gcInfoInde
 FreeList::FreeList()
     : m_biggestFreeListIndex(0)
 {
+    clear();
 }
 
 void FreeList::addToFreeList(Address address, size_t size)
@@ -985,6 +1442,10 @@ void FreeList::addToFreeList(Address address, size_t size)
 #endif
     ASAN_POISON_MEMORY_REGION(address, size);
 
+    if (size <= maxSizeClassAllocationSize) {
+        entry->link(&m_sizeClassFreeLists[sizeClassIndexForSize(size)]);
+        return;
+    }
     int index = bucketIndexForSize(size);
     entry->link(&m_freeLists[index]);
     if (index > m_biggestFreeListIndex)
@@ -1016,6 +1477,42 @@ void FreeList::clear()
     m_biggestFreeListIndex = 0;
     for (size_t i = 0; i < blinkPageSizeLog2; ++i)
         m_freeLists[i] = nullptr;
+    for (size_t i = 0; i < sizeClassCount; ++i)
+        m_sizeClassFreeLists[i] = nullptr;
+}
+
+static void prependEntries(FreeListEntry** list, FreeListEntry* entries)
+{
+    if (!entries)
+        return;
+    FreeListEntry* last = entries;
+    while (last->next())
+        last = last->next();
+    last->append(*list);
+    *list = entries;
+}
+
+void FreeList::takeEntriesFrom(FreeList* other)
+{
+    for (size_t i = 0; i < blinkPageSizeLog2; ++i)
+        prependEntries(&m_freeLists[i], other->m_freeLists[i]);
+    for (size_t i = 0; i < sizeClassCount; ++i)
+        prependEntries(&m_sizeClassFreeLists[i], other->m_sizeClassFreeLists[i]);
+    if (other->m_biggestFreeListIndex > m_biggestFreeListIndex)
+        m_biggestFreeListIndex = other->m_biggestFreeListIndex;
+    other->clear();
+}
+
+FreeListEntry* FreeList::takeSizeClassEntry(size_t allocationSize)
+{
+    for (size_t i = sizeClassIndexForSize(allocationSize); i < sizeClassCount; ++i) {
+        FreeListEntry* entry = m_sizeClassFreeLists[i];
+        if (entry) {
+            entry->unlink(&m_sizeClassFreeLists[i]);
+            return entry;
+        }
+    }
+    return nullptr;
 }
 
 int FreeList::bucketIndexForSize(size_t size)
@@ -1031,10 +1528,22 @@ int FreeList::bucketIndexForSize(size_t size)
 
 bool FreeList::takeSnapshot(const String& dumpBaseName)
 {
+    // The entries of the size classes are reported in the buckets they
+    // would be in.
+    size_t sizeClassEntryCounts[blinkPageSizeLog2] = { 0 };
+    size_t sizeClassFreeSizes[blinkPageSizeLog2] = { 0 };
+    for (size_t i = 0; i < sizeClassCount; ++i) {
+        for (FreeListEntry* entry = m_sizeClassFreeLists[i]; entry; entry = entry->next()) {
+            int index = bucketIndexForSize(entry->size());
+            ++sizeClassEntryCounts[index];
+            sizeClassFreeSizes[index] += entry->size();
+        }
+    }
+
     bool didDumpBucketStats = false;
     for (size_t i = 0; i < blinkPageSizeLog2; ++i) {
-        size_t entryCount = 0;
-        size_t freeSize = 0;
+        size_t entryCount = sizeClassEntryCounts[i];
+        size_t freeSize = sizeClassFreeSizes[i];
         for (FreeListEntry* entry = m_freeLists[i]; entry; entry = entry->next()) {
             ++entryCount;
             freeSize += entry->size();
@@ -1105,9 +1614,11 @@ void NormalPage::removeFromHeap()
     heapForNormalPage()->freePage(this);
 }
 
-void NormalPage::sweep()
+template<typename FreeListType>
+size_t NormalPage::sweepInto(FreeListType* freeList)
 {
     size_t markedObjectSize = 0;
+    size_t promptlyFreedSize = 0;
     Address startOfGap = payload();
     for (Address headerAddress = startOfGap; headerAddress < payloadEnd(); ) {
         HeapObjectHeader* header = reinterpret_cast<HeapObjectHeader*>(headerAddress);
@@ -1115,7 +1626,7 @@ void NormalPage::sweep()
         ASSERT(header->size() < blinkPagePayloadSize());
 
         if (header->isPromptlyFreed())
-            heapForNormalPage()->decreasePromptlyFreedSize(header->size());
+            promptlyFreedSize += header->size();
         if (header->isFree()) {
             size_t size = header->size();
             // Zero the memory in the free list header to maintain the
@@ -1148,17 +1659,44 @@ void NormalPage::sweep()
             continue;
         }
         if (startOfGap != headerAddress)
-            heapForNormalPage()->addToFreeList(startOfGap, headerAddress - startOfGap);
+            freeList->addToFreeList(startOfGap, headerAddress - startOfGap);
         header->unmark();
         headerAddress += header->size();
         markedObjectSize += header->size();
         startOfGap = headerAddress;
     }
     if (startOfGap != payloadEnd())
-        heapForNormalPage()->addToFreeList(startOfGap, payloadEnd() - startOfGap);
+        freeList->addToFreeList(startOfGap, payloadEnd() - startOfGap);
 
     if (markedObjectSize)
         Heap::increaseMarkedObjectSize(markedObjectSize);
+    return promptlyFreedSize;
+}
+
+void NormalPage::sweep()
+{
+    NormalPageHeap* heap = heapForNormalPage();
+    heap->decreasePromptlyFreedSize(sweepInto(heap));
+}
+
+size_t NormalPage::sweepIntoFreeList(FreeList* freeList)
+{
+    return sweepInto(freeList);
+}
+
+bool NormalPage::hasFinalizableDeadObjects()
+{
+    for (Address headerAddress = payload(); headerAddress < payloadEnd();) {
+        HeapObjectHeader* header = reinterpret_cast<HeapObjectHeader*>(headerAddress);
+        ASSERT(header->size() < blinkPagePayloadSize());
+        if (!header->isFree()) {
+            ASSERT(header->checkHeader());
+            if (!header->isMarked() && Heap::gcInfo(header->gcInfoIndex())->hasFinalizer())
+                return true;
+        }
+        headerAddress += header->size();
+    }
+    return false;
 }
 
 void NormalPage::makeConsistentForGC()
@@ -1348,6 +1886,11 @@ void NormalPage::checkAndMarkPointer(Visitor* visitor, Address address)
     HeapObjectHeader* header = findHeaderFromAddress(address);
     if (!header || header->isDead())
         return;
+    // A conservatively found pointer can't be updated when the object
+    // moves.
+    HeapCompact* compact = heap()->threadState()->heapCompact();
+    if (compact->isCompacting() && HeapCompact::isCompactableHeap(heap()->heapIndex()))
+        compact->pinPage(this);
     markPointer(visitor, header);
 }
 
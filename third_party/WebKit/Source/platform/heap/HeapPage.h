@@ -77,6 +77,15 @@ const size_t maxHeapObjectSizeLog2 = 27;
 const size_t maxHeapObjectSize = 1 << maxHeapObjectSizeLog2;
 const size_t largeObjectSizeThreshold = blinkPageSize / 2;
 
+// Allocations of up to maxSizeClassAllocationSize bytes (header included) are
+// segregated by size. Each size class has its own free list and its own
+// allocation area that only holds objects of that size.
+const size_t maxSizeClassAllocationSize = 256;
+const size_t sizeClassCount = maxSizeClassAllocationSize / allocationGranularity;
+// The number of objects that an allocation area of a size class is carved out
+// for at a time.
+const size_t sizeClassAllocationAreaObjectCount = 32;
+
 // A zap value used for freed memory that is allowed to be added to the free
 // list in the next addToFreeList().
 const uint8_t reuseAllowedZapValue = 0x2a;
@@ -123,7 +132,9 @@ const uint8_t reuseForbiddenZapValue = 0x2c;
 #endif
 
 class CallbackStack;
+class FreeList;
 class FreePagePool;
+class HeapCompact;
 class NormalPageHeap;
 class OrphanedPagePool;
 class PageMemory;
@@ -206,6 +217,9 @@ public:
     }
     bool isMarked() const;
     void mark();
+    // Atomically sets the mark bit. Returns false if the header had
+    // already been marked, possibly by another marker thread.
+    bool tryMark();
     void unmark();
     void markDead();
     bool isDead() const;
@@ -465,6 +479,14 @@ public:
     void checkAndMarkPointer(Visitor*, Address) override;
     void markOrphaned() override;
 
+    // Returns true if the page has unmarked objects with a finalizer.
+    bool hasFinalizableDeadObjects();
+    // Sweeps the page into |freeList| instead of the free list of the heap
+    // and returns the size of the promptly freed objects that were swept.
+    // The heap is not touched, so this can run on the sweeper thread for
+    // pages without finalizable dead objects.
+    size_t sweepIntoFreeList(FreeList*);
+
     void takeSnapshot(String dumpBaseName, size_t pageIndex, ThreadState::GCSnapshotInfo&, size_t* outFreeSize, size_t* outFreeCount) override;
 #if ENABLE(ASSERT)
     // Returns true for the whole blinkPageSize page that the page is on, even
@@ -487,6 +509,8 @@ public:
 private:
     HeapObjectHeader* findHeaderFromAddress(Address);
     void populateObjectStartBitMap();
+    template<typename FreeListType>
+    size_t sweepInto(FreeListType*);
 
     bool m_objectStartBitMapComputed;
     uint8_t m_objectStartBitMap[reservedForObjectBitMap];
@@ -616,11 +640,26 @@ public:
 
     void addToFreeList(Address, size_t);
     void clear();
+    // Moves all entries of |other| to this free list.
+    void takeEntriesFrom(FreeList* other);
 
     // Returns a bucket number for inserting a FreeListEntry of a given size.
     // All FreeListEntries in the given bucket, n, have size >= 2^n.
     static int bucketIndexForSize(size_t);
 
+    // Returns the size class of an allocation or a FreeListEntry of a given
+    // size, which must be at most maxSizeClassAllocationSize.
+    static size_t sizeClassIndexForSize(size_t size)
+    {
+        ASSERT(size && size <= maxSizeClassAllocationSize);
+        ASSERT(!(size & allocationMask));
+        return size / allocationGranularity - 1;
+    }
+
+    // Unlinks and returns an entry of the size class of |allocationSize|, or
+    // of the smallest larger size class that has one.
+    FreeListEntry* takeSizeClassEntry(size_t allocationSize);
+
     // Returns true if the freelist snapshot is captured.
     bool takeSnapshot(const String& dumpBaseName);
 
@@ -635,6 +674,10 @@ private:
     // All FreeListEntries in the nth list have size >= 2^n.
     FreeListEntry* m_freeLists[blinkPageSizeLog2];
 
+    // FreeListEntries of up to maxSizeClassAllocationSize bytes, which are not
+    // put in the buckets above. The nth list has the entries of size class n.
+    FreeListEntry* m_sizeClassFreeLists[sizeClassCount];
+
     friend class NormalPageHeap;
 };
 
@@ -659,6 +702,10 @@ public:
     virtual void clearFreeLists() { }
     void makeConsistentForGC();
     void makeConsistentForMutator();
+    // Prepares the swept pages of the heap for a step of incremental
+    // marking, which needs to find objects from addresses while keeping
+    // the free lists of the heap.
+    virtual void makeConsistentForIncrementalMarking();
 #if ENABLE(ASSERT)
     virtual bool isConsistentForGC() = 0;
 #endif
@@ -675,6 +722,14 @@ public:
     bool lazySweepWithDeadline(double deadlineSeconds);
     void completeSweep();
 
+    // Returns true while pages of this heap are queued for, or are being
+    // swept by, the sweeper thread and have not been handed back yet.
+    virtual bool isSweepingConcurrently() const { return false; }
+    // Sweeps the queued pages on the calling thread and waits for the
+    // sweeper thread to finish the pages it has started on. The page lists
+    // of the heap are left untouched.
+    virtual void waitForConcurrentSweep() { }
+
     ThreadState* threadState() { return m_threadState; }
     int heapIndex() const { return m_index; }
 
@@ -684,6 +739,8 @@ protected:
 
 private:
     virtual Address lazySweepPages(size_t, size_t gcInfoIndex) = 0;
+    // Hands the pages swept by the sweeper thread back to the heap.
+    virtual void collectConcurrentlySweptPages() { }
 
     ThreadState* m_threadState;
 
@@ -702,6 +759,7 @@ public:
         m_freeList.addToFreeList(address, size);
     }
     void clearFreeLists() override;
+    void makeConsistentForIncrementalMarking() override;
 #if ENABLE(ASSERT)
     bool isConsistentForGC() override;
     bool pagesToBeSweptContains(Address);
@@ -710,6 +768,12 @@ public:
 
     Address allocateObject(size_t allocationSize, size_t gcInfoIndex);
 
+    // Size class allocation is enabled for all heaps but the collection
+    // backing heaps, which rather expand and shrink backings in place at the
+    // allocation point.
+    void setSizeClassAllocationEnabled(bool);
+    bool isSizeClassAllocationEnabled() const { return m_maxSizeClassAllocationSize > 0; }
+
     void freePage(NormalPage*);
 
     bool coalesce();
@@ -723,12 +787,44 @@ public:
         return header->payloadEnd() == m_currentAllocationPoint;
     }
 
+    // Queues the unswept pages for the sweeper thread. Pages with
+    // finalizable dead objects are handed back unswept.
+    void scheduleConcurrentSweep();
+    bool isSweepingConcurrently() const override { return m_isSweepingConcurrently; }
+    void waitForConcurrentSweep() override;
+
+    // Sweeps a page queued on |heap|, or on any heap if |heap| is null.
+    // Returns false if there was no queued page.
+    static bool sweepConcurrentPage(NormalPageHeap*);
+    static void sweepOnSweeperThread();
+
+    // Heap compaction (see HeapCompact). planCompaction() takes the unswept
+    // pages whose live objects can all be moved, if moving them releases
+    // any page, and assigns the live objects their new addresses. Returns
+    // the free space on the unswept pages.
+    size_t planCompaction(HeapCompact*);
+    // Moves the live objects of the pages taken by planCompaction(),
+    // finalizes the dead ones and releases the pages left empty. Returns
+    // the payload size of the released pages.
+    size_t compact(HeapCompact*);
+
 private:
     void allocatePage();
+    Address allocateAtAllocationPoint(size_t allocationSize, size_t gcInfoIndex);
     Address outOfLineAllocate(size_t allocationSize, size_t gcInfoIndex);
     Address allocateFromFreeList(size_t, size_t gcInfoIndex);
+    Address initializeObject(Address headerAddress, size_t allocationSize, size_t gcInfoIndex);
+
+    // Refills the allocation area of the size class of |allocationSize| and
+    // allocates from it.
+    Address outOfLineAllocateSizeClassObject(size_t allocationSize, size_t gcInfoIndex);
+    // Returns what is left of the allocation area of |sizeClass| to the free
+    // list and makes [point, point + size) its new allocation area.
+    void setSizeClassAllocationArea(size_t sizeClass, Address point, size_t size);
+    void clearSizeClassAllocationAreas();
 
     Address lazySweepPages(size_t, size_t gcInfoIndex) override;
+    void collectConcurrentlySweptPages() override;
 
     Address currentAllocationPoint() const { return m_currentAllocationPoint; }
     bool hasCurrentAllocationArea() const { return currentAllocationPoint() && remainingAllocationSize(); }
@@ -738,13 +834,43 @@ private:
     void setRemainingAllocationSize(size_t);
     void updateRemainingAllocationSize();
 
+    // Returns the number of compacted pages that the live objects on them
+    // fill once moved, and records their new addresses in |compact| unless
+    // it is null.
+    size_t assignForwardingAddresses(HeapCompact*);
+    // Adds the end of a page that objects have been moved into to the free
+    // list and links the page as swept.
+    void finishCompactedPage(NormalPage*, Address end);
+
     FreeList m_freeList;
     Address m_currentAllocationPoint;
     size_t m_remainingAllocationSize;
     size_t m_lastRemainingAllocationSize;
 
+    // Allocations of up to this size are served from the allocation areas
+    // of their size class. Zero if size class allocation is disabled. The
+    // areas are accounted as allocated objects as a whole when they are set
+    // up, rather than object by object.
+    size_t m_maxSizeClassAllocationSize;
+    Address m_sizeClassAllocationPoints[sizeClassCount];
+    size_t m_sizeClassRemainingAllocationSizes[sizeClassCount];
+
     // The size of promptly freed objects in the heap.
     size_t m_promptlyFreedSize;
+
+    // Only accessed by the thread owning the heap.
+    bool m_isSweepingConcurrently;
+
+    // The following members are guarded by the concurrent sweeping mutex.
+    BasePage* m_firstConcurrentSweepPage;
+    BasePage* m_firstConcurrentlySweptPage;
+    BasePage* m_firstDeferredConcurrentSweepPage;
+    size_t m_concurrentSweepPagesInProgress;
+    FreeList m_concurrentFreeList;
+    size_t m_concurrentPromptlyFreedSize;
+
+    // The pages being compacted, between planCompaction() and compact().
+    BasePage* m_firstCompactedPage;
 };
 
 class LargeObjectHeap final : public BaseHeap {
@@ -837,6 +963,14 @@ void HeapObjectHeader::mark()
     m_encoded = m_encoded | headerMarkBitMask;
 }
 
+NO_SANITIZE_ADDRESS inline
+bool HeapObjectHeader::tryMark()
+{
+    ASSERT(checkHeader());
+    static_assert(sizeof(m_encoded) == sizeof(unsigned), "m_encoded must be usable with atomicOr");
+    return !(atomicOr(reinterpret_cast<volatile unsigned*>(&m_encoded), static_cast<unsigned>(headerMarkBitMask)) & headerMarkBitMask);
+}
+
 NO_SANITIZE_ADDRESS inline
 void HeapObjectHeader::unmark()
 {
@@ -860,24 +994,44 @@ void HeapObjectHeader::markDead()
     m_encoded |= headerDeadBitMask;
 }
 
-inline Address NormalPageHeap::allocateObject(size_t allocationSize, size_t gcInfoIndex)
+inline Address NormalPageHeap::initializeObject(Address headerAddress, size_t allocationSize, size_t gcInfoIndex)
+{
+    ASSERT(gcInfoIndex > 0);
+    new (NotNull, headerAddress) HeapObjectHeader(allocationSize, gcInfoIndex);
+    Address result = headerAddress + sizeof(HeapObjectHeader);
+    ASSERT(!(reinterpret_cast<uintptr_t>(result) & allocationMask));
+
+    SET_MEMORY_ACCESSIBLE(result, allocationSize - sizeof(HeapObjectHeader));
+    ASSERT(findPageFromAddress(headerAddress + allocationSize - 1));
+    return result;
+}
+
+inline Address NormalPageHeap::allocateAtAllocationPoint(size_t allocationSize, size_t gcInfoIndex)
 {
     if (LIKELY(allocationSize <= m_remainingAllocationSize)) {
         Address headerAddress = m_currentAllocationPoint;
         m_currentAllocationPoint += allocationSize;
         m_remainingAllocationSize -= allocationSize;
-        ASSERT(gcInfoIndex > 0);
-        new (NotNull, headerAddress) HeapObjectHeader(allocationSize, gcInfoIndex);
-        Address result = headerAddress + sizeof(HeapObjectHeader);
-        ASSERT(!(reinterpret_cast<uintptr_t>(result) & allocationMask));
-
-        SET_MEMORY_ACCESSIBLE(result, allocationSize - sizeof(HeapObjectHeader));
-        ASSERT(findPageFromAddress(headerAddress + allocationSize - 1));
-        return result;
+        return initializeObject(headerAddress, allocationSize, gcInfoIndex);
     }
     return outOfLineAllocate(allocationSize, gcInfoIndex);
 }
 
+inline Address NormalPageHeap::allocateObject(size_t allocationSize, size_t gcInfoIndex)
+{
+    if (allocationSize <= m_maxSizeClassAllocationSize) {
+        size_t sizeClass = FreeList::sizeClassIndexForSize(allocationSize);
+        if (LIKELY(allocationSize <= m_sizeClassRemainingAllocationSizes[sizeClass])) {
+            Address headerAddress = m_sizeClassAllocationPoints[sizeClass];
+            m_sizeClassAllocationPoints[sizeClass] += allocationSize;
+            m_sizeClassRemainingAllocationSizes[sizeClass] -= allocationSize;
+            return initializeObject(headerAddress, allocationSize, gcInfoIndex);
+        }
+        return outOfLineAllocateSizeClassObject(allocationSize, gcInfoIndex);
+    }
+    return allocateAtAllocationPoint(allocationSize, gcInfoIndex);
+}
+
 } // namespace blink
 
 #endif // HeapPage_h
@@ -0,0 +1,112 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include "platform/heap/Handle.h"
+#include "platform/heap/Heap.h"
+#include "platform/heap/HeapPage.h"
+#include "platform/heap/ThreadState.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "wtf/CurrentTime.h"
+
+namespace blink {
+
+namespace {
+
+// Allocates objects the size of typical DOM nodes on the Node heap, the way
+// HTMLConstructionSite does while building a document.
+template<size_t payloadSize>
+class NodeSizedObject : public GarbageCollected<NodeSizedObject<payloadSize>> {
+public:
+    GC_PLUGIN_IGNORE("crbug.com/443854")
+    void* operator new(size_t size)
+    {
+        ThreadState* state = ThreadState::current();
+        return Heap::allocateOnHeapIndex(state, size, BlinkGC::NodeHeapIndex, GCInfoTrait<NodeSizedObject>::index());
+    }
+
+    static NodeSizedObject* create()
+    {
+        return new NodeSizedObject;
+    }
+
+    DEFINE_INLINE_TRACE() { }
+
+private:
+    NodeSizedObject() { }
+
+    char m_data[payloadSize];
+};
+
+// A survivor of a round of allocations, which keeps the pages fragmented
+// for the next round.
+class Survivor : public GarbageCollected<Survivor> {
+public:
+    GC_PLUGIN_IGNORE("crbug.com/443854")
+    void* operator new(size_t size)
+    {
+        ThreadState* state = ThreadState::current();
+        return Heap::allocateOnHeapIndex(state, size, BlinkGC::NodeHeapIndex, GCInfoTrait<Survivor>::index());
+    }
+
+    static Survivor* create(Survivor* next)
+    {
+        return new Survivor(next);
+    }
+
+    DEFINE_INLINE_TRACE() { visitor->trace(m_next); }
+
+private:
+    explicit Survivor(Survivor* next)
+        : m_next(next)
+    {
+    }
+
+    Member<Survivor> m_next;
+    char m_data[64];
+};
+
+const int allocationRounds = 20;
+const size_t allocationsPerRound = 200000;
+
+double measureAllocationsPerSecond(bool sizeClassAllocation)
+{
+    NormalPageHeap* heap = static_cast<NormalPageHeap*>(ThreadState::current()->heap(BlinkGC::NodeHeapIndex));
+    heap->setSizeClassAllocationEnabled(sizeClassAllocation);
+
+    Persistent<Survivor> survivors;
+    double allocationTime = 0;
+    for (int round = 0; round < allocationRounds; ++round) {
+        // The survivors of the previous round only die in the next GC.
+        survivors.clear();
+        double startTime = WTF::monotonicallyIncreasingTime();
+        for (size_t i = 0; i < allocationsPerRound; i += 4) {
+            NodeSizedObject<64>::create();
+            NodeSizedObject<96>::create();
+            NodeSizedObject<136>::create();
+            survivors = Survivor::create(survivors);
+        }
+        allocationTime += WTF::monotonicallyIncreasingTime() - startTime;
+        Heap::collectGarbage(BlinkGC::NoHeapPointersOnStack, BlinkGC::GCWithSweep, BlinkGC::ForcedGC);
+    }
+    survivors.clear();
+    Heap::collectGarbage(BlinkGC::NoHeapPointersOnStack, BlinkGC::GCWithSweep, BlinkGC::ForcedGC);
+
+    heap->setSizeClassAllocationEnabled(true);
+    return allocationRounds * allocationsPerRound / allocationTime;
+}
+
+} // namespace
+
+TEST(HeapPerfTest, AllocateNodeSizedObjects)
+{
+    double freeListAllocationsPerSecond = measureAllocationsPerSecond(false);
+    double sizeClassAllocationsPerSecond = measureAllocationsPerSecond(true);
+    perf_test::PrintResult("node_sized_allocations", "", "free_list", freeListAllocationsPerSecond, "allocations/s", true);
+    perf_test::PrintResult("node_sized_allocations", "", "size_classes", sizeClassAllocationsPerSecond, "allocations/s", true);
+}
+
+} // namespace blink
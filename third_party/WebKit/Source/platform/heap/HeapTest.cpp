@@ -34,6 +34,7 @@
 #include "platform/ThreadSafeFunctional.h"
 #include "platform/heap/Handle.h"
 #include "platform/heap/Heap.h"
+#include "platform/heap/HeapCompact.h"
 #include "platform/heap/HeapLinkedStack.h"
 #include "platform/heap/HeapTerminatedArrayBuilder.h"
 #include "platform/heap/SafePoint.h"
@@ -6531,4 +6532,402 @@ TEST(HeapTest, TestPersistentHeapVectorWithUnusedSlots)
 #endif
 }
 
+class MarkingGraphNode : public GarbageCollected<MarkingGraphNode> {
+public:
+    static MarkingGraphNode* create(int id) { return new MarkingGraphNode(id); }
+
+    DEFINE_INLINE_TRACE()
+    {
+        visitor->trace(m_edges);
+        visitor->trace(m_ephemerons);
+    }
+
+    int id() const { return m_id; }
+    HeapVector<Member<MarkingGraphNode>>& edges() { return m_edges; }
+    HeapHashMap<WeakMember<MarkingGraphNode>, Member<MarkingGraphNode>>& ephemerons() { return m_ephemerons; }
+
+private:
+    explicit MarkingGraphNode(int id) : m_id(id) { }
+
+    int m_id;
+    HeapVector<Member<MarkingGraphNode>> m_edges;
+    HeapHashMap<WeakMember<MarkingGraphNode>, Member<MarkingGraphNode>> m_ephemerons;
+};
+
+// Builds a random object graph from |seed|, collects garbage and returns the
+// sorted ids of the nodes that survived.
+static Vector<int> survivorsOfRandomGraph(uint32_t seed, int nodeCount)
+{
+    Persistent<HeapHashSet<WeakMember<MarkingGraphNode>>> allNodes = new HeapHashSet<WeakMember<MarkingGraphNode>>;
+    Persistent<HeapVector<Member<MarkingGraphNode>>> roots = new HeapVector<Member<MarkingGraphNode>>;
+    {
+        HeapVector<Member<MarkingGraphNode>> nodes;
+        for (int i = 0; i < nodeCount; ++i) {
+            nodes.append(MarkingGraphNode::create(i));
+            allNodes->add(nodes.last());
+        }
+        uint32_t random = seed;
+        for (int i = 0; i < nodeCount; ++i) {
+            MarkingGraphNode* node = nodes[i];
+            random = random * 1103515245 + 12345;
+            int edgeCount = (random >> 16) % 4;
+            for (int j = 0; j < edgeCount; ++j) {
+                random = random * 1103515245 + 12345;
+                node->edges().append(nodes[(random >> 8) % nodeCount]);
+            }
+            random = random * 1103515245 + 12345;
+            if (!((random >> 16) % 8)) {
+                random = random * 1103515245 + 12345;
+                MarkingGraphNode* key = nodes[(random >> 8) % nodeCount];
+                random = random * 1103515245 + 12345;
+                node->ephemerons().add(key, nodes[(random >> 8) % nodeCount]);
+            }
+            random = random * 1103515245 + 12345;
+            if (!((random >> 16) % 64))
+                roots->append(node);
+        }
+    }
+    preciselyCollectGarbage();
+
+    Vector<int> survivors;
+    for (MarkingGraphNode* node : *allNodes)
+        survivors.append(node->id());
+    std::sort(survivors.begin(), survivors.end());
+    return survivors;
+}
+
+TEST(HeapTest, ParallelMarkingMatchesSerialMarking)
+{
+    const int nodeCount = 20000;
+    for (uint32_t seed = 1; seed <= 8; ++seed) {
+        clearOutOldGarbage();
+        Vector<int> serialSurvivors = survivorsOfRandomGraph(seed, nodeCount);
+
+        clearOutOldGarbage();
+        Heap::enableParallelMarking(3);
+        Vector<int> parallelSurvivors = survivorsOfRandomGraph(seed, nodeCount);
+        Heap::disableParallelMarking();
+
+        EXPECT_GT(serialSurvivors.size(), 0u);
+        EXPECT_LT(serialSurvivors.size(), static_cast<size_t>(nodeCount));
+        EXPECT_EQ(serialSurvivors, parallelSurvivors);
+    }
+}
+
+TEST(HeapTest, ParallelMarkingStress)
+{
+    // A long chain plus a wide fan-out makes marker threads repeatedly run
+    // dry and share work with each other.
+    Heap::enableParallelMarking(7);
+    Persistent<MarkingGraphNode> root = MarkingGraphNode::create(0);
+    {
+        MarkingGraphNode* tail = root;
+        for (int i = 1; i < 50000; ++i) {
+            MarkingGraphNode* node = MarkingGraphNode::create(i);
+            tail->edges().append(node);
+            if (!(i % 100)) {
+                for (int j = 0; j < 100; ++j)
+                    node->edges().append(MarkingGraphNode::create(-1));
+            }
+            tail = node;
+        }
+    }
+    for (int i = 0; i < 10; ++i) {
+        conservativelyCollectGarbage();
+        preciselyCollectGarbage();
+    }
+    Heap::disableParallelMarking();
+
+    size_t chainLength = 0;
+    size_t fanOutNodes = 0;
+    for (MarkingGraphNode* node = root; node; ) {
+        ++chainLength;
+        MarkingGraphNode* next = nullptr;
+        for (MarkingGraphNode* edge : node->edges()) {
+            if (edge->id() == -1)
+                ++fanOutNodes;
+            else
+                next = edge;
+        }
+        node = next;
+    }
+    EXPECT_EQ(50000u, chainLength);
+    EXPECT_EQ(499u * 100, fanOutNodes);
+}
+
+class ConcurrentlySweptObject : public GarbageCollected<ConcurrentlySweptObject> {
+public:
+    static ConcurrentlySweptObject* create(int value) { return new ConcurrentlySweptObject(value); }
+    DEFINE_INLINE_TRACE() { }
+    int value() const { return m_value; }
+
+private:
+    explicit ConcurrentlySweptObject(int value) : m_value(value) { }
+    int m_value;
+};
+
+TEST(HeapTest, ConcurrentSweeping)
+{
+    clearOutOldGarbage();
+    Heap::enableConcurrentSweeping();
+    SimpleFinalizedObject::s_destructorCalls = 0;
+
+    Persistent<HeapVector<Member<ConcurrentlySweptObject>>> survivors = new HeapVector<Member<ConcurrentlySweptObject>>();
+    for (int i = 0; i < 20000; i++) {
+        ConcurrentlySweptObject* object = ConcurrentlySweptObject::create(i);
+        if (!(i % 3))
+            survivors->append(object);
+        if (!(i % 2))
+            SimpleFinalizedObject::create();
+    }
+    Heap::collectGarbage(BlinkGC::NoHeapPointersOnStack, BlinkGC::GCWithoutSweep, BlinkGC::ForcedGC);
+    // Finalizers are still left to the lazy sweeping of this thread.
+    EXPECT_EQ(0, SimpleFinalizedObject::s_destructorCalls);
+
+    // Reuse the memory freed by the sweeper thread.
+    for (int i = 0; i < 20000; i++)
+        ConcurrentlySweptObject::create(-1);
+    for (size_t i = 0; i < survivors->size(); i++)
+        EXPECT_EQ(static_cast<int>(i * 3), survivors->at(i)->value());
+
+    preciselyCollectGarbage();
+    EXPECT_EQ(10000, SimpleFinalizedObject::s_destructorCalls);
+    for (size_t i = 0; i < survivors->size(); i++)
+        EXPECT_EQ(static_cast<int>(i * 3), survivors->at(i)->value());
+    Heap::disableConcurrentSweeping();
+}
+
+
+class IncrementallyMarkedHolder : public GarbageCollected<IncrementallyMarkedHolder> {
+public:
+    static IncrementallyMarkedHolder* create() { return new IncrementallyMarkedHolder(); }
+    DEFINE_INLINE_TRACE()
+    {
+        visitor->trace(m_member);
+        visitor->trace(m_vector);
+        visitor->trace(m_set);
+    }
+
+    Member<IntWrapper> m_member;
+    HeapVector<Member<IntWrapper>> m_vector;
+    HeapHashSet<Member<IntWrapper>> m_set;
+};
+
+TEST(HeapTest, IncrementalMarking)
+{
+    clearOutOldGarbage();
+    Heap::enableIncrementalMarking();
+    IntWrapper::s_destructorCalls = 0;
+
+    Persistent<IncrementallyMarkedHolder> holder = IncrementallyMarkedHolder::create();
+    holder->m_member = IntWrapper::create(-1);
+    EXPECT_TRUE(Heap::startIncrementalMarking());
+    EXPECT_TRUE(Heap::isIncrementalMarkingInProgress());
+    while (!Heap::incrementalMarkingStep(0)) { }
+
+    // The holder has been traced already. Objects stored into it from now on
+    // must be kept alive by the write barriers.
+    holder->m_member = IntWrapper::create(0);
+    for (int i = 1; i <= 100; i++) {
+        holder->m_vector.append(IntWrapper::create(i));
+        holder->m_set.add(IntWrapper::create(i));
+    }
+    preciselyCollectGarbage();
+    EXPECT_FALSE(Heap::isIncrementalMarkingInProgress());
+    // The object overwritten after it was marked survives as floating garbage.
+    EXPECT_EQ(0, IntWrapper::s_destructorCalls);
+    EXPECT_EQ(0, holder->m_member->value());
+    EXPECT_EQ(100u, holder->m_vector.size());
+    EXPECT_EQ(100u, holder->m_set.size());
+    for (int i = 1; i <= 100; i++)
+        EXPECT_EQ(i, holder->m_vector[i - 1]->value());
+
+    preciselyCollectGarbage();
+    EXPECT_EQ(1, IntWrapper::s_destructorCalls);
+    Heap::disableIncrementalMarking();
+}
+
+
+class CompactedBackingsHolder : public GarbageCollected<CompactedBackingsHolder> {
+public:
+    static CompactedBackingsHolder* create(int base)
+    {
+        CompactedBackingsHolder* holder = new CompactedBackingsHolder();
+        for (int i = 0; i < 10; i++) {
+            holder->m_vector.append(IntWrapper::create(base + i));
+            holder->m_map.add(base + i, IntWrapper::create(base + i));
+            holder->m_linkedSet.add(IntWrapper::create(base + i));
+        }
+        return holder;
+    }
+
+    DEFINE_INLINE_TRACE()
+    {
+        visitor->trace(m_vector);
+        visitor->trace(m_map);
+        visitor->trace(m_linkedSet);
+    }
+
+    void check(int base)
+    {
+        EXPECT_EQ(10u, m_vector.size());
+        EXPECT_EQ(10u, m_map.size());
+        EXPECT_EQ(10u, m_linkedSet.size());
+        int value = base;
+        for (IntWrapper* wrapper : m_linkedSet)
+            EXPECT_EQ(value++, wrapper->value());
+        for (int i = 0; i < 10; i++) {
+            EXPECT_EQ(base + i, m_vector[i]->value());
+            EXPECT_EQ(base + i, m_map.get(base + i)->value());
+        }
+    }
+
+    void clear()
+    {
+        m_vector.clear();
+        m_map.clear();
+        m_linkedSet.clear();
+    }
+
+private:
+    HeapVector<Member<IntWrapper>> m_vector;
+    HeapHashMap<int, Member<IntWrapper>> m_map;
+    HeapLinkedHashSet<Member<IntWrapper>> m_linkedSet;
+};
+
+TEST(HeapTest, CompactCollectionBackings)
+{
+    clearOutOldGarbage();
+    Heap::enableHeapCompaction();
+
+    Persistent<HeapVector<Member<CompactedBackingsHolder>>> holders = new HeapVector<Member<CompactedBackingsHolder>>();
+    for (int i = 0; i < 5000; i++)
+        holders->append(CompactedBackingsHolder::create(i * 10));
+    preciselyCollectGarbage();
+
+    // Leave every tenth holder alive, spread over the backing pages.
+    Persistent<HeapVector<Member<CompactedBackingsHolder>>> survivors = new HeapVector<Member<CompactedBackingsHolder>>();
+    for (size_t i = 0; i < holders->size(); i += 10)
+        survivors->append(holders->at(i));
+    holders.clear();
+    size_t allocatedSpace = Heap::allocatedSpace();
+    preciselyCollectGarbage();
+    EXPECT_GT(HeapCompact::compactionFreedSize(), 0u);
+    EXPECT_LT(HeapCompact::fragmentedSizeAfterCompaction(), HeapCompact::fragmentedSizeBeforeCompaction());
+    EXPECT_LT(Heap::allocatedSpace(), allocatedSpace);
+
+    for (size_t i = 0; i < survivors->size(); i++)
+        survivors->at(i)->check(i * 100);
+
+    // The moved backings can still be resized and freed.
+    for (size_t i = 0; i < survivors->size(); i++)
+        survivors->at(i)->clear();
+    survivors->append(CompactedBackingsHolder::create(-10));
+    preciselyCollectGarbage();
+    survivors->last()->check(-10);
+    Heap::disableHeapCompaction();
+}
+
+class PersistentVectorOwner {
+    USING_FAST_MALLOC(PersistentVectorOwner);
+public:
+    PersistentVectorOwner()
+    {
+        for (int i = 0; i < 10; i++)
+            m_vector.append(IntWrapper::create(i));
+    }
+
+private:
+    PersistentHeapVector<Member<IntWrapper>> m_vector;
+};
+
+// Destroys a persistent collection, whose backing slot has been traced as
+// a root, after marking and before the heap is compacted.
+class PersistentVectorOwnerDisposer : public GarbageCollectedFinalized<PersistentVectorOwnerDisposer> {
+    USING_PRE_FINALIZER(PersistentVectorOwnerDisposer, dispose);
+public:
+    static PersistentVectorOwnerDisposer* create() { return new PersistentVectorOwnerDisposer(); }
+    DEFINE_INLINE_TRACE() { }
+    void dispose() { m_owner.clear(); }
+
+private:
+    PersistentVectorOwnerDisposer()
+        : m_owner(adoptPtr(new PersistentVectorOwner))
+    {
+        ThreadState::current()->registerPreFinalizer(this);
+    }
+
+    OwnPtr<PersistentVectorOwner> m_owner;
+};
+
+TEST(HeapTest, CompactWithPersistentCollectionFreedByPreFinalizer)
+{
+    clearOutOldGarbage();
+    Heap::enableHeapCompaction();
+
+    Persistent<HeapVector<Member<CompactedBackingsHolder>>> holders = new HeapVector<Member<CompactedBackingsHolder>>();
+    for (int i = 0; i < 5000; i++) {
+        holders->append(CompactedBackingsHolder::create(i * 10));
+        if (!(i % 50))
+            PersistentVectorOwnerDisposer::create();
+    }
+    PersistentHeapVector<Member<IntWrapper>> persistentVector;
+    for (int i = 0; i < 10; i++)
+        persistentVector.append(IntWrapper::create(i));
+
+    Persistent<HeapVector<Member<CompactedBackingsHolder>>> survivors = new HeapVector<Member<CompactedBackingsHolder>>();
+    for (size_t i = 0; i < holders->size(); i += 10)
+        survivors->append(holders->at(i));
+    holders.clear();
+    preciselyCollectGarbage();
+    EXPECT_GT(HeapCompact::compactionFreedSize(), 0u);
+
+    for (size_t i = 0; i < survivors->size(); i++)
+        survivors->at(i)->check(i * 100);
+    ASSERT_EQ(10u, persistentVector.size());
+    for (int i = 0; i < 10; i++)
+        EXPECT_EQ(i, persistentVector[i]->value());
+    Heap::disableHeapCompaction();
+}
+
+static size_t countAdjacentIntWrappers(NormalPageHeap* heap, bool sizeClassAllocation)
+{
+    heap->setSizeClassAllocationEnabled(sizeClassAllocation);
+    Persistent<HeapVector<Member<IntWrapper>>> wrappers = new HeapVector<Member<IntWrapper>>();
+    Persistent<HeapVector<Member<DynamicallySizedObject>>> others = new HeapVector<Member<DynamicallySizedObject>>();
+    wrappers->reserveCapacity(10);
+    others->reserveCapacity(10);
+    for (int i = 0; i < 10; i++) {
+        wrappers->append(IntWrapper::create(i));
+        others->append(DynamicallySizedObject::create(24));
+    }
+    size_t allocationSize = Heap::allocationSizeFromSize(sizeof(IntWrapper));
+    size_t adjacentCount = 0;
+    for (size_t i = 1; i < wrappers->size(); i++) {
+        if (reinterpret_cast<Address>(wrappers->at(i - 1).get()) + allocationSize == reinterpret_cast<Address>(wrappers->at(i).get()))
+            adjacentCount++;
+    }
+    heap->setSizeClassAllocationEnabled(true);
+    return adjacentCount;
+}
+
+TEST(HeapTest, SizeClassAllocation)
+{
+    clearOutOldGarbage();
+    // IntWrappers and 24 byte DynamicallySizedObjects share the heap of the
+    // objects smaller than 32 bytes.
+    NormalPageHeap* heap = static_cast<NormalPageHeap*>(ThreadState::current()->heap(BlinkGC::NormalPage1HeapIndex));
+    EXPECT_TRUE(heap->isSizeClassAllocationEnabled());
+
+    // Objects of a size class are allocated next to each other, whatever is
+    // allocated in between.
+    EXPECT_GE(countAdjacentIntWrappers(heap, true), 7u);
+    EXPECT_EQ(0u, countAdjacentIntWrappers(heap, false));
+    clearOutOldGarbage();
+
+    // The backing heaps allocate at a single allocation point.
+    EXPECT_FALSE(static_cast<NormalPageHeap*>(ThreadState::current()->heap(BlinkGC::Vector1HeapIndex))->isSizeClassAllocationEnabled());
+    EXPECT_FALSE(static_cast<NormalPageHeap*>(ThreadState::current()->heap(BlinkGC::HashTableHeapIndex))->isSizeClassAllocationEnabled());
+}
+
 } // namespace blink
@@ -63,6 +63,11 @@ protected:
         return m_visitor->markingMode();
     }
 
+    inline CallbackStack* markingStack() const
+    {
+        return m_visitor->markingStack();
+    }
+
 private:
     static InlinedGlobalMarkingVisitor fromHelper(Helper* helper)
     {
@@ -38,16 +38,19 @@ protected:
         if (header->isMarked())
             return;
 
-        ASSERT(ThreadState::current()->isInGC());
+        ASSERT(Heap::isMarkingOnCurrentThread());
 #if !defined(NDEBUG)
-        ASSERT(Heap::findPageFromAddress(header));
+        // Parallel marker threads have no ThreadState and cannot take the
+        // thread attach mutex that the GCing thread holds.
+        ASSERT(!ThreadState::current() || Heap::findPageFromAddress(header));
 #endif
         ASSERT(toDerived()->markingMode() != Visitor::WeakProcessing);
 
-        header->mark();
+        if (!markHeaderIfUnmarked(header))
+            return;
 
         if (callback)
-            Heap::pushTraceCallback(const_cast<void*>(objectPointer), callback);
+            Heap::pushTraceCallback(toDerived()->markingStack(), const_cast<void*>(objectPointer), callback);
     }
 
     inline void mark(const void* objectPointer, TraceCallback callback)
@@ -96,6 +99,14 @@ protected:
         if (HeapObjectHeader::fromPayload(objectPointer)->isMarked())
             return false;
 
+        // A parallel marker may lose the race for the mark bit, in which
+        // case the winning marker is responsible for tracing the object.
+        if (toDerived()->markingStack()) {
+            ASSERT(!pageFromObject(objectPointer)->orphaned());
+            ASSERT(Heap::isMarkingOnCurrentThread());
+            return HeapObjectHeader::fromPayload(objectPointer)->tryMark();
+        }
+
         toDerived()->markNoTracing(objectPointer);
 #else
         // Inline what the above markNoTracing() call expands to,
@@ -103,11 +114,24 @@ protected:
         HeapObjectHeader* header = HeapObjectHeader::fromPayload(objectPointer);
         if (header->isMarked())
             return false;
-        header->mark();
+        if (!markHeaderIfUnmarked(header))
+            return false;
 #endif
         return true;
     }
 
+    // Sets the mark bit of an object that was observed to be unmarked.
+    // Visitors with a private marking stack run concurrently with other
+    // marker threads, so the bit has to be set atomically and the race
+    // for the object may be lost.
+    inline bool markHeaderIfUnmarked(HeapObjectHeader* header)
+    {
+        if (toDerived()->markingStack())
+            return header->tryMark();
+        header->mark();
+        return true;
+    }
+
     Derived* toDerived()
     {
         return static_cast<Derived*>(this);
@@ -38,6 +38,18 @@ public:
 #endif
     }
 
+    // Makes no call chain safe to recurse on, so that all trace calls go
+    // through the marking stacks. Used while marking runs on multiple
+    // threads, as the limit is only meaningful on the thread that enabled
+    // it, and while marking with visitors that must not trace eagerly.
+    static void disableRecursion()
+    {
+        s_stackFrameLimit = static_cast<uintptr_t>(-1);
+#if ENABLE(ASSERT)
+        s_isEnabled = false;
+#endif
+    }
+
 #if ENABLE(ASSERT)
     inline static bool isEnabled() { return s_isEnabled; }
 #endif
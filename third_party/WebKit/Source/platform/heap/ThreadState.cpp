@@ -37,6 +37,7 @@
 #include "platform/heap/CallbackStack.h"
 #include "platform/heap/Handle.h"
 #include "platform/heap/Heap.h"
+#include "platform/heap/HeapCompact.h"
 #include "platform/heap/MarkingVisitor.h"
 #include "platform/heap/SafePoint.h"
 #include "public/platform/Platform.h"
@@ -100,6 +101,7 @@ ThreadState::ThreadState()
     , m_gcMixinMarker(nullptr)
     , m_shouldFlushHeapDoesNotContainCache(false)
     , m_gcState(NoGCScheduled)
+    , m_heapCompact(HeapCompact::create())
     , m_traceDOMWrappers(nullptr)
 #if defined(ADDRESS_SANITIZER)
     , m_asanFakeStack(__asan_get_current_fake_stack())
@@ -209,7 +211,9 @@ void ThreadState::detachMainThread()
     // safepoint.
     ThreadState* state = mainThreadState();
 
-    // 1. Finish sweeping.
+    // 1. Finish incremental marking and sweeping.
+    if (Heap::isIncrementalMarkingInProgress())
+        Heap::collectGarbage(BlinkGC::NoHeapPointersOnStack, BlinkGC::GCWithoutSweep, BlinkGC::ForcedGC);
     state->completeSweep();
     {
         SafePointAwareMutexLocker locker(threadAttachMutex(), BlinkGC::NoHeapPointersOnStack);
@@ -264,6 +268,11 @@ void ThreadState::cleanup()
         // GC.
         SafePointAwareMutexLocker locker(threadAttachMutex(), BlinkGC::NoHeapPointersOnStack);
 
+        // Finish incremental marking of the main thread, the thread local
+        // GCs below can't share the marking stack with it.
+        if (Heap::isIncrementalMarkingInProgress())
+            Heap::collectGarbage(BlinkGC::NoHeapPointersOnStack, BlinkGC::GCWithoutSweep, BlinkGC::ForcedGC);
+
         // Finish sweeping.
         completeSweep();
 
@@ -735,6 +744,14 @@ void ThreadState::scheduleGCIfNeeded()
             return;
         }
     }
+    if (gcState() == IncrementalMarking) {
+        // Have the marking keep pace with the allocations that don't leave
+        // idle time to it.
+        double allocationStepBudget = 0.001;
+        if (Heap::incrementalMarkingStep(Platform::current()->monotonicallyIncreasingTimeSeconds() + allocationStepBudget))
+            schedulePreciseGC();
+        return;
+    }
     if (shouldScheduleIdleGC()) {
 #if PRINT_HEAP_STATS
         dataLogF("Scheduled IdleGC\n");
@@ -753,6 +770,11 @@ void ThreadState::performIdleGC(double deadlineSeconds)
     if (gcState() != IdleGCScheduled)
         return;
 
+    if (Heap::isIncrementalMarkingEnabled() && Heap::startIncrementalMarking()) {
+        performIdleIncrementalMarking(deadlineSeconds);
+        return;
+    }
+
     double idleDeltaInSeconds = deadlineSeconds - Platform::current()->monotonicallyIncreasingTimeSeconds();
     TRACE_EVENT2("blink_gc", "ThreadState::performIdleGC", "idleDeltaInSeconds", idleDeltaInSeconds, "estimatedMarkingTime", Heap::estimatedMarkingTime());
     if (idleDeltaInSeconds <= Heap::estimatedMarkingTime() && !Platform::current()->currentThread()->scheduler()->canExceedIdleDeadlineIfRequired()) {
@@ -765,6 +787,28 @@ void ThreadState::performIdleGC(double deadlineSeconds)
     Heap::collectGarbage(BlinkGC::NoHeapPointersOnStack, BlinkGC::GCWithoutSweep, BlinkGC::IdleGC);
 }
 
+void ThreadState::performIdleIncrementalMarking(double deadlineSeconds)
+{
+    ASSERT(checkThread());
+    ASSERT(isMainThread());
+
+    // Marking may have been finalized, or a GC to finalize it may have been
+    // scheduled, since this task was posted.
+    if (gcState() != IncrementalMarking)
+        return;
+
+    TRACE_EVENT1("blink_gc", "ThreadState::performIdleIncrementalMarking", "idleDeltaInSeconds", deadlineSeconds - Platform::current()->monotonicallyIncreasingTimeSeconds());
+    if (Heap::incrementalMarkingStep(deadlineSeconds)) {
+        // What is left for the finalizing GC is to rescan the roots and to
+        // trace what they newly reach, which is expected to be short.
+        if (Platform::current()->monotonicallyIncreasingTimeSeconds() < deadlineSeconds || Platform::current()->currentThread()->scheduler()->canExceedIdleDeadlineIfRequired()) {
+            Heap::collectGarbage(BlinkGC::NoHeapPointersOnStack, BlinkGC::GCWithoutSweep, BlinkGC::IdleGC);
+            return;
+        }
+    }
+    scheduleIdleIncrementalMarking();
+}
+
 void ThreadState::performIdleLazySweep(double deadlineSeconds)
 {
     ASSERT(checkThread());
@@ -815,6 +859,10 @@ void ThreadState::scheduleIdleGC()
     if (!isMainThread())
         return;
 
+    // Idle tasks are already driving the incremental marking.
+    if (gcState() == IncrementalMarking)
+        return;
+
     if (isSweepingInProgress()) {
         setGCState(SweepingAndIdleGCScheduled);
         return;
@@ -841,6 +889,18 @@ void ThreadState::scheduleIdleLazySweep()
     Platform::current()->currentThread()->scheduler()->postIdleTask(BLINK_FROM_HERE, WTF::bind<double>(&ThreadState::performIdleLazySweep, this));
 }
 
+void ThreadState::scheduleIdleIncrementalMarking()
+{
+    ASSERT(isMainThread());
+    ASSERT(gcState() == IncrementalMarking);
+
+    // Without a scheduler, marking is finalized by the allocation steps.
+    if (!Platform::current()->currentThread()->scheduler())
+        return;
+
+    Platform::current()->currentThread()->scheduler()->postNonNestableIdleTask(BLINK_FROM_HERE, WTF::bind<double>(&ThreadState::performIdleIncrementalMarking, this));
+}
+
 void ThreadState::schedulePreciseGC()
 {
     ASSERT(checkThread());
@@ -869,6 +929,7 @@ void unexpectedGCState(ThreadState::GCState gcState)
         UNEXPECTED_GCSTATE(Sweeping);
         UNEXPECTED_GCSTATE(SweepingAndIdleGCScheduled);
         UNEXPECTED_GCSTATE(SweepingAndPreciseGCScheduled);
+        UNEXPECTED_GCSTATE(IncrementalMarking);
     default:
         ASSERT_NOT_REACHED();
         return;
@@ -893,7 +954,7 @@ void ThreadState::setGCState(GCState gcState)
     case FullGCScheduled:
     case PageNavigationGCScheduled:
         ASSERT(checkThread());
-        VERIFY_STATE_TRANSITION(m_gcState == NoGCScheduled || m_gcState == IdleGCScheduled || m_gcState == PreciseGCScheduled || m_gcState == FullGCScheduled || m_gcState == PageNavigationGCScheduled || m_gcState == SweepingAndIdleGCScheduled || m_gcState == SweepingAndPreciseGCScheduled);
+        VERIFY_STATE_TRANSITION(m_gcState == NoGCScheduled || m_gcState == IdleGCScheduled || m_gcState == PreciseGCScheduled || m_gcState == FullGCScheduled || m_gcState == PageNavigationGCScheduled || m_gcState == SweepingAndIdleGCScheduled || m_gcState == SweepingAndPreciseGCScheduled || (m_gcState == IncrementalMarking && gcState != IdleGCScheduled));
         completeSweep();
         break;
     case GCRunning:
@@ -914,6 +975,11 @@ void ThreadState::setGCState(GCState gcState)
         ASSERT(checkThread());
         VERIFY_STATE_TRANSITION(m_gcState == Sweeping || m_gcState == SweepingAndIdleGCScheduled || m_gcState == SweepingAndPreciseGCScheduled);
         break;
+    case IncrementalMarking:
+        ASSERT(isInGC());
+        ASSERT(isMainThread());
+        VERIFY_STATE_TRANSITION(m_gcState == GCRunning);
+        break;
     default:
         ASSERT_NOT_REACHED();
     }
@@ -970,6 +1036,14 @@ void ThreadState::makeConsistentForGC()
         m_heaps[i]->makeConsistentForGC();
 }
 
+void ThreadState::makeConsistentForIncrementalMarking()
+{
+    ASSERT(isInGC());
+    for (int i = 0; i < BlinkGC::NumberOfHeaps; ++i)
+        m_heaps[i]->makeConsistentForIncrementalMarking();
+    flushHeapDoesNotContainCacheIfNeeded();
+}
+
 void ThreadState::makeConsistentForMutator()
 {
     ASSERT(isInGC());
@@ -1030,6 +1104,11 @@ void ThreadState::preSweep()
 
     m_accumulatedSweepingTime = 0;
 
+    // Compact the collection backing heaps before the unswept pages are
+    // poisoned and the pages that could not be compacted are swept.
+    if (m_heapCompact->isCompacting())
+        m_heapCompact->compact(this);
+
 #if defined(ADDRESS_SANITIZER)
     poisonEagerHeap(BlinkGC::SetPoison);
 #endif
@@ -1043,10 +1122,26 @@ void ThreadState::preSweep()
         completeSweep();
     } else {
         // The default behavior is lazy sweeping.
+        if (Heap::isConcurrentSweepingEnabled())
+            scheduleConcurrentSweep();
         scheduleIdleLazySweep();
     }
 }
 
+void ThreadState::scheduleConcurrentSweep()
+{
+    ASSERT(checkThread());
+    ASSERT(isSweepingInProgress());
+    // The eagerly swept heap has been swept by now, large objects are not
+    // on normal pages, and vector and hash table backings are freed and
+    // resized in place by the mutator while the sweep is in progress.
+    for (int i = BlinkGC::NormalPage1HeapIndex; i < BlinkGC::LargeObjectHeapIndex; i++) {
+        if (isVectorHeapIndex(i) || i == BlinkGC::InlineVectorHeapIndex || i == BlinkGC::HashTableHeapIndex)
+            continue;
+        static_cast<NormalPageHeap*>(m_heaps[i])->scheduleConcurrentSweep();
+    }
+}
+
 #if defined(ADDRESS_SANITIZER)
 void ThreadState::poisonAllHeaps()
 {
@@ -55,6 +55,7 @@ class CallbackStack;
 class CrossThreadPersistentRegion;
 struct GCInfo;
 class GarbageCollectedMixinConstructorMarker;
+class HeapCompact;
 class HeapObjectHeader;
 class PersistentNode;
 class PersistentRegion;
@@ -137,6 +138,7 @@ public:
         Sweeping,
         SweepingAndIdleGCScheduled,
         SweepingAndPreciseGCScheduled,
+        IncrementalMarking,
     };
 
     // The NoAllocationScope class is used in debug mode to catch unwanted
@@ -237,9 +239,11 @@ public:
 
     void performIdleGC(double deadlineSeconds);
     void performIdleLazySweep(double deadlineSeconds);
+    void performIdleIncrementalMarking(double deadlineSeconds);
 
     void scheduleIdleGC();
     void scheduleIdleLazySweep();
+    void scheduleIdleIncrementalMarking();
     void schedulePreciseGC();
     void scheduleV8FollowupGCIfNeeded(BlinkGC::V8GCType);
     void schedulePageNavigationGCIfNeeded(float estimatedRemovalRatio);
@@ -286,6 +290,10 @@ public:
     // free lists. This is called after taking a snapshot and before resuming
     // the executions of mutators.
     void makeConsistentForMutator();
+    // makeConsistentForIncrementalMarking() is called at the start of each
+    // incremental marking step. Unlike makeConsistentForGC(), it keeps the
+    // free lists, as the mutator continues to allocate after the step.
+    void makeConsistentForIncrementalMarking();
 
     // Support for disallowing allocation. Mainly used for sanity
     // checks asserts.
@@ -394,6 +402,10 @@ public:
     bool popAndInvokeThreadLocalWeakCallback(Visitor*);
     void threadLocalWeakProcessing();
 
+    // The state of the compaction of this thread's collection backing heaps
+    // by the current GC.
+    HeapCompact* heapCompact() const { return m_heapCompact.get(); }
+
     size_t objectPayloadSizeForTesting();
 
     // Register the pre-finalizer for the |self| object. This method is normally
@@ -571,6 +583,9 @@ private:
     void runScheduledGC(BlinkGC::StackState);
 
     void eagerSweep();
+    // Hands the pages of the normal page heaps to the sweeper thread; see
+    // Heap::enableConcurrentSweeping().
+    void scheduleConcurrentSweep();
 
 #if defined(ADDRESS_SANITIZER)
     void poisonEagerHeap(BlinkGC::Poisoning);
@@ -646,6 +661,7 @@ private:
     GCState m_gcState;
 
     CallbackStack* m_threadLocalWeakCallbackStack;
+    OwnPtr<HeapCompact> m_heapCompact;
 
     // Pre-finalizers are called in the reverse order in which they are
     // registered by the constructors (including constructors of Mixin objects)
@@ -46,6 +46,7 @@
 
 namespace blink {
 
+class CallbackStack;
 template<typename T> class GarbageCollected;
 class HeapObjectHeader;
 class InlinedGlobalMarkingVisitor;
@@ -369,9 +370,15 @@ public:
 
     inline MarkingMode markingMode() const { return m_markingMode; }
 
+    // The stack that trace callbacks are pushed onto. Null denotes the
+    // global marking stack; visitors of parallel marker threads each have
+    // a private stack and must set mark bits atomically.
+    CallbackStack* markingStack() const { return m_markingStack; }
+
 protected:
-    explicit Visitor(MarkingMode markingMode)
+    explicit Visitor(MarkingMode markingMode, CallbackStack* markingStack = nullptr)
         : m_markingMode(markingMode)
+        , m_markingStack(markingStack)
     { }
 
     virtual void registerWeakCellWithCallback(void**, WeakCallback) = 0;
@@ -380,6 +387,7 @@ private:
     static Visitor* fromHelper(VisitorHelper<Visitor>* helper) { return static_cast<Visitor*>(helper); }
 
     const MarkingMode m_markingMode;
+    CallbackStack* m_markingStack;
     bool m_isGlobalMarkingVisitor;
 };
 
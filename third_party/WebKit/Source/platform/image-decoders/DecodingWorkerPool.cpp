@@ -0,0 +1,146 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "platform/image-decoders/DecodingWorkerPool.h"
+
+#include "platform/Task.h"
+#include "platform/ThreadSafeFunctional.h"
+#include "platform/TraceEvent.h"
+#include "public/platform/Platform.h"
+#include "public/platform/WebThread.h"
+#include "public/platform/WebTraceLocation.h"
+#include "wtf/Atomics.h"
+#include "wtf/LeakAnnotations.h"
+#include "wtf/Threading.h"
+#include "wtf/ThreadingPrimitives.h"
+
+namespace blink {
+
+namespace {
+
+// Decoding is bound by memory bandwidth well before it runs out of cores.
+const size_t maximumWorkerCount = 3;
+
+// Hands out the parts of a job to the threads taking part in it.
+class PartDispatcher {
+    STACK_ALLOCATED();
+    WTF_MAKE_NONCOPYABLE(PartDispatcher);
+public:
+    PartDispatcher(DecodingWorkerPool::Job& job, size_t partCount, size_t workerCount)
+        : m_job(job)
+        , m_partCount(partCount)
+        , m_nextPart(0)
+        , m_runningWorkers(workerCount)
+    {
+    }
+
+    void decodeParts()
+    {
+        for (;;) {
+            size_t part;
+            {
+                MutexLocker locker(m_mutex);
+                if (m_nextPart == m_partCount)
+                    return;
+                part = m_nextPart++;
+            }
+            m_job.decodePart(part);
+        }
+    }
+
+    void decodePartsOnWorker()
+    {
+        TRACE_EVENT0("blink", "DecodingWorkerPool::decodePartsOnWorker");
+        decodeParts();
+
+        MutexLocker locker(m_mutex);
+        if (!--m_runningWorkers)
+            m_workersDone.signal();
+    }
+
+    void waitForWorkers()
+    {
+        MutexLocker locker(m_mutex);
+        while (m_runningWorkers)
+            m_workersDone.wait(m_mutex);
+    }
+
+private:
+    DecodingWorkerPool::Job& m_job;
+    const size_t m_partCount;
+    size_t m_nextPart;
+    size_t m_runningWorkers;
+    Mutex m_mutex;
+    ThreadCondition m_workersDone;
+};
+
+Mutex& sharedPoolMutex()
+{
+    AtomicallyInitializedStaticReference(Mutex, mutex, new Mutex);
+    return mutex;
+}
+
+DecodingWorkerPool* sharedPoolForTesting = nullptr;
+
+} // namespace
+
+DecodingWorkerPool::DecodingWorkerPool(Vector<OwnPtr<WebThread>>& workers)
+    : m_jobCount(0)
+{
+    m_workers.swap(workers);
+}
+
+PassOwnPtr<DecodingWorkerPool> DecodingWorkerPool::create(size_t workerCount)
+{
+    Vector<OwnPtr<WebThread>> workers;
+    for (size_t i = 0; i < workerCount; ++i) {
+        OwnPtr<WebThread> thread = adoptPtr(Platform::current()->createThread("ImageDecodingWorker"));
+        if (!thread)
+            return nullptr;
+        workers.append(thread.release());
+    }
+    return adoptPtr(new DecodingWorkerPool(workers));
+}
+
+DecodingWorkerPool* DecodingWorkerPool::shared()
+{
+    MutexLocker locker(sharedPoolMutex());
+    if (sharedPoolForTesting)
+        return sharedPoolForTesting;
+
+    static bool initialized = false;
+    static DecodingWorkerPool* pool = nullptr;
+    if (!initialized) {
+        size_t processorCount = Platform::current()->numberOfProcessors();
+        if (processorCount > 1)
+            pool = create(std::min(processorCount - 1, maximumWorkerCount)).leakPtr();
+        LEAK_SANITIZER_IGNORE_OBJECT(pool);
+        initialized = true;
+    }
+    return pool;
+}
+
+void DecodingWorkerPool::setSharedForTesting(DecodingWorkerPool* pool)
+{
+    MutexLocker locker(sharedPoolMutex());
+    sharedPoolForTesting = pool;
+}
+
+void DecodingWorkerPool::run(Job& job, size_t partCount)
+{
+    if (!partCount)
+        return;
+    atomicIncrement(&m_jobCount);
+
+    size_t workerCount = std::min(m_workers.size(), partCount - 1);
+    PartDispatcher dispatcher(job, partCount, workerCount);
+    for (size_t i = 0; i < workerCount; ++i)
+        m_workers[i]->taskRunner()->postTask(BLINK_FROM_HERE, new Task(threadSafeBind(&PartDispatcher::decodePartsOnWorker, AllowCrossThreadAccess(&dispatcher))));
+
+    dispatcher.decodeParts();
+    dispatcher.waitForWorkers();
+}
+
+} // namespace blink
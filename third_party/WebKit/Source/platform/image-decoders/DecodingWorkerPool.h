@@ -0,0 +1,65 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef DecodingWorkerPool_h
+#define DecodingWorkerPool_h
+
+#include "platform/PlatformExport.h"
+#include "wtf/Allocator.h"
+#include "wtf/Noncopyable.h"
+#include "wtf/OwnPtr.h"
+#include "wtf/PassOwnPtr.h"
+#include "wtf/Vector.h"
+
+namespace blink {
+
+class WebThread;
+
+// Threads shared by the image decoders which split the decoding of an image
+// into parts that decode independently of each other. The thread decoding the
+// image decodes parts as well, and waits for the parts decoded by the workers.
+class PLATFORM_EXPORT DecodingWorkerPool {
+    USING_FAST_MALLOC(DecodingWorkerPool);
+    WTF_MAKE_NONCOPYABLE(DecodingWorkerPool);
+public:
+    class Job {
+    public:
+        virtual ~Job() { }
+        // Called once for each part, on any of the threads.
+        virtual void decodePart(size_t part) = 0;
+    };
+
+    // Returns null if the platform has a single processor or can't create
+    // threads, in which case images decode on their own thread only.
+    static DecodingWorkerPool* shared();
+
+    // Creates a pool of |workerCount| threads, or returns null if the
+    // platform can't create them. A pool without workers decodes every part
+    // on the thread running the job.
+    static PassOwnPtr<DecodingWorkerPool> create(size_t workerCount);
+
+    // Makes shared() return |pool|, or the platform's pool again if |pool| is
+    // null. The pool must outlive its use by the decoders.
+    static void setSharedForTesting(DecodingWorkerPool*);
+
+    size_t workerCount() const { return m_workers.size(); }
+
+    // The number of jobs run so far, so that tests can check that a decoder
+    // split an image.
+    int jobCount() const { return m_jobCount; }
+
+    // Decodes the parts [0, partCount) of |job|, returning once all of them
+    // are decoded.
+    void run(Job&, size_t partCount);
+
+private:
+    explicit DecodingWorkerPool(Vector<OwnPtr<WebThread>>& workers);
+
+    Vector<OwnPtr<WebThread>> m_workers;
+    int m_jobCount;
+};
+
+} // namespace blink
+
+#endif // DecodingWorkerPool_h
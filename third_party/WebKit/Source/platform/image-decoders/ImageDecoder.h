@@ -297,6 +297,8 @@ public:
     virtual bool canDecodeToYUV() { return false; }
     virtual bool decodeToYUV() { return false; }
     virtual void setImagePlanes(PassOwnPtr<ImagePlanes>) { }
+    // The color space of the planes decodeToYUV() writes.
+    virtual SkYUVColorSpace yuvColorSpace() const { return kJPEG_SkYUVColorSpace; }
 
 protected:
     // Calculates the most recent frame whose image data may be needed in
@@ -140,4 +140,72 @@ void testMergeBuffer(DecoderCreator createDecoder, const char* file)
     EXPECT_EQ(hashBitmap(frame->bitmap()), hash);
 }
 
+// Decodes |data| with a quarter of the bytes it takes at full size, which
+// halves both of its dimensions.
+void testDownscale(DecoderCreatorWithMaxDecodedBytes createDecoder, SharedBuffer* data)
+{
+    OwnPtr<ImageDecoder> fullSizeDecoder = createDecoder(ImageDecoder::noDecodedImageByteLimit);
+    fullSizeDecoder->setData(data, true);
+    ASSERT_TRUE(fullSizeDecoder->isSizeAvailable());
+    const IntSize size = fullSizeDecoder->size();
+    const size_t frameCount = fullSizeDecoder->frameCount();
+
+    OwnPtr<ImageDecoder> decoder = createDecoder(size.width() * size.height() * sizeof(ImageFrame::PixelData) / 4);
+    decoder->setData(data, true);
+    ASSERT_TRUE(decoder->isSizeAvailable());
+    EXPECT_EQ(size, decoder->size());
+    const IntSize decodedSize((size.width() + 1) / 2, (size.height() + 1) / 2);
+    EXPECT_EQ(decodedSize, decoder->decodedSize());
+
+    EXPECT_EQ(frameCount, decoder->frameCount());
+    for (size_t i = 0; i < frameCount; ++i) {
+        ImageFrame* frame = decoder->frameBufferAtIndex(i);
+        ASSERT_TRUE(frame);
+        EXPECT_EQ(ImageFrame::FrameComplete, frame->status());
+        EXPECT_EQ(decodedSize.width(), frame->getSkBitmap().width());
+        EXPECT_EQ(decodedSize.height(), frame->getSkBitmap().height());
+    }
+    EXPECT_FALSE(decoder->failed());
+}
+
+void testDownscale(DecoderCreatorWithMaxDecodedBytes createDecoder, const char* file)
+{
+    RefPtr<SharedBuffer> data = readFile(file);
+    ASSERT_TRUE(data);
+    testDownscale(createDecoder, data.get());
+}
+
+void testDecodeToYUV(DecoderCreator createDecoder, const char* file)
+{
+    RefPtr<SharedBuffer> data = readFile(file);
+    ASSERT_TRUE(data);
+
+    // Empty planes ask for the sizes of the planes, as ImageFrameGenerator does.
+    OwnPtr<ImageDecoder> decoder = createDecoder();
+    decoder->setData(data.get(), true);
+    decoder->setImagePlanes(adoptPtr(new ImagePlanes()));
+    ASSERT_TRUE(decoder->isSizeAvailable());
+    ASSERT_TRUE(decoder->canDecodeToYUV());
+
+    Vector<uint8_t> planeData[3];
+    void* planes[3];
+    size_t rowBytes[3];
+    for (int component = 0; component < 3; ++component) {
+        IntSize size = decoder->decodedYUVSize(component, ImageDecoder::SizeForMemoryAllocation);
+        IntSize actualSize = decoder->decodedYUVSize(component, ImageDecoder::ActualSize);
+        EXPECT_GE(size.width(), actualSize.width());
+        EXPECT_GE(size.height(), actualSize.height());
+        planeData[component].resize(size.width() * size.height());
+        planes[component] = planeData[component].data();
+        rowBytes[component] = size.width();
+    }
+
+    decoder = createDecoder();
+    decoder->setData(data.get(), true);
+    decoder->setImagePlanes(adoptPtr(new ImagePlanes(planes, rowBytes)));
+    ASSERT_TRUE(decoder->canDecodeToYUV());
+    EXPECT_TRUE(decoder->decodeToYUV());
+    EXPECT_FALSE(decoder->failed());
+}
+
 } // namespace blink
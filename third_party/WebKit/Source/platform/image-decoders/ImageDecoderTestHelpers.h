@@ -11,10 +11,16 @@ class ImageDecoder;
 class SharedBuffer;
 
 using DecoderCreator = PassOwnPtr<ImageDecoder>(*)();
+using DecoderCreatorWithMaxDecodedBytes = PassOwnPtr<ImageDecoder>(*)(size_t maxDecodedBytes);
 PassRefPtr<SharedBuffer> readFile(const char* fileName);
 PassRefPtr<SharedBuffer> readFile(const char* dir, const char* fileName);
 unsigned hashBitmap(const SkBitmap&);
 void createDecodingBaseline(DecoderCreator, SharedBuffer*, Vector<unsigned>* baselineHashes);
 void testByteByByteDecode(DecoderCreator createDecoder, const char* file, size_t expectedFrameCount, int expectedRepetitionCount);
 void testMergeBuffer(DecoderCreator createDecoder, const char* file);
+void testDownscale(DecoderCreatorWithMaxDecodedBytes createDecoder, SharedBuffer* data);
+void testDownscale(DecoderCreatorWithMaxDecodedBytes createDecoder, const char* file);
+// Decodes |file| into Y, U and V planes sized the way ImageFrameGenerator
+// sizes them.
+void testDecodeToYUV(DecoderCreator createDecoder, const char* file);
 }
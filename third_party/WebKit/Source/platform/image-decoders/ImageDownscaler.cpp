@@ -0,0 +1,218 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "platform/image-decoders/ImageDownscaler.h"
+
+#include "SkColorPriv.h"
+#include "wtf/MathExtras.h"
+#include "wtf/PassOwnPtr.h"
+#include <algorithm>
+
+namespace blink {
+
+namespace {
+
+// Keeps the sums of a block in 32 bits: for frames which don't premultiply
+// alpha, a block adds up to 255 * 255 * factor * factor.
+const unsigned maximumFactor = 256;
+
+IntSize scaledSizeFor(const IntSize& size, unsigned factor)
+{
+    return IntSize((size.width() + factor - 1) / factor, (size.height() + factor - 1) / factor);
+}
+
+uint64_t bytesFor(const IntSize& size)
+{
+    return static_cast<uint64_t>(size.width()) * size.height() * sizeof(ImageFrame::PixelData);
+}
+
+} // namespace
+
+// The sums of the pixels of the image added to a row of the frame so far.
+struct ImageDownscaler::PendingRow {
+    USING_FAST_MALLOC(PendingRow);
+    WTF_MAKE_NONCOPYABLE(PendingRow);
+public:
+    explicit PendingRow(size_t width)
+        : decodedRows(0)
+        , sums(width * 4)
+        , coverage(width)
+    {
+        sums.fill(0);
+        coverage.fill(0);
+    }
+
+    int decodedRows;
+    // Alpha, red, green and blue for each pixel. Colors are weighted by alpha
+    // for frames which don't premultiply it.
+    Vector<uint32_t> sums;
+    // The number of pixels of the image added to each pixel.
+    Vector<uint32_t> coverage;
+};
+
+ImageDownscaler::ImageDownscaler(size_t maxDecodedBytes)
+    : m_maxDecodedBytes(maxDecodedBytes)
+    , m_factor(1)
+{
+}
+
+ImageDownscaler::~ImageDownscaler()
+{
+}
+
+unsigned ImageDownscaler::factorFor(const IntSize& size, size_t maxDecodedBytes)
+{
+    uint64_t bytes = bytesFor(size);
+    if (bytes <= maxDecodedBytes)
+        return 1;
+
+    // Rounding the scaled size up can leave the estimate a little short.
+    unsigned factor = std::max(2u, static_cast<unsigned>(sqrt(static_cast<double>(bytes) / std::max<size_t>(maxDecodedBytes, 1))));
+    while (factor < maximumFactor && bytesFor(scaledSizeFor(size, factor)) > maxDecodedBytes)
+        ++factor;
+    return std::min(factor, maximumFactor);
+}
+
+void ImageDownscaler::setImageSize(const IntSize& size, bool canScale)
+{
+    m_pendingRows.clear();
+    m_imageSize = size;
+    m_factor = canScale ? factorFor(size, m_maxDecodedBytes) : 1;
+    m_scaledSize = scaledSizeFor(size, m_factor);
+}
+
+IntRect ImageDownscaler::scaledRect(const IntRect& rect) const
+{
+    if (!isScaling())
+        return rect;
+    // Edges at the edge of the image stay there, as the last row and column
+    // of the frame may cover less than a whole block.
+    const int factor = m_factor;
+    int x = std::min((rect.x() + factor / 2) / factor, m_scaledSize.width());
+    int y = std::min((rect.y() + factor / 2) / factor, m_scaledSize.height());
+    int maxX = rect.maxX() >= m_imageSize.width() ? m_scaledSize.width() : (rect.maxX() + factor / 2) / factor;
+    int maxY = rect.maxY() >= m_imageSize.height() ? m_scaledSize.height() : (rect.maxY() + factor / 2) / factor;
+    return IntRect(x, y, std::max(maxX - x, 0), std::max(maxY - y, 0));
+}
+
+void ImageDownscaler::beginFrame(const IntRect& frameRect)
+{
+    ASSERT(isScaling());
+    m_frameRect = intersection(frameRect, IntRect(IntPoint(), m_imageSize));
+    m_rowBuffer.resize(m_imageSize.width());
+    m_pendingRows.clear();
+    m_pendingRows.resize(m_scaledSize.height());
+}
+
+int ImageDownscaler::rowsCoveredBy(int scaledY) const
+{
+    int firstRow = std::max<int>(scaledY * m_factor, m_frameRect.y());
+    int endRow = std::min<int>((scaledY + 1) * m_factor, m_frameRect.maxY());
+    return endRow - firstRow;
+}
+
+void ImageDownscaler::rowDecoded(ImageFrame& frame, int y, int left, int right, bool skipTransparentPixels)
+{
+    ASSERT(isScaling());
+    ASSERT(left >= 0 && right <= m_imageSize.width());
+    if (y < m_frameRect.y() || y >= m_frameRect.maxY())
+        return;
+
+    int scaledY = y / m_factor;
+    OwnPtr<PendingRow>& row = m_pendingRows[scaledY];
+    if (!row)
+        row = m_spareRow ? m_spareRow.release() : adoptPtr(new PendingRow(m_scaledSize.width()));
+
+    const bool premultiplied = frame.premultiplyAlpha();
+    const ImageFrame::PixelData* pixels = m_rowBuffer.data();
+    for (int x = left; x < right;) {
+        int scaledX = x / m_factor;
+        int blockEnd = std::min<int>((scaledX + 1) * m_factor, right);
+        uint32_t* sum = row->sums.data() + scaledX * 4;
+        uint32_t covered = 0;
+        for (; x < blockEnd; ++x) {
+            ImageFrame::PixelData pixel = pixels[x];
+            unsigned alpha = SkGetPackedA32(pixel);
+            if (skipTransparentPixels && !alpha)
+                continue;
+            unsigned weight = premultiplied ? 1 : alpha;
+            sum[0] += alpha;
+            sum[1] += SkGetPackedR32(pixel) * weight;
+            sum[2] += SkGetPackedG32(pixel) * weight;
+            sum[3] += SkGetPackedB32(pixel) * weight;
+            ++covered;
+        }
+        row->coverage[scaledX] += covered;
+    }
+
+    if (++row->decodedRows == rowsCoveredBy(scaledY))
+        writeRow(frame, scaledY);
+}
+
+void ImageDownscaler::flush(ImageFrame& frame)
+{
+    for (size_t scaledY = 0; scaledY < m_pendingRows.size(); ++scaledY) {
+        if (m_pendingRows[scaledY])
+            writeRow(frame, scaledY);
+    }
+}
+
+void ImageDownscaler::zeroFillPendingRows()
+{
+    for (const OwnPtr<PendingRow>& row : m_pendingRows) {
+        if (row)
+            row->sums.fill(0);
+    }
+    m_rowBuffer.fill(0);
+}
+
+void ImageDownscaler::writeRow(ImageFrame& frame, int scaledY)
+{
+    OwnPtr<PendingRow> row = m_pendingRows[scaledY].release();
+    const bool premultiplied = frame.premultiplyAlpha();
+    const unsigned blockHeight = std::min<unsigned>(m_factor, m_imageSize.height() - scaledY * m_factor);
+    ImageFrame::PixelData* address = frame.getAddr(0, scaledY);
+
+    for (int scaledX = 0; scaledX < m_scaledSize.width(); ++scaledX, ++address) {
+        const uint32_t covered = row->coverage[scaledX];
+        if (!covered)
+            continue;
+        const uint32_t* sum = row->sums.data() + scaledX * 4;
+        const unsigned blockWidth = std::min<unsigned>(m_factor, m_imageSize.width() - scaledX * m_factor);
+        const uint32_t area = blockWidth * blockHeight;
+        const uint32_t uncovered = area - covered;
+        const ImageFrame::PixelData previous = *address;
+        const unsigned previousAlpha = SkGetPackedA32(previous);
+
+        if (premultiplied) {
+            *address = SkPackARGB32NoCheck(
+                (sum[0] + uncovered * previousAlpha + area / 2) / area,
+                (sum[1] + uncovered * SkGetPackedR32(previous) + area / 2) / area,
+                (sum[2] + uncovered * SkGetPackedG32(previous) + area / 2) / area,
+                (sum[3] + uncovered * SkGetPackedB32(previous) + area / 2) / area);
+            continue;
+        }
+
+        const uint32_t totalAlpha = sum[0] + uncovered * previousAlpha;
+        if (!totalAlpha) {
+            *address = 0;
+            continue;
+        }
+        const uint32_t previousWeight = uncovered * previousAlpha;
+        *address = SkPackARGB32NoCheck(
+            (totalAlpha + area / 2) / area,
+            (sum[1] + previousWeight * SkGetPackedR32(previous) + totalAlpha / 2) / totalAlpha,
+            (sum[2] + previousWeight * SkGetPackedG32(previous) + totalAlpha / 2) / totalAlpha,
+            (sum[3] + previousWeight * SkGetPackedB32(previous) + totalAlpha / 2) / totalAlpha);
+    }
+
+    // Keep the row around for the next one.
+    row->decodedRows = 0;
+    row->sums.fill(0);
+    row->coverage.fill(0);
+    m_spareRow = row.release();
+}
+
+} // namespace blink
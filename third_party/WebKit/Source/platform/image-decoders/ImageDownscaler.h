@@ -0,0 +1,94 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef ImageDownscaler_h
+#define ImageDownscaler_h
+
+#include "platform/PlatformExport.h"
+#include "platform/geometry/IntRect.h"
+#include "platform/geometry/IntSize.h"
+#include "platform/image-decoders/ImageFrame.h"
+#include "wtf/Allocator.h"
+#include "wtf/Noncopyable.h"
+#include "wtf/OwnPtr.h"
+#include "wtf/Vector.h"
+
+namespace blink {
+
+// Scales an image down by a whole factor while a decoder decodes it, so that
+// the image never exists at full size. The decoder writes each row of the
+// image at full size into rowBuffer(), in the pixel format of the frame, and
+// hands it to rowDecoded(). Once all the rows of the image a row of the frame
+// covers are decoded, each pixel of that row is set to the average of the
+// factor x factor block of pixels it covers (clipped to the image).
+//
+// Rows may be decoded in any order. A row of the frame keeps 20 bytes of sums
+// per pixel until its block is complete, so interlaced images, whose blocks
+// all complete in their last pass, take more memory while they decode.
+//
+// Pixels the decoder leaves out of a block, because they are outside the rect
+// of the frame or are transparent pixels of a frame drawn atop the previous
+// one, count as the pixel the frame held before the block was written.
+class PLATFORM_EXPORT ImageDownscaler final {
+    DISALLOW_NEW();
+    WTF_MAKE_NONCOPYABLE(ImageDownscaler);
+public:
+    explicit ImageDownscaler(size_t maxDecodedBytes);
+    ~ImageDownscaler();
+
+    // Returns the smallest factor which brings an image of |size| under
+    // |maxDecodedBytes|, or 1 if it fits already.
+    static unsigned factorFor(const IntSize&, size_t maxDecodedBytes);
+
+    // Sets the size of the image, scaling it down if it doesn't fit under the
+    // byte limit and |canScale|. Decoders pass false for images they can't
+    // hand over a row at a time.
+    void setImageSize(const IntSize&, bool canScale = true);
+
+    bool isScaling() const { return m_factor > 1; }
+    unsigned factor() const { return m_factor; }
+    // The size of the frames of the image, which is the size of the image
+    // when it isn't scaled.
+    IntSize scaledSize() const { return m_scaledSize; }
+    // Returns the pixels of the frame mostly covered by |rect| of the image.
+    IntRect scaledRect(const IntRect&) const;
+
+    // Starts a frame which covers |frameRect| of the image. The rows of the
+    // previous frame which are still pending are dropped.
+    void beginFrame(const IntRect& frameRect);
+
+    ImageFrame::PixelData* rowBuffer() { return m_rowBuffer.data(); }
+
+    // Adds the pixels [left, right) of rowBuffer() to |frame| as row |y| of
+    // the image. With |skipTransparentPixels|, transparent pixels are left
+    // out.
+    void rowDecoded(ImageFrame&, int y, int left, int right, bool skipTransparentPixels);
+
+    // Writes the rows of |frame| which still wait for rows of the image, as if
+    // the missing rows were left out.
+    void flush(ImageFrame&);
+
+    // Makes the pixels added to pending rows and the pixels in rowBuffer()
+    // transparent, for decoders which zero-fill the frame halfway through.
+    void zeroFillPendingRows();
+
+private:
+    struct PendingRow;
+
+    int rowsCoveredBy(int scaledY) const;
+    void writeRow(ImageFrame&, int scaledY);
+
+    size_t m_maxDecodedBytes;
+    unsigned m_factor;
+    IntSize m_imageSize;
+    IntSize m_scaledSize;
+    IntRect m_frameRect;
+    Vector<ImageFrame::PixelData> m_rowBuffer;
+    Vector<OwnPtr<PendingRow>> m_pendingRows;
+    OwnPtr<PendingRow> m_spareRow;
+};
+
+} // namespace blink
+
+#endif // ImageDownscaler_h
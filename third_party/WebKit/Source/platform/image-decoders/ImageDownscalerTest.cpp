@@ -0,0 +1,144 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "platform/image-decoders/ImageDownscaler.h"
+
+#include "SkColorPriv.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace blink {
+
+namespace {
+
+ImageFrame::PixelData gray(unsigned value)
+{
+    return SkPackARGB32NoCheck(255, value, value, value);
+}
+
+template <size_t width>
+void setRow(ImageDownscaler& downscaler, const ImageFrame::PixelData (&pixels)[width])
+{
+    memcpy(downscaler.rowBuffer(), pixels, sizeof(pixels));
+}
+
+} // namespace
+
+TEST(ImageDownscalerTest, factorFor)
+{
+    EXPECT_EQ(1u, ImageDownscaler::factorFor(IntSize(100, 100), 40000));
+    EXPECT_EQ(2u, ImageDownscaler::factorFor(IntSize(100, 100), 10000));
+    // 50x50 is a byte too many.
+    EXPECT_EQ(3u, ImageDownscaler::factorFor(IntSize(100, 100), 9999));
+}
+
+TEST(ImageDownscalerTest, doesNotScaleWhenAskedNotTo)
+{
+    ImageDownscaler downscaler(16);
+    downscaler.setImageSize(IntSize(100, 100), false);
+    EXPECT_FALSE(downscaler.isScaling());
+    EXPECT_EQ(IntSize(100, 100), downscaler.scaledSize());
+}
+
+TEST(ImageDownscalerTest, scaledRectKeepsEdgesAtTheEdgeOfTheImage)
+{
+    ImageDownscaler downscaler(34 * 34 * 4);
+    downscaler.setImageSize(IntSize(100, 100));
+    ASSERT_EQ(3u, downscaler.factor());
+    ASSERT_EQ(IntSize(34, 34), downscaler.scaledSize());
+
+    EXPECT_EQ(IntRect(0, 0, 34, 34), downscaler.scaledRect(IntRect(0, 0, 100, 100)));
+    EXPECT_EQ(IntRect(1, 3, 10, 31), downscaler.scaledRect(IntRect(2, 10, 31, 90)));
+}
+
+TEST(ImageDownscalerTest, averagesBlocksClippedToTheImage)
+{
+    ImageDownscaler downscaler(16);
+    downscaler.setImageSize(IntSize(3, 3));
+    ASSERT_EQ(2u, downscaler.factor());
+    ASSERT_EQ(IntSize(2, 2), downscaler.scaledSize());
+
+    ImageFrame frame;
+    ASSERT_TRUE(frame.setSize(2, 2));
+    downscaler.beginFrame(IntRect(0, 0, 3, 3));
+
+    const ImageFrame::PixelData firstRow[] = { gray(0), gray(100), gray(200) };
+    setRow(downscaler, firstRow);
+    downscaler.rowDecoded(frame, 0, 0, 3, false);
+    const ImageFrame::PixelData secondRow[] = { gray(20), gray(40), gray(60) };
+    setRow(downscaler, secondRow);
+    downscaler.rowDecoded(frame, 1, 0, 3, false);
+    EXPECT_EQ(gray(40), *frame.getAddr(0, 0));
+    EXPECT_EQ(gray(130), *frame.getAddr(1, 0));
+
+    const ImageFrame::PixelData thirdRow[] = { gray(255), gray(255), gray(255) };
+    setRow(downscaler, thirdRow);
+    downscaler.rowDecoded(frame, 2, 0, 3, false);
+    EXPECT_EQ(gray(255), *frame.getAddr(0, 1));
+    EXPECT_EQ(gray(255), *frame.getAddr(1, 1));
+}
+
+TEST(ImageDownscalerTest, skippedPixelsKeepThePreviousPixel)
+{
+    ImageDownscaler downscaler(4);
+    downscaler.setImageSize(IntSize(2, 2));
+    ASSERT_EQ(IntSize(1, 1), downscaler.scaledSize());
+
+    ImageFrame frame;
+    ASSERT_TRUE(frame.setSize(1, 1));
+    *frame.getAddr(0, 0) = gray(200);
+    downscaler.beginFrame(IntRect(0, 0, 2, 2));
+
+    const ImageFrame::PixelData firstRow[] = { 0, gray(100) };
+    setRow(downscaler, firstRow);
+    downscaler.rowDecoded(frame, 0, 0, 2, true);
+    const ImageFrame::PixelData secondRow[] = { gray(100), gray(100) };
+    setRow(downscaler, secondRow);
+    downscaler.rowDecoded(frame, 1, 0, 2, true);
+    EXPECT_EQ(gray(125), *frame.getAddr(0, 0));
+}
+
+TEST(ImageDownscalerTest, writesRowsOnceTheirBlocksAreComplete)
+{
+    ImageDownscaler downscaler(8);
+    downscaler.setImageSize(IntSize(2, 4));
+    ASSERT_EQ(IntSize(1, 2), downscaler.scaledSize());
+
+    ImageFrame frame;
+    ASSERT_TRUE(frame.setSize(1, 2));
+    downscaler.beginFrame(IntRect(0, 0, 2, 4));
+
+    const ImageFrame::PixelData pixels[] = { gray(80), gray(80) };
+    const int rows[] = { 1, 3, 0, 2 };
+    for (int y : rows) {
+        setRow(downscaler, pixels);
+        downscaler.rowDecoded(frame, y, 0, 2, false);
+        if (y == 0) {
+            EXPECT_EQ(gray(80), *frame.getAddr(0, 0));
+            EXPECT_EQ(0u, *frame.getAddr(0, 1));
+        }
+    }
+    EXPECT_EQ(gray(80), *frame.getAddr(0, 1));
+}
+
+TEST(ImageDownscalerTest, flushWritesIncompleteBlocks)
+{
+    ImageDownscaler downscaler(4);
+    downscaler.setImageSize(IntSize(2, 2));
+
+    ImageFrame frame;
+    ASSERT_TRUE(frame.setSize(1, 1));
+    downscaler.beginFrame(IntRect(0, 0, 2, 2));
+
+    const ImageFrame::PixelData pixels[] = { gray(100), gray(100) };
+    setRow(downscaler, pixels);
+    downscaler.rowDecoded(frame, 0, 0, 2, false);
+    EXPECT_EQ(0u, *frame.getAddr(0, 0));
+
+    // The missing row counts as the transparent pixel the frame held.
+    downscaler.flush(frame);
+    EXPECT_EQ(SkPackARGB32NoCheck(128, 50, 50, 50), *frame.getAddr(0, 0));
+}
+
+} // namespace blink
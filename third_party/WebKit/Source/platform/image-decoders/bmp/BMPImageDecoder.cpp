@@ -44,6 +44,7 @@ static const size_t sizeOfFileHeader = 14;
 BMPImageDecoder::BMPImageDecoder(AlphaOption alphaOption, GammaAndColorProfileOption colorOptions, size_t maxDecodedBytes)
     : ImageDecoder(alphaOption, colorOptions, maxDecodedBytes)
     , m_decodedOffset(0)
+    , m_downscaler(maxDecodedBytes)
 {
 }
 
@@ -82,6 +83,7 @@ bool BMPImageDecoder::decodeHelper(bool onlySize)
 
     if (!m_reader) {
         m_reader = adoptPtr(new BMPImageReader(this, m_decodedOffset, imgDataOffset, false));
+        m_reader->setDownscaler(&m_downscaler);
         m_reader->setData(m_data.get());
     }
 
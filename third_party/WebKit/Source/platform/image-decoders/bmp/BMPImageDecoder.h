@@ -31,6 +31,7 @@
 #ifndef BMPImageDecoder_h
 #define BMPImageDecoder_h
 
+#include "platform/image-decoders/ImageDownscaler.h"
 #include "platform/image-decoders/bmp/BMPImageReader.h"
 #include "wtf/OwnPtr.h"
 
@@ -43,6 +44,7 @@ public:
 
     // ImageDecoder:
     String filenameExtension() const override { return "bmp"; }
+    IntSize decodedSize() const override { return m_downscaler.scaledSize(); }
     void onSetData(SharedBuffer*) override;
     // CAUTION: setFailed() deletes |m_reader|.  Be careful to avoid
     // accessing deleted memory, especially when calling this from inside
@@ -75,6 +77,8 @@ private:
 
     // The reader used to do most of the BMP decoding.
     OwnPtr<BMPImageReader> m_reader;
+
+    ImageDownscaler m_downscaler;
 };
 
 } // namespace blink
@@ -13,9 +13,14 @@ namespace blink {
 
 namespace {
 
+PassOwnPtr<ImageDecoder> createDecoder(size_t maxDecodedBytes)
+{
+    return adoptPtr(new BMPImageDecoder(ImageDecoder::AlphaNotPremultiplied, ImageDecoder::GammaAndColorProfileApplied, maxDecodedBytes));
+}
+
 PassOwnPtr<ImageDecoder> createDecoder()
 {
-    return adoptPtr(new BMPImageDecoder(ImageDecoder::AlphaNotPremultiplied, ImageDecoder::GammaAndColorProfileApplied, ImageDecoder::noDecodedImageByteLimit));
+    return createDecoder(ImageDecoder::noDecodedImageByteLimit);
 }
 
 } // anonymous namespace
@@ -76,4 +81,9 @@ TEST(BMPImageDecoderTest, mergeBuffer)
     testMergeBuffer(&createDecoder, bmpFile);
 }
 
+TEST(BMPImageDecoderTest, downscale)
+{
+    testDownscale(&createDecoder, "/LayoutTests/fast/images/resources/lenna.bmp");
+}
+
 } // namespace blink
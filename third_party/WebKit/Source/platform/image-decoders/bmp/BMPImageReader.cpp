@@ -69,6 +69,8 @@ namespace blink {
 BMPImageReader::BMPImageReader(ImageDecoder* parent, size_t decodedAndHeaderOffset, size_t imgDataOffset, bool isInICO)
     : m_parent(parent)
     , m_buffer(0)
+    , m_downscaler(0)
+    , m_downscaledRow(0)
     , m_fastReader(nullptr)
     , m_decodedOffset(decodedAndHeaderOffset)
     , m_headerOffset(decodedAndHeaderOffset)
@@ -117,7 +119,8 @@ bool BMPImageReader::decodeBMP(bool onlySize)
     // Initialize the framebuffer if needed.
     ASSERT(m_buffer);  // Parent should set this before asking us to decode!
     if (m_buffer->status() == ImageFrame::FrameEmpty) {
-        if (!m_buffer->setSize(m_parent->size().width(), m_parent->size().height()))
+        const IntSize frameSize = m_downscaler ? m_downscaler->scaledSize() : m_parent->size();
+        if (!m_buffer->setSize(frameSize.width(), frameSize.height()))
             return m_parent->setFailed(); // Unable to allocate.
         m_buffer->setStatus(ImageFrame::FramePartial);
         // setSize() calls eraseARGB(), which resets the alpha flag, so we force
@@ -130,6 +133,11 @@ bool BMPImageReader::decodeBMP(bool onlySize)
 
         if (!m_isTopDown)
             m_coord.setY(m_parent->size().height() - 1);
+
+        if (m_downscaler && m_downscaler->isScaling()) {
+            m_downscaler->beginFrame(IntRect(IntPoint(), m_parent->size()));
+            m_downscaledRow = m_downscaler->rowBuffer();
+        }
     }
 
     // Decode the data.
@@ -152,6 +160,8 @@ bool BMPImageReader::decodeBMP(bool onlySize)
         return false;
 
     // Done!
+    if (m_downscaledRow)
+        m_downscaler->flush(*m_buffer);
     m_buffer->setStatus(ImageFrame::FrameComplete);
     return true;
 }
@@ -213,6 +223,10 @@ bool BMPImageReader::processInfoHeader()
     // Set our size.
     if (!m_parent->setSize(m_infoHeader.biWidth, m_infoHeader.biHeight))
         return false;
+    // Compressed images can skip over rows and pixels, leaving them for
+    // later ones to show through, which doesn't work with downscaled rows.
+    if (m_downscaler)
+        m_downscaler->setImageSize(m_parent->size(), (m_infoHeader.biCompression == RGB) || (m_infoHeader.biCompression == BITFIELDS));
 
     // For paletted images, bitmaps can set biClrUsed to 0 to mean "all
     // colors", so set it to the maximum number of colors for this bit depth.
@@ -785,6 +799,8 @@ BMPImageReader::ProcessingResult BMPImageReader::processNonRLEData(bool inRLE, i
                     m_seenNonZeroAlphaPixel = true;
                     if (m_seenZeroAlphaPixel) {
                         m_buffer->zeroFillPixelData();
+                        if (m_downscaledRow)
+                            m_downscaler->zeroFillPendingRows();
                         m_seenZeroAlphaPixel = false;
                     } else if (alpha != 255)
                         m_buffer->setHasAlpha(true);
@@ -808,6 +824,8 @@ BMPImageReader::ProcessingResult BMPImageReader::processNonRLEData(bool inRLE, i
 
 void BMPImageReader::moveBufferToNextRow()
 {
+    if (m_downscaledRow)
+        m_downscaler->rowDecoded(*m_buffer, m_coord.y(), 0, m_parent->size().width(), false);
     m_coord.move(-m_coord.x(), m_isTopDown ? 1 : -1);
 }
 
@@ -33,6 +33,7 @@
 
 #include "platform/image-decoders/FastSharedBufferReader.h"
 #include "platform/image-decoders/ImageDecoder.h"
+#include "platform/image-decoders/ImageDownscaler.h"
 #include "wtf/Allocator.h"
 #include "wtf/CPU.h"
 #include "wtf/Noncopyable.h"
@@ -65,6 +66,9 @@ public:
     BMPImageReader(ImageDecoder* parent, size_t decodedAndHeaderOffset, size_t imgDataOffset, bool isInICO);
 
     void setBuffer(ImageFrame* buffer) { m_buffer = buffer; }
+    // Scales uncompressed images down with |downscaler|, which the decoder
+    // owns.
+    void setDownscaler(ImageDownscaler* downscaler) { m_downscaler = downscaler; }
     void setData(SharedBuffer* data)
     {
         m_data = data;
@@ -260,10 +264,17 @@ private:
                         unsigned blue,
                         unsigned alpha)
     {
-        m_buffer->setRGBA(m_coord.x(), m_coord.y(), red, green, blue, alpha);
+        m_buffer->setRGBA(pixelAddress(), red, green, blue, alpha);
         m_coord.move(1, 0);
     }
 
+    // Returns where the current pixel goes: the frame, or the row handed to
+    // the downscaler.
+    inline ImageFrame::PixelData* pixelAddress()
+    {
+        return m_downscaledRow ? m_downscaledRow + m_coord.x() : m_buffer->getAddr(m_coord.x(), m_coord.y());
+    }
+
     // Fills pixels from the current X-coordinate up to, but not including,
     // |endCoord| with the color given by the individual components.  This
     // also increments the relevant local variables to move the current
@@ -289,6 +300,10 @@ private:
     // The destination for the pixel data.
     ImageFrame* m_buffer;
 
+    // Set while the rows of the image go through the downscaler.
+    ImageDownscaler* m_downscaler;
+    ImageFrame::PixelData* m_downscaledRow;
+
     // The file to decode.
     RefPtr<SharedBuffer> m_data;
     FastSharedBufferReader m_fastReader;
@@ -27,15 +27,76 @@
 #include "platform/image-decoders/gif/GIFImageDecoder.h"
 
 #include <limits>
+#include "platform/RuntimeEnabledFeatures.h"
+#include "platform/TraceEvent.h"
+#include "platform/image-decoders/DecodingWorkerPool.h"
+#include "platform/image-decoders/FastSharedBufferReader.h"
 #include "platform/image-decoders/gif/GIFImageReader.h"
 #include "wtf/NotFound.h"
 #include "wtf/PassOwnPtr.h"
 
 namespace blink {
 
+namespace {
+
+// Smaller frames decode faster than a worker takes to start on them.
+const unsigned minimumPixelsToDecodeAhead = 128 * 128;
+
+} // namespace
+
+// Decodes the frames a requested frame needs on one thread, and the frame
+// after it, which needs none of them, on another. Each has a reader of its
+// own, made on the decoding thread, as they share the encoded data.
+class GIFImageDecoder::FrameAheadDecoder final : public DecodingWorkerPool::Job {
+    STACK_ALLOCATED();
+    WTF_MAKE_NONCOPYABLE(FrameAheadDecoder);
+public:
+    FrameAheadDecoder(GIFImageDecoder& decoder, const Vector<size_t>& framesToDecode, size_t frameAhead)
+        : m_decoder(decoder)
+        , m_framesToDecode(framesToDecode)
+        , m_frameAhead(frameAhead)
+        , m_reader(decoder.m_data)
+        , m_aheadReader(decoder.m_data)
+        , m_framesDecoded(false)
+        , m_frameAheadDecoded(false)
+    {
+        for (size_t frame : framesToDecode)
+            decoder.m_reader->prepareToDecode(frame, &m_reader);
+        decoder.m_reader->prepareToDecode(frameAhead, &m_aheadReader);
+    }
+
+    bool framesDecoded() const { return m_framesDecoded; }
+    bool frameAheadDecoded() const { return m_frameAheadDecoded; }
+
+    // DecodingWorkerPool::Job:
+    void decodePart(size_t part) override
+    {
+        if (!part) {
+            m_framesDecoded = m_decoder.decodeFrames(m_framesToDecode, &m_reader);
+            return;
+        }
+        TRACE_EVENT1("blink", "GIFImageDecoder::decodeFrameAhead", "frame", static_cast<int>(m_frameAhead));
+        m_frameAheadDecoded = m_decoder.m_reader->decode(m_frameAhead, &m_aheadReader);
+    }
+
+private:
+    GIFImageDecoder& m_decoder;
+    const Vector<size_t>& m_framesToDecode;
+    const size_t m_frameAhead;
+    FastSharedBufferReader m_reader;
+    FastSharedBufferReader m_aheadReader;
+    bool m_framesDecoded;
+    bool m_frameAheadDecoded;
+};
+
 GIFImageDecoder::GIFImageDecoder(AlphaOption alphaOption, GammaAndColorProfileOption colorOptions, size_t maxDecodedBytes)
     : ImageDecoder(alphaOption, colorOptions, maxDecodedBytes)
     , m_repetitionCount(cAnimationLoopOnce)
+    , m_downscaler(maxDecodedBytes)
+    , m_downscaledFrameIndex(kNotFound)
+    , m_aheadBufferSawAlpha(false)
+    , m_decodingFrameAhead(false)
+    , m_frameDecodedAhead(kNotFound)
 {
 }
 
@@ -96,9 +157,18 @@ float GIFImageDecoder::frameDurationAtIndex(size_t index) const
         m_reader->frameContext(index)->delayTime() : 0;
 }
 
+bool GIFImageDecoder::setSize(unsigned width, unsigned height)
+{
+    if (!ImageDecoder::setSize(width, height))
+        return false;
+    m_downscaler.setImageSize(size());
+    return true;
+}
+
 bool GIFImageDecoder::setFailed()
 {
-    m_reader.clear();
+    if (!m_decodingFrameAhead)
+        m_reader.clear();
     return ImageDecoder::setFailed();
 }
 
@@ -132,6 +202,25 @@ bool GIFImageDecoder::haveDecodedRow(size_t frameIndex, GIFRow::const_iterator r
 
     const size_t transparentPixel = frameContext->transparentPixel();
     GIFRow::const_iterator rowEnd = rowBegin + (xEnd - xBegin);
+
+    if (m_downscaler.isScaling()) {
+        // Rows are never repeated, as frames aren't displayed progressively.
+        ImageFrame::PixelData* rowAddress = m_downscaler.rowBuffer() + xBegin;
+        for (; rowBegin != rowEnd; ++rowBegin, ++rowAddress) {
+            const size_t sourceValue = *rowBegin;
+            if ((sourceValue != transparentPixel) && (sourceValue < colorTable.size())) {
+                *rowAddress = colorTableIter[sourceValue];
+            } else {
+                *rowAddress = 0;
+                sawAlpha(frameIndex) = true;
+            }
+        }
+        for (int y = yBegin; y < yEnd; ++y)
+            m_downscaler.rowDecoded(buffer, y, xBegin, xEnd, !writeTransparentPixels);
+        buffer.setPixelsChanged(true);
+        return true;
+    }
+
     ImageFrame::PixelData* currentAddress = buffer.getAddr(xBegin, yBegin);
 
     // We may or may not need to write transparent pixels to the buffer.
@@ -153,7 +242,7 @@ bool GIFImageDecoder::haveDecodedRow(size_t frameIndex, GIFRow::const_iterator r
                 *currentAddress = colorTableIter[sourceValue];
             } else {
                 *currentAddress = 0;
-                m_currentBufferSawAlpha = true;
+                sawAlpha(frameIndex) = true;
             }
         }
     } else {
@@ -162,7 +251,7 @@ bool GIFImageDecoder::haveDecodedRow(size_t frameIndex, GIFRow::const_iterator r
             if ((sourceValue != transparentPixel) && (sourceValue < colorTable.size()))
                 *currentAddress = colorTableIter[sourceValue];
             else
-                m_currentBufferSawAlpha = true;
+                sawAlpha(frameIndex) = true;
         }
     }
 
@@ -187,9 +276,13 @@ bool GIFImageDecoder::frameComplete(size_t frameIndex)
     if ((buffer.status() == ImageFrame::FrameEmpty) && !initFrameBuffer(frameIndex))
         return false; // initFrameBuffer() has already called setFailed().
 
+    if (m_downscaledFrameIndex == frameIndex) {
+        m_downscaler.flush(buffer);
+        m_downscaledFrameIndex = kNotFound;
+    }
     buffer.setStatus(ImageFrame::FrameComplete);
 
-    if (!m_currentBufferSawAlpha) {
+    if (!sawAlpha(frameIndex)) {
         // The whole frame was non-transparent, so it's possible that the entire
         // resulting buffer was non-transparent, and we can setHasAlpha(false).
         if (buffer.originalFrameRect().contains(IntRect(IntPoint(), size()))) {
@@ -221,15 +314,32 @@ bool GIFImageDecoder::frameComplete(size_t frameIndex)
 
 size_t GIFImageDecoder::clearCacheExceptFrame(size_t clearExceptFrame)
 {
+    // Don't clear if there are no frames or only one frame.
+    if (m_frameBufferCache.size() <= 1)
+        return 0;
+
     // We need to preserve frames such that:
     //  1. We don't clear |clearExceptFrame|;
     //  2. We don't clear any frame from which a future initFrameBuffer() call
-    //     will copy bitmap data.
+    //     will copy bitmap data;
+    //  3. We don't clear the frame decoded ahead of a frame up to
+    //     |clearExceptFrame|, unless all frames are cleared.
     // All other frames can be cleared.
+    const bool keepFrameAhead = clearExceptFrame != kNotFound && m_frameDecodedAhead != kNotFound && m_frameDecodedAhead > clearExceptFrame;
     while ((clearExceptFrame < m_frameBufferCache.size()) && (m_frameBufferCache[clearExceptFrame].status() == ImageFrame::FrameEmpty))
         clearExceptFrame = m_frameBufferCache[clearExceptFrame].requiredPreviousFrameIndex();
 
-    return ImageDecoder::clearCacheExceptFrame(clearExceptFrame);
+    if (!keepFrameAhead)
+        return ImageDecoder::clearCacheExceptFrame(clearExceptFrame);
+
+    size_t frameBytesCleared = 0;
+    for (size_t i = 0; i < m_frameBufferCache.size(); ++i) {
+        if (i != clearExceptFrame && i != m_frameDecodedAhead) {
+            frameBytesCleared += frameBytesAtIndex(i);
+            clearFrameBuffer(i);
+        }
+    }
+    return frameBytesCleared;
 }
 
 void GIFImageDecoder::clearFrameBuffer(size_t frameIndex)
@@ -239,6 +349,10 @@ void GIFImageDecoder::clearFrameBuffer(size_t frameIndex)
         // can be decoded again when requested.
         m_reader->clearDecodeState(frameIndex);
     }
+    if (m_downscaledFrameIndex == frameIndex)
+        m_downscaledFrameIndex = kNotFound;
+    if (m_frameDecodedAhead == frameIndex)
+        m_frameDecodedAhead = kNotFound;
     ImageDecoder::clearFrameBuffer(frameIndex);
 }
 
@@ -276,15 +390,36 @@ void GIFImageDecoder::decode(size_t index)
         frameToDecode = m_frameBufferCache[frameToDecode].requiredPreviousFrameIndex();
     } while (frameToDecode != kNotFound && m_frameBufferCache[frameToDecode].status() != ImageFrame::FrameComplete);
 
-    for (auto i = framesToDecode.rbegin(); i != framesToDecode.rend(); ++i) {
-        if (!m_reader->decode(*i)) {
+    const size_t frameAhead = frameToDecodeAhead(index);
+    if (frameAhead == kNotFound) {
+        FastSharedBufferReader reader(m_data);
+        if (!decodeFrames(framesToDecode, &reader)) {
             setFailed();
             return;
         }
-
-        // We need more data to continue decoding.
-        if (m_frameBufferCache[*i].status() != ImageFrame::FrameComplete)
-            break;
+    } else {
+        // The buffer of the frame ahead is set up here, as setting it up on
+        // the worker could fail the decoder there. This mustn't reset the
+        // alpha tracker of a partial frame about to resume decoding.
+        const bool currentBufferSawAlpha = m_currentBufferSawAlpha;
+        if (!initFrameBuffer(frameAhead))
+            return;
+        m_currentBufferSawAlpha = currentBufferSawAlpha;
+        m_aheadBufferSawAlpha = false;
+        m_frameDecodedAhead = frameAhead;
+        m_decodingFrameAhead = true;
+        FrameAheadDecoder frameAheadDecoder(*this, framesToDecode, frameAhead);
+        DecodingWorkerPool::shared()->run(frameAheadDecoder, 2);
+        m_decodingFrameAhead = false;
+
+        if (failed() || !frameAheadDecoder.framesDecoded()) {
+            setFailed();
+            return;
+        }
+        // A frame ahead which fails to decode is decoded again when it is
+        // asked for, failing the decoder then.
+        if (!frameAheadDecoder.frameAheadDecoded() || m_frameBufferCache[frameAhead].status() != ImageFrame::FrameComplete)
+            clearFrameBuffer(frameAhead);
     }
 
     // It is also a fatal error if all data is received and we have decoded all
@@ -293,6 +428,38 @@ void GIFImageDecoder::decode(size_t index)
         setFailed();
 }
 
+bool GIFImageDecoder::decodeFrames(const Vector<size_t>& framesToDecode, FastSharedBufferReader* reader)
+{
+    for (auto i = framesToDecode.rbegin(); i != framesToDecode.rend(); ++i) {
+        if (!m_reader->decode(*i, reader))
+            return false;
+
+        // We need more data to continue decoding.
+        if (m_frameBufferCache[*i].status() != ImageFrame::FrameComplete)
+            break;
+    }
+    return true;
+}
+
+size_t GIFImageDecoder::frameToDecodeAhead(size_t index) const
+{
+    if (!RuntimeEnabledFeatures::decodeImageFramesAheadEnabled() || m_downscaler.isScaling())
+        return kNotFound;
+
+    // Only frames whose data is all there decode ahead, so that they never
+    // wait for more data halfway through.
+    const size_t frameAhead = index + 1;
+    if (frameAhead >= m_frameBufferCache.size() || !frameIsCompleteAtIndex(frameAhead))
+        return kNotFound;
+    const ImageFrame& buffer = m_frameBufferCache[frameAhead];
+    if (buffer.status() != ImageFrame::FrameEmpty || buffer.requiredPreviousFrameIndex() != kNotFound)
+        return kNotFound;
+    const IntRect& frameRect = buffer.originalFrameRect();
+    if (static_cast<uint64_t>(frameRect.width()) * frameRect.height() < minimumPixelsToDecodeAhead)
+        return kNotFound;
+    return DecodingWorkerPool::shared() ? frameAhead : kNotFound;
+}
+
 void GIFImageDecoder::parse(GIFParseQuery query)
 {
     if (failed())
@@ -315,7 +482,7 @@ bool GIFImageDecoder::initFrameBuffer(size_t frameIndex)
     size_t requiredPreviousFrameIndex = buffer->requiredPreviousFrameIndex();
     if (requiredPreviousFrameIndex == kNotFound) {
         // This frame doesn't rely on any previous data.
-        if (!buffer->setSize(size().width(), size().height()))
+        if (!buffer->setSize(decodedSize().width(), decodedSize().height()))
             return setFailed();
     } else {
         const ImageFrame* prevBuffer = &m_frameBufferCache[requiredPreviousFrameIndex];
@@ -330,10 +497,19 @@ bool GIFImageDecoder::initFrameBuffer(size_t frameIndex)
             // affecting pixels in the image outside of the frame.
             const IntRect& prevRect = prevBuffer->originalFrameRect();
             ASSERT(!prevRect.contains(IntRect(IntPoint(), size())));
-            buffer->zeroFillFrameRect(prevRect);
+            buffer->zeroFillFrameRect(m_downscaler.scaledRect(prevRect));
         }
     }
 
+    if (m_downscaler.isScaling()) {
+        // The rows of another partial frame can't be kept around; decode that
+        // frame again when it is asked for.
+        if (m_downscaledFrameIndex != kNotFound)
+            clearFrameBuffer(m_downscaledFrameIndex);
+        m_downscaler.beginFrame(buffer->originalFrameRect());
+        m_downscaledFrameIndex = frameIndex;
+    }
+
     // Update our status to be partially complete.
     buffer->setStatus(ImageFrame::FramePartial);
 
@@ -27,8 +27,10 @@
 #define GIFImageDecoder_h
 
 #include "platform/image-decoders/ImageDecoder.h"
+#include "platform/image-decoders/ImageDownscaler.h"
 #include "wtf/Noncopyable.h"
 #include "wtf/OwnPtr.h"
+#include "wtf/Vector.h"
 
 class GIFImageReader;
 
@@ -36,7 +38,14 @@ typedef Vector<unsigned char> GIFRow;
 
 namespace blink {
 
+class FastSharedBufferReader;
+
 // This class decodes the GIF image format.
+//
+// With the DecodeImageFramesAhead feature, decoding a frame also decodes the
+// frame after it on a decoding worker, if that frame doesn't depend on the
+// frames before it, so that animations don't stall on it. The frame is kept
+// until the frames before it are shown.
 class PLATFORM_EXPORT GIFImageDecoder final : public ImageDecoder {
     WTF_MAKE_NONCOPYABLE(GIFImageDecoder);
 public:
@@ -47,6 +56,8 @@ public:
 
     // ImageDecoder:
     String filenameExtension() const override { return "gif"; }
+    IntSize decodedSize() const override { return m_downscaler.scaledSize(); }
+    bool setSize(unsigned width, unsigned height) override;
     void onSetData(SharedBuffer* data) override;
     int repetitionCount() const override;
     bool frameIsCompleteAtIndex(size_t) const override;
@@ -60,11 +71,16 @@ public:
     // Callbacks from the GIF reader.
     bool haveDecodedRow(size_t frameIndex, GIFRow::const_iterator rowBegin, size_t width, size_t rowNumber, unsigned repeatCount, bool writeTransparentPixels);
     bool frameComplete(size_t frameIndex);
+    // Downscaled rows only appear once all the rows they cover are decoded,
+    // so the reader doesn't display interlaced frames progressively.
+    bool downscalesFrames() const { return m_downscaler.isScaling(); }
 
     // For testing.
     bool parseCompleted() const;
 
 private:
+    class FrameAheadDecoder;
+
     // ImageDecoder:
     void clearFrameBuffer(size_t frameIndex) override;
     virtual void decodeSize() { parse(GIFSizeQuery); }
@@ -76,14 +92,33 @@ private:
     // data. If parsing fails, sets the "decode failure" flag.
     void parse(GIFParseQuery);
 
+    // Decodes |framesToDecode|, the last first, until one is incomplete.
+    // Returns false if the reader fails.
+    bool decodeFrames(const Vector<size_t>& framesToDecode, FastSharedBufferReader*);
+
+    // Returns the frame after |index| if it can decode while the frames
+    // |index| needs decode, or kNotFound.
+    size_t frameToDecodeAhead(size_t index) const;
+
     // Called to initialize the frame buffer with the given index, based on
     // the previous frame's disposal method. Returns true on success. On
     // failure, this will mark the image as failed.
     bool initFrameBuffer(size_t frameIndex);
 
+    bool& sawAlpha(size_t frameIndex) { return m_decodingFrameAhead && frameIndex == m_frameDecodedAhead ? m_aheadBufferSawAlpha : m_currentBufferSawAlpha; }
+
     bool m_currentBufferSawAlpha;
     mutable int m_repetitionCount;
     OwnPtr<GIFImageReader> m_reader;
+    ImageDownscaler m_downscaler;
+    // The partial frame whose rows the downscaler holds, if any.
+    size_t m_downscaledFrameIndex;
+    bool m_aheadBufferSawAlpha;
+    // Whether a frame decodes on a worker, in which case setFailed() leaves
+    // |m_reader| to decode() to delete.
+    bool m_decodingFrameAhead;
+    // The last frame decoded ahead, if it is still around.
+    size_t m_frameDecodedAhead;
 };
 
 } // namespace blink
@@ -31,14 +31,18 @@
 #include "config.h"
 #include "platform/image-decoders/gif/GIFImageDecoder.h"
 
+#include "platform/RuntimeEnabledFeatures.h"
 #include "platform/SharedBuffer.h"
+#include "platform/image-decoders/DecodingWorkerPool.h"
 #include "platform/image-decoders/ImageDecoderTestHelpers.h"
 #include "public/platform/WebData.h"
 #include "public/platform/WebSize.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "wtf/OwnPtr.h"
 #include "wtf/PassOwnPtr.h"
+#include "wtf/HashMap.h"
 #include "wtf/Vector.h"
+#include "SkColorPriv.h"
 
 namespace blink {
 
@@ -48,9 +52,14 @@ const char decodersTestingDir[] = "Source/platform/image-decoders/testing";
 const char layoutTestResourcesDir[] = "LayoutTests/fast/images/resources";
 const char webTestsDataDir[] = "Source/web/tests/data";
 
+PassOwnPtr<ImageDecoder> createDecoder(size_t maxDecodedBytes)
+{
+    return adoptPtr(new GIFImageDecoder(ImageDecoder::AlphaNotPremultiplied, ImageDecoder::GammaAndColorProfileApplied, maxDecodedBytes));
+}
+
 PassOwnPtr<ImageDecoder> createDecoder()
 {
-    return adoptPtr(new GIFImageDecoder(ImageDecoder::AlphaNotPremultiplied, ImageDecoder::GammaAndColorProfileApplied, ImageDecoder::noDecodedImageByteLimit));
+    return createDecoder(ImageDecoder::noDecodedImageByteLimit);
 }
 
 void testRandomFrameDecode(const char* dir, const char* gifFile)
@@ -110,6 +119,254 @@ void testRandomDecodeAfterClearFrameBufferCache(const char* dir, const char* gif
     }
 }
 
+// Writes the LZW codes of a frame the way GIFLZWContext reads them back,
+// growing the code size as the decoder's dictionary grows.
+class LZWCodeWriter {
+    STACK_ALLOCATED();
+public:
+    explicit LZWCodeWriter(int dataSize)
+        : m_dataSize(dataSize)
+        , m_clearCode(1 << dataSize)
+        , m_avail(m_clearCode + 2)
+        , m_oldcode(-1)
+        , m_codesize(dataSize + 1)
+        , m_datum(0)
+        , m_bits(0)
+    {
+    }
+
+    void write(int code)
+    {
+        m_datum |= code << m_bits;
+        m_bits += m_codesize;
+        for (; m_bits >= 8; m_bits -= 8, m_datum >>= 8)
+            m_bytes.append(static_cast<char>(m_datum & 0xFF));
+
+        if (code == m_clearCode) {
+            m_codesize = m_dataSize + 1;
+            m_avail = m_clearCode + 2;
+            m_oldcode = -1;
+            return;
+        }
+        if (m_avail < 4096 && m_oldcode != -1) {
+            ++m_avail;
+            if (!(m_avail & ((1 << m_codesize) - 1)) && m_avail < 4096)
+                ++m_codesize;
+        }
+        m_oldcode = code;
+    }
+
+    // Appends the codes written, in data sub-blocks, to |data|.
+    void finish(Vector<char>& data)
+    {
+        if (m_bits)
+            m_bytes.append(static_cast<char>(m_datum & 0xFF));
+        data.append(static_cast<char>(m_dataSize));
+        for (size_t position = 0; position < m_bytes.size(); position += 255) {
+            size_t length = std::min<size_t>(255, m_bytes.size() - position);
+            data.append(static_cast<char>(length));
+            data.append(m_bytes.data() + position, length);
+        }
+        data.append(0);
+    }
+
+private:
+    const int m_dataSize;
+    const int m_clearCode;
+    int m_avail;
+    int m_oldcode;
+    int m_codesize;
+    unsigned m_datum;
+    int m_bits;
+    Vector<char> m_bytes;
+};
+
+// Compresses |indices| into LZW codes. Once the dictionary is full, it either
+// starts over after a clear code, or keeps using the full dictionary.
+Vector<int> encodeLZW(const Vector<unsigned char>& indices, int dataSize, bool clearWhenFull)
+{
+    const int clearCode = 1 << dataSize;
+    Vector<int> codes;
+    codes.append(clearCode);
+    // Maps a code and the index which follows its string to the code of the
+    // longer string. Keys are offset by one, as 0 is the empty key.
+    HashMap<unsigned, int> dictionary;
+    int nextCode = clearCode + 2;
+    int code = indices[0];
+    for (size_t i = 1; i < indices.size(); ++i) {
+        unsigned key = (code << 8 | indices[i]) + 1;
+        HashMap<unsigned, int>::const_iterator it = dictionary.find(key);
+        if (it != dictionary.end()) {
+            code = it->value;
+            continue;
+        }
+        codes.append(code);
+        if (nextCode < 4096) {
+            dictionary.add(key, nextCode++);
+        } else if (clearWhenFull) {
+            codes.append(clearCode);
+            dictionary.clear();
+            nextCode = clearCode + 2;
+        }
+        code = indices[i];
+    }
+    codes.append(code);
+    codes.append(clearCode + 1);
+    return codes;
+}
+
+// Builds an image of |width| by |height| pixels whose frames all cover it,
+// with a global color table of 2^|colorBits| entries.
+class GIFBuilder {
+    STACK_ALLOCATED();
+public:
+    GIFBuilder(unsigned width, unsigned height, int colorBits)
+        : m_width(width)
+        , m_height(height)
+        , m_colorBits(colorBits)
+    {
+        m_data.append("GIF89a", 6);
+        appendShort(width);
+        appendShort(height);
+        m_data.append(static_cast<char>(0xF0 | (colorBits - 1)));
+        m_data.append(0); // Background color.
+        m_data.append(0); // Pixel aspect ratio.
+        for (int i = 0; i < 1 << colorBits; ++i) {
+            SkPMColor pixel = color(i);
+            m_data.append(static_cast<char>(SkGetPackedR32(pixel)));
+            m_data.append(static_cast<char>(SkGetPackedG32(pixel)));
+            m_data.append(static_cast<char>(SkGetPackedB32(pixel)));
+        }
+    }
+
+    static SkPMColor color(unsigned char index)
+    {
+        return SkPackARGB32NoCheck(255, index, static_cast<unsigned char>(index * 37 + 11), static_cast<unsigned char>(~index));
+    }
+
+    // Adds a frame encoded from |indices|. Index 0 is transparent if
+    // |transparent| is set. Every frame is disposed to the background, which
+    // lets the next one decode without it.
+    void addFrame(const Vector<unsigned char>& indices, bool transparent = false, bool clearWhenFull = true)
+    {
+        addFrameWithCodes(encodeLZW(indices, dataSize(), clearWhenFull), transparent);
+    }
+
+    // Adds a frame made of |codes|, valid or not.
+    void addFrameWithCodes(const Vector<int>& codes, bool transparent = false)
+    {
+        const char graphicControl[] = { 0x21, static_cast<char>(0xF9), 4, static_cast<char>(2 << 2 | transparent), 1, 0, 0, 0 };
+        m_data.append(graphicControl, sizeof(graphicControl));
+        m_data.append(0x2C); // Image descriptor.
+        appendShort(0);
+        appendShort(0);
+        appendShort(m_width);
+        appendShort(m_height);
+        m_data.append(0);
+        LZWCodeWriter writer(dataSize());
+        for (int code : codes)
+            writer.write(code);
+        writer.finish(m_data);
+    }
+
+    int dataSize() const { return std::max(m_colorBits, 2); }
+
+    PassRefPtr<SharedBuffer> data()
+    {
+        RefPtr<SharedBuffer> data = SharedBuffer::create(m_data.data(), m_data.size());
+        data->append(";", 1);
+        return data.release();
+    }
+
+private:
+    void appendShort(unsigned value)
+    {
+        m_data.append(static_cast<char>(value & 0xFF));
+        m_data.append(static_cast<char>(value >> 8));
+    }
+
+    const unsigned m_width;
+    const unsigned m_height;
+    const int m_colorBits;
+    Vector<char> m_data;
+};
+
+// Decodes a single frame image made of |indices| and checks every pixel.
+void testLZWDecode(unsigned width, unsigned height, int colorBits, const Vector<unsigned char>& indices, bool clearWhenFull)
+{
+    GIFBuilder builder(width, height, colorBits);
+    builder.addFrame(indices, false, clearWhenFull);
+    RefPtr<SharedBuffer> data = builder.data();
+
+    OwnPtr<ImageDecoder> decoder = createDecoder();
+    decoder->setData(data.get(), true);
+    ImageFrame* frame = decoder->frameBufferAtIndex(0);
+    ASSERT_TRUE(frame);
+    EXPECT_FALSE(decoder->failed());
+    ASSERT_EQ(ImageFrame::FrameComplete, frame->status());
+    for (unsigned y = 0; y < height; ++y) {
+        for (unsigned x = 0; x < width; ++x) {
+            if (*frame->getAddr(x, y) != GIFBuilder::color(indices[y * width + x])) {
+                ADD_FAILURE() << "Pixel (" << x << ", " << y << ") differs";
+                return;
+            }
+        }
+    }
+}
+
+// Returns runs of each index in turn, the lengths of which cycle through
+// |runLengths|.
+Vector<unsigned char> runs(size_t pixelCount, int colorBits, const Vector<size_t>& runLengths)
+{
+    Vector<unsigned char> indices;
+    for (size_t run = 0; indices.size() < pixelCount; ++run) {
+        size_t length = std::min(runLengths[run % runLengths.size()], pixelCount - indices.size());
+        indices.appendVector(Vector<unsigned char>(length, static_cast<unsigned char>(run % (1 << colorBits))));
+    }
+    return indices;
+}
+
+Vector<unsigned char> noise(size_t pixelCount, int colorBits)
+{
+    Vector<unsigned char> indices(pixelCount);
+    unsigned seed = 1;
+    for (size_t i = 0; i < pixelCount; ++i) {
+        seed = seed * 1103515245 + 12345;
+        indices[i] = (seed >> 16) % (1 << colorBits);
+    }
+    return indices;
+}
+
+void testAnimateFramesAhead(const char* dir, const char* gifFile)
+{
+    SCOPED_TRACE(gifFile);
+
+    RefPtr<SharedBuffer> data = readFile(dir, gifFile);
+    ASSERT_TRUE(data.get());
+    Vector<unsigned> baselineHashes;
+    createDecodingBaseline(&createDecoder, data.get(), &baselineHashes);
+    size_t frameCount = baselineHashes.size();
+
+    // Decode the frames in order keeping only the last one, as an animation
+    // does, twice to show the frames decoded ahead after they were cleared.
+    OwnPtr<DecodingWorkerPool> workers = DecodingWorkerPool::create(1);
+    ASSERT_TRUE(workers);
+    DecodingWorkerPool::setSharedForTesting(workers.get());
+    bool framesAheadEnabled = RuntimeEnabledFeatures::decodeImageFramesAheadEnabled();
+    RuntimeEnabledFeatures::setDecodeImageFramesAheadEnabled(true);
+    OwnPtr<ImageDecoder> decoder = createDecoder();
+    decoder->setData(data.get(), true);
+    for (size_t i = 0; i < frameCount * 2; ++i) {
+        SCOPED_TRACE(testing::Message() << "Frame:" << i % frameCount);
+        ImageFrame* frame = decoder->frameBufferAtIndex(i % frameCount);
+        EXPECT_EQ(ImageFrame::FrameComplete, frame->status());
+        EXPECT_EQ(baselineHashes[i % frameCount], hashBitmap(frame->getSkBitmap()));
+        decoder->clearCacheExceptFrame(i % frameCount);
+    }
+    RuntimeEnabledFeatures::setDecodeImageFramesAheadEnabled(framesAheadEnabled);
+    DecodingWorkerPool::setSharedForTesting(nullptr);
+}
+
 } // anonymous namespace
 
 TEST(GIFImageDecoderTest, decodeTwoFrames)
@@ -403,6 +660,171 @@ TEST(GIFImageDecoderTest, randomDecodeAfterClearFrameBufferCache)
     testRandomDecodeAfterClearFrameBufferCache(layoutTestResourcesDir, "animated-10color.gif");
 }
 
+TEST(GIFImageDecoderTest, animateFramesAhead)
+{
+    testAnimateFramesAhead(layoutTestResourcesDir, "animated-gif-with-offsets.gif");
+    testAnimateFramesAhead(layoutTestResourcesDir, "animated-10color.gif");
+}
+
+// Frames of 128x128 pixels or more which don't need the frame before them
+// decode on a worker while the frame before them decodes.
+TEST(GIFImageDecoderTest, decodeFramesAheadOnWorker)
+{
+    // Every other frame has transparent pixels, so the frame decoded ahead
+    // tracks its alpha apart from the frame asked for.
+    const unsigned size = 128;
+    GIFBuilder builder(size, size, 4);
+    const size_t frameCount = 5;
+    for (size_t i = 0; i < frameCount; ++i)
+        builder.addFrame(runs(size * size, 4, Vector<size_t>(1, 3 + i)), i % 2);
+    RefPtr<SharedBuffer> data = builder.data();
+
+    Vector<unsigned> baselineHashes;
+    Vector<bool> baselineHasAlpha;
+    OwnPtr<ImageDecoder> baselineDecoder = createDecoder();
+    baselineDecoder->setData(data.get(), true);
+    ASSERT_EQ(frameCount, baselineDecoder->frameCount());
+    for (size_t i = 0; i < frameCount; ++i) {
+        ImageFrame* frame = baselineDecoder->frameBufferAtIndex(i);
+        baselineHashes.append(hashBitmap(frame->getSkBitmap()));
+        baselineHasAlpha.append(frame->hasAlpha());
+    }
+
+    OwnPtr<DecodingWorkerPool> workers = DecodingWorkerPool::create(1);
+    ASSERT_TRUE(workers);
+    DecodingWorkerPool::setSharedForTesting(workers.get());
+    bool framesAheadEnabled = RuntimeEnabledFeatures::decodeImageFramesAheadEnabled();
+    RuntimeEnabledFeatures::setDecodeImageFramesAheadEnabled(true);
+
+    OwnPtr<ImageDecoder> decoder = createDecoder();
+    decoder->setData(data.get(), true);
+    for (size_t i = 0; i < frameCount; ++i) {
+        SCOPED_TRACE(testing::Message() << "Frame:" << i);
+        // Frame 0 and every other frame after it decode with the next frame
+        // ahead; the frames decoded ahead need no decoding when asked for.
+        bool decodedAhead = i % 2;
+        EXPECT_EQ(decodedAhead, !!decoder->frameBytesAtIndex(i));
+        int jobCount = workers->jobCount();
+        ImageFrame* frame = decoder->frameBufferAtIndex(i);
+        bool decodesAhead = !decodedAhead && i + 1 < frameCount;
+        EXPECT_EQ(jobCount + decodesAhead, workers->jobCount());
+        EXPECT_EQ(ImageFrame::FrameComplete, frame->status());
+        EXPECT_EQ(baselineHashes[i], hashBitmap(frame->getSkBitmap()));
+        EXPECT_EQ(baselineHasAlpha[i], frame->hasAlpha());
+
+        // The frame ahead outlives clearing the cache for the frame shown.
+        decoder->clearCacheExceptFrame(i);
+        if (decodesAhead)
+            EXPECT_TRUE(decoder->frameBytesAtIndex(i + 1));
+    }
+    EXPECT_FALSE(decoder->failed());
+
+    RuntimeEnabledFeatures::setDecodeImageFramesAheadEnabled(framesAheadEnabled);
+    DecodingWorkerPool::setSharedForTesting(nullptr);
+}
+
+// A frame which fails to decode ahead leaves the decoder working until the
+// frame is asked for.
+TEST(GIFImageDecoderTest, decodeBrokenFrameAheadOnWorker)
+{
+    const unsigned size = 128;
+    GIFBuilder builder(size, size, 4);
+    builder.addFrame(runs(size * size, 4, Vector<size_t>(1, 5)));
+    Vector<int> badCodes;
+    badCodes.append(1 << builder.dataSize());
+    badCodes.append(3);
+    badCodes.append(30); // Past the code being defined.
+    builder.addFrameWithCodes(badCodes);
+    RefPtr<SharedBuffer> data = builder.data();
+
+    OwnPtr<DecodingWorkerPool> workers = DecodingWorkerPool::create(1);
+    ASSERT_TRUE(workers);
+    DecodingWorkerPool::setSharedForTesting(workers.get());
+    bool framesAheadEnabled = RuntimeEnabledFeatures::decodeImageFramesAheadEnabled();
+    RuntimeEnabledFeatures::setDecodeImageFramesAheadEnabled(true);
+
+    OwnPtr<ImageDecoder> decoder = createDecoder();
+    decoder->setData(data.get(), true);
+    ASSERT_EQ(2u, decoder->frameCount());
+    ImageFrame* frame = decoder->frameBufferAtIndex(0);
+    EXPECT_EQ(1, workers->jobCount());
+    EXPECT_EQ(ImageFrame::FrameComplete, frame->status());
+    EXPECT_FALSE(decoder->failed());
+    EXPECT_FALSE(decoder->frameBytesAtIndex(1));
+
+    decoder->frameBufferAtIndex(1);
+    EXPECT_TRUE(decoder->failed());
+
+    RuntimeEnabledFeatures::setDecodeImageFramesAheadEnabled(framesAheadEnabled);
+    DecodingWorkerPool::setSharedForTesting(nullptr);
+}
+
+// Runs of one index define every code as the one being defined (KwKwK), and
+// make strings grow past several LZW_CHUNK_SIZE byte chunks.
+TEST(GIFImageDecoderTest, lzwRuns)
+{
+    testLZWDecode(64, 64, 1, runs(64 * 64, 1, Vector<size_t>(1, 64 * 32)), true);
+
+    Vector<size_t> runLengths;
+    for (size_t length = 1; length <= 25; ++length)
+        runLengths.append(length);
+    testLZWDecode(61, 47, 2, runs(61 * 47, 2, runLengths), true);
+    testLZWDecode(200, 100, 8, runs(200 * 100, 8, runLengths), true);
+}
+
+// Strings of 7 to 9 and 15 to 17 indices end on either side of the chunk
+// boundaries.
+TEST(GIFImageDecoderTest, lzwStringsAcrossChunks)
+{
+    Vector<size_t> runLengths;
+    const size_t lengths[] = { 7, 8, 9, 15, 16, 17 };
+    runLengths.append(lengths, WTF_ARRAY_LENGTH(lengths));
+    Vector<unsigned char> indices;
+    // Repeating a pattern makes the encoder reuse, and extend, long strings.
+    Vector<unsigned char> pattern = runs(70, 3, runLengths);
+    while (indices.size() < 100 * 100)
+        indices.appendVector(pattern);
+    indices.shrink(100 * 100);
+    testLZWDecode(100, 100, 3, indices, true);
+}
+
+// Noise fills the dictionary, after which images either clear it or keep on
+// with 12-bit codes from the full dictionary.
+TEST(GIFImageDecoderTest, lzwFullDictionary)
+{
+    testLZWDecode(256, 256, 8, noise(256 * 256, 8), true);
+    testLZWDecode(256, 256, 8, noise(256 * 256, 8), false);
+    testLZWDecode(256, 256, 2, noise(256 * 256, 2), false);
+}
+
+// Codes which aren't in the dictionary yet fail the decode.
+TEST(GIFImageDecoderTest, lzwInvalidCodes)
+{
+    const int dataSize = 2;
+    const int clearCode = 1 << dataSize;
+    const int codeLists[][4] = {
+        // The code being defined, right after a clear code.
+        { clearCode, clearCode + 2, 0, clearCode + 1 },
+        // A code past the one being defined.
+        { clearCode, 0, clearCode + 3, clearCode + 1 },
+        // The end code before the last row.
+        { clearCode, 0, 1, clearCode + 1 },
+    };
+    for (const auto& codeList : codeLists) {
+        GIFBuilder builder(16, 16, dataSize);
+        Vector<int> codes;
+        codes.append(codeList, WTF_ARRAY_LENGTH(codeList));
+        builder.addFrameWithCodes(codes);
+        RefPtr<SharedBuffer> data = builder.data();
+
+        OwnPtr<ImageDecoder> decoder = createDecoder();
+        decoder->setData(data.get(), true);
+        EXPECT_EQ(1u, decoder->frameCount());
+        ASSERT_TRUE(decoder->frameBufferAtIndex(0));
+        EXPECT_TRUE(decoder->failed());
+    }
+}
+
 TEST(GIFImageDecoderTest, resumePartialDecodeAfterClearFrameBufferCache)
 {
     RefPtr<SharedBuffer> fullData = readFile(layoutTestResourcesDir, "animated-10color.gif");
@@ -501,4 +923,10 @@ TEST(GIFImageDecoderTest, firstFrameHasGreaterSizeThanScreenSize)
     }
 }
 
+TEST(GIFImageDecoderTest, downscale)
+{
+    // The frames of this animation are offset within the image.
+    testDownscale(&createDecoder, "/LayoutTests/fast/images/resources/animated-gif-with-offsets.gif");
+}
+
 } // namespace blink
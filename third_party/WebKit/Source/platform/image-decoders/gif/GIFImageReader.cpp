@@ -202,7 +202,7 @@ bool GIFLZWContext::doLZW(const unsigned char* block, size_t bytesInBlock)
 {
     const size_t width = m_frameContext->width();
 
-    if (rowIter == rowBuffer.end())
+    if (rowIter == rowBuffer.end() - (LZW_CHUNK_SIZE - 1))
         return true;
 
     for (const unsigned char* ch = block; bytesInBlock-- > 0; ch++) {
@@ -234,40 +234,31 @@ bool GIFLZWContext::doLZW(const unsigned char* block, size_t bytesInBlock)
                 return false;
             }
 
-            const int tempCode = code;
-            unsigned short codeLength = 0;
-            if (code < avail) {
-                // This is a pre-existing code, so we already know what it
-                // encodes.
-                codeLength = suffixLength[code];
-                rowIter += codeLength;
-            } else if (code == avail && oldcode != -1) {
-                // This is a new code just being added to the dictionary.
-                // It must encode the contents of the previous code, plus
-                // the first character of the previous code again.
-                codeLength = suffixLength[oldcode] + 1;
-                rowIter += codeLength;
-                *--rowIter = firstchar;
-                code = oldcode;
-            } else {
+            if (code > avail || (code == avail && oldcode == -1)) {
                 // This is an invalid code. The dictionary is just initialized
                 // and the code is incomplete. We don't know how to handle
                 // this case.
                 return false;
             }
 
-            while (code >= clearCode) {
-                *--rowIter = suffix[code];
-                code = prefix[code];
-            }
-
-            *--rowIter = firstchar = suffix[code];
-
             // Define a new codeword in the dictionary as long as we've read
-            // more than one value from the stream.
+            // more than one value from the stream. If the code is the one
+            // being defined, it encodes the contents of the previous code,
+            // plus the first character of the previous code again.
             if (avail < MAX_DICTIONARY_ENTRIES && oldcode != -1) {
-                prefix[avail] = oldcode;
-                suffix[avail] = firstchar;
+                const unsigned char suffix = firstChar[code < avail ? code : oldcode];
+                const unsigned char oldLength = chunkLength[oldcode];
+                if (oldLength == LZW_CHUNK_SIZE) {
+                    prefix[avail] = oldcode;
+                    chunk[avail][0] = suffix;
+                    chunkLength[avail] = 1;
+                } else {
+                    prefix[avail] = prefix[oldcode];
+                    memcpy(chunk[avail], chunk[oldcode], LZW_CHUNK_SIZE);
+                    chunk[avail][oldLength] = suffix;
+                    chunkLength[avail] = oldLength + 1;
+                }
+                firstChar[avail] = firstChar[oldcode];
                 suffixLength[avail] = suffixLength[oldcode] + 1;
                 ++avail;
 
@@ -279,7 +270,19 @@ bool GIFLZWContext::doLZW(const unsigned char* block, size_t bytesInBlock)
                     codemask += avail;
                 }
             }
-            oldcode = tempCode;
+            oldcode = code;
+
+            // Write the string out a whole chunk at a time, from its end
+            // back. The last chunk may write past the end of the string, into
+            // bytes the next code overwrites.
+            const unsigned short codeLength = suffixLength[code];
+            GIFRow::iterator chunkIter = rowIter + codeLength - chunkLength[code];
+            memcpy(chunkIter, chunk[code], LZW_CHUNK_SIZE);
+            while (chunkIter != rowIter) {
+                code = prefix[code];
+                chunkIter -= LZW_CHUNK_SIZE;
+                memcpy(chunkIter, chunk[code], LZW_CHUNK_SIZE);
+            }
             rowIter += codeLength;
 
             // Output as many rows as possible.
@@ -377,15 +380,26 @@ bool GIFFrameContext::decode(blink::FastSharedBufferReader* reader, blink::GIFIm
 bool GIFImageReader::decode(size_t frameIndex)
 {
     blink::FastSharedBufferReader reader(m_data);
-    m_globalColorMap.buildTable(&reader);
+    return decode(frameIndex, &reader);
+}
+
+bool GIFImageReader::decode(size_t frameIndex, blink::FastSharedBufferReader* reader)
+{
+    m_globalColorMap.buildTable(reader);
 
     bool frameDecoded = false;
     GIFFrameContext* currentFrame = m_frames[frameIndex].get();
 
-    return currentFrame->decode(&reader, m_client, &frameDecoded)
+    return currentFrame->decode(reader, m_client, &frameDecoded)
         && (!frameDecoded || m_client->frameComplete(frameIndex));
 }
 
+void GIFImageReader::prepareToDecode(size_t frameIndex, blink::FastSharedBufferReader* reader)
+{
+    m_globalColorMap.buildTable(reader);
+    m_frames[frameIndex]->localColorMap().buildTable(reader);
+}
+
 bool GIFImageReader::parse(GIFImageDecoder::GIFParseQuery query)
 {
     ASSERT(m_bytesRead <= m_data->size());
@@ -732,7 +746,9 @@ bool GIFImageReader::parseData(size_t dataPosition, size_t len, GIFImageDecoder:
             // frame can be progressively displayed.
             // FIXME: It is possible that a non-transparent frame
             // can be interlaced and progressively displayed.
-            currentFrame->setProgressiveDisplay(currentFrameIsFirstFrame());
+            // Downscaled frames can't show rows before the rows below
+            // them are decoded either.
+            currentFrame->setProgressiveDisplay(currentFrameIsFirstFrame() && !(m_client && m_client->downscalesFrames()));
 
             const bool isLocalColormapDefined = currentComponent[8] & 0x80;
             if (isLocalColormapDefined) {
@@ -837,13 +853,18 @@ bool GIFLZWContext::prepareToDecode()
     // until we have at least one row worth of data, then call outputRow().
     // This means worst case we may have (row width - 1) bytes in the buffer
     // and then decode a sequence |maxBytes| long to append.
-    rowBuffer.resize(m_frameContext->width() - 1 + maxBytes);
+    // The last chunk of a sequence may write LZW_CHUNK_SIZE - 1 bytes
+    // past its end.
+    rowBuffer.resize(m_frameContext->width() - 1 + maxBytes + LZW_CHUNK_SIZE - 1);
     rowIter = rowBuffer.begin();
     rowsRemaining = m_frameContext->height();
 
-    // Clearing the whole suffix table lets us be more tolerant of bad data.
+    // Clearing the whole dictionary lets us be more tolerant of bad data.
+    memset(chunk, 0, sizeof(chunk));
     for (int i = 0; i < clearCode; ++i) {
-        suffix[i] = i;
+        chunk[i][0] = i;
+        chunkLength[i] = 1;
+        firstChar[i] = i;
         suffixLength[i] = 1;
     }
     return true;
@@ -51,6 +51,7 @@
 
 #define MAX_DICTIONARY_ENTRY_BITS 12
 #define MAX_DICTIONARY_ENTRIES    4096 // 2^MAX_DICTIONARY_ENTRY_BITS
+#define LZW_CHUNK_SIZE            8 // Bytes of its string each dictionary entry holds.
 #define MAX_COLORS                256
 #define BYTES_PER_COLORMAP_ENTRY  3
 
@@ -93,7 +94,6 @@ public:
         , clearCode(0)
         , avail(0)
         , oldcode(0)
-        , firstchar(0)
         , bits(0)
         , datum(0)
         , ipass(0)
@@ -116,15 +116,20 @@ private:
     int clearCode; // Codeword used to trigger dictionary reset.
     int avail; // Index of next available slot in dictionary.
     int oldcode;
-    unsigned char firstchar;
     int bits; // Number of unread bits in "datum".
     int datum; // 32-bit input buffer.
     int ipass; // Interlace pass; Ranges 1-4 if interlaced.
     size_t irow; // Current output row, starting at zero.
     size_t rowsRemaining; // Rows remaining to be output.
 
+    // The string of each code is kept as a chain of chunks, so that it can be
+    // written out LZW_CHUNK_SIZE bytes at a time. The chunk of a code holds the
+    // last chunkLength bytes of its string, and prefix is the code whose string
+    // is the rest of it. The strings of prefix codes fill whole chunks.
     unsigned short prefix[MAX_DICTIONARY_ENTRIES];
-    unsigned char suffix[MAX_DICTIONARY_ENTRIES];
+    unsigned char chunk[MAX_DICTIONARY_ENTRIES][LZW_CHUNK_SIZE];
+    unsigned char chunkLength[MAX_DICTIONARY_ENTRIES];
+    unsigned char firstChar[MAX_DICTIONARY_ENTRIES];
     unsigned short suffixLength[MAX_DICTIONARY_ENTRIES];
     GIFRow rowBuffer; // Single scanline temporary buffer.
     GIFRow::iterator rowIter;
@@ -302,6 +307,12 @@ public:
     void setData(PassRefPtr<blink::SharedBuffer> data) { m_data = data; }
     bool parse(blink::GIFImageDecoder::GIFParseQuery);
     bool decode(size_t frameIndex);
+    // Decodes a frame reading through |reader|. Frames can decode on several
+    // threads at once this way, each with a reader of its own, once
+    // prepareToDecode() has been called for each of them.
+    bool decode(size_t frameIndex, blink::FastSharedBufferReader*);
+    // Builds the color tables of a frame, which decode() would build lazily.
+    void prepareToDecode(size_t frameIndex, blink::FastSharedBufferReader*);
 
     size_t imagesCount() const
     {
@@ -190,7 +190,9 @@ bool ICOImageDecoder::decodeAtIndex(size_t index)
     if (!m_pngDecoders[index]) {
         AlphaOption alphaOption = m_premultiplyAlpha ? AlphaPremultiplied : AlphaNotPremultiplied;
         GammaAndColorProfileOption colorOptions = m_ignoreGammaAndColorProfile ? GammaAndColorProfileIgnored : GammaAndColorProfileApplied;
-        m_pngDecoders[index] = adoptPtr(new PNGImageDecoder(alphaOption, colorOptions, m_maxDecodedBytes, dirEntry.m_imageOffset));
+        // The frames of an icon keep the sizes in its directory, which the
+        // PNG decoder would change if it scaled them down.
+        m_pngDecoders[index] = adoptPtr(new PNGImageDecoder(alphaOption, colorOptions, noDecodedImageByteLimit, dirEntry.m_imageOffset));
         setDataForPNGDecoderAtIndex(index);
     }
     // Fail if the size the PNGImageDecoder calculated does not match the size
@@ -39,6 +39,8 @@
 #include "platform/image-decoders/jpeg/JPEGImageDecoder.h"
 
 #include "platform/PlatformInstrumentation.h"
+#include "platform/TraceEvent.h"
+#include "platform/image-decoders/DecodingWorkerPool.h"
 
 extern "C" {
 #include <stdio.h> // jpeglib.h needs stdio FILE.
@@ -74,9 +76,18 @@ namespace {
 
 const int exifMarker = JPEG_APP0 + 1;
 
+// Marker codes which jpeglib.h doesn't define.
+const unsigned char sof0Marker = 0xC0; // Baseline DCT
+const unsigned char sof1Marker = 0xC1; // Extended sequential DCT
+const unsigned char sosMarker = 0xDA;
+const unsigned char rst7Marker = JPEG_RST0 + 7;
+
 // JPEG only supports a denominator of 8.
 const unsigned scaleDenominator = 8;
 
+// Smaller images decode faster than the workers take to start on them.
+const unsigned minimumPixelsForParallelDecoding = 1024 * 1024;
+
 } // namespace
 
 namespace blink {
@@ -236,61 +247,362 @@ static void readColorProfile(jpeg_decompress_struct* info, ColorProfile& colorPr
 
 static IntSize computeYUVSize(const jpeg_decompress_struct* info, int component, ImageDecoder::SizeType sizeType)
 {
+    // Use comp_info rather than cur_comp_info: the first scan of a progressive
+    // or non-interleaved image may not contain every component.
     if (sizeType == ImageDecoder::SizeForMemoryAllocation) {
-        return IntSize(info->cur_comp_info[component]->width_in_blocks * DCTSIZE, info->cur_comp_info[component]->height_in_blocks * DCTSIZE);
+        return IntSize(info->comp_info[component].width_in_blocks * DCTSIZE, info->comp_info[component].height_in_blocks * DCTSIZE);
     }
-    return IntSize(info->cur_comp_info[component]->downsampled_width, info->cur_comp_info[component]->downsampled_height);
+    return IntSize(info->comp_info[component].downsampled_width, info->comp_info[component].downsampled_height);
 }
 
 static yuv_subsampling yuvSubsampling(const jpeg_decompress_struct& info)
 {
-    if ((DCTSIZE == 8)
-        && (info.num_components == 3)
-        && (info.comps_in_scan >= info.num_components)
-        && (info.scale_denom <= 8)
-        && (info.cur_comp_info[0])
-        && (info.cur_comp_info[1])
-        && (info.cur_comp_info[2])
-        && (info.cur_comp_info[1]->h_samp_factor == 1)
-        && (info.cur_comp_info[1]->v_samp_factor == 1)
-        && (info.cur_comp_info[2]->h_samp_factor == 1)
-        && (info.cur_comp_info[2]->v_samp_factor == 1)) {
-        int h = info.cur_comp_info[0]->h_samp_factor;
-        int v = info.cur_comp_info[0]->v_samp_factor;
-        // 4:4:4 : (h == 1) && (v == 1)
-        // 4:4:0 : (h == 1) && (v == 2)
-        // 4:2:2 : (h == 2) && (v == 1)
-        // 4:2:0 : (h == 2) && (v == 2)
-        // 4:1:1 : (h == 4) && (v == 1)
-        // 4:1:0 : (h == 4) && (v == 2)
-        if (v == 1) {
-            switch (h) {
-            case 1:
-                return YUV_444;
-            case 2:
-                return YUV_422;
-            case 4:
-                return YUV_411;
-            default:
-                break;
-            }
-        } else if (v == 2) {
-            switch (h) {
-            case 1:
-                return YUV_440;
-            case 2:
-                return YUV_420;
-            case 4:
-                return YUV_410;
-            default:
-                break;
-            }
+    if ((DCTSIZE != 8) || (info.num_components != 3) || (info.scale_denom > 8) || !info.comp_info)
+        return YUV_UNKNOWN;
+
+    // Both chroma components must be sampled alike, and the luma sampling
+    // factors must be whole multiples of theirs: encoders may write 4:2:0 as
+    // 2x2,1x1,1x1 or 4:4:4 as 2x2,2x2,2x2, for instance.
+    const jpeg_component_info* y = &info.comp_info[0];
+    const jpeg_component_info* u = &info.comp_info[1];
+    const jpeg_component_info* v = &info.comp_info[2];
+    if ((u->h_samp_factor != v->h_samp_factor) || (u->v_samp_factor != v->v_samp_factor))
+        return YUV_UNKNOWN;
+    if ((y->h_samp_factor % u->h_samp_factor) || (y->v_samp_factor % u->v_samp_factor))
+        return YUV_UNKNOWN;
+    // outputRawData() reads at most 16 rows of each component at a time.
+    if (y->v_samp_factor > 2)
+        return YUV_UNKNOWN;
+
+    int h = y->h_samp_factor / u->h_samp_factor;
+    int vRatio = y->v_samp_factor / u->v_samp_factor;
+    // 4:4:4 : (h == 1) && (v == 1)
+    // 4:4:0 : (h == 1) && (v == 2)
+    // 4:2:2 : (h == 2) && (v == 1)
+    // 4:2:0 : (h == 2) && (v == 2)
+    // 4:1:1 : (h == 4) && (v == 1)
+    // 4:1:0 : (h == 4) && (v == 2)
+    if (vRatio == 1) {
+        switch (h) {
+        case 1:
+            return YUV_444;
+        case 2:
+            return YUV_422;
+        case 4:
+            return YUV_411;
+        default:
+            break;
+        }
+    } else if (vRatio == 2) {
+        switch (h) {
+        case 1:
+            return YUV_440;
+        case 2:
+            return YUV_420;
+        case 4:
+            return YUV_410;
+        default:
+            break;
         }
     }
 
     return YUV_UNKNOWN;
 }
 
+// The source of a band, which has all of its data in memory.
+static boolean fill_band_input_buffer(j_decompress_ptr jd)
+{
+    // The band ended early: insert a fake EOI marker, as libjpeg's own memory
+    // source does, so the missing rows are reported as corrupt data.
+    static const JOCTET fakeEOI[2] = { 0xFF, JPEG_EOI };
+    jd->src->next_input_byte = fakeEOI;
+    jd->src->bytes_in_buffer = 2;
+    return true;
+}
+
+static void skip_band_input_data(j_decompress_ptr jd, long num_bytes)
+{
+    if (num_bytes <= 0)
+        return;
+    size_t bytesToSkip = std::min(static_cast<size_t>(num_bytes), jd->src->bytes_in_buffer);
+    jd->src->next_input_byte += bytesToSkip;
+    jd->src->bytes_in_buffer -= bytesToSkip;
+}
+
+static void term_band_source(j_decompress_ptr)
+{
+}
+
+// Decodes a baseline JPEG with restart markers in bands of MCU rows, in
+// parallel. The entropy decoder is reset at every restart marker, so when
+// every MCU row starts a restart interval, a band of rows decodes on its own:
+// it is decoded as a JPEG made of the headers of the image, with the height
+// of the band, and the entropy-coded data of its rows.
+//
+// When the chroma planes are subsampled vertically, upsampling the edge rows
+// of a band needs the chroma rows of the MCU rows around it, so each band
+// also decodes the MCU rows next to it and drops their pixels. This keeps the
+// output identical to decoding the image in one go.
+class JPEGBandDecoder final : public DecodingWorkerPool::Job {
+    STACK_ALLOCATED();
+    WTF_MAKE_NONCOPYABLE(JPEGBandDecoder);
+public:
+    JPEGBandDecoder(ImageFrame& buffer, J_COLOR_SPACE outColorSpace)
+        : m_buffer(buffer)
+        , m_outColorSpace(outColorSpace)
+        , m_width(0)
+        , m_height(0)
+        , m_mcuHeight(0)
+#if USE(QCMSLIB)
+        , m_transform(0)
+#endif
+    {
+    }
+
+#if USE(QCMSLIB)
+    void setColorTransform(qcms_transform* transform) { m_transform = transform; }
+#endif
+
+    // Splits the image into |bandCount| bands at most. |scanDataOffset| is the
+    // offset of the entropy-coded data of the single scan of |info|.
+    bool split(const jpeg_decompress_struct& info, SharedBuffer& data, size_t scanDataOffset, size_t bandCount)
+    {
+        if (!info.restart_interval || info.comps_in_scan != info.num_components)
+            return false;
+        if (info.num_components == 1 && (info.max_h_samp_factor != 1 || info.max_v_samp_factor != 1))
+            return false;
+
+        m_width = info.image_width;
+        m_height = info.image_height;
+        unsigned mcuWidth = info.max_h_samp_factor * DCTSIZE;
+        m_mcuHeight = info.max_v_samp_factor * DCTSIZE;
+        unsigned mcusPerRow = (m_width + mcuWidth - 1) / mcuWidth;
+        unsigned mcuRows = (m_height + m_mcuHeight - 1) / m_mcuHeight;
+        if (mcusPerRow % info.restart_interval)
+            return false;
+        unsigned intervalsPerRow = mcusPerRow / info.restart_interval;
+
+        bandCount = std::min<size_t>(bandCount, mcuRows / minimumMCURowsPerBand);
+        if (bandCount < 2)
+            return false;
+
+        Vector<size_t> markers;
+        size_t scanEnd;
+        if (!findRestartMarkers(data, scanDataOffset, markers, scanEnd))
+            return false;
+        if (markers.size() != mcuRows * intervalsPerRow - 1)
+            return false;
+
+        Vector<char> header;
+        size_t heightOffset;
+        if (!copyData(data, 0, scanDataOffset, header) || !findFrameHeight(header, heightOffset))
+            return false;
+
+        unsigned overlapRows = info.max_v_samp_factor > 1 ? 1 : 0;
+        unsigned rowsPerBand = (mcuRows + bandCount - 1) / bandCount;
+        for (unsigned firstRow = 0; firstRow < mcuRows; firstRow += rowsPerBand) {
+            Band band;
+            band.firstKeptRow = firstRow * m_mcuHeight;
+            band.endKeptRow = std::min(m_height, (firstRow + rowsPerBand) * m_mcuHeight);
+            unsigned firstDecodedMCURow = firstRow - std::min(firstRow, overlapRows);
+            unsigned endDecodedMCURow = std::min(mcuRows, firstRow + rowsPerBand + overlapRows);
+            band.firstDecodedRow = firstDecodedMCURow * m_mcuHeight;
+            band.decodedHeight = std::min(m_height, endDecodedMCURow * m_mcuHeight) - band.firstDecodedRow;
+
+            // The band's data runs from the restart marker before its first
+            // row to the one after its last row.
+            size_t firstInterval = firstDecodedMCURow * intervalsPerRow;
+            size_t endInterval = endDecodedMCURow * intervalsPerRow;
+            size_t dataStart = firstInterval ? markers[firstInterval - 1] + 2 : scanDataOffset;
+            size_t dataEnd = endInterval < markers.size() + 1 ? markers[endInterval - 1] : scanEnd;
+
+            band.stream.append(header.data(), header.size());
+            band.stream[heightOffset] = band.decodedHeight >> 8;
+            band.stream[heightOffset + 1] = band.decodedHeight & 0xFF;
+            if (!copyData(data, dataStart, dataEnd - dataStart, band.stream))
+                return false;
+            // libjpeg expects the restart markers of the band to count from 0.
+            for (size_t interval = firstInterval; interval + 1 < endInterval; ++interval)
+                band.stream[header.size() + markers[interval] + 1 - dataStart] = JPEG_RST0 + ((interval - firstInterval) & 7);
+            band.stream.append(static_cast<char>(0xFF));
+            band.stream.append(static_cast<char>(JPEG_EOI));
+            m_bands.append(band);
+        }
+        return true;
+    }
+
+    size_t bandCount() const { return m_bands.size(); }
+
+    bool allBandsDecoded() const
+    {
+        for (const Band& band : m_bands) {
+            if (!band.decoded)
+                return false;
+        }
+        return true;
+    }
+
+    // DecodingWorkerPool::Job:
+    void decodePart(size_t index) override
+    {
+        Band& band = m_bands[index];
+        // Rows decoded only for their chroma samples are dropped here.
+        Vector<unsigned char> droppedRow(m_width * 4);
+
+        jpeg_decompress_struct info;
+        decoder_error_mgr err;
+        jpeg_source_mgr src;
+        memset(&info, 0, sizeof(jpeg_decompress_struct));
+        info.err = jpeg_std_error(&err.pub);
+        err.pub.error_exit = error_exit;
+        jpeg_create_decompress(&info);
+        if (!setjmp(err.setjmp_buffer)) {
+            memset(&src, 0, sizeof(jpeg_source_mgr));
+            src.init_source = init_source;
+            src.fill_input_buffer = fill_band_input_buffer;
+            src.skip_input_data = skip_band_input_data;
+            src.resync_to_restart = jpeg_resync_to_restart;
+            src.term_source = term_band_source;
+            src.next_input_byte = reinterpret_cast<const JOCTET*>(band.stream.data());
+            src.bytes_in_buffer = band.stream.size();
+            info.src = &src;
+
+            // A fake EOI stands in for missing data, so don't trust a band
+            // which libjpeg had to warn about.
+            band.decoded = decodeBand(band, info, droppedRow.data()) && !err.pub.num_warnings;
+        }
+        jpeg_destroy_decompress(&info);
+    }
+
+private:
+    // Smaller bands cost more in duplicated header parsing and overlapping
+    // rows than they gain.
+    static const unsigned minimumMCURowsPerBand = 8;
+
+    struct Band {
+        Band() : firstKeptRow(0), endKeptRow(0), firstDecodedRow(0), decodedHeight(0), decoded(false) { }
+
+        unsigned firstKeptRow;
+        unsigned endKeptRow;
+        unsigned firstDecodedRow;
+        unsigned decodedHeight;
+        Vector<char> stream;
+        bool decoded;
+    };
+
+    bool decodeBand(const Band& band, jpeg_decompress_struct& info, JSAMPROW droppedRow)
+    {
+        if (jpeg_read_header(&info, true) != JPEG_HEADER_OK)
+            return false;
+        info.out_color_space = m_outColorSpace;
+        info.dct_method = JDCT_ISLOW;
+        info.dither_mode = JDITHER_FS;
+        info.do_fancy_upsampling = true;
+        info.do_block_smoothing = true;
+        if (!jpeg_start_decompress(&info))
+            return false;
+        if (info.output_width != m_width || info.output_height != band.decodedHeight)
+            return false;
+
+        while (info.output_scanline < info.output_height) {
+            unsigned y = band.firstDecodedRow + info.output_scanline;
+            bool kept = y >= band.firstKeptRow && y < band.endKeptRow;
+            JSAMPROW row = kept ? reinterpret_cast_ptr<JSAMPROW>(m_buffer.getAddr(0, y)) : droppedRow;
+            if (jpeg_read_scanlines(&info, &row, 1) != 1)
+                return false;
+#if USE(QCMSLIB)
+            if (kept && m_transform)
+                qcms_transform_data_type(m_transform, row, row, m_width, rgbOutputColorSpace() == JCS_EXT_BGRA ? QCMS_OUTPUT_BGRX : QCMS_OUTPUT_RGBX);
+#endif
+        }
+        return true;
+    }
+
+    static bool copyData(SharedBuffer& data, size_t position, size_t length, Vector<char>& destination)
+    {
+        while (length) {
+            const char* segment;
+            size_t segmentLength = data.getSomeData(segment, position);
+            if (!segmentLength)
+                return false;
+            segmentLength = std::min(segmentLength, length);
+            destination.append(segment, segmentLength);
+            position += segmentLength;
+            length -= segmentLength;
+        }
+        return true;
+    }
+
+    // Finds the restart markers in the entropy-coded data starting at
+    // |position|, and the marker which ends it.
+    static bool findRestartMarkers(SharedBuffer& data, size_t position, Vector<size_t>& markers, size_t& scanEnd)
+    {
+        bool afterFF = false;
+        for (;;) {
+            const char* segment;
+            size_t length = data.getSomeData(segment, position);
+            if (!length)
+                return false;
+            for (size_t i = 0; i < length; ++i) {
+                unsigned char byte = segment[i];
+                if (!afterFF) {
+                    afterFF = byte == 0xFF;
+                    continue;
+                }
+                // 0xFF 0xFF is a fill byte, and 0xFF 0x00 a stuffed 0xFF.
+                if (byte == 0xFF)
+                    continue;
+                afterFF = false;
+                if (!byte)
+                    continue;
+                if (byte < JPEG_RST0 || byte > rst7Marker) {
+                    scanEnd = position + i - 1;
+                    return true;
+                }
+                if (byte != JPEG_RST0 + (markers.size() & 7))
+                    return false;
+                markers.append(position + i - 1);
+            }
+            position += length;
+        }
+    }
+
+    // Finds the offset of the image height in the SOF marker of |header|.
+    static bool findFrameHeight(const Vector<char>& header, size_t& heightOffset)
+    {
+        size_t position = 2; // Skip SOI.
+        while (position + 4 <= header.size()) {
+            if (static_cast<unsigned char>(header[position]) != 0xFF)
+                return false;
+            unsigned char marker = header[position + 1];
+            if (marker == 0xFF) {
+                ++position;
+                continue;
+            }
+            if (marker == sof0Marker || marker == sof1Marker) {
+                // Length, sample precision, then the height.
+                heightOffset = position + 5;
+                return heightOffset + 2 <= header.size();
+            }
+            if (marker == sosMarker)
+                return false;
+            size_t length = (static_cast<unsigned char>(header[position + 2]) << 8) | static_cast<unsigned char>(header[position + 3]);
+            position += 2 + length;
+        }
+        return false;
+    }
+
+    ImageFrame& m_buffer;
+    J_COLOR_SPACE m_outColorSpace;
+    unsigned m_width;
+    unsigned m_height;
+    unsigned m_mcuHeight;
+    Vector<Band> m_bands;
+#if USE(QCMSLIB)
+    qcms_transform* m_transform;
+#endif
+};
+
 class JPEGImageReader final {
     USING_FAST_MALLOC(JPEGImageReader);
     WTF_MAKE_NONCOPYABLE(JPEGImageReader);
@@ -300,6 +612,7 @@ public:
         , m_needsRestart(false)
         , m_restartPosition(0)
         , m_nextReadPosition(0)
+        , m_scanDataOffset(0)
         , m_lastSetByte(nullptr)
         , m_state(JPEG_HEADER)
         , m_samples(nullptr)
@@ -424,6 +737,7 @@ public:
             // Read file parameters with jpeg_read_header().
             if (jpeg_read_header(&m_info, true) == JPEG_SUSPENDED)
                 return false; // I/O suspension.
+            m_scanDataOffset = m_nextReadPosition - m_info.src->bytes_in_buffer;
 
             switch (m_info.jpeg_color_space) {
             case JCS_YCbCr:
@@ -537,6 +851,11 @@ public:
             m_info.quantize_colors = false;
             m_info.colormap = 0;
 
+            if (!m_info.buffered_image && decodeBandsInParallel()) {
+                m_decoder->complete();
+                return true;
+            }
+
             // Make a one-row-high sample array that will go away when done with
             // image. Always make it big enough to hold one RGBA row. Since this
             // uses the IJG memory manager, it must be allocated before the call
@@ -677,6 +996,44 @@ private:
         return (*m_info.mem->alloc_sarray)(reinterpret_cast_ptr<j_common_ptr>(&m_info), JPOOL_IMAGE, width * 4, 1);
     }
 
+    // Decodes a complete baseline image in bands on the decoding workers, if
+    // it is large enough and restart markers split it into bands.
+    bool decodeBandsInParallel()
+    {
+#if defined(TURBO_JPEG_RGB_SWIZZLE)
+        if (!m_decoder->isAllDataReceived() || m_decoder->hasImagePlanes())
+            return false;
+        if (m_info.progressive_mode || m_info.arith_code || m_info.scale_num != m_info.scale_denom)
+            return false;
+        if (!turboSwizzled(m_info.out_color_space) || static_cast<uint64_t>(m_info.image_width) * m_info.image_height < minimumPixelsForParallelDecoding)
+            return false;
+        DecodingWorkerPool* workers = DecodingWorkerPool::shared();
+        if (!workers)
+            return false;
+        ImageFrame* buffer = m_decoder->frameBufferForOutput();
+        if (!buffer)
+            return false;
+
+        JPEGBandDecoder bandDecoder(*buffer, m_info.out_color_space);
+#if USE(QCMSLIB)
+        bandDecoder.setColorTransform(m_transform);
+#endif
+        if (!bandDecoder.split(m_info, *m_data, m_scanDataOffset, workers->workerCount() + 1))
+            return false;
+
+        TRACE_EVENT1("blink", "JPEGImageReader::decodeBandsInParallel", "bands", static_cast<int>(bandDecoder.bandCount()));
+        workers->run(bandDecoder, bandDecoder.bandCount());
+        // A band which fails to decode on its own is decoded again with the
+        // rest of the image.
+        if (!bandDecoder.allBandsDecoded())
+            return false;
+        buffer->setPixelsChanged(true);
+        return true;
+#else
+        return false;
+#endif
+    }
+
     void updateRestartPosition()
     {
         if (m_lastSetByte != m_info.src->next_input_byte) {
@@ -707,6 +1064,8 @@ private:
     // has found the next restart position, so if it no longer matches this
     // value, we know we've reached the next restart position.
     const JOCTET* m_lastSetByte;
+    // The position of the entropy-coded data of the first scan.
+    unsigned m_scanDataOffset;
 
     jpeg_decompress_struct m_info;
     decoder_error_mgr m_err;
@@ -902,14 +1261,15 @@ static bool outputRawData(JPEGImageReader* reader, ImagePlanes* imagePlanes)
     jpeg_decompress_struct* info = reader->info();
 
     JSAMPARRAY bufferraw[3];
-    JSAMPROW bufferraw2[32];
+    JSAMPROW bufferraw2[48];
     bufferraw[0] = &bufferraw2[0]; // Y channel rows (8 or 16)
-    bufferraw[1] = &bufferraw2[16]; // U channel rows (8)
-    bufferraw[2] = &bufferraw2[24]; // V channel rows (8)
+    bufferraw[1] = &bufferraw2[16]; // U channel rows (8 or 16)
+    bufferraw[2] = &bufferraw2[32]; // V channel rows (8 or 16)
     int yWidth = info->output_width;
     int yHeight = info->output_height;
     int yMaxH = yHeight - 1;
-    int v = info->cur_comp_info[0]->v_samp_factor;
+    int maxV = info->max_v_samp_factor;
+    int uvV = info->comp_info[1].v_samp_factor;
     IntSize uvSize = reader->uvSize();
     int uvMaxH = uvSize.height() - 1;
     JSAMPROW outputY = static_cast<JSAMPROW>(imagePlanes->plane(0));
@@ -919,8 +1279,10 @@ static bool outputRawData(JPEGImageReader* reader, ImagePlanes* imagePlanes)
     size_t rowBytesU = imagePlanes->rowBytes(1);
     size_t rowBytesV = imagePlanes->rowBytes(2);
 
-    // Request 8 or 16 scanlines: returns 0 or more scanlines.
-    int yScanlinesToRead = DCTSIZE * v;
+    // Request 8 or 16 scanlines: returns 0 or more scanlines. Each component
+    // gets DCTSIZE rows per unit of its vertical sampling factor.
+    int yScanlinesToRead = DCTSIZE * maxV;
+    int uvScanlinesToRead = DCTSIZE * uvV;
     JSAMPROW yLastRow = *samples;
     JSAMPROW uLastRow = yLastRow + rowBytesY;
     JSAMPROW vLastRow = uLastRow + rowBytesY;
@@ -941,21 +1303,21 @@ static bool outputRawData(JPEGImageReader* reader, ImagePlanes* imagePlanes)
             }
         }
 
-        // Assign 8 rows of memory to read the U and V channels.
+        // Assign 8 or 16 rows of memory to read the U and V channels.
         bool hasUVLastRow = false;
-        int scaledScanline = info->output_scanline / v;
-        for (int i = 0; i < 8; ++i) {
+        int scaledScanline = info->output_scanline * uvV / maxV;
+        for (int i = 0; i < uvScanlinesToRead; ++i) {
             int scanline = scaledScanline + i;
             if (scanline < uvMaxH) {
                 bufferraw2[16 + i] = &outputU[scanline * rowBytesU];
-                bufferraw2[24 + i] = &outputV[scanline * rowBytesV];
+                bufferraw2[32 + i] = &outputV[scanline * rowBytesV];
             } else if (scanline == uvMaxH) {
                 bufferraw2[16 + i] = uLastRow;
-                bufferraw2[24 + i] = vLastRow;
+                bufferraw2[32 + i] = vLastRow;
                 hasUVLastRow = true;
             } else {
                 bufferraw2[16 + i] = dummyRow;
-                bufferraw2[24 + i] = dummyRow;
+                bufferraw2[32 + i] = dummyRow;
             }
         }
 
@@ -976,24 +1338,14 @@ static bool outputRawData(JPEGImageReader* reader, ImagePlanes* imagePlanes)
     return true;
 }
 
-bool JPEGImageDecoder::outputScanlines()
+ImageFrame* JPEGImageDecoder::frameBufferForOutput()
 {
-    if (hasImagePlanes())
-        return outputRawData(m_reader.get(), m_imagePlanes.get());
-
     if (m_frameBufferCache.isEmpty())
-        return false;
-
-    jpeg_decompress_struct* info = m_reader->info();
-
-    // Initialize the framebuffer if needed.
+        return nullptr;
     ImageFrame& buffer = m_frameBufferCache[0];
     if (buffer.status() == ImageFrame::FrameEmpty) {
-        ASSERT(info->output_width == static_cast<JDIMENSION>(m_decodedSize.width()));
-        ASSERT(info->output_height == static_cast<JDIMENSION>(m_decodedSize.height()));
-
-        if (!buffer.setSize(info->output_width, info->output_height))
-            return setFailed();
+        if (!buffer.setSize(m_decodedSize.width(), m_decodedSize.height()))
+            return nullptr;
 
         // The buffer is transparent outside the decoded area while the image is
         // loading. The image will be marked fully opaque in complete().
@@ -1003,6 +1355,24 @@ bool JPEGImageDecoder::outputScanlines()
         // For JPEGs, the frame always fills the entire image.
         buffer.setOriginalFrameRect(IntRect(IntPoint(), size()));
     }
+    return &buffer;
+}
+
+bool JPEGImageDecoder::outputScanlines()
+{
+    if (hasImagePlanes())
+        return outputRawData(m_reader.get(), m_imagePlanes.get());
+
+    if (m_frameBufferCache.isEmpty())
+        return false;
+
+    ImageFrame* frame = frameBufferForOutput();
+    if (!frame)
+        return setFailed();
+    ImageFrame& buffer = *frame;
+    jpeg_decompress_struct* info = m_reader->info();
+    ASSERT(info->output_width == static_cast<JDIMENSION>(m_decodedSize.width()));
+    ASSERT(info->output_height == static_cast<JDIMENSION>(m_decodedSize.height()));
 
 #if defined(TURBO_JPEG_RGB_SWIZZLE)
     if (turboSwizzled(info->out_color_space)) {
@@ -50,6 +50,9 @@ public:
     void setImagePlanes(PassOwnPtr<ImagePlanes>) override;
     bool hasImagePlanes() const { return m_imagePlanes; }
 
+    // Returns the frame to output decoded rows to, allocating it first if
+    // needed, or null if it can't be allocated.
+    ImageFrame* frameBufferForOutput();
     bool outputScanlines();
     unsigned desiredScaleNumerator() const;
     void complete();
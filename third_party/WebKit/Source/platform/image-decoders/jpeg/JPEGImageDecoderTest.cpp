@@ -32,6 +32,7 @@
 #include "platform/image-decoders/jpeg/JPEGImageDecoder.h"
 
 #include "platform/SharedBuffer.h"
+#include "platform/image-decoders/DecodingWorkerPool.h"
 #include "platform/image-decoders/ImageAnimation.h"
 #include "platform/image-decoders/ImageDecoderTestHelpers.h"
 #include "public/platform/WebData.h"
@@ -40,6 +41,11 @@
 #include "wtf/OwnPtr.h"
 #include "wtf/PassOwnPtr.h"
 
+extern "C" {
+#include <stdio.h> // jpeglib.h needs stdio FILE.
+#include "jpeglib.h"
+}
+
 namespace blink {
 
 static const size_t LargeEnoughSize = 1000 * 1000;
@@ -56,6 +62,130 @@ PassOwnPtr<ImageDecoder> createDecoder()
     return createDecoder(ImageDecoder::noDecodedImageByteLimit);
 }
 
+struct EncodedJPEG : public jpeg_destination_mgr {
+    RefPtr<SharedBuffer> data;
+    JOCTET buffer[8192];
+};
+
+void initDestination(j_compress_ptr cinfo)
+{
+    EncodedJPEG* out = static_cast<EncodedJPEG*>(cinfo->dest);
+    out->next_output_byte = out->buffer;
+    out->free_in_buffer = sizeof(out->buffer);
+}
+
+boolean emptyOutputBuffer(j_compress_ptr cinfo)
+{
+    EncodedJPEG* out = static_cast<EncodedJPEG*>(cinfo->dest);
+    out->data->append(reinterpret_cast<const char*>(out->buffer), sizeof(out->buffer));
+    initDestination(cinfo);
+    return true;
+}
+
+void termDestination(j_compress_ptr cinfo)
+{
+    EncodedJPEG* out = static_cast<EncodedJPEG*>(cinfo->dest);
+    out->data->append(reinterpret_cast<const char*>(out->buffer), sizeof(out->buffer) - out->free_in_buffer);
+}
+
+// Encodes a baseline JPEG of a noisy gradient with a restart marker at the
+// start of every MCU row, which lets the decoder split it into bands. The
+// chroma planes are subsampled by |chromaSubsampling| in both directions.
+PassRefPtr<SharedBuffer> encodeJPEGWithRestartMarkerPerRow(unsigned width, unsigned height, int chromaSubsampling)
+{
+    jpeg_compress_struct cinfo;
+    jpeg_error_mgr error;
+    cinfo.err = jpeg_std_error(&error);
+    jpeg_create_compress(&cinfo);
+
+    EncodedJPEG out;
+    out.data = SharedBuffer::create();
+    out.init_destination = initDestination;
+    out.empty_output_buffer = emptyOutputBuffer;
+    out.term_destination = termDestination;
+    cinfo.dest = &out;
+
+    cinfo.image_width = width;
+    cinfo.image_height = height;
+    cinfo.input_components = 3;
+    cinfo.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, 90, TRUE);
+    cinfo.comp_info[0].h_samp_factor = chromaSubsampling;
+    cinfo.comp_info[0].v_samp_factor = chromaSubsampling;
+    cinfo.restart_in_rows = 1;
+
+    jpeg_start_compress(&cinfo, TRUE);
+    Vector<JSAMPLE> row(width * 3);
+    while (cinfo.next_scanline < height) {
+        unsigned y = cinfo.next_scanline;
+        for (unsigned x = 0; x < width; ++x) {
+            unsigned noise = (x * 7919 + y * 104729) >> 3;
+            row[x * 3] = (x * 255 / width) ^ (noise & 0x1F);
+            row[x * 3 + 1] = (y * 255 / height) ^ ((noise >> 5) & 0x1F);
+            row[x * 3 + 2] = (x + y) ^ (noise >> 10);
+        }
+        JSAMPROW rowPointer = row.data();
+        jpeg_write_scanlines(&cinfo, &rowPointer, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+    return out.data.release();
+}
+
+// Decodes |data| with |pool| as the decoding workers and returns a copy of
+// the pixels.
+SkBitmap decodeWithWorkers(SharedBuffer* data, DecodingWorkerPool* pool)
+{
+    DecodingWorkerPool::setSharedForTesting(pool);
+    OwnPtr<ImageDecoder> decoder = createDecoder();
+    decoder->setData(data, true);
+    ImageFrame* frame = decoder->frameBufferAtIndex(0);
+    DecodingWorkerPool::setSharedForTesting(nullptr);
+
+    SkBitmap bitmap;
+    EXPECT_TRUE(frame);
+    EXPECT_FALSE(decoder->failed());
+    if (frame && frame->status() == ImageFrame::FrameComplete)
+        frame->getSkBitmap().copyTo(&bitmap);
+    return bitmap;
+}
+
+void testBandedDecode(int chromaSubsampling)
+{
+    // Bands are only decoded in images of a megapixel or more.
+    const unsigned width = 1280;
+    const unsigned height = 1024;
+    RefPtr<SharedBuffer> data = encodeJPEGWithRestartMarkerPerRow(width, height, chromaSubsampling);
+
+    // Without workers the image can't be split, and decodes in one go.
+    OwnPtr<DecodingWorkerPool> serialPool = DecodingWorkerPool::create(0);
+    OwnPtr<DecodingWorkerPool> workers = DecodingWorkerPool::create(3);
+    ASSERT_TRUE(serialPool);
+    ASSERT_TRUE(workers);
+    SkBitmap serial = decodeWithWorkers(data.get(), serialPool.get());
+    SkBitmap banded = decodeWithWorkers(data.get(), workers.get());
+    EXPECT_EQ(0, serialPool->jobCount());
+#if defined(JCS_ALPHA_EXTENSIONS)
+    EXPECT_EQ(1, workers->jobCount());
+#endif
+
+    ASSERT_EQ(static_cast<int>(width), serial.width());
+    ASSERT_EQ(static_cast<int>(height), serial.height());
+    ASSERT_EQ(serial.width(), banded.width());
+    ASSERT_EQ(serial.height(), banded.height());
+    SkAutoLockPixels serialLock(serial);
+    SkAutoLockPixels bandedLock(banded);
+    for (unsigned y = 0; y < height; ++y) {
+        for (unsigned x = 0; x < width; ++x) {
+            if (*serial.getAddr32(x, y) != *banded.getAddr32(x, y)) {
+                ADD_FAILURE() << "Pixel (" << x << ", " << y << ") differs";
+                return;
+            }
+        }
+    }
+}
+
 } // anonymous namespace
 
 void downsample(size_t maxDecodedBytes, unsigned* outputWidth, unsigned* outputHeight, const char* imageFilePath)
@@ -231,6 +361,12 @@ TEST(JPEGImageDecoderTest, yuv)
     ASSERT_FALSE(decoder->canDecodeToYUV());
 }
 
+TEST(JPEGImageDecoderTest, decodeToYUV)
+{
+    testDecodeToYUV(&createDecoder, "/LayoutTests/fast/images/resources/lenna.jpg");
+    testDecodeToYUV(&createDecoder, "/LayoutTests/fast/images/resources/bug106024.jpg"); // Progressive
+}
+
 TEST(JPEGImageDecoderTest, byteByByteBaselineJPEGWithColorProfileAndRestartMarkers)
 {
     testByteByByteDecode(&createDecoder, "/LayoutTests/fast/images/resources/small-square-with-colorspin-profile.jpg", 1u, cAnimationNone);
@@ -246,6 +382,19 @@ TEST(JPEGImageDecoderTest, byteByByteRGBJPEGWithAdobeMarkers)
     testByteByByteDecode(&createDecoder, "/LayoutTests/fast/images/resources/rgb-jpeg-with-adobe-marker-only.jpg", 1u, cAnimationNone);
 }
 
+// Tests that decoding a baseline JPEG in bands on the decoding workers outputs
+// the same pixels as decoding it in one go.
+TEST(JPEGImageDecoderTest, bandedDecode420)
+{
+    testBandedDecode(2);
+}
+
+// Without chroma subsampling, the bands don't overlap.
+TEST(JPEGImageDecoderTest, bandedDecode444)
+{
+    testBandedDecode(1);
+}
+
 // This test verifies that calling SharedBuffer::mergeSegmentsIntoBuffer() does
 // not break JPEG decoding at a critical point: in between a call to decode the
 // size (when JPEGImageDecoder stops while it may still have input data to
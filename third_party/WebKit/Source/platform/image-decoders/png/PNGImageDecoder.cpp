@@ -200,6 +200,8 @@ private:
 
 PNGImageDecoder::PNGImageDecoder(AlphaOption alphaOption, GammaAndColorProfileOption colorOptions, size_t maxDecodedBytes, unsigned offset)
     : ImageDecoder(alphaOption, colorOptions, maxDecodedBytes)
+    , m_downscaler(maxDecodedBytes)
+    , m_nextDownscaledRow(0)
     , m_hasColorProfile(false)
     , m_offset(offset)
 {
@@ -265,6 +267,7 @@ void PNGImageDecoder::headerAvailable()
         longjmp(JMPBUF(png), 1);
         return;
     }
+    m_downscaler.setImageSize(size());
 
     int bitDepth, colorType, interlaceType, compressionType, filterType, channels;
     png_get_IHDR(png, info, &width, &height, &bitDepth, &colorType, &interlaceType, &compressionType, &filterType);
@@ -345,7 +348,7 @@ void PNGImageDecoder::headerAvailable()
     }
 }
 
-void PNGImageDecoder::rowAvailable(unsigned char* rowBuffer, unsigned rowIndex, int)
+void PNGImageDecoder::rowAvailable(unsigned char* rowBuffer, unsigned rowIndex, int pass)
 {
     if (m_frameBufferCache.isEmpty())
         return;
@@ -354,7 +357,7 @@ void PNGImageDecoder::rowAvailable(unsigned char* rowBuffer, unsigned rowIndex,
     ImageFrame& buffer = m_frameBufferCache[0];
     if (buffer.status() == ImageFrame::FrameEmpty) {
         png_structp png = m_reader->pngPtr();
-        if (!buffer.setSize(size().width(), size().height())) {
+        if (!buffer.setSize(decodedSize().width(), decodedSize().height())) {
             longjmp(JMPBUF(png), 1);
             return;
         }
@@ -382,6 +385,8 @@ void PNGImageDecoder::rowAvailable(unsigned char* rowBuffer, unsigned rowIndex,
 
         // For PNGs, the frame always fills the entire image.
         buffer.setOriginalFrameRect(IntRect(IntPoint(), size()));
+        if (m_downscaler.isScaling())
+            m_downscaler.beginFrame(IntRect(IntPoint(), size()));
     }
 
     /* libpng comments (here to explain what follows).
@@ -433,6 +438,26 @@ void PNGImageDecoder::rowAvailable(unsigned char* rowBuffer, unsigned rowIndex,
         png_progressive_combine_row(m_reader->pngPtr(), row, rowBuffer);
     }
 
+    if (!m_downscaler.isScaling()) {
+        writeRowPixels(buffer, row, buffer.getAddr(0, y));
+        return;
+    }
+
+    // The rows of an interlaced image are only complete in its last pass,
+    // which covers the odd rows once the even ones are done.
+    if (m_reader->interlaceBuffer()) {
+        const int lastPass = 6;
+        if (pass == lastPass)
+            downscaleInterlacedRows(buffer, y + 1);
+        return;
+    }
+
+    writeRowPixels(buffer, row, m_downscaler.rowBuffer());
+    m_downscaler.rowDecoded(buffer, y, 0, size().width(), false);
+}
+
+void PNGImageDecoder::writeRowPixels(ImageFrame& buffer, unsigned char* row, ImageFrame::PixelData* address)
+{
 #if USE(QCMSLIB)
     if (qcms_transform* transform = m_reader->colorTransform()) {
         qcms_transform_data(transform, row, m_reader->rowBuffer(), size().width());
@@ -442,12 +467,11 @@ void PNGImageDecoder::rowAvailable(unsigned char* rowBuffer, unsigned rowIndex,
 
     // Write the decoded row pixels to the frame buffer. The repetitive
     // form of the row write loops is for speed.
-    ImageFrame::PixelData* address = buffer.getAddr(0, y);
     unsigned alphaMask = 255;
     int width = size().width();
 
     png_bytep pixel = row;
-    if (hasAlpha) {
+    if (m_reader->hasAlpha()) {
         if (buffer.premultiplyAlpha()) {
             for (int x = 0; x < width; ++x, pixel += 4) {
                 buffer.setRGBAPremultiply(address++, pixel[0], pixel[1], pixel[2], pixel[3]);
@@ -471,12 +495,28 @@ void PNGImageDecoder::rowAvailable(unsigned char* rowBuffer, unsigned rowIndex,
     buffer.setPixelsChanged(true);
 }
 
+void PNGImageDecoder::downscaleInterlacedRows(ImageFrame& buffer, int endRow)
+{
+    unsigned colorChannels = m_reader->hasAlpha() ? 4 : 3;
+    for (; m_nextDownscaledRow < endRow; ++m_nextDownscaledRow) {
+        png_bytep row = m_reader->interlaceBuffer() + (m_nextDownscaledRow * colorChannels * size().width());
+        writeRowPixels(buffer, row, m_downscaler.rowBuffer());
+        m_downscaler.rowDecoded(buffer, m_nextDownscaledRow, 0, size().width(), false);
+    }
+}
+
 void PNGImageDecoder::complete()
 {
     if (m_frameBufferCache.isEmpty())
         return;
 
-    m_frameBufferCache[0].setStatus(ImageFrame::FrameComplete);
+    ImageFrame& buffer = m_frameBufferCache[0];
+    if (m_downscaler.isScaling() && buffer.status() == ImageFrame::FramePartial) {
+        if (m_reader->interlaceBuffer())
+            downscaleInterlacedRows(buffer, size().height());
+        m_downscaler.flush(buffer);
+    }
+    buffer.setStatus(ImageFrame::FrameComplete);
 }
 
 inline bool isComplete(const PNGImageDecoder* decoder)
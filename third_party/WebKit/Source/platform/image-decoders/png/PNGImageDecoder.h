@@ -27,6 +27,7 @@
 #define PNGImageDecoder_h
 
 #include "platform/image-decoders/ImageDecoder.h"
+#include "platform/image-decoders/ImageDownscaler.h"
 
 namespace blink {
 
@@ -41,6 +42,7 @@ public:
     // ImageDecoder:
     String filenameExtension() const override { return "png"; }
     bool hasColorProfile() const override { return m_hasColorProfile; }
+    IntSize decodedSize() const override { return m_downscaler.scaledSize(); }
 
     // Callbacks from libpng
     void headerAvailable();
@@ -57,7 +59,15 @@ private:
     // data coming, sets the "decode failure" flag.
     void decode(bool onlySize);
 
+    // Writes |row| of the image, as libpng hands it over, to |address|.
+    void writeRowPixels(ImageFrame&, unsigned char* row, ImageFrame::PixelData* address);
+    // Hands the rows of an interlaced image before |endRow|, which are
+    // complete, to the downscaler.
+    void downscaleInterlacedRows(ImageFrame&, int endRow);
+
     OwnPtr<PNGImageReader> m_reader;
+    ImageDownscaler m_downscaler;
+    int m_nextDownscaledRow;
     bool m_hasColorProfile;
     const unsigned m_offset;
 };
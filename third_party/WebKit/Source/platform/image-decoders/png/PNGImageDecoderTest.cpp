@@ -0,0 +1,147 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+#include "platform/image-decoders/png/PNGImageDecoder.h"
+
+#include "platform/SharedBuffer.h"
+#include "platform/image-decoders/ImageDecoderTestHelpers.h"
+#include "platform/image-decoders/ImageDownscaler.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "wtf/Vector.h"
+
+#include "png.h"
+
+namespace blink {
+
+namespace {
+
+PassOwnPtr<ImageDecoder> createDecoder(size_t maxDecodedBytes)
+{
+    return adoptPtr(new PNGImageDecoder(ImageDecoder::AlphaPremultiplied, ImageDecoder::GammaAndColorProfileApplied, maxDecodedBytes));
+}
+
+void writeData(png_structp png, png_bytep data, png_size_t size)
+{
+    static_cast<SharedBuffer*>(png_get_io_ptr(png))->append(reinterpret_cast<const char*>(data), size);
+}
+
+// Encodes an RGBA image in which every pixel differs from its neighbours, so
+// that a row or block averaged from the wrong pixels shows.
+PassRefPtr<SharedBuffer> encodePNG(int width, int height, bool interlaced)
+{
+    Vector<png_byte> pixels(width * height * 4);
+    Vector<png_bytep> rows(height);
+    for (int y = 0; y < height; ++y) {
+        rows[y] = pixels.data() + y * width * 4;
+        for (int x = 0; x < width; ++x) {
+            png_bytep pixel = rows[y] + x * 4;
+            pixel[0] = x * 7 + y * 3;
+            pixel[1] = y * 11;
+            pixel[2] = x * y;
+            pixel[3] = 255 - ((x + y) * 5 & 0x7f);
+        }
+    }
+
+    RefPtr<SharedBuffer> data = SharedBuffer::create();
+    png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0);
+    png_infop info = png_create_info_struct(png);
+    if (setjmp(png_jmpbuf(png))) {
+        png_destroy_write_struct(&png, &info);
+        return nullptr;
+    }
+    png_set_write_fn(png, data.get(), writeData, 0);
+    png_set_IHDR(png, info, width, height, 8, PNG_COLOR_TYPE_RGB_ALPHA,
+        interlaced ? PNG_INTERLACE_ADAM7 : PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE);
+    png_write_info(png, info);
+    // Writes the passes of an interlaced image.
+    png_write_image(png, rows.data());
+    png_write_end(png, info);
+    png_destroy_write_struct(&png, &info);
+    return data.release();
+}
+
+// Decodes |data| under |maxDecodedBytes|, handing it over in chunks so the
+// rows arrive over several calls, and checks that each pixel is the average
+// of the block of the full size decode it covers.
+void testDownscaledPixels(SharedBuffer* data, size_t maxDecodedBytes)
+{
+    OwnPtr<ImageDecoder> fullSizeDecoder = createDecoder(ImageDecoder::noDecodedImageByteLimit);
+    fullSizeDecoder->setData(data, true);
+    ImageFrame* fullSizeFrame = fullSizeDecoder->frameBufferAtIndex(0);
+    ASSERT_TRUE(fullSizeFrame);
+    ASSERT_EQ(ImageFrame::FrameComplete, fullSizeFrame->status());
+    const IntSize size = fullSizeDecoder->size();
+    const int factor = ImageDownscaler::factorFor(size, maxDecodedBytes);
+    ASSERT_GT(factor, 1);
+
+    OwnPtr<ImageDecoder> decoder = createDecoder(maxDecodedBytes);
+    RefPtr<SharedBuffer> partialData = SharedBuffer::create();
+    const size_t chunkSize = 1000;
+    for (size_t offset = 0; offset < data->size(); offset += chunkSize) {
+        partialData->append(data->data() + offset, std::min(chunkSize, data->size() - offset));
+        decoder->setData(partialData.get(), partialData->size() == data->size());
+        decoder->frameBufferAtIndex(0);
+        ASSERT_FALSE(decoder->failed());
+    }
+    ImageFrame* frame = decoder->frameBufferAtIndex(0);
+    ASSERT_TRUE(frame);
+    ASSERT_EQ(ImageFrame::FrameComplete, frame->status());
+    const int scaledWidth = frame->getSkBitmap().width();
+    const int scaledHeight = frame->getSkBitmap().height();
+    EXPECT_EQ((size.width() + factor - 1) / factor, scaledWidth);
+    EXPECT_EQ((size.height() + factor - 1) / factor, scaledHeight);
+
+    for (int scaledY = 0; scaledY < scaledHeight; ++scaledY) {
+        for (int scaledX = 0; scaledX < scaledWidth; ++scaledX) {
+            const int right = std::min(size.width(), (scaledX + 1) * factor);
+            const int bottom = std::min(size.height(), (scaledY + 1) * factor);
+            const unsigned area = (right - scaledX * factor) * (bottom - scaledY * factor);
+            // The pixels are premultiplied, so each channel averages alike.
+            ImageFrame::PixelData expected = 0;
+            for (int shift = 0; shift < 32; shift += 8) {
+                unsigned sum = 0;
+                for (int y = scaledY * factor; y < bottom; ++y) {
+                    for (int x = scaledX * factor; x < right; ++x)
+                        sum += (*fullSizeFrame->getAddr(x, y) >> shift) & 0xff;
+                }
+                expected |= ((sum + area / 2) / area) << shift;
+            }
+            ASSERT_EQ(expected, *frame->getAddr(scaledX, scaledY)) << "at " << scaledX << ", " << scaledY;
+        }
+    }
+}
+
+} // anonymous namespace
+
+TEST(PNGImageDecoderTest, downscale)
+{
+    RefPtr<SharedBuffer> data = encodePNG(64, 48, false);
+    ASSERT_TRUE(data);
+    testDownscale(&createDecoder, data.get());
+}
+
+TEST(PNGImageDecoderTest, downscaleInterlaced)
+{
+    RefPtr<SharedBuffer> data = encodePNG(64, 48, true);
+    ASSERT_TRUE(data);
+    testDownscale(&createDecoder, data.get());
+}
+
+TEST(PNGImageDecoderTest, downscaledPixels)
+{
+    // Odd sizes leave partial blocks along the right and bottom edges.
+    const int width = 61;
+    const int height = 47;
+    const size_t fullSizeBytes = width * height * sizeof(ImageFrame::PixelData);
+    for (bool interlaced : { false, true }) {
+        SCOPED_TRACE(interlaced ? "interlaced" : "not interlaced");
+        RefPtr<SharedBuffer> data = encodePNG(width, height, interlaced);
+        ASSERT_TRUE(data);
+        testDownscaledPixels(data.get(), fullSizeBytes / 4);
+        testDownscaledPixels(data.get(), fullSizeBytes / 9);
+    }
+}
+
+} // namespace blink
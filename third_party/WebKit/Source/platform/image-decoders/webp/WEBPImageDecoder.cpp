@@ -29,6 +29,8 @@
 #include "config.h"
 #include "platform/image-decoders/webp/WEBPImageDecoder.h"
 
+#include "platform/PlatformInstrumentation.h"
+
 #if USE(QCMSLIB)
 #include "qcms.h"
 #endif
@@ -125,6 +127,7 @@ namespace blink {
 WEBPImageDecoder::WEBPImageDecoder(AlphaOption alphaOption, GammaAndColorProfileOption colorOptions, size_t maxDecodedBytes)
     : ImageDecoder(alphaOption, colorOptions, maxDecodedBytes)
     , m_decoder(0)
+    , m_downscaler(maxDecodedBytes)
     , m_formatFlags(0)
     , m_frameBackgroundHasAlpha(false)
     , m_hasColorProfile(false)
@@ -237,6 +240,8 @@ bool WEBPImageDecoder::updateDemuxer()
             // FIXME: Implement ICC profile support for animated images.
             m_formatFlags &= ~ICCP_FLAG;
         }
+        // Frames of animations blend with each other at full size.
+        m_downscaler.setImageSize(size(), !(m_formatFlags & ANIMATION_FLAG));
 
 #if USE(QCMSLIB)
         if ((m_formatFlags & ICCP_FLAG) && !ignoresGammaAndColorProfile())
@@ -376,7 +381,7 @@ void WEBPImageDecoder::applyPostProcessing(size_t frameIndex)
     if (decodedHeight <= 0)
         return;
 
-    const IntRect& frameRect = buffer.originalFrameRect();
+    const IntRect frameRect = decodedFrameRect(buffer);
     ASSERT_WITH_SECURITY_IMPLICATION(width == frameRect.width());
     ASSERT_WITH_SECURITY_IMPLICATION(decodedHeight <= frameRect.height());
     const int left = frameRect.x();
@@ -508,7 +513,7 @@ bool WEBPImageDecoder::decodeSingleFrame(const uint8_t* dataBytes, size_t dataSi
     ASSERT(buffer.status() != ImageFrame::FrameComplete);
 
     if (buffer.status() == ImageFrame::FrameEmpty) {
-        if (!buffer.setSize(size().width(), size().height()))
+        if (!buffer.setSize(decodedSize().width(), decodedSize().height()))
             return setFailed();
         buffer.setStatus(ImageFrame::FramePartial);
         // The buffer is transparent outside the decoded area while the image is loading.
@@ -517,7 +522,7 @@ bool WEBPImageDecoder::decodeSingleFrame(const uint8_t* dataBytes, size_t dataSi
         buffer.setOriginalFrameRect(IntRect(IntPoint(), size()));
     }
 
-    const IntRect& frameRect = buffer.originalFrameRect();
+    const IntRect frameRect = decodedFrameRect(buffer);
     if (!m_decoder) {
         WEBP_CSP_MODE mode = outputMode(m_formatFlags & ALPHA_FLAG);
         if (!m_premultiplyAlpha)
@@ -526,17 +531,23 @@ bool WEBPImageDecoder::decodeSingleFrame(const uint8_t* dataBytes, size_t dataSi
         if (colorTransform())
             mode = MODE_RGBA; // Decode to RGBA for input to libqcms.
 #endif
-        WebPInitDecBuffer(&m_decoderBuffer);
-        m_decoderBuffer.colorspace = mode;
-        m_decoderBuffer.u.RGBA.stride = size().width() * sizeof(ImageFrame::PixelData);
-        m_decoderBuffer.u.RGBA.size = m_decoderBuffer.u.RGBA.stride * frameRect.height();
-        m_decoderBuffer.is_external_memory = 1;
-        m_decoder = WebPINewDecoder(&m_decoderBuffer);
+        WebPInitDecoderConfig(&m_decoderConfig);
+        WebPDecBuffer& output = m_decoderConfig.output;
+        output.colorspace = mode;
+        output.u.RGBA.stride = decodedSize().width() * sizeof(ImageFrame::PixelData);
+        output.u.RGBA.size = output.u.RGBA.stride * frameRect.height();
+        output.is_external_memory = 1;
+        if (m_downscaler.isScaling()) {
+            m_decoderConfig.options.use_scaling = 1;
+            m_decoderConfig.options.scaled_width = frameRect.width();
+            m_decoderConfig.options.scaled_height = frameRect.height();
+        }
+        m_decoder = WebPIDecode(0, 0, &m_decoderConfig);
         if (!m_decoder)
             return setFailed();
     }
 
-    m_decoderBuffer.u.RGBA.rgba = reinterpret_cast<uint8_t*>(buffer.getAddr(frameRect.x(), frameRect.y()));
+    m_decoderConfig.output.u.RGBA.rgba = reinterpret_cast<uint8_t*>(buffer.getAddr(frameRect.x(), frameRect.y()));
 
     switch (WebPIUpdate(m_decoder, dataBytes, dataSize)) {
     case VP8_STATUS_OK:
@@ -557,4 +568,79 @@ bool WEBPImageDecoder::decodeSingleFrame(const uint8_t* dataBytes, size_t dataSi
     }
 }
 
+IntSize WEBPImageDecoder::decodedYUVSize(int component, SizeType) const
+{
+    ASSERT((component >= 0) && (component <= 2));
+    // VP8 samples chroma at half the resolution in both directions.
+    if (!component)
+        return size();
+    return IntSize((size().width() + 1) / 2, (size().height() + 1) / 2);
+}
+
+bool WEBPImageDecoder::isLossyOpaqueStillImage()
+{
+    // YUV planes are decoded at full size, and carry no alpha or color
+    // correction.
+    if (!isSizeAvailable() || (m_formatFlags & (ANIMATION_FLAG | ALPHA_FLAG)) || m_hasColorProfile || m_downscaler.isScaling())
+        return false;
+
+    WebPIterator webpFrame;
+    if (!WebPDemuxGetFrame(m_demux, 1, &webpFrame))
+        return false;
+    WebPBitstreamFeatures features;
+    const int lossyFormat = 1;
+    bool lossyOpaque = webpFrame.complete
+        && WebPGetFeatures(webpFrame.fragment.bytes, webpFrame.fragment.size, &features) == VP8_STATUS_OK
+        && features.format == lossyFormat && !features.has_alpha;
+    WebPDemuxReleaseIterator(&webpFrame);
+    return lossyOpaque;
+}
+
+bool WEBPImageDecoder::canDecodeToYUV()
+{
+    return hasImagePlanes() && isLossyOpaqueStillImage();
+}
+
+bool WEBPImageDecoder::decodeToYUV()
+{
+    if (!canDecodeToYUV())
+        return false;
+
+    WebPIterator webpFrame;
+    if (!WebPDemuxGetFrame(m_demux, 1, &webpFrame))
+        return setFailed();
+
+    WebPDecoderConfig config;
+    WebPInitDecoderConfig(&config);
+    WebPDecBuffer& output = config.output;
+    output.colorspace = MODE_YUV;
+    output.is_external_memory = 1;
+    const IntSize ySize = decodedYUVSize(0, ActualSize);
+    const IntSize uvSize = decodedYUVSize(1, ActualSize);
+    WebPYUVABuffer& yuva = output.u.YUVA;
+    yuva.y = static_cast<uint8_t*>(m_imagePlanes->plane(0));
+    yuva.u = static_cast<uint8_t*>(m_imagePlanes->plane(1));
+    yuva.v = static_cast<uint8_t*>(m_imagePlanes->plane(2));
+    yuva.y_stride = m_imagePlanes->rowBytes(0);
+    yuva.u_stride = m_imagePlanes->rowBytes(1);
+    yuva.v_stride = m_imagePlanes->rowBytes(2);
+    yuva.y_size = m_imagePlanes->rowBytes(0) * ySize.height();
+    yuva.u_size = m_imagePlanes->rowBytes(1) * uvSize.height();
+    yuva.v_size = m_imagePlanes->rowBytes(2) * uvSize.height();
+
+    PlatformInstrumentation::willDecodeImage(filenameExtension());
+    VP8StatusCode status = WebPDecode(webpFrame.fragment.bytes, webpFrame.fragment.size, &config);
+    PlatformInstrumentation::didDecodeImage();
+    WebPDemuxReleaseIterator(&webpFrame);
+
+    if (status != VP8_STATUS_OK)
+        return setFailed();
+    return true;
+}
+
+void WEBPImageDecoder::setImagePlanes(PassOwnPtr<ImagePlanes> imagePlanes)
+{
+    m_imagePlanes = imagePlanes;
+}
+
 } // namespace blink
@@ -30,6 +30,7 @@
 #define WEBPImageDecoder_h
 
 #include "platform/image-decoders/ImageDecoder.h"
+#include "platform/image-decoders/ImageDownscaler.h"
 #include "webp/decode.h"
 #include "webp/demux.h"
 
@@ -44,11 +45,20 @@ public:
     // ImageDecoder:
     String filenameExtension() const override { return "webp"; }
     bool hasColorProfile() const override { return m_hasColorProfile; }
+    IntSize decodedSize() const override { return m_downscaler.scaledSize(); }
     void onSetData(SharedBuffer* data) override;
     int repetitionCount() const override;
     bool frameIsCompleteAtIndex(size_t) const override;
     float frameDurationAtIndex(size_t) const override;
     size_t clearCacheExceptFrame(size_t) override;
+    // Lossy still images without alpha decode straight to the Y, U and V
+    // planes of their VP8 bitstream.
+    IntSize decodedYUVSize(int component, SizeType) const override;
+    bool canDecodeToYUV() override;
+    bool decodeToYUV() override;
+    void setImagePlanes(PassOwnPtr<ImagePlanes>) override;
+    SkYUVColorSpace yuvColorSpace() const override { return kRec601_SkYUVColorSpace; }
+    bool hasImagePlanes() const { return m_imagePlanes; }
 
 private:
     // ImageDecoder:
@@ -58,12 +68,21 @@ private:
     void decode(size_t) override;
 
     bool decodeSingleFrame(const uint8_t* dataBytes, size_t dataSize, size_t frameIndex);
+    bool isLossyOpaqueStillImage();
+
+    // The rect of the frame the decoder writes to, which is scaled down along
+    // with the frame.
+    IntRect decodedFrameRect(const ImageFrame& buffer) const { return m_downscaler.scaledRect(buffer.originalFrameRect()); }
 
     WebPIDecoder* m_decoder;
-    WebPDecBuffer m_decoderBuffer;
+    // The decoder keeps pointers to the output buffer and the options.
+    WebPDecoderConfig m_decoderConfig;
+    // Only picks the size: libwebp scales still images down itself.
+    ImageDownscaler m_downscaler;
     int m_formatFlags;
     bool m_frameBackgroundHasAlpha;
     bool m_hasColorProfile;
+    OwnPtr<ImagePlanes> m_imagePlanes;
 
 #if USE(QCMSLIB)
     qcms_transform* colorTransform() const { return m_transform; }
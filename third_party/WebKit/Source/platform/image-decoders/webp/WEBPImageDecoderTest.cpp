@@ -56,6 +56,11 @@ PassOwnPtr<ImageDecoder> createDecoder()
     return createDecoder(ImageDecoder::AlphaNotPremultiplied);
 }
 
+PassOwnPtr<ImageDecoder> createDecoderWithMaxDecodedBytes(size_t maxDecodedBytes)
+{
+    return adoptPtr(new WEBPImageDecoder(ImageDecoder::AlphaNotPremultiplied, ImageDecoder::GammaAndColorProfileApplied, maxDecodedBytes));
+}
+
 void testRandomFrameDecode(const char* webpFile)
 {
     SCOPED_TRACE(webpFile);
@@ -688,4 +693,43 @@ TEST(StaticWebPTests, notAnimated)
     EXPECT_EQ(cAnimationNone, decoder->repetitionCount());
 }
 
+TEST(StaticWebPTests, yuv)
+{
+    const char* webpFile = "/LayoutTests/fast/images/resources/test.webp"; // Lossy, opaque
+    testDecodeToYUV(&createDecoder, webpFile);
+
+    RefPtr<SharedBuffer> data = readFile(webpFile);
+    ASSERT_TRUE(data);
+    OwnPtr<ImageDecoder> decoder = createDecoder();
+    decoder->setData(data.get(), true);
+    decoder->setImagePlanes(adoptPtr(new ImagePlanes()));
+    ASSERT_TRUE(decoder->isSizeAvailable());
+    IntSize size = decoder->size();
+    EXPECT_EQ(size, decoder->decodedYUVSize(0, ImageDecoder::ActualSize));
+    EXPECT_EQ(IntSize((size.width() + 1) / 2, (size.height() + 1) / 2), decoder->decodedYUVSize(1, ImageDecoder::ActualSize));
+    EXPECT_EQ(decoder->decodedYUVSize(1, ImageDecoder::ActualSize), decoder->decodedYUVSize(2, ImageDecoder::ActualSize));
+    EXPECT_EQ(kRec601_SkYUVColorSpace, decoder->yuvColorSpace());
+
+    // Animations and downscaled images decode to RGBA.
+    decoder = createDecoder();
+    data = readFile("/LayoutTests/fast/images/resources/webp-animated.webp");
+    ASSERT_TRUE(data);
+    decoder->setData(data.get(), true);
+    decoder->setImagePlanes(adoptPtr(new ImagePlanes()));
+    ASSERT_TRUE(decoder->isSizeAvailable());
+    EXPECT_FALSE(decoder->canDecodeToYUV());
+
+    decoder = createDecoderWithMaxDecodedBytes(size.width() * size.height());
+    data = readFile(webpFile);
+    decoder->setData(data.get(), true);
+    decoder->setImagePlanes(adoptPtr(new ImagePlanes()));
+    ASSERT_TRUE(decoder->isSizeAvailable());
+    EXPECT_FALSE(decoder->canDecodeToYUV());
+}
+
+TEST(StaticWebPTests, downscale)
+{
+    testDownscale(&createDecoderWithMaxDecodedBytes, "/LayoutTests/fast/images/resources/test.webp");
+}
+
 } // namespace blink
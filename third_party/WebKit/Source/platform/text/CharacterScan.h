@@ -0,0 +1,142 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CharacterScan_h
+#define CharacterScan_h
+
+#include "wtf/CPU.h"
+#include "wtf/text/Unicode.h"
+
+#if CPU(X86) || CPU(X86_64)
+#include <emmintrin.h>
+#elif HAVE(ARM_NEON_INTRINSICS)
+#include <arm_neon.h>
+#endif
+
+namespace blink {
+
+// Helpers for tokenizers that skip runs of uninteresting characters. The
+// scans look at 16 characters at a time, one per byte. 16-bit characters
+// outside Latin-1 are folded to 0xFF, so a classifier written for bytes
+// works for both string widths as long as it treats 0xFF like any other
+// non-ASCII character.
+namespace CharacterScan {
+
+#if CPU(X86) || CPU(X86_64)
+typedef __m128i CharacterVector;
+
+inline CharacterVector loadCharacters(const LChar* characters)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(characters));
+}
+
+inline __m128i foldToLatin1(__m128i characters)
+{
+    __m128i isLatin1 = _mm_cmpeq_epi16(_mm_srli_epi16(characters, 8), _mm_setzero_si128());
+    return _mm_or_si128(_mm_and_si128(isLatin1, characters), _mm_andnot_si128(isLatin1, _mm_set1_epi16(0xFF)));
+}
+
+inline CharacterVector loadCharacters(const UChar* characters)
+{
+    __m128i low = foldToLatin1(_mm_loadu_si128(reinterpret_cast<const __m128i*>(characters)));
+    __m128i high = foldToLatin1(_mm_loadu_si128(reinterpret_cast<const __m128i*>(characters + 8)));
+    return _mm_packus_epi16(low, high);
+}
+
+inline CharacterVector equalTo(CharacterVector characters, LChar c)
+{
+    return _mm_cmpeq_epi8(characters, _mm_set1_epi8(c));
+}
+
+inline CharacterVector inRange(CharacterVector characters, LChar low, LChar high)
+{
+    __m128i clamped = _mm_max_epu8(_mm_min_epu8(characters, _mm_set1_epi8(high)), _mm_set1_epi8(low));
+    return _mm_cmpeq_epi8(clamped, characters);
+}
+
+inline CharacterVector either(CharacterVector a, CharacterVector b)
+{
+    return _mm_or_si128(a, b);
+}
+
+inline CharacterVector invert(CharacterVector mask)
+{
+    return _mm_xor_si128(mask, _mm_set1_epi8(-1));
+}
+
+inline bool anySet(CharacterVector mask)
+{
+    return _mm_movemask_epi8(mask);
+}
+#elif HAVE(ARM_NEON_INTRINSICS)
+typedef uint8x16_t CharacterVector;
+
+inline CharacterVector loadCharacters(const LChar* characters)
+{
+    return vld1q_u8(characters);
+}
+
+inline CharacterVector loadCharacters(const UChar* characters)
+{
+    const uint16_t* words = reinterpret_cast<const uint16_t*>(characters);
+    return vcombine_u8(vqmovn_u16(vld1q_u16(words)), vqmovn_u16(vld1q_u16(words + 8)));
+}
+
+inline CharacterVector equalTo(CharacterVector characters, LChar c)
+{
+    return vceqq_u8(characters, vdupq_n_u8(c));
+}
+
+inline CharacterVector inRange(CharacterVector characters, LChar low, LChar high)
+{
+    return vandq_u8(vcgeq_u8(characters, vdupq_n_u8(low)), vcleq_u8(characters, vdupq_n_u8(high)));
+}
+
+inline CharacterVector either(CharacterVector a, CharacterVector b)
+{
+    return vorrq_u8(a, b);
+}
+
+inline CharacterVector invert(CharacterVector mask)
+{
+    return vmvnq_u8(mask);
+}
+
+inline bool anySet(CharacterVector mask)
+{
+    uint64x2_t words = vreinterpretq_u64_u8(mask);
+    return vgetq_lane_u64(words, 0) | vgetq_lane_u64(words, 1);
+}
+#endif
+
+#if CPU(X86) || CPU(X86_64) || HAVE(ARM_NEON_INTRINSICS)
+#define CHARACTER_SCAN_VECTORIZED 1
+const size_t characterVectorLength = 16;
+#endif
+
+// Returns the index of the first character in [start, length) that the
+// matcher stops at, or |length|. A matcher answers whether the scan stops
+// at a character, both for a single character and, when the scan is
+// vectorized, for a vector of them.
+template<typename CharacterType, typename Matcher>
+size_t scanCharacters(const CharacterType* characters, size_t start, size_t length, const Matcher& stopsAt)
+{
+    size_t i = start;
+#if CHARACTER_SCAN_VECTORIZED
+    // Skip whole vectors, then find the exact position in the last one.
+    for (; i + characterVectorLength <= length; i += characterVectorLength) {
+        if (anySet(stopsAt(loadCharacters(characters + i))))
+            break;
+    }
+#endif
+    while (i < length && !stopsAt(characters[i]))
+        ++i;
+    return i;
+}
+
+} // namespace CharacterScan
+
+} // namespace blink
+
+#endif // CharacterScan_h
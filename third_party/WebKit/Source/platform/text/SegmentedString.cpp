@@ -224,6 +224,42 @@ void SegmentedString::advanceAndUpdateLineNumber16()
     m_currentChar = m_currentString.incrementAndGetCurrentChar16();
 }
 
+template<typename CharacterType>
+static inline unsigned lastNewlineEnd(const CharacterType* characters, unsigned length, unsigned& newlineCount)
+{
+    unsigned end = 0;
+    for (unsigned i = 0; i < length; ++i) {
+        if (characters[i] == '\n') {
+            ++newlineCount;
+            end = i + 1;
+        }
+    }
+    return end;
+}
+
+void SegmentedString::advanceWithinCurrentSubstring(unsigned count)
+{
+    ASSERT(count < currentSubstringLength());
+    if (!count)
+        return;
+
+    if (m_currentString.doNotExcludeLineNumbers()) {
+        unsigned newlineCount = 0;
+        unsigned end = m_currentString.is8Bit()
+            ? lastNewlineEnd(m_currentString.currentCharacters8(), count, newlineCount)
+            : lastNewlineEnd(m_currentString.currentCharacters16(), count, newlineCount);
+        if (newlineCount) {
+            m_currentLine += newlineCount;
+            m_numberOfCharactersConsumedPriorToCurrentLine = numberOfCharactersConsumed() + end;
+        }
+    }
+
+    m_currentString.advanceBy(count);
+    m_currentChar = m_currentString.getCurrentChar();
+    if (m_currentString.haveOneCharacterLeft())
+        updateSlowCaseFunctionPointers();
+}
+
 void SegmentedString::advanceSlowCase()
 {
     if (m_currentString.length()) {
@@ -61,7 +61,7 @@ public:
 
     void clear() { m_length = 0; m_data.string16Ptr = nullptr; m_is8Bit = false;}
 
-    bool is8Bit() { return m_is8Bit; }
+    bool is8Bit() const { return m_is8Bit; }
 
     bool excludeLineNumbers() const { return !m_doNotExcludeLineNumbers; }
     bool doNotExcludeLineNumbers() const { return m_doNotExcludeLineNumbers; }
@@ -132,6 +132,28 @@ public:
         return *++m_data.string16Ptr;
     }
 
+    const LChar* currentCharacters8() const
+    {
+        ASSERT(m_is8Bit);
+        return m_data.string8Ptr;
+    }
+
+    const UChar* currentCharacters16() const
+    {
+        ASSERT(!m_is8Bit);
+        return m_data.string16Ptr;
+    }
+
+    void advanceBy(int count)
+    {
+        ASSERT(count < m_length);
+        if (m_is8Bit)
+            m_data.string8Ptr += count;
+        else
+            m_data.string16Ptr += count;
+        m_length -= count;
+    }
+
     String currentSubString(unsigned length)
     {
         int offset = m_string.length() - m_length;
@@ -295,6 +317,19 @@ public:
     // have space for at least |count| characters.
     void advance(unsigned count, UChar* consumedCharacters);
 
+    // The rest of the current substring, starting at the current character,
+    // for tokenizers that scan ahead for the end of a run of characters.
+    // Only valid until the string is next advanced or modified.
+    unsigned currentSubstringLength() const { return m_currentString.length(); }
+    bool currentSubstringIs8Bit() const { return m_currentString.is8Bit(); }
+    const LChar* currentSubstringCharacters8() const { return m_currentString.currentCharacters8(); }
+    const UChar* currentSubstringCharacters16() const { return m_currentString.currentCharacters16(); }
+
+    // Advances past |count| characters of the current substring, which must
+    // have more than |count| characters left, updating line numbers like
+    // advanceAndUpdateLineNumber() does.
+    void advanceWithinCurrentSubstring(unsigned count);
+
     int numberOfCharactersConsumed() const
     {
         int numberOfPushedCharacters = 0;
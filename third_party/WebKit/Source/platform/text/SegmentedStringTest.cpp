@@ -79,4 +79,41 @@ TEST(SegmentedStringTest, CurrentChar)
     }
 }
 
+static void expectSamePosition(const SegmentedString& expected, const SegmentedString& actual)
+{
+    EXPECT_EQ(expected.currentChar(), actual.currentChar());
+    EXPECT_EQ(expected.numberOfCharactersConsumed(), actual.numberOfCharactersConsumed());
+    EXPECT_EQ(expected.currentLine().zeroBasedInt(), actual.currentLine().zeroBasedInt());
+    EXPECT_EQ(expected.currentColumn().zeroBasedInt(), actual.currentColumn().zeroBasedInt());
+    EXPECT_EQ(expected.toString(), actual.toString());
+}
+
+TEST(SegmentedStringTest, AdvanceWithinCurrentSubstring)
+{
+    String latin1("ab\ncd\n\nefg");
+    const UChar arrow = 0x2192;
+    String utf16 = latin1 + String(&arrow, 1);
+    ASSERT_FALSE(utf16.is8Bit());
+
+    for (const String& input : { latin1, utf16 }) {
+        for (unsigned count = 0; count < latin1.length(); ++count) {
+            SegmentedString expected(input);
+            SegmentedString actual(input);
+            for (unsigned i = 0; i < count; ++i)
+                expected.advanceAndUpdateLineNumber();
+            actual.advanceWithinCurrentSubstring(count);
+            expectSamePosition(expected, actual);
+
+            // The string advances as usual afterwards, including from its
+            // last character.
+            while (!expected.isEmpty()) {
+                expected.advanceAndUpdateLineNumber();
+                actual.advanceAndUpdateLineNumber();
+                expectSamePosition(expected, actual);
+            }
+            EXPECT_TRUE(actual.isEmpty());
+        }
+    }
+}
+
 } // namespace blink
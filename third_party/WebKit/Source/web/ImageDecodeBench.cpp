@@ -7,10 +7,21 @@
 Provides a minimal wrapping of the Blink image decoders. Used to perform
 a non-threaded, memory-to-memory image decode using micro second accuracy
 clocks to measure image decode time. Optionally applies color correction
-during image decoding on supported platforms (default off). Usage:
+during image decoding on supported platforms (default off), and limits the
+memory decoded images may take, which makes decoders scale large images
+down (default no limit). Usage:
 
   % ninja -C /out/Release image_decode_bench &&
-     ./out/Release/image_decode_bench file [iterations]
+     ./out/Release/image_decode_bench [--max-decoded-bytes N] file [iterations]
+
+With --animate, the frames of an animated image are decoded one after the
+other keeping only the frame shown, as an animation advances, and the longest
+time a frame took to show is output as well. --decode-frames-ahead lets GIF
+frames decode ahead on worker threads, which are only created on POSIX.
+
+Large baseline JPEGs with a restart marker on every row of MCUs decode in
+bands on the worker threads. --no-decoding-workers decodes them in one go on
+the decoding thread instead, so that the two timings can be compared.
 
 FIXME: Consider adding md5 checksum support to WTF. Use it to compute the
 decoded image frame md5 and output that value.
@@ -23,13 +34,18 @@ http://crbug.com/398235#c103 and http://crbug.com/258324#c5
 
 #include "config.h"
 
+#include "platform/RuntimeEnabledFeatures.h"
 #include "platform/SharedBuffer.h"
 #include "platform/image-decoders/ImageDecoder.h"
 #include "platform/testing/TestingPlatformSupport.h"
 #include "public/platform/Platform.h"
+#include "public/platform/WebTaskRunner.h"
+#include "public/platform/WebThread.h"
 #include "public/web/WebKit.h"
+#include "wtf/Deque.h"
 #include "wtf/OwnPtr.h"
 #include "wtf/PassRefPtr.h"
+#include "wtf/ThreadingPrimitives.h"
 
 #if defined(_WIN32)
 #if defined(WIN32_LEAN_AND_MEAN)
@@ -41,8 +57,10 @@ http://crbug.com/398235#c103 and http://crbug.com/258324#c5
 #define stat(x,y) _stat(x,y)
 typedef struct _stat sttype;
 #else
+#include <pthread.h>
 #include <sys/stat.h>
 #include <sys/time.h>
+#include <unistd.h>
 typedef struct stat sttype;
 #endif
 
@@ -266,7 +284,37 @@ PassRefPtr<SharedBuffer> readFile(const char* fileName)
     return SharedBuffer::create(buffer.get(), fileSize);
 }
 
-bool decodeImageData(SharedBuffer* data, bool colorCorrection, size_t packetSize)
+size_t decodedBytes(ImageDecoder* decoder)
+{
+    size_t bytes = 0;
+    for (size_t i = 0; i < decoder->frameCount(); ++i) {
+        if (ImageFrame* frame = decoder->frameBufferAtIndex(i))
+            bytes += frame->getSkBitmap().getSize();
+    }
+    return bytes;
+}
+
+bool animateImageData(SharedBuffer* data, bool colorCorrection, double& longestFrameTime)
+{
+    OwnPtr<ImageDecoder> decoder = ImageDecoder::create(*data,
+        ImageDecoder::AlphaPremultiplied, colorCorrection ?
+            ImageDecoder::GammaAndColorProfileApplied : ImageDecoder::GammaAndColorProfileIgnored);
+
+    decoder->setData(data, true);
+    int frameCount = decoder->frameCount();
+    for (int i = 0; i < frameCount; ++i) {
+        double startTime = getCurrentTime();
+        if (!decoder->frameBufferAtIndex(i))
+            return false;
+        longestFrameTime = std::max(longestFrameTime, getCurrentTime() - startTime);
+        // ImageFrameGenerator keeps only the frame it asked for.
+        decoder->clearCacheExceptFrame(i);
+    }
+
+    return !decoder->failed();
+}
+
+bool decodeImageData(SharedBuffer* data, bool colorCorrection, size_t packetSize, size_t& bytes)
 {
     OwnPtr<ImageDecoder> decoder = ImageDecoder::create(*data,
         ImageDecoder::AlphaPremultiplied, colorCorrection ?
@@ -282,6 +330,7 @@ bool decodeImageData(SharedBuffer* data, bool colorCorrection, size_t packetSize
                 return false;
         }
 
+        bytes = decodedBytes(decoder.get());
         return !decoder->failed();
     }
 
@@ -308,9 +357,78 @@ bool decodeImageData(SharedBuffer* data, bool colorCorrection, size_t packetSize
             break;
     }
 
+    bytes = decodedBytes(decoder.get());
     return !decoder->failed();
 }
 
+static size_t maxDecodedBytes = Platform::noDecodedImageByteLimit;
+static bool decodingWorkers = true;
+
+#if !defined(_WIN32)
+
+// Runs the tasks posted to it on a thread of its own, so that the decoders
+// which split their work between threads do so here too.
+class BenchThread final : public WebThread, public WebTaskRunner {
+public:
+    BenchThread()
+        : m_thread(0)
+    {
+        m_running = !pthread_create(&m_thread, 0, &BenchThread::threadMain, this);
+    }
+
+    bool isRunning() const { return m_running; }
+
+    // WebThread:
+    WebTaskRunner* taskRunner() override { return this; }
+    bool isCurrentThread() const override { return m_running && pthread_equal(m_thread, pthread_self()); }
+    WebScheduler* scheduler() const override { return 0; }
+
+    // WebTaskRunner:
+    void postTask(const WebTraceLocation&, Task* task) override
+    {
+        MutexLocker locker(m_mutex);
+        m_tasks.append(adoptPtr(task));
+        m_taskPosted.signal();
+    }
+
+    void postDelayedTask(const WebTraceLocation& location, Task* task, double) override
+    {
+        postTask(location, task);
+    }
+
+    WebTaskRunner* clone() override { return 0; }
+
+private:
+    // The threads live as long as the process.
+    static void* threadMain(void* thread)
+    {
+        static_cast<BenchThread*>(thread)->runTasks();
+        return 0;
+    }
+
+    void runTasks()
+    {
+        for (;;) {
+            OwnPtr<Task> task;
+            {
+                MutexLocker locker(m_mutex);
+                while (m_tasks.isEmpty())
+                    m_taskPosted.wait(m_mutex);
+                task = m_tasks.takeFirst();
+            }
+            task->run();
+        }
+    }
+
+    pthread_t m_thread;
+    bool m_running;
+    Mutex m_mutex;
+    ThreadCondition m_taskPosted;
+    Deque<OwnPtr<Task>> m_tasks;
+};
+
+#endif
+
 int main(int argc, char* argv[])
 {
     char* name = argv[0];
@@ -322,14 +440,47 @@ int main(int argc, char* argv[])
 #if USE(QCMSLIB)
     if (argc >= 2 && strcmp(argv[1], "--color-correct") == 0)
         applyColorCorrection = (--argc, ++argv, true);
+#endif
+
+    // Decode the frames of animated images as an animation shows them.
 
+    bool animate = false;
+    if (argc >= 2 && strcmp(argv[1], "--animate") == 0)
+        animate = (--argc, ++argv, true);
+
+    bool decodeFramesAhead = false;
+    if (argc >= 2 && strcmp(argv[1], "--decode-frames-ahead") == 0)
+        decodeFramesAhead = (--argc, ++argv, true);
+
+    // Decode on the decoding thread only, rather than in bands on workers.
+
+    if (argc >= 2 && strcmp(argv[1], "--no-decoding-workers") == 0)
+        decodingWorkers = (--argc, ++argv, false);
+
+    // Limit the memory decoded images may take.
+
+    bool limitDecodedBytes = false;
+    if (argc >= 3 && strcmp(argv[1], "--max-decoded-bytes") == 0) {
+        char* end = 0;
+        maxDecodedBytes = strtoul(argv[2], &end, 10);
+        if (*end != '\0' || !maxDecodedBytes) {
+            fprintf(stderr, "--max-decoded-bytes should be followed by a "
+                "positive number of bytes. You supplied %s\n", argv[2]);
+            exit(1);
+        }
+        limitDecodedBytes = true;
+        argc -= 2;
+        argv += 2;
+    }
+
+#if USE(QCMSLIB)
     if (argc < 2) {
-        fprintf(stderr, "Usage: %s [--color-correct] file [iterations] [packetSize]\n", name);
+        fprintf(stderr, "Usage: %s [--color-correct] [--animate] [--decode-frames-ahead] [--no-decoding-workers] [--max-decoded-bytes N] file [iterations] [packetSize]\n", name);
         exit(1);
     }
 #else
     if (argc < 2) {
-        fprintf(stderr, "Usage: %s file [iterations] [packetSize]\n", name);
+        fprintf(stderr, "Usage: %s [--animate] [--decode-frames-ahead] [--no-decoding-workers] [--max-decoded-bytes N] file [iterations] [packetSize]\n", name);
         exit(1);
     }
 #endif
@@ -367,9 +518,35 @@ int main(int argc, char* argv[])
         {
             getScreenColorProfile(profile); // Returns a whacked color profile.
         }
+
+        size_t maxDecodedImageBytes() override
+        {
+            return maxDecodedBytes;
+        }
+
+#if !defined(_WIN32)
+        size_t numberOfProcessors() override
+        {
+            // The decoders only use workers with more than one processor.
+            if (!decodingWorkers)
+                return 1;
+            long processors = sysconf(_SC_NPROCESSORS_ONLN);
+            return processors > 0 ? processors : 1;
+        }
+
+        WebThread* createThread(const char*) override
+        {
+            BenchThread* thread = new BenchThread;
+            if (thread->isRunning())
+                return thread;
+            delete thread;
+            return 0;
+        }
+#endif
     };
 
     blink::initializeWithoutV8(new WebPlatform());
+    RuntimeEnabledFeatures::setDecodeImageFramesAheadEnabled(decodeFramesAhead);
 
     // Set image decoding Platform options.
 
@@ -391,10 +568,13 @@ int main(int argc, char* argv[])
     // Image decode bench for iterations.
 
     double totalTime = 0.0;
+    double longestFrameTime = 0.0;
+    size_t bytes = 0;
 
     for (size_t i = 0; i < iterations; ++i) {
         double startTime = getCurrentTime();
-        bool decoded = decodeImageData(data.get(), applyColorCorrection, packetSize);
+        bool decoded = animate ? animateImageData(data.get(), applyColorCorrection, longestFrameTime)
+            : decodeImageData(data.get(), applyColorCorrection, packetSize, bytes);
         double elapsedTime = getCurrentTime() - startTime;
         totalTime += elapsedTime;
         if (!decoded) {
@@ -406,6 +586,11 @@ int main(int argc, char* argv[])
     // Results to stdout.
 
     double averageTime = totalTime / static_cast<double>(iterations);
-    printf("%f %f\n", totalTime, averageTime);
+    if (animate)
+        printf("%f %f %f\n", totalTime, averageTime, longestFrameTime);
+    else if (limitDecodedBytes)
+        printf("%f %f %lu\n", totalTime, averageTime, static_cast<unsigned long>(bytes));
+    else
+        printf("%f %f\n", totalTime, averageTime);
     return 0;
 }
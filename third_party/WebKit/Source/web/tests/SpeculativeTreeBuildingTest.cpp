@@ -0,0 +1,126 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "config.h"
+
+#include "core/dom/Document.h"
+#include "core/dom/Element.h"
+#include "core/frame/LocalFrame.h"
+#include "core/page/Page.h"
+#include "platform/RuntimeEnabledFeatures.h"
+#include "platform/testing/URLTestHelpers.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "web/WebViewImpl.h"
+#include "web/tests/FrameTestHelpers.h"
+#include "wtf/text/StringBuilder.h"
+
+namespace blink {
+
+namespace {
+
+// Speculative subtrees are only found by the background parser, which parses
+// documents loaded into a frame.
+class SpeculativeTreeBuildingTest : public ::testing::Test {
+protected:
+    SpeculativeTreeBuildingTest()
+        : m_speculativeTreeBuildingEnabled(RuntimeEnabledFeatures::speculativeTreeBuildingEnabled())
+    {
+    }
+
+    ~SpeculativeTreeBuildingTest() override
+    {
+        RuntimeEnabledFeatures::setSpeculativeTreeBuildingEnabled(m_speculativeTreeBuildingEnabled);
+    }
+
+    // Loads |html| and returns the markup of the resulting document.
+    String parse(const String& html, bool speculativeTreeBuilding)
+    {
+        RuntimeEnabledFeatures::setSpeculativeTreeBuildingEnabled(speculativeTreeBuilding);
+        FrameTestHelpers::WebViewHelper webViewHelper;
+        webViewHelper.initialize(true);
+        FrameTestHelpers::loadHTMLString(webViewHelper.webView()->mainFrame(), html.utf8().data(), URLTestHelpers::toKURL("about:blank"));
+        Document* document = toLocalFrame(webViewHelper.webViewImpl()->page()->mainFrame())->document();
+        return document->documentElement()->outerHTML();
+    }
+
+    void expectSameTree(const String& html)
+    {
+        SCOPED_TRACE(html.utf8().data());
+        String expected = parse(html, false);
+        EXPECT_EQ(expected, parse(html, true));
+    }
+
+private:
+    bool m_speculativeTreeBuildingEnabled;
+};
+
+// Enough subtrees to fill several chunks of the background parser.
+String repeat(const char* markup, unsigned count)
+{
+    StringBuilder builder;
+    for (unsigned i = 0; i < count; ++i)
+        builder.append(markup);
+    return builder.toString();
+}
+
+const char plainSubtree[] = "<div class=item><p>Hello <span>world</span></p>\n<div><span>a</span> b</div></div>\n";
+
+TEST_F(SpeculativeTreeBuildingTest, PlainSubtrees)
+{
+    expectSameTree("<!DOCTYPE html><body>" + repeat(plainSubtree, 500));
+    // Only the newline right after <pre> is skipped, not the one after the
+    // subtree which follows it.
+    expectSameTree("<!DOCTYPE html><body><pre>" + repeat(plainSubtree, 50) + "</pre>");
+}
+
+TEST_F(SpeculativeTreeBuildingTest, NotInBody)
+{
+    // After the head, and in a table, subtrees aren't inserted "in body".
+    expectSameTree("<!DOCTYPE html><head></head>" + repeat(plainSubtree, 50));
+    expectSameTree("<!DOCTYPE html><body><table>" + repeat(plainSubtree, 50) + "</table>");
+    expectSameTree("<!DOCTYPE html><body><select>" + repeat(plainSubtree, 50) + "</select>");
+}
+
+TEST_F(SpeculativeTreeBuildingTest, FosterParenting)
+{
+    // Subtrees in a table row are foster parented before the table.
+    expectSameTree("<!DOCTYPE html><body><table><tr><td>cell</td>" + repeat(plainSubtree, 50) + "</tr></table>");
+}
+
+TEST_F(SpeculativeTreeBuildingTest, OpenFormattingElements)
+{
+    // The <b> closed by </p> reopens in every subtree that follows.
+    expectSameTree("<!DOCTYPE html><body><p><b>bold</p>" + repeat(plainSubtree, 50));
+    expectSameTree("<!DOCTYPE html><body><b><i>" + repeat(plainSubtree, 50) + "</i></b>");
+}
+
+TEST_F(SpeculativeTreeBuildingTest, ParagraphInButtonScope)
+{
+    // The first <div> closes the open <p>, but not when inside a button.
+    expectSameTree("<!DOCTYPE html><body><p>text" + repeat(plainSubtree, 50));
+    expectSameTree("<!DOCTYPE html><body><p><button>" + repeat(plainSubtree, 50) + "</button>");
+}
+
+TEST_F(SpeculativeTreeBuildingTest, DepthLimit)
+{
+    // Subtrees which would nest past the parser's depth limit are flattened.
+    for (unsigned openElements : { 505u, 508u, 511u })
+        expectSameTree("<!DOCTYPE html><body>" + repeat("<span>", openElements) + repeat(plainSubtree, 20));
+}
+
+TEST_F(SpeculativeTreeBuildingTest, MutationObserver)
+{
+    // Observers see each node inserted, which the count of records shows.
+    expectSameTree("<!DOCTYPE html><body><script>"
+        "var records = 0;"
+        "new MutationObserver(function(mutations) {"
+        "    records += mutations.length;"
+        "    document.documentElement.setAttribute('data-records', records);"
+        "}).observe(document, { childList: true, subtree: true });"
+        "</script>" + repeat(plainSubtree, 50));
+}
+
+} // namespace
+
+} // namespace blink
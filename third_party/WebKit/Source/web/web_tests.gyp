@@ -57,6 +57,7 @@
                 '<(DEPTH)/base/base.gyp:test_support_base',
                 '<(DEPTH)/testing/gmock.gyp:gmock',
                 '<(DEPTH)/testing/gtest.gyp:gtest',
+                '<(DEPTH)/testing/perf/perf_test.gyp:perf_test',
                 '<(DEPTH)/third_party/libwebp/libwebp.gyp:libwebp',
                 '<(DEPTH)/third_party/zlib/zlib.gyp:zlib',
                 '<(DEPTH)/url/url.gyp:url_lib',
@@ -103,6 +103,12 @@ ALWAYS_INLINE void atomicSetOneToZero(int volatile* ptr)
     InterlockedExchange(reinterpret_cast<long volatile*>(ptr), 0);
 }
 
+// atomicOr returns the value before the bitwise or.
+ALWAYS_INLINE unsigned atomicOr(unsigned volatile* ptr, unsigned bits)
+{
+    return static_cast<unsigned>(InterlockedOr(reinterpret_cast<long volatile*>(ptr), static_cast<long>(bits)));
+}
+
 #else
 
 // atomicAdd returns the result of the addition.
@@ -132,6 +138,9 @@ ALWAYS_INLINE void atomicSetOneToZero(int volatile* ptr)
     ASSERT(*ptr == 1);
     __sync_lock_release(ptr);
 }
+
+// atomicOr returns the value before the bitwise or.
+ALWAYS_INLINE unsigned atomicOr(unsigned volatile* ptr, unsigned bits) { return __sync_fetch_and_or(ptr, bits); }
 #endif
 
 #if defined(THREAD_SANITIZER)
@@ -360,6 +369,7 @@ using WTF::atomicAdd;
 using WTF::atomicSubtract;
 using WTF::atomicDecrement;
 using WTF::atomicIncrement;
+using WTF::atomicOr;
 using WTF::atomicTestAndSetToOne;
 using WTF::atomicSetOneToZero;
 using WTF::acquireLoad;
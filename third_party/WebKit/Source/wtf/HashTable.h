@@ -1126,6 +1126,7 @@ Value* HashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits, Alloca
 
     m_table = newTable;
     m_tableSize = newTableSize;
+    Allocator::backingWriteBarrier(m_table);
 
     Value* newEntry = nullptr;
     for (unsigned i = 0; i != oldTableSize; ++i) {
@@ -1240,8 +1241,13 @@ void HashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits, Allocato
     unsigned deleted = m_deletedCount;
     m_deletedCount = other.m_deletedCount;
     other.m_deletedCount = deleted;
-    ASSERT(!m_queueFlag);
-    ASSERT(!other.m_queueFlag);
+    // Tables are only queued for ephemeron iteration during GCs, and
+    // between the steps of incremental marking. The queued bits belong to
+    // the registered HashTable objects, so they aren't swapped.
+    ASSERT(!m_queueFlag || Allocator::isIncrementalMarkingInProgress());
+    ASSERT(!other.m_queueFlag || Allocator::isIncrementalMarkingInProgress());
+    Allocator::backingWriteBarrier(m_table);
+    Allocator::backingWriteBarrier(other.m_table);
 
 #if ENABLE(ASSERT)
     std::swap(m_modifications, other.m_modifications);
@@ -1353,6 +1359,9 @@ void HashTable<Key, Value, Extractor, HashFunctions, Traits, KeyTraits, Allocato
     // place after we know if the backing is reachable from elsewhere. We also
     // register a weakProcessing callback which will perform weak processing if
     // needed.
+    // The backing of a table whose values point into it has to stay put.
+    if (!Traits::hasInteriorPointers)
+        Allocator::registerBackingStoreReference(visitor, reinterpret_cast<void**>(&m_table));
     if (Traits::weakHandlingFlag == NoWeakHandlingInCollections) {
         Allocator::markNoTracing(visitor, m_table);
     } else {
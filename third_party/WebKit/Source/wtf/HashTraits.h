@@ -67,6 +67,11 @@ template <typename T> struct GenericHashTraitsBase<false, T> {
         static const bool value = NeedsTracing<T>::value;
     };
     static const WeakHandlingFlag weakHandlingFlag = IsWeak<T>::value ? WeakHandlingInCollections : NoWeakHandlingInCollections;
+
+    // The hasInteriorPointers flag is set for values that point into the
+    // backing of their hash table, like collections with inline capacity,
+    // which then can't be moved by the garbage collector.
+    static const bool hasInteriorPointers = false;
 };
 
 // Default integer traits disallow both 0 and -1 as keys (max value instead of
@@ -280,6 +285,7 @@ struct KeyValuePairHashTraits : GenericHashTraits<KeyValuePair<typename KeyTrait
         static const bool value = NeedsTracingTrait<KeyTraits>::value || NeedsTracingTrait<ValueTraits>::value;
     };
     static const WeakHandlingFlag weakHandlingFlag = (KeyTraits::weakHandlingFlag == WeakHandlingInCollections || ValueTraits::weakHandlingFlag == WeakHandlingInCollections) ? WeakHandlingInCollections : NoWeakHandlingInCollections;
+    static const bool hasInteriorPointers = KeyTraits::hasInteriorPointers || ValueTraits::hasInteriorPointers;
 
     static const unsigned minimumTableSize = KeyTraits::minimumTableSize;
 
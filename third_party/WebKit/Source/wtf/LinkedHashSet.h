@@ -322,6 +322,9 @@ struct LinkedHashSetTraits : public SimpleClassHashTraits<LinkedHashSetNode<Valu
         static const bool value = ValueTraits::template NeedsTracingLazily<>::value;
     };
     static const WeakHandlingFlag weakHandlingFlag = ValueTraits::weakHandlingFlag;
+
+    // The nodes are linked to each other and to the anchor of the set.
+    static const bool hasInteriorPointers = true;
 };
 
 template<typename LinkedHashSetType>
@@ -178,6 +178,8 @@ public:
 
     static void enterGCForbiddenScope() { }
     static void leaveGCForbiddenScope() { }
+    static bool isIncrementalMarkingInProgress() { return false; }
+    static void backingWriteBarrier(const void*) { }
 
 private:
     static void* allocateBacking(size_t, const char* typeName);
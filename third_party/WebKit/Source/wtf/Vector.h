@@ -311,6 +311,7 @@ public:
         else
             m_buffer = Allocator::template allocateVectorBacking<T>(sizeToAllocate);
         m_capacity = sizeToAllocate / sizeof(T);
+        Allocator::backingWriteBarrier(m_buffer);
     }
 
     void allocateExpandedBuffer(size_t newCapacity)
@@ -322,6 +323,7 @@ public:
         else
             m_buffer = Allocator::template allocateExpandedVectorBacking<T>(sizeToAllocate);
         m_capacity = sizeToAllocate / sizeof(T);
+        Allocator::backingWriteBarrier(m_buffer);
     }
 
     size_t allocationSize(size_t capacity) const
@@ -428,6 +430,8 @@ public:
     {
         std::swap(m_buffer, other.m_buffer);
         std::swap(m_capacity, other.m_capacity);
+        Allocator::backingWriteBarrier(m_buffer);
+        Allocator::backingWriteBarrier(other.m_buffer);
     }
 
     using Base::allocateBuffer;
@@ -523,6 +527,8 @@ public:
     {
         m_buffer = inlineBuffer();
         m_capacity = inlineCapacity;
+        // The elements are about to be moved into the inline buffer.
+        Allocator::backingWriteBarrier(m_buffer);
     }
 
     void allocateBuffer(size_t newCapacity)
@@ -588,6 +594,8 @@ public:
             std::swap(m_buffer, other.m_buffer);
             std::swap(m_capacity, other.m_capacity);
         }
+        Allocator::backingWriteBarrier(m_buffer);
+        Allocator::backingWriteBarrier(other.m_buffer);
     }
 
     using Base::buffer;
@@ -1332,6 +1340,9 @@ void Vector<T, inlineCapacity, Allocator>::trace(VisitorDispatcher visitor)
         if (Allocator::isHeapObjectAlive(buffer()))
             return;
         Allocator::markNoTracing(visitor, buffer());
+        // The backing of elements that point into it has to stay put.
+        if (!VectorTraits<T>::hasInteriorPointers)
+            Allocator::registerBackingStoreReference(visitor, reinterpret_cast<void**>(&Base::m_buffer));
     }
     const T* bufferBegin = buffer();
     const T* bufferEnd = buffer() + size();
@@ -52,6 +52,11 @@ struct VectorTraitsBase {
         static const bool value = NeedsTracing<T>::value;
     };
     static const WeakHandlingFlag weakHandlingFlag = NoWeakHandlingInCollections; // We don't support weak handling in vectors.
+
+    // The hasInteriorPointers flag is set for values that point into
+    // themselves, like collections with inline capacity, whose backing then
+    // can't be moved by the garbage collector.
+    static const bool hasInteriorPointers = false;
 };
 
 template <typename T>
@@ -103,6 +108,7 @@ struct VectorTraits<std::pair<First, Second>> {
         static const bool value = NeedsTracingTrait<FirstTraits>::value || NeedsTracingTrait<SecondTraits>::value;
     };
     static const WeakHandlingFlag weakHandlingFlag = NoWeakHandlingInCollections; // We don't support weak handling in vectors.
+    static const bool hasInteriorPointers = FirstTraits::hasInteriorPointers || SecondTraits::hasInteriorPointers;
 };
 
 } // namespace WTF
@@ -20,6 +20,9 @@
 // OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
 // WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
+#ifndef _QCMS_QCMSINT_H
+#define _QCMS_QCMSINT_H
+
 #include "qcms.h"
 #include "qcmstypes.h"
 
@@ -302,6 +305,27 @@ static inline float uInt16Number_to_float(uInt16Number a)
 void precache_release(struct precache_output *p);
 qcms_bool set_rgb_colorants(qcms_profile *profile, qcms_CIE_xyY white_point, qcms_CIE_xyYTRIPLE primaries);
 
+void qcms_transform_data_rgb_out_lut_precache(qcms_transform *transform,
+                                              unsigned char *src,
+                                              unsigned char *dest,
+                                              size_t length,
+                                              qcms_format_type output_format);
+void qcms_transform_data_rgba_out_lut_precache(qcms_transform *transform,
+                                               unsigned char *src,
+                                               unsigned char *dest,
+                                               size_t length,
+                                               qcms_format_type output_format);
+void qcms_transform_data_tetra_clut(qcms_transform *transform,
+                                    unsigned char *src,
+                                    unsigned char *dest,
+                                    size_t length,
+                                    qcms_format_type output_format);
+void qcms_transform_data_tetra_clut_rgba(qcms_transform *transform,
+                                         unsigned char *src,
+                                         unsigned char *dest,
+                                         size_t length,
+                                         qcms_format_type output_format);
+
 void qcms_transform_data_rgb_out_lut_sse2(qcms_transform *transform,
                                           unsigned char *src,
                                           unsigned char *dest,
@@ -317,8 +341,40 @@ void qcms_transform_data_tetra_clut_rgba_sse2(qcms_transform* transform,
                                               unsigned char* dest,
                                               size_t length,
                                               qcms_format_type output_format);
+void qcms_transform_data_tetra_clut_rgb_sse2(qcms_transform* transform,
+                                             unsigned char* src,
+                                             unsigned char* dest,
+                                             size_t length,
+                                             qcms_format_type output_format);
+
+void qcms_transform_data_rgb_out_lut_avx2(qcms_transform *transform,
+                                          unsigned char *src,
+                                          unsigned char *dest,
+                                          size_t length,
+                                          qcms_format_type output_format);
+void qcms_transform_data_rgba_out_lut_avx2(qcms_transform *transform,
+                                           unsigned char *src,
+                                           unsigned char *dest,
+                                           size_t length,
+                                           qcms_format_type output_format);
+
+void qcms_transform_data_rgb_out_lut_neon(qcms_transform *transform,
+                                          unsigned char *src,
+                                          unsigned char *dest,
+                                          size_t length,
+                                          qcms_format_type output_format);
+void qcms_transform_data_rgba_out_lut_neon(qcms_transform *transform,
+                                           unsigned char *src,
+                                           unsigned char *dest,
+                                           size_t length,
+                                           qcms_format_type output_format);
 
 void qcms_transform_build_clut_cache(qcms_transform* transform);
+qcms_transform* qcms_transform_precacheLUT_float(qcms_transform *transform,
+                                                 qcms_profile *in,
+                                                 qcms_profile *out,
+                                                 int samples,
+                                                 qcms_data_type in_type);
 
 extern qcms_bool qcms_supports_iccv4;
 
@@ -339,3 +395,5 @@ long __cdecl _InterlockedDecrement(long volatile *);
 #define qcms_atomic_decrement(x) __sync_sub_and_fetch(&x, 1)
 
 #endif
+
+#endif
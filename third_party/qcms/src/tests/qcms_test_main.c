@@ -14,14 +14,16 @@
 // Manually update the items below to add more tests.
 extern struct qcms_test_case qcms_test_tetra_clut_rgba_info;
 extern struct qcms_test_case qcms_test_munsell_info;
+extern struct qcms_test_case qcms_test_throughput_info;
 
-struct qcms_test_case qcms_test[2];
+struct qcms_test_case qcms_test[3];
 #define TEST_CASES    (sizeof(qcms_test) / sizeof(qcms_test[0]))
 
 static void initialize_tests()
 {
     qcms_test[0] = qcms_test_tetra_clut_rgba_info;
     qcms_test[1] = qcms_test_munsell_info;
+    qcms_test[2] = qcms_test_throughput_info;
 }
 
 static void list_tests()
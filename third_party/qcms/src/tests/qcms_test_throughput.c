@@ -0,0 +1,243 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the Chromium LICENSE file.
+
+#include "qcms.h"
+#include "qcms_test_util.h"
+#include "qcmsint.h"
+#include "timing.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Measures the throughput of the transforms qcms picks for the pixel formats
+// Blink decodes images to, against the scalar versions, for the matrix-shaper
+// path and for the tetrahedral clut path.
+
+typedef void (*transform_function)(qcms_transform *transform,
+        unsigned char *src,
+        unsigned char *dest,
+        size_t length,
+        qcms_format_type output_format);
+
+struct pixel_format {
+    const char *name;
+    qcms_data_type type;
+    qcms_format_type output;
+    size_t pixel_size;
+};
+
+static const struct pixel_format pixel_formats[] = {
+    { "RGB", QCMS_DATA_RGB_8, { 0, 2 }, 3 },
+    { "RGBA", QCMS_DATA_RGBA_8, { 0, 2 }, 4 },
+    { "BGRA", QCMS_DATA_RGBA_8, { 2, 0 }, 4 },
+};
+
+#define PIXEL_FORMATS (sizeof(pixel_formats) / sizeof(pixel_formats[0]))
+
+static qcms_profile *adobe_rgb_profile()
+{
+    qcms_CIE_xyY D65 = { 0.3127, 0.3290, 1.0 };
+    qcms_CIE_xyYTRIPLE primaries = {
+        { 0.6400, 0.3300, 1.0 },
+        { 0.2100, 0.7100, 1.0 },
+        { 0.1500, 0.0600, 1.0 },
+    };
+    return qcms_profile_create_rgb_with_gamma(D65, primaries, 563.0f / 256.0f);
+}
+
+static qcms_profile *prophoto_rgb_profile()
+{
+    qcms_CIE_xyY D50 = { 0.3457, 0.3585, 1.0 };
+    qcms_CIE_xyYTRIPLE primaries = {
+        { 0.7347, 0.2653, 1.0 },
+        { 0.1596, 0.8404, 1.0 },
+        { 0.0366, 0.0001, 1.0 },
+    };
+    return qcms_profile_create_rgb_with_gamma(D50, primaries, 1.8f);
+}
+
+static int diffs;
+
+static int validate(unsigned char *dst0, unsigned char *dst1, size_t length, int limit, const size_t pixel_size)
+{
+    size_t bytes = length * pixel_size;
+    size_t i;
+
+    // The scalar matrix transforms truncate the output table index where the
+    // SIMD ones round it, so allow for off-by-one differences.
+
+    for (diffs = 0, i = 0; i < bytes; ++i) {
+        if (abs((int)dst0[i] - (int)dst1[i]) > limit) {
+            ++diffs;
+        }
+    }
+
+    return !diffs;
+}
+
+static int time_transforms(const char *path,
+        const struct pixel_format *format,
+        qcms_transform *transform,
+        transform_function reference,
+        size_t length,
+        int iterations)
+{
+    const size_t pixel_size = format->pixel_size;
+    transform_function selected = transform->transform_fn;
+    double time0 = 0.0, time1 = 0.0;
+    int errors = 0;
+    int i;
+
+    // Re-generate and use different data sources during the iteration loop
+    // to avoid compiler / cache optimizations that may affect performance.
+
+    for (i = 0; i < iterations; ++i) {
+        unsigned char *src = (unsigned char *)calloc(length, pixel_size);
+        unsigned char *dst0 = (unsigned char *)calloc(length, pixel_size);
+        unsigned char *dst1 = (unsigned char *)calloc(length, pixel_size);
+
+        generate_source_uint8_t(src, length, pixel_size);
+
+        TIME(reference(transform, src, dst0, length, format->output), &time0);
+        TIME(selected(transform, src, dst1, length, format->output), &time1);
+
+        if (!validate(dst0, dst1, length, 1, pixel_size)) {
+            fprintf(stderr, "Invalid %s %s transform output: %d diffs\n", path, format->name, diffs);
+            ++errors;
+        }
+
+        free(src);
+        free(dst0);
+        free(dst1);
+    }
+
+    printf("%-8s %-4s %9.2lf %9.2lf Mpixels/s %6.2lfx\n", path, format->name,
+            length * iterations / time0 * 1e-6,
+            length * iterations / time1 * 1e-6,
+            time0 / time1);
+
+    return errors;
+}
+
+static int time_profile(qcms_profile *in_profile,
+        const char *in_name,
+        qcms_profile *out_profile,
+        const char *out_name,
+        size_t length,
+        int iterations,
+        const int force_software)
+{
+    int errors = 0;
+    size_t i;
+
+    printf("\n%s to %s\n", in_name, out_name);
+    printf("%-8s %-4s %9s %9s\n", "path", "", "software", "selected");
+
+    for (i = 0; i < PIXEL_FORMATS; ++i) {
+        const struct pixel_format *format = &pixel_formats[i];
+        transform_function reference;
+        qcms_transform *transform;
+        qcms_transform clut;
+
+        transform = qcms_transform_create(in_profile, format->type, out_profile, format->type, QCMS_INTENT_PERCEPTUAL);
+        if (!transform) {
+            fprintf(stderr, "Failed to create %s color transform\n", format->name);
+            return errors + 1;
+        }
+
+        reference = format->type == QCMS_DATA_RGB_8 ?
+                qcms_transform_data_rgb_out_lut_precache : qcms_transform_data_rgba_out_lut_precache;
+        if (force_software)
+            transform->transform_fn = reference;
+        errors += time_transforms("matrix", format, transform, reference, length, iterations);
+        qcms_transform_release(transform);
+
+        // The clut path is taken for profiles with lut tags: build the same
+        // clut qcms would, from the matrix-shaper profiles.
+
+        memset(&clut, 0, sizeof(clut));
+        if (!qcms_transform_precacheLUT_float(&clut, in_profile, out_profile, 33, format->type)) {
+            fprintf(stderr, "Failed to create %s clut transform\n", format->name);
+            return errors + 1;
+        }
+
+        reference = format->type == QCMS_DATA_RGB_8 ?
+                qcms_transform_data_tetra_clut : qcms_transform_data_tetra_clut_rgba;
+        if (force_software)
+            clut.transform_fn = reference;
+        errors += time_transforms("clut", format, &clut, reference, length, iterations);
+        free(clut.r_clut);
+    }
+
+    return errors;
+}
+
+static int qcms_test_throughput(size_t width,
+        size_t height,
+        int iterations,
+        const char *in_path,
+        const char *out_path,
+        const int force_software)
+{
+    qcms_profile *in_profiles[4];
+    const char *in_names[4];
+    qcms_profile *out_profile;
+    size_t in_profile_count = 0;
+    const size_t length = width * height;
+    int errors = 0;
+    size_t i;
+
+    printf("Test qcms transform throughput for %d iterations\n", iterations);
+    printf("Test image size %u x %u pixels\n", (unsigned) width, (unsigned) height);
+    fflush(stdout);
+
+    srand(0);
+    seconds();
+
+    in_names[in_profile_count] = "sRGB";
+    in_profiles[in_profile_count++] = qcms_profile_sRGB();
+    in_names[in_profile_count] = "Adobe RGB (1998)";
+    in_profiles[in_profile_count++] = adobe_rgb_profile();
+    in_names[in_profile_count] = "ProPhoto RGB";
+    in_profiles[in_profile_count++] = prophoto_rgb_profile();
+    if (in_path) {
+        qcms_profile *profile = qcms_profile_from_path(in_path);
+        if (!profile || qcms_profile_get_color_space(profile) != rgbData || qcms_profile_is_bogus(profile)) {
+            fprintf(stderr, "Invalid input profile\n");
+            return EXIT_FAILURE;
+        }
+        in_names[in_profile_count] = in_path;
+        in_profiles[in_profile_count++] = profile;
+    }
+
+    // Blink converts to the screen profile, sRGB by default, precached.
+    out_profile = out_path ? qcms_profile_from_path(out_path) : qcms_profile_sRGB();
+    if (!out_profile || qcms_profile_get_color_space(out_profile) != rgbData || qcms_profile_is_bogus(out_profile)) {
+        fprintf(stderr, "Invalid output profile\n");
+        return EXIT_FAILURE;
+    }
+    qcms_profile_precache_output_transform(out_profile);
+
+    for (i = 0; i < in_profile_count; ++i) {
+        if (!in_profiles[i]) {
+            fprintf(stderr, "Failed to create input profile\n");
+            ++errors;
+            continue;
+        }
+        errors += time_profile(in_profiles[i], in_names[i], out_profile, out_path ? out_path : "sRGB", length, iterations, force_software);
+        qcms_profile_release(in_profiles[i]);
+    }
+
+    qcms_profile_release(out_profile);
+    printf("\n");
+    return errors;
+}
+
+struct qcms_test_case qcms_test_throughput_info = {
+        "qcms_test_throughput",
+        qcms_test_throughput,
+        QCMS_TEST_DISABLED
+};
@@ -0,0 +1,164 @@
+//  qcms
+//  Copyright (C) 2009 Mozilla Foundation
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <immintrin.h>
+
+#include "qcmsint.h"
+
+/* This file must be built with AVX2 code generation enabled (-mavx2 or
+ * /arch:AVX2): transform.c only selects these functions once it has checked
+ * the CPU and the OS support AVX2. */
+
+#define FLOATSCALE  (float)(PRECACHE_OUTPUT_SIZE - 1)
+#define CLAMPMAXVAL 1.0f
+
+/* Transforms eight pixels per iteration, one pixel per float lane: the input
+ * gamma tables are read with gathers and each output channel takes three
+ * multiplies for all eight pixels. The arithmetic is done in the same order
+ * as the SSE2 code, so both produce the same output. The pixels left over are
+ * handed to the SSE2 code. */
+static inline void matrix_out_lut_avx2(qcms_transform *transform,
+                                       unsigned char *src,
+                                       unsigned char *dest,
+                                       size_t length,
+                                       qcms_format_type output_format,
+                                       const int has_alpha)
+{
+    const int components = has_alpha ? 4 : 3;
+    /* the rgb loads read 16 bytes from the middle of a block of 24: keep 4
+     * bytes of pixels after the block */
+    const size_t min_length = has_alpha ? 8 : 10;
+
+    float (*mat)[4] = transform->matrix;
+
+    /* deref *transform now to avoid it in loop */
+    const float *igtbl_r = transform->input_gamma_table_r;
+    const float *igtbl_g = transform->input_gamma_table_g;
+    const float *igtbl_b = transform->input_gamma_table_b;
+
+    const uint8_t *otdata_r = &transform->output_table_r->data[0];
+    const uint8_t *otdata_g = &transform->output_table_g->data[0];
+    const uint8_t *otdata_b = &transform->output_table_b->data[0];
+
+    /* one coefficient per register: out_c = r * m[0][c] + g * m[1][c] + b * m[2][c] */
+    const __m256 m00 = _mm256_set1_ps(mat[0][0]);
+    const __m256 m01 = _mm256_set1_ps(mat[0][1]);
+    const __m256 m02 = _mm256_set1_ps(mat[0][2]);
+    const __m256 m10 = _mm256_set1_ps(mat[1][0]);
+    const __m256 m11 = _mm256_set1_ps(mat[1][1]);
+    const __m256 m12 = _mm256_set1_ps(mat[1][2]);
+    const __m256 m20 = _mm256_set1_ps(mat[2][0]);
+    const __m256 m21 = _mm256_set1_ps(mat[2][1]);
+    const __m256 m22 = _mm256_set1_ps(mat[2][2]);
+
+    const __m256 max   = _mm256_set1_ps(CLAMPMAXVAL);
+    const __m256 min   = _mm256_setzero_ps();
+    const __m256 scale = _mm256_set1_ps(FLOATSCALE);
+
+    const __m256i byte_mask = _mm256_set1_epi32(0xff);
+    /* spreads four packed rgb pixels of each 128-bit lane over 32-bit lanes */
+    const __m256i rgb_to_rgbx = _mm256_setr_epi8(
+            0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+            0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+
+    const int r_out = output_format.r;
+    const int b_out = output_format.b;
+
+    uint32_t out_r[8], out_g[8], out_b[8];
+    int i;
+
+    while (length >= min_length) {
+        __m256i pixels, index_r, index_g, index_b;
+        __m256 vec_r, vec_g, vec_b, result;
+
+        if (has_alpha) {
+            pixels = _mm256_loadu_si256((const __m256i*)src);
+        } else {
+            pixels = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)src));
+            pixels = _mm256_inserti128_si256(pixels, _mm_loadu_si128((const __m128i*)(src + 12)), 1);
+            pixels = _mm256_shuffle_epi8(pixels, rgb_to_rgbx);
+        }
+
+        index_r = _mm256_and_si256(pixels, byte_mask);
+        index_g = _mm256_and_si256(_mm256_srli_epi32(pixels, 8), byte_mask);
+        index_b = _mm256_and_si256(_mm256_srli_epi32(pixels, 16), byte_mask);
+
+        /* linear values from gamma tables */
+        vec_r = _mm256_i32gather_ps(igtbl_r, index_r, 4);
+        vec_g = _mm256_i32gather_ps(igtbl_g, index_g, 4);
+        vec_b = _mm256_i32gather_ps(igtbl_b, index_b, 4);
+
+        /* gamma * matrix, clamp, and scale to output table indices */
+#define MATRIX_ROW(c0, c1, c2) \
+        _mm256_add_ps(_mm256_mul_ps(vec_g, c1), \
+                      _mm256_add_ps(_mm256_mul_ps(vec_r, c0), _mm256_mul_ps(vec_b, c2)))
+#define OUTPUT_INDEX(out, c0, c1, c2) \
+        result = _mm256_min_ps(max, _mm256_max_ps(min, MATRIX_ROW(c0, c1, c2))); \
+        _mm256_storeu_si256((__m256i*)out, _mm256_cvtps_epi32(_mm256_mul_ps(result, scale)))
+
+        OUTPUT_INDEX(out_r, m00, m10, m20);
+        OUTPUT_INDEX(out_g, m01, m11, m21);
+        OUTPUT_INDEX(out_b, m02, m12, m22);
+
+#undef OUTPUT_INDEX
+#undef MATRIX_ROW
+
+        /* use calc'd indices to output RGB values; src may be dest, so each
+         * pixel's alpha is copied before the next pixel is written */
+        for (i = 0; i < 8; i++) {
+            if (has_alpha)
+                dest[3] = src[3];
+            dest[r_out] = otdata_r[out_r[i]];
+            dest[1]     = otdata_g[out_g[i]];
+            dest[b_out] = otdata_b[out_b[i]];
+            src += components;
+            dest += components;
+        }
+
+        length -= 8;
+    }
+
+    if (!length)
+        return;
+
+    if (has_alpha)
+        qcms_transform_data_rgba_out_lut_sse2(transform, src, dest, length, output_format);
+    else
+        qcms_transform_data_rgb_out_lut_sse2(transform, src, dest, length, output_format);
+}
+
+void qcms_transform_data_rgb_out_lut_avx2(qcms_transform *transform,
+                                          unsigned char *src,
+                                          unsigned char *dest,
+                                          size_t length,
+                                          qcms_format_type output_format)
+{
+    matrix_out_lut_avx2(transform, src, dest, length, output_format, 0);
+}
+
+void qcms_transform_data_rgba_out_lut_avx2(qcms_transform *transform,
+                                           unsigned char *src,
+                                           unsigned char *dest,
+                                           size_t length,
+                                           qcms_format_type output_format)
+{
+    matrix_out_lut_avx2(transform, src, dest, length, output_format, 1);
+}
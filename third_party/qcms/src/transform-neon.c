@@ -0,0 +1,133 @@
+//  qcms
+//  Copyright (C) 2009 Mozilla Foundation
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the Software
+// is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <arm_neon.h>
+
+#include "qcmsint.h"
+
+#define FLOATSCALE  (float)(PRECACHE_OUTPUT_SIZE - 1)
+#define CLAMPMAXVAL 1.0f
+
+/* Rounds to the nearest output table index, as the SSE2 code does. */
+static inline uint32x4_t output_index(float32x4_t value)
+{
+#if defined(__aarch64__)
+    return vcvtnq_u32_f32(value);
+#else
+    return vcvtq_u32_f32(vaddq_f32(value, vdupq_n_f32(0.5f)));
+#endif
+}
+
+/* Transforms four pixels per iteration, one pixel per float lane, so each
+ * output channel takes three multiplies for all four pixels. NEON has no
+ * gathers, so the gamma tables are read a pixel at a time. */
+static inline void matrix_out_lut_neon(qcms_transform *transform,
+                                       unsigned char *src,
+                                       unsigned char *dest,
+                                       size_t length,
+                                       qcms_format_type output_format,
+                                       const int has_alpha)
+{
+    const int components = has_alpha ? 4 : 3;
+
+    float (*mat)[4] = transform->matrix;
+
+    /* deref *transform now to avoid it in loop */
+    const float *igtbl_r = transform->input_gamma_table_r;
+    const float *igtbl_g = transform->input_gamma_table_g;
+    const float *igtbl_b = transform->input_gamma_table_b;
+
+    const uint8_t *otdata_r = &transform->output_table_r->data[0];
+    const uint8_t *otdata_g = &transform->output_table_g->data[0];
+    const uint8_t *otdata_b = &transform->output_table_b->data[0];
+
+    const float32x4_t max   = vdupq_n_f32(CLAMPMAXVAL);
+    const float32x4_t min   = vdupq_n_f32(0.0f);
+    const float32x4_t scale = vdupq_n_f32(FLOATSCALE);
+
+    const int r_out = output_format.r;
+    const int b_out = output_format.b;
+
+    float linear_r[4] = { 0 }, linear_g[4] = { 0 }, linear_b[4] = { 0 };
+    uint32_t out_r[4], out_g[4], out_b[4];
+    size_t i;
+
+    while (length) {
+        const size_t count = length < 4 ? length : 4;
+        float32x4_t vec_r, vec_g, vec_b, result;
+
+        /* linear values from gamma tables; lanes past the last pixel keep
+         * the values of the previous block and are never written out */
+        for (i = 0; i < count; i++) {
+            linear_r[i] = igtbl_r[src[i * components + 0]];
+            linear_g[i] = igtbl_g[src[i * components + 1]];
+            linear_b[i] = igtbl_b[src[i * components + 2]];
+        }
+        vec_r = vld1q_f32(linear_r);
+        vec_g = vld1q_f32(linear_g);
+        vec_b = vld1q_f32(linear_b);
+
+        /* gamma * matrix, clamp, and scale to output table indices, adding
+         * the terms in the order the SSE2 code does */
+#define OUTPUT_INDEX(out, c) \
+        result = vaddq_f32(vmulq_n_f32(vec_g, mat[1][c]), \
+                           vaddq_f32(vmulq_n_f32(vec_r, mat[0][c]), vmulq_n_f32(vec_b, mat[2][c]))); \
+        result = vminq_f32(max, vmaxq_f32(min, result)); \
+        vst1q_u32(out, output_index(vmulq_f32(result, scale)))
+
+        OUTPUT_INDEX(out_r, 0);
+        OUTPUT_INDEX(out_g, 1);
+        OUTPUT_INDEX(out_b, 2);
+
+#undef OUTPUT_INDEX
+
+        /* use calc'd indices to output RGB values */
+        for (i = 0; i < count; i++) {
+            if (has_alpha)
+                dest[3] = src[3];
+            dest[r_out] = otdata_r[out_r[i]];
+            dest[1]     = otdata_g[out_g[i]];
+            dest[b_out] = otdata_b[out_b[i]];
+            src += components;
+            dest += components;
+        }
+
+        length -= count;
+    }
+}
+
+void qcms_transform_data_rgb_out_lut_neon(qcms_transform *transform,
+                                          unsigned char *src,
+                                          unsigned char *dest,
+                                          size_t length,
+                                          qcms_format_type output_format)
+{
+    matrix_out_lut_neon(transform, src, dest, length, output_format, 0);
+}
+
+void qcms_transform_data_rgba_out_lut_neon(qcms_transform *transform,
+                                           unsigned char *src,
+                                           unsigned char *dest,
+                                           size_t length,
+                                           qcms_format_type output_format)
+{
+    matrix_out_lut_neon(transform, src, dest, length, output_format, 1);
+}
@@ -275,11 +275,14 @@ static inline __m128i __mm_swizzle_epi32(__m128i value, int bgra)
                   _mm_shuffle_epi32(value, _MM_SHUFFLE(0, 3, 2, 1)) ;
 }
 
-void qcms_transform_data_tetra_clut_rgba_sse2(qcms_transform *transform,
-                                              unsigned char *src,
-                                              unsigned char *dest,
-                                              size_t length,
-                                              qcms_format_type output_format)
+/* has_alpha is a constant at each call site, so each caller gets its own
+ * copy of the loop without the per-pixel alpha tests */
+static inline void tetra_clut_sse2(qcms_transform *transform,
+                                   unsigned char *src,
+                                   unsigned char *dest,
+                                   size_t length,
+                                   qcms_format_type output_format,
+                                   const int has_alpha)
 {
     const int bgra = output_format.r;
 
@@ -314,7 +317,7 @@ void qcms_transform_data_tetra_clut_rgba_sse2(qcms_transform *transform,
 
         // initialize the output result with the alpha channel only
 
-        __m128i result = _mm_setr_epi32(*src++, 0, 0, 0);
+        __m128i result = _mm_setr_epi32(has_alpha ? *src++ : 0, 0, 0, 0);
 
         // get the input point r.xyz relative to the subcube origin
 
@@ -450,9 +453,35 @@ void qcms_transform_data_tetra_clut_rgba_sse2(qcms_transform *transform,
         result = _mm_packus_epi16(result, result);
         result = _mm_packus_epi16(result, result);
 
-        // store into uint32_t* pixel destination
+        // store into uint32_t* pixel destination, or the three color bytes
+        // of the pixel without alpha
 
-        *(uint32_t *)dest = _mm_cvtsi128_si32(result);
-        dest += 4;
+        if (has_alpha) {
+            *(uint32_t *)dest = _mm_cvtsi128_si32(result);
+            dest += 4;
+        } else {
+            uint32_t pixel = _mm_cvtsi128_si32(result);
+            *dest++ = pixel;
+            *dest++ = pixel >> 8;
+            *dest++ = pixel >> 16;
+        }
     }
 }
+
+void qcms_transform_data_tetra_clut_rgba_sse2(qcms_transform *transform,
+                                              unsigned char *src,
+                                              unsigned char *dest,
+                                              size_t length,
+                                              qcms_format_type output_format)
+{
+    tetra_clut_sse2(transform, src, dest, length, output_format, 1);
+}
+
+void qcms_transform_data_tetra_clut_rgb_sse2(qcms_transform *transform,
+                                             unsigned char *src,
+                                             unsigned char *dest,
+                                             size_t length,
+                                             qcms_format_type output_format)
+{
+    tetra_clut_sse2(transform, src, dest, length, output_format, 0);
+}
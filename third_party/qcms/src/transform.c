@@ -374,7 +374,7 @@ static void qcms_transform_data_graya_out_precache(qcms_transform *transform, un
 	}
 }
 
-static void qcms_transform_data_rgb_out_lut_precache(qcms_transform *transform, unsigned char *src, unsigned char *dest, size_t length, qcms_format_type output_format)
+void qcms_transform_data_rgb_out_lut_precache(qcms_transform *transform, unsigned char *src, unsigned char *dest, size_t length, qcms_format_type output_format)
 {
 	const int r_out = output_format.r;
 	const int b_out = output_format.b;
@@ -639,7 +639,7 @@ void qcms_transform_data_tetra_clut_rgba(qcms_transform *transform, unsigned cha
 }
 
 // Using lcms' tetra interpolation code.
-static void qcms_transform_data_tetra_clut(qcms_transform *transform, unsigned char *src, unsigned char *dest, size_t length, qcms_format_type output_format)
+void qcms_transform_data_tetra_clut(qcms_transform *transform, unsigned char *src, unsigned char *dest, size_t length, qcms_format_type output_format)
 {
 	const int r_out = output_format.r;
 	const int b_out = output_format.b;
@@ -1048,6 +1048,62 @@ static int sse_version_available(void)
 	return 0;
 #endif
 }
+
+#if defined(AVX2_ENABLE)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+#define OSXSAVE_ECX_MASK (1UL << 27)
+#define AVX_ECX_MASK     (1UL << 28)
+#define AVX2_EBX_MASK    (1UL <<  5)
+/* XCR0 bits for the XMM and YMM register state */
+#define XCR0_YMM_MASK    0x6
+
+/* AVX2 needs the CPU to support it and the OS to save the YMM registers. */
+static int avx2_available(void)
+{
+	static int avx2 = -1;
+	uint32_t xcr0;
+
+	if (avx2 != -1)
+		return avx2;
+	avx2 = 0;
+#if defined(_MSC_VER)
+	{
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return avx2;
+		__cpuid(info, 1);
+		if ((info[2] & (OSXSAVE_ECX_MASK | AVX_ECX_MASK)) != (OSXSAVE_ECX_MASK | AVX_ECX_MASK))
+			return avx2;
+		__cpuidex(info, 7, 0);
+		if (!(info[1] & AVX2_EBX_MASK))
+			return avx2;
+		xcr0 = (uint32_t)_xgetbv(0);
+	}
+#else
+	{
+		unsigned int a, b, c, d;
+		if (__get_cpuid_max(0, 0) < 7)
+			return avx2;
+		__cpuid(1, a, b, c, d);
+		if ((c & (OSXSAVE_ECX_MASK | AVX_ECX_MASK)) != (OSXSAVE_ECX_MASK | AVX_ECX_MASK))
+			return avx2;
+		__cpuid_count(7, 0, a, b, c, d);
+		if (!(b & AVX2_EBX_MASK))
+			return avx2;
+		__asm__ __volatile__ ("xgetbv" : "=a" (a), "=d" (d) : "c" (0));
+		xcr0 = a;
+	}
+#endif
+	avx2 = (xcr0 & XCR0_YMM_MASK) == XCR0_YMM_MASK;
+	return avx2;
+}
+#endif
 #endif
 
 static const struct matrix bradford_matrix = {{	{ 0.8951f, 0.2664f,-0.1614f},
@@ -1167,7 +1223,15 @@ qcms_transform* qcms_transform_precacheLUT_float(qcms_transform *transform, qcms
 				transform->transform_fn = qcms_transform_data_tetra_clut_rgba;
 #endif
 			} else {
+#if defined(SSE2_ENABLE)
+				if (sse_version_available() >= 2) {
+					transform->transform_fn = qcms_transform_data_tetra_clut_rgb_sse2;
+				} else {
+					transform->transform_fn = qcms_transform_data_tetra_clut;
+				}
+#else
 				transform->transform_fn = qcms_transform_data_tetra_clut;
+#endif
 			}
 		}
 	}
@@ -1350,6 +1414,14 @@ qcms_transform* qcms_transform_create(
 		}
 
 		if (precache) {
+#if defined(AVX2_ENABLE)
+			if (avx2_available()) {
+				if (in_type == QCMS_DATA_RGB_8)
+					transform->transform_fn = qcms_transform_data_rgb_out_lut_avx2;
+				else
+					transform->transform_fn = qcms_transform_data_rgba_out_lut_avx2;
+			} else
+#endif
 #if defined(SSE2_ENABLE)
 			if (sse_version_available() >= 2) {
 				if (in_type == QCMS_DATA_RGB_8)
@@ -1358,12 +1430,21 @@ qcms_transform* qcms_transform_create(
 					transform->transform_fn = qcms_transform_data_rgba_out_lut_sse2;
 			} else
 #endif
+#if defined(NEON_ENABLE)
+			{
+				if (in_type == QCMS_DATA_RGB_8)
+					transform->transform_fn = qcms_transform_data_rgb_out_lut_neon;
+				else
+					transform->transform_fn = qcms_transform_data_rgba_out_lut_neon;
+			}
+#else
 			{
 				if (in_type == QCMS_DATA_RGB_8)
 					transform->transform_fn = qcms_transform_data_rgb_out_lut_precache;
 				else
 					transform->transform_fn = qcms_transform_data_rgba_out_lut_precache;
 			}
+#endif
 		} else {
 			if (in_type == QCMS_DATA_RGB_8)
 				transform->transform_fn = qcms_transform_data_rgb_out_lut;